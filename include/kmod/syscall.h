@@ -34,6 +34,7 @@ enum KmodSchedClass : size_t {
     SCHED_CLASS_FCFS = 2,
     SCHED_CLASS_RR   = 3,
     SCHED_CLASS_RT   = 5,
+    SCHED_CLASS_FAIR = 6,
 };
 
 constexpr size_t WNOHANG = 1;
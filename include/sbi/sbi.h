@@ -253,6 +253,41 @@ SBIRet sbi_set_timer(qword stime_value);
  */
 SBIRet sbi_send_ipi(umb_t hart_mask, umb_t hart_mask_base);
 
+//-----------------------
+// HSM Extension
+// EID #0x48534D "HSM"
+//-----------------------
+
+/**
+ * @brief 启动处于 STOPPED 状态的 hart (FID #0)
+ *
+ * 目标 hart 以 S-Mode 从 start_addr 开始执行, 此时分页关闭,
+ * a0 为其 hartid, a1 为 opaque.
+ *
+ * @param hartid 目标 hart
+ * @param start_addr 起始物理地址
+ * @param opaque 传给目标 hart 的参数
+ * @return SBIRet 返回值
+ */
+SBIRet sbi_hart_start(umb_t hartid, umb_t start_addr, umb_t opaque);
+
+/**
+ * @brief 停止当前 hart (FID #1)
+ *
+ * 成功时不返回.
+ *
+ * @return SBIRet 返回值
+ */
+SBIRet sbi_hart_stop(void);
+
+/**
+ * @brief 获取 hart 的 HSM 状态 (FID #2)
+ *
+ * @param hartid 目标 hart
+ * @return SBIRet 返回值, value 为 HSM_STATE
+ */
+SBIRet sbi_hart_get_status(umb_t hartid);
+
 //-----------------------
 // RFENCE Extension
 // EID #0x52464E43 "RFNC"
@@ -14,14 +14,20 @@
 #include <sus/units.h>
 #include <sustcore/addr.h>
 
+#include <cstddef>
+
 // Timer Tick Event Pack
 struct TimerTickEvent {
     units::time last;
     units::time now;
     units::time delta;
+    // 本次覆盖的 tick 周期数, tick 停止 (NO_HZ) 后恢复时大于 1
+    size_t ticks = 1;
 };
 
 // No Present Event Pack
 struct NoPresentEvent {
     VirAddr access_address;
+    // 是否由写访问触发
+    bool write = false;
 };
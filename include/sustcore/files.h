@@ -82,6 +82,7 @@ struct VFSPageCacheStats {
     size_t writebacks;
     size_t evictions;
     size_t cached_pages;
+    // 0 表示不设上限, 由内核在内存紧张时回收
     size_t max_pages;
     size_t backing_reads;
     size_t backing_writes;
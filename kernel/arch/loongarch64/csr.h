@@ -1193,4 +1193,20 @@ __OPCSR__ csr_dmw_t csr_xchg_dmw3(csr_dmw_t d) {
     return {LA64_CSR_SWAP(CSR_DMWIN3, d.value)};
 }
 
+/* ===================== IOCSR 访问 ===================== */
+
+__OPCSR__ csr32_t iocsr_read32(umb_t reg) {
+    csr32_t v;
+    asm volatile("iocsrrd.w %0, %1" : "=r"(v) : "r"(reg) : "memory");
+    return v;
+}
+
+__OPCSR__ void iocsr_write32(csr32_t v, umb_t reg) {
+    asm volatile("iocsrwr.w %0, %1" : : "r"(v), "r"(reg) : "memory");
+}
+
+__OPCSR__ void iocsr_write64(csr_t v, umb_t reg) {
+    asm volatile("iocsrwr.d %0, %1" : : "r"(v), "r"(reg) : "memory");
+}
+
 #undef __OPCSR__
\ No newline at end of file
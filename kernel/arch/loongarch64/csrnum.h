@@ -160,6 +160,8 @@
 
 #define INT_TIMER  11
 #define ECFG_TIMER (1UL << INT_TIMER)
+#define INT_IPI    12
+#define ECFG_IPI   (1UL << INT_IPI)
 
 #define TCFG_EN            (1UL << 0)
 #define TCFG_PERIODIC      (1UL << 1)
@@ -198,4 +200,8 @@
 #define IOCSR_IPI_SEND_BLOCKING   (1UL << 31)
 #define IOCSR_MBUF_SEND_BLOCKING  (1ULL << 31)
 #define IOCSR_MBUF_SEND_BOX_SHIFT 2
-#define IOCSR_MBUF_SEND_CPU_SHIFT 16
\ No newline at end of file
+#define IOCSR_MBUF_SEND_CPU_SHIFT 16
+#define IOCSR_MBUF_SEND_BUF_SHIFT 32
+#define IOCSR_MBUF_SEND_H32_MASK  0xFFFFFFFF00000000ULL
+#define IOCSR_MBUF_SEND_BOX_LO(box) ((box) << 1)
+#define IOCSR_MBUF_SEND_BOX_HI(box) (((box) << 1) + 1)
\ No newline at end of file
@@ -18,6 +18,14 @@
 #define HART_CONTEXT_SIZE 512
 #define MAX_HARTS         32
 
+// 从 hart 启动参数块 (SecondaryBootParams) 的字段偏移
+#define SECONDARY_PGDL_OFFSET      0
+#define SECONDARY_PGDH_OFFSET      8
+#define SECONDARY_TLBRENTRY_OFFSET 16
+#define SECONDARY_SP_OFFSET        24
+#define SECONDARY_TP_OFFSET        32
+#define SECONDARY_ENTRY_OFFSET     40
+
 #define CTX_RA_SLOT     0
 #define CTX_TP_SLOT     1
 #define CTX_SP_SLOT     2
@@ -12,6 +12,7 @@
 #include <arch/loongarch64/csr.h>
 #include <arch/loongarch64/device/clock.h>
 #include <device/model.h>
+#include <env.h>
 #include <logger.h>
 
 namespace la64 {
@@ -47,9 +48,19 @@ namespace la64 {
         : driver::Alarm(clksrc), _clock_virq(clock_virq) {
         _last_recorded_time = _clksrc->to_ns(_clksrc->now());
         auto &irqman        = device::DeviceModel::inst().interrupt();
+        // 各 hart 共用同一个定时器 virq, 由首个创建的定时器登记,
+        // 中断到来时转交给当前 hart 自己的定时器
         auto register_res = irqman.register_handler(
-            clock_virq, this_call(this, &CSRTimer::handle_irq));
-        assert(register_res.has_value());
+            clock_virq, [](const driver::IrqEvent &event) {
+                auto *alarm = env::hart_ctx->alarm();
+                if (alarm == nullptr) {
+                    loggers::INTERRUPT::ERROR("当前 hart 未初始化 CSRTimer");
+                    return;
+                }
+                static_cast<CSRTimer *>(alarm)->handle_irq(event);
+            });
+        assert(register_res.has_value() ||
+               register_res.error() == ErrCode::KEY_DUPLICATED);
     }
 
     void CSRTimer::set_next_event(units::time delta) noexcept {
@@ -20,8 +20,10 @@ namespace la64 {
     public:
         static constexpr driver::hwirq_t HWI_BEGIN        = 2;
         static constexpr driver::hwirq_t HWI_END          = 9;
+        static constexpr driver::hwirq_t PMC_IRQ          = 10;
         static constexpr driver::hwirq_t TIMER_IRQ        = 11;
-        static constexpr driver::hwirq_t PMC_IRQ          = 12;
+        // 核间中断不经中断域分发, 由 handle_trap 在取大内核锁前处理
+        static constexpr driver::hwirq_t IPI_IRQ          = 12;
         static constexpr size_t MAX_HW_IRQ                = 13;
         static constexpr const char *COMPATIBLE_STRING =
             "loongson,cpu-interrupt-controller";
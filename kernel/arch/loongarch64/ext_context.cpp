@@ -174,4 +174,35 @@ namespace la64 {
     void copy_ext_context(ExtContext &dst, const ExtContext &src) noexcept {
         memcpy(&dst, &src, sizeof(dst));
     }
+
+    // EUEN 不随 trap 上下文保存, 下列操作直接作用于当前 hart,
+    // 调用方须保证 uctx 属于当前线程或即将切换到的线程
+    bool ext_context_dirty(const Context &uctx) noexcept {
+        (void)uctx;
+        // EUEN 没有脏位, 自上次保存后重新启用过即视为已修改
+        csr_euen_t euen = csr_get_euen();
+        return euen.fpe || euen.sxe;
+    }
+
+    void ext_context_clean(Context &uctx) noexcept {
+        // 关闭后再次使用时陷入, 由此得知保存之后是否又被修改
+        ext_context_disable(uctx);
+    }
+
+    void ext_context_disable(Context &uctx) noexcept {
+        (void)uctx;
+        // 首条浮点/LSX 指令将触发未使能例外
+        csr_euen_t euen = csr_get_euen();
+        euen.fpe        = 0;
+        euen.sxe        = 0;
+        csr_set_euen(euen);
+    }
+
+    void ext_context_enable(Context &uctx) noexcept {
+        (void)uctx;
+        csr_euen_t euen = csr_get_euen();
+        euen.fpe        = 1;
+        euen.sxe        = 1;
+        csr_set_euen(euen);
+    }
 }  // namespace la64
@@ -15,6 +15,7 @@
 #include <device/model.h>
 #include <env.h>
 #include <logger.h>
+#include <smp/smp.h>
 #include <sus/logger.h>
 #include <syscall/syscall.h>
 #include <task/scheduler.h>
@@ -510,7 +511,8 @@ namespace exception {
                             "缺页异常可尝试处理: addr=%p, page=%p, tm_pgd=%p",
                             fault_addr.addr(), fault_page.addr(),
                             tm->pgd().addr());
-                        processed |= tm->on_np({fault_addr});
+                        processed |= tm->on_np(
+                            {fault_addr, cause == STORE_PAGE_INVALID});
                         if (processed) {
                             auto verify_pman = PageMan(PageMan::read_root());
                             log_pte_debug(fault_addr, verify_pman);
@@ -623,6 +625,17 @@ namespace exception {
         log_user_illegal_instruction_bytes(env::inst().pgd(), fault_pc);
     }
 
+    /**
+     * @brief 用户态首次使用浮点/LSX 指令, 装载扩展上下文后重新执行.
+     */
+    [[nodiscard]]
+    bool ext_disabled(Context *ctx) noexcept {
+        if (!from_umode() || !schd::Scheduler::initialized()) {
+            return false;
+        }
+        return schd::Scheduler::inst().ext_context_fault(ctx);
+    }
+
     void exception(umb_t cause, csr_estat_t estat, Context *ctx) {
         if (cause == INSTRUCTION_NOT_EXIST) {
             illegal_instruction(cause, ctx);
@@ -642,6 +655,12 @@ namespace exception {
             case PAGE_PRIVILEGE_VIOLATION:
                 paging::paging_fault(cause, estat, ctx);
                 break;
+            case FLOAT_DISABLED:
+            case VECTOR_128_DISABLED:
+                if (!ext_disabled(ctx)) {
+                    unrecoverable(cause, estat, ctx);
+                }
+                break;
             default: unrecoverable(cause, estat, ctx); break;
         }
     }
@@ -673,8 +692,10 @@ namespace interrupt {
         }
         auto &cpuic = static_cast<la64::CpuICChip &>(chip);
 
-        for (umb_t bit = 0; bit <= la64::CpuICChip::PMC_IRQ; ++bit) {
-            if ((estat.is & (1ULL << bit)) == 0) {
+        for (umb_t bit = 0; bit < la64::CpuICChip::MAX_HW_IRQ; ++bit) {
+            if ((estat.is & (1ULL << bit)) == 0 ||
+                bit == la64::CpuICChip::IPI_IRQ)
+            {
                 continue;
             }
 
@@ -706,6 +727,15 @@ namespace interrupt {
 extern "C" void isr_entry();
 
 extern "C" void handle_trap(umb_t era, csr_estat_t estat, Context *ctx) {
+    if (estat.ecode == ECODE_INT &&
+        (estat.is & (1ULL << la64::CpuICChip::IPI_IRQ)) != 0)
+    {
+        // 核间请求不依赖大内核锁, 先于取锁处理
+        Hart::clear_ipi();
+        SMP::handle_ipi();
+    }
+    BigKernelLock::acquire();
+
     loggers::EXCEPTION::DEBUG("trap: ecode=%llu era=%p ctx=%p from_%s",
                               static_cast<unsigned long long>(estat.ecode),
                               (void *)era, ctx,
@@ -732,6 +762,8 @@ extern "C" void handle_trap(umb_t era, csr_estat_t estat, Context *ctx) {
             }
         }
     }
+
+    BigKernelLock::release();
 }
 
 void Interrupt::init() {
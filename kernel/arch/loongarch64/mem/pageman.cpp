@@ -176,9 +176,26 @@ Result<void> PageMan::init_task_root(PhyAddr root) noexcept {
 void PageMan::__switch_root(PhyAddr root) {
     umb_t root_val = root.arith() & PAGE_ADDR_MASK;
     LA64_CSR_WRITE(CSR_PGDL, root_val);
+    // 未分配 ASID 的地址空间统一使用 ASID 0
+    csr_asid_t asid = csr_get_asid();
+    asid.asid       = 0;
+    csr_set_asid(asid);
     flush_tlb();
 }
 
+void PageMan::__switch_root(PhyAddr root, uint16_t asid) {
+    umb_t root_val = root.arith() & PAGE_ADDR_MASK;
+    csr_asid_t csr = csr_get_asid();
+    csr.asid       = asid;
+    // 先更换 ASID 再更换页表根, 之间不会有用户态访存
+    csr_set_asid(csr);
+    LA64_CSR_WRITE(CSR_PGDL, root_val);
+}
+
+size_t PageMan::asid_bits() {
+    return csr_get_asid().asidbits;
+}
+
 void PageMan::__kernel_switch_root(PhyAddr root) {
     umb_t root_val = root.arith() & PAGE_ADDR_MASK;
     LA64_CSR_WRITE(CSR_PGDH, root_val);
@@ -193,6 +210,38 @@ void PageMan::flush_tlb() {
         : "memory");
 }
 
+void PageMan::flush_tlb_asid(uint16_t asid) {
+    // op 4: 清除 G=0 且 ASID 匹配的项
+    umb_t asid_val = asid;
+    asm volatile(
+        "    dbar 0\n"
+        "    invtlb 0x4, %0, $zero\n"
+        "    ibar 0" ::"r"(asid_val)
+        : "memory");
+}
+
+void PageMan::flush_tlb_asid_page(VirAddr vaddr, uint16_t asid) {
+    // op 5: 清除 G=0 且 ASID 与 VA 均匹配的项
+    umb_t asid_val = asid;
+    asm volatile(
+        "    dbar 0\n"
+        "    invtlb 0x5, %0, %1\n"
+        "    ibar 0" ::"r"(asid_val),
+        "r"(vaddr.arith())
+        : "memory");
+}
+
+void PageMan::flush_tlb_page(VirAddr vaddr) {
+    // op 6: 清除 G=1 或 ASID 匹配, 且 VA 匹配的项
+    umb_t asid = csr_get_asid().asid;
+    asm volatile(
+        "    dbar 0\n"
+        "    invtlb 0x6, %0, %1\n"
+        "    ibar 0" ::"r"(asid),
+        "r"(vaddr.arith())
+        : "memory");
+}
+
 Result<PageMan::QueryResult> PageMan::query_page(VirAddr vaddr) {
     umb_t vpn[level(PageSize::_4K)];
     make_vpn<PageSize::_4K>(vaddr, vpn);
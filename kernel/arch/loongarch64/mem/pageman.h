@@ -220,6 +220,14 @@ namespace la64 {
         static void set_cow(PTE *pte, bool cow);
         static void protect_cow(PTE *pte, RWX original_rwx);
         static void restore_from_cow(PTE *pte, PageFlags flags);
+        /**
+         * @brief 读取并清除访问位
+         *
+         * LoongArch 页表项没有访问位, 总是返回 false, 所有页都视为冷页.
+         */
+        static constexpr bool test_and_clear_young(PTE *) {
+            return false;
+        }
         static void set_paddr(PTE *pte, PhyAddr paddr);
         static PhyAddr read_root();
         static PhyAddr __kernel_read_root();
@@ -227,7 +235,12 @@ namespace la64 {
         static Result<void> init_task_root(PhyAddr root) noexcept;
         static void __switch_root(PhyAddr root);
         static void __kernel_switch_root(PhyAddr root);
+        static void __switch_root(PhyAddr root, uint16_t asid);
+        static size_t asid_bits();
         static void flush_tlb();
+        static void flush_tlb_page(VirAddr vaddr);
+        static void flush_tlb_asid(uint16_t asid);
+        static void flush_tlb_asid_page(VirAddr vaddr, uint16_t asid);
 
     private:
         PhyAddr __root;
@@ -289,12 +302,112 @@ namespace la64 {
             return query_res.value().size;
         }
 
+        static constexpr PageSize leaf_size(size_t level_index) {
+            switch (level_index) {
+                case 1:  return PageSize::_1G;
+                case 2:  return PageSize::_2M;
+                default: return PageSize::_4K;
+            }
+        }
+
+        template <typename Fn>
+        static bool walk_table(PTE *pt, size_t level_index, umb_t base,
+                               umb_t vstart, umb_t vend, Fn &fn) {
+            const umb_t span  = 1UL << level_shift(level_index);
+            const umb_t first = (vstart - base) >> level_shift(level_index);
+            for (umb_t idx = first; idx < PTE_CNT; ++idx) {
+                umb_t entry_base = base + idx * span;
+                if (entry_base >= vend) {
+                    break;
+                }
+                PTE &pte = pt[idx];
+                if (!pte_exists(pte)) {
+                    continue;
+                }
+                bool last = level_index + 1 == PAGE_LEVELS;
+                if (last || !pte_is_table(pte)) {
+                    if (!fn(VirAddr(entry_base), &pte, leaf_size(level_index)))
+                    {
+                        return false;
+                    }
+                    // 回调可能把大页拆成了下级页表, 此时继续向下遍历
+                    if (last || !pte_exists(pte) || !pte_is_table(pte)) {
+                        continue;
+                    }
+                }
+                umb_t sub_start = vstart > entry_base ? vstart : entry_base;
+                if (!walk_table(_as<PTE>(get_physical_address(pte)),
+                                level_index + 1, entry_base, sub_start, vend,
+                                fn))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
     public:
         explicit constexpr PageMan(PhyAddr root) : __root(root) {}
 
         [[nodiscard]]
         Result<QueryResult> query_page(VirAddr vaddr);
 
+        /**
+         * @brief 按地址升序访问与 [vstart, vend) 相交的全部叶子页表项.
+         *
+         * 跳过不存在的上级表项, 代价与实际存在的页表数成正比, 而非区间长度.
+         * fn 形如 bool(VirAddr leaf_base, PTE *pte, PageSize size),
+         * 返回 false 时停止遍历. 大页叶子的起点可能早于 vstart.
+         * 回调可以把大页叶子拆分为下级页表, 遍历会继续进入新页表.
+         * 仅支持低半部 (用户) 地址.
+         */
+        template <typename Fn>
+        void walk_leaves(VirAddr vstart, VirAddr vend, Fn &&fn) {
+            if (vend <= vstart) {
+                return;
+            }
+            walk_table(root(), 0, 0, vstart.page_align_down().arith(),
+                       vend.arith(), fn);
+        }
+
+        /**
+         * @brief 获取 vaddr 所在的最后一级页表, 缺失的中间页表会被分配.
+         *
+         * @return 最后一级页表首项; 路径被大页占用返回 BUSY,
+         * 分配失败返回分配器错误
+         */
+        [[nodiscard]]
+        Result<PTE *> ensure_leaf_table(VirAddr vaddr) {
+            umb_t vpn[level(PageSize::_4K)];
+            make_vpn<PageSize::_4K>(vaddr, vpn);
+
+            PTE *pt = root();
+            for (size_t level_index = 0; level_index + 1 < PAGE_LEVELS;
+                 ++level_index)
+            {
+                PTE &pte = pt[vpn[level_index]];
+                if (!pte_exists(pte)) {
+                    auto new_page_res = new_page();
+                    propagate(new_page_res);
+                    PhyAddr new_pt = new_page_res.value();
+                    make_root(new_pt);
+                    pte = {};
+                    set_paddr(&pte, new_pt);
+                } else if (!pte_is_table(pte)) {
+                    unexpect_return(ErrCode::BUSY);
+                }
+                pt = _as<PTE>(get_physical_address(pte));
+            }
+            return pt;
+        }
+
+        /**
+         * @brief vaddr 在最后一级页表中的下标.
+         */
+        static constexpr size_t leaf_index(VirAddr vaddr) {
+            return (vaddr.arith() >> PAGE_BITS) & index_mask();
+        }
+
         template <PageSize size>
         void map_page(VirAddr vaddr, PhyAddr paddr, PageFlags flags) {
             static_assert(size != PageSize::_NULL, "不能映射大小为0的页");
@@ -346,6 +459,11 @@ namespace la64 {
             *target_pte = {};
             set_paddr(target_pte, paddr);
             modify_pte<Modifier::ALL>(target_pte, flags);
+            if constexpr (size != PageSize::_4K) {
+                // 目录级叶子的 bit 6 是 HUGE 标志, 缺少它时 lddir
+                // 会把该表项当作下级页表继续遍历
+                target_pte->basic.g = true;
+            }
             loggers::PAGING::DEBUG(
                 "LoongArch64 映射完成: va=%p pa=%p rwx=%lu u=%d g=%d p=%d",
                 vaddr.addr(), paddr.addr(),
@@ -361,6 +479,52 @@ namespace la64 {
             query_res.value().pte->value = 0;
         }
 
+        /**
+         * @brief 确保 vaddr 处可以直接放置 size 大小的叶子页表项.
+         *
+         * 目标表项为空时直接返回 true; 若其指向一张全空的下级页表,
+         * 回收该页表并清空表项. 路径或目标上存在任何有效映射时返回 false.
+         */
+        template <PageSize size>
+        bool prepare_leaf_slot(VirAddr vaddr) {
+            static_assert(size != PageSize::_NULL);
+            constexpr int total_levels = level(size);
+            umb_t vpn[total_levels];
+            make_vpn<size>(vaddr, vpn);
+
+            PTE *pt = root();
+            for (int level_index = 0; level_index < total_levels - 1;
+                 ++level_index)
+            {
+                PTE &pte = pt[vpn[level_index]];
+                if (!pte_exists(pte)) {
+                    return true;
+                }
+                if (!pte_is_table(pte)) {
+                    return false;
+                }
+                pt = _as<PTE>(get_physical_address(pte));
+            }
+
+            PTE &slot = pt[vpn[total_levels - 1]];
+            if (!pte_exists(slot)) {
+                return true;
+            }
+            if (!pte_is_table(slot)) {
+                return false;
+            }
+            PhyAddr table = get_physical_address(slot);
+            PTE *entries  = _as<PTE>(table);
+            for (size_t i = 0; i < PTE_CNT; i++) {
+                if (pte_exists(entries[i])) {
+                    return false;
+                }
+            }
+            slot.value = 0;
+            GFP::page_putpage(table);
+            return true;
+        }
+
         template <bool use_hugepage>
         void map_range(VirAddr vstart, PhyAddr pstart, size_t range_sz,
                        PageFlags flags) {
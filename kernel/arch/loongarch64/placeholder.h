@@ -83,6 +83,9 @@ namespace la64 {
         static void set_cow(PTE *, bool);
         static void protect_cow(PTE *, RWX) {}
         static void restore_from_cow(PTE *, PageFlags) {}
+        static constexpr bool test_and_clear_young(PTE *) {
+            return false;
+        }
         static void set_paddr(PTE *, PhyAddr);
         static PhyAddr read_root();
         static PhyAddr __kernel_read_root();
@@ -91,7 +94,12 @@ namespace la64 {
         static Result<void> init_task_root(PhyAddr root) noexcept;
         static void __switch_root(PhyAddr root);
         static void __kernel_switch_root(PhyAddr root);
+        static void __switch_root(PhyAddr root, uint16_t asid);
+        static size_t asid_bits();
         static void flush_tlb();
+        static void flush_tlb_page(VirAddr vaddr);
+        static void flush_tlb_asid(uint16_t asid);
+        static void flush_tlb_asid_page(VirAddr vaddr, uint16_t asid);
 
         static constexpr size_t PTE_CNT = 512;
 
@@ -107,6 +115,22 @@ namespace la64 {
 
         void unmap_page(VirAddr) {}
 
+        template <typename Fn>
+        void walk_leaves(VirAddr, VirAddr, Fn &&) {}
+
+        [[nodiscard]]
+        Result<PTE *> ensure_leaf_table(VirAddr);
+
+        static constexpr size_t leaf_index(VirAddr) {
+            return 0;
+        }
+
+        template <PageSize size>
+        bool prepare_leaf_slot(VirAddr) {
+            static_assert(size == PageSize::_4K || size != PageSize::_4K);
+            return false;
+        }
+
         template <bool use_hugepage>
         void map_range(VirAddr, PhyAddr, size_t, PageFlags) {
             static_assert(!use_hugepage || use_hugepage);
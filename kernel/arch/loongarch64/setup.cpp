@@ -9,6 +9,7 @@
  *
  */
 
+#include <arch/loongarch64/csr.h>
 #include <arch/loongarch64/mem/pageman.h>
 #include <arch/loongarch64/device/clock.h>
 #include <arch/loongarch64/device/platform.h>
@@ -19,6 +20,7 @@
 #include <env.h>
 #include <logger.h>
 #include <sus/logger.h>
+#include <sustcore/addr.h>
 #include <sustcore/boot.h>
 
 #include <cstddef>
@@ -66,6 +68,73 @@ extern "C" void c_setup_main(size_t boot_hart_id, BootInfoHeader *bootinfo) {
     }
 }
 
+extern "C" SecondaryBootParams __secondary_boot;
+SecondaryBootParams __secondary_boot = {};
+
+extern "C" void _secondary_start(void);
+extern "C" void secondary_post_init(void);
+
+/**
+ * @brief 从 hart 开启分页后的 C 入口, 栈与 tp 已由 _secondary_start 设置.
+ */
+extern "C" void c_secondary_setup(void) {
+    Interrupt::init();
+    secondary_post_init();
+    while (true) {
+    }
+}
+
+namespace {
+    /**
+     * @brief 把 64 位数据写入目标 hart 的邮箱, 先高后低各 32 位.
+     */
+    void mail_send(umb_t data, size_t hart, umb_t mailbox) {
+        umb_t val = IOCSR_MBUF_SEND_BLOCKING |
+                    (IOCSR_MBUF_SEND_BOX_HI(mailbox)
+                     << IOCSR_MBUF_SEND_BOX_SHIFT) |
+                    (hart << IOCSR_MBUF_SEND_CPU_SHIFT) |
+                    (data & IOCSR_MBUF_SEND_H32_MASK);
+        iocsr_write64(val, IOCSR_MBUF_SEND);
+
+        val = IOCSR_MBUF_SEND_BLOCKING |
+              (IOCSR_MBUF_SEND_BOX_LO(mailbox) << IOCSR_MBUF_SEND_BOX_SHIFT) |
+              (hart << IOCSR_MBUF_SEND_CPU_SHIFT) |
+              (data << IOCSR_MBUF_SEND_BUF_SHIFT);
+        iocsr_write64(val, IOCSR_MBUF_SEND);
+    }
+}  // namespace
+
+Result<void> Hart::start(size_t hart, void *stack_top) {
+    __secondary_boot.pgdl      = LA64_CSR_READ(CSR_PGDL);
+    __secondary_boot.pgdh      = LA64_CSR_READ(CSR_PGDH);
+    __secondary_boot.tlbrentry = LA64_CSR_READ(CSR_TLBRENTRY);
+    __secondary_boot.sp        = reinterpret_cast<umb_t>(stack_top);
+    __secondary_boot.tp        = reinterpret_cast<umb_t>(&env::hart_context(hart));
+    __secondary_boot.entry     = reinterpret_cast<umb_t>(&c_secondary_setup);
+    // 对方在直接地址模式下读取参数块
+    asm volatile("dbar 0" ::: "memory");
+
+    // 固件在邮箱 0 中取得入口物理地址, 收到核间中断后跳转
+    mail_send(KVA2PA(reinterpret_cast<addr_t>(&_secondary_start)), hart, 0);
+    send_ipi(hart);
+    void_return();
+}
+
+void Hart::send_ipi(size_t hart) {
+    iocsr_write32(static_cast<csr32_t>(IOCSR_IPI_SEND_BLOCKING |
+                                       (hart << IOCSR_IPI_SEND_CPU_SHIFT)),
+                  IOCSR_IPI_SEND);
+}
+
+void Hart::clear_ipi() {
+    iocsr_write32(iocsr_read32(IOCSR_IPI_STATUS), IOCSR_IPI_CLEAR);
+}
+
+void Hart::enable_ipi() {
+    iocsr_write32(0xFFFF'FFFF, IOCSR_IPI_EN);
+    LA64_CSR_SET(CSR_ECFG, ECFG_IPI);
+}
+
 void Initialization::pre_init(void) {}
 
 void Initialization::init_fpu(void) {
@@ -73,7 +142,7 @@ void Initialization::init_fpu(void) {
     euen.fpe  = 1;
     csr_set_euen(euen);
     loggers::SUSTCORE::INFO(
-        "已启用 LoongArch64 浮点指令支持(FPE), 当前尚未支持上下文保存");
+        "已启用 LoongArch64 浮点指令支持(FPE), 用户线程首次使用时装载浮点上下文");
 }
 
 void Initialization::init_simd(void) {
@@ -81,7 +150,7 @@ void Initialization::init_simd(void) {
     euen.sxe  = 1;
     csr_set_euen(euen);
     loggers::SUSTCORE::INFO(
-        "已启用 LoongArch64 LSX 向量指令支持(SXE), 当前尚未支持上下文保存");
+        "已启用 LoongArch64 LSX 向量指令支持(SXE), 与浮点上下文一同懒惰切换");
 }
 
 void Initialization::post_init(void) {
@@ -44,6 +44,13 @@ namespace la64 {
     void restore_ext_context(const ExtContext &ctx) noexcept;
     void copy_ext_context(ExtContext &dst, const ExtContext &src) noexcept;
 
+    // 懒惰切换扩展上下文, uctx 为线程的用户态 trap 上下文
+    [[nodiscard]]
+    bool ext_context_dirty(const Context &uctx) noexcept;
+    void ext_context_clean(Context &uctx) noexcept;
+    void ext_context_disable(Context &uctx) noexcept;
+    void ext_context_enable(Context &uctx) noexcept;
+
     constexpr void write_ret(Context &ctx, const syscall::RetPack &pack) {
         ctx.a0 = pack.ret0;
         ctx.a1 = pack.ret1;
@@ -82,5 +89,51 @@ namespace la64 {
 
     static_assert(IdleTrait<Idle>);
 
+    /**
+     * @brief 从 hart 启动参数, 由 _secondary_start 在直接地址模式下读取.
+     */
+    struct SecondaryBootParams {
+        umb_t pgdl;
+        umb_t pgdh;
+        umb_t tlbrentry;
+        umb_t sp;
+        umb_t tp;
+        umb_t entry;
+    };
+    static_assert(offsetof(SecondaryBootParams, pgdl) == SECONDARY_PGDL_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, pgdh) == SECONDARY_PGDH_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, tlbrentry) ==
+                  SECONDARY_TLBRENTRY_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, sp) == SECONDARY_SP_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, tp) == SECONDARY_TP_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, entry) ==
+                  SECONDARY_ENTRY_OFFSET);
+
+    struct Hart {
+        /**
+         * @brief 通过 IPI 邮箱拉起 hart, 使其以 stack_top 为栈进入内核.
+         *
+         * 调用方须已设置好该 hart 的 Hart 上下文槽.
+         */
+        static Result<void> start(size_t hart, void *stack_top);
+
+        /**
+         * @brief 向 hart 发送核间中断.
+         */
+        static void send_ipi(size_t hart);
+
+        /**
+         * @brief 清除当前 hart 未决的核间中断.
+         */
+        static void clear_ipi();
+
+        /**
+         * @brief 允许当前 hart 接收核间中断.
+         */
+        static void enable_ipi();
+    };
+
+    static_assert(HartTrait<Hart>);
+
     class PageMan;
 }  // namespace la64
@@ -64,6 +64,8 @@ namespace rv64 {
         umb_t sepc;
         csr_sstatus_t sstatus;
         umb_t kstack_sp;
+        umb_t hart;
+        umb_t reserved;
 
         [[nodiscard]]
         constexpr umb_t &ra() {
@@ -179,6 +181,7 @@ namespace rv64 {
                   CTX_SLOT_OFFSET(CTX_SSTATUS_SLOT));
     static_assert(offsetof(Context, kstack_sp) ==
                   CTX_SLOT_OFFSET(CTX_KSTACK_SP_SLOT));
+    static_assert(offsetof(Context, hart) == CTX_SLOT_OFFSET(CTX_HART_SLOT));
 
     constexpr void write_ret(Context &ctx, const syscall::RetPack &pack) {
         ctx.a0 = pack.ret0;
@@ -14,6 +14,12 @@
 #define HART_CONTEXT_SIZE 512UL
 #define MAX_HARTS 32UL
 
+// 从 hart 启动参数块 (SecondaryBootParams) 的字段偏移
+#define SECONDARY_SATP_OFFSET 0UL
+#define SECONDARY_SP_OFFSET 8UL
+#define SECONDARY_TP_OFFSET 16UL
+#define SECONDARY_ENTRY_OFFSET 24UL
+
 #define CTX_SLOT_SIZE 8UL
 #define CTX_SLOT_SHIFT 3UL
 #define CTX_SLOT_OFFSET(slot) ((slot) << CTX_SLOT_SHIFT)
@@ -53,7 +59,11 @@
 #define CTX_SEPC_SLOT 31UL
 #define CTX_SSTATUS_SLOT 32UL
 #define CTX_KSTACK_SP_SLOT 33UL
-#define CTX_SLOT_COUNT 34UL
+// 返回用户态时所在 hart 的上下文指针, 用户态陷入时据此恢复 tp
+#define CTX_HART_SLOT 34UL
+// 填充, 保持上下文大小 16 字节对齐
+#define CTX_RESERVED_SLOT 35UL
+#define CTX_SLOT_COUNT 36UL
 
 #define CTX_RA_SLOT CTX_X1_SLOT
 #define CTX_SP_SLOT CTX_X2_SLOT
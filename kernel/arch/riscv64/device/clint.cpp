@@ -90,6 +90,22 @@ namespace riscv {
         return virq_resources().at(1)->virq();
     }
 
+    driver::virq_t Clint::clock_virq(device::cpuid_t hart_id) const noexcept {
+        for (size_t i = 0; i < _target_harts.size(); ++i) {
+            if (_target_harts[i] != hart_id) {
+                continue;
+            }
+            size_t index = i * 2 + 1;
+            if (index >= virq_resources().size() ||
+                virq_resources().at(index) == nullptr)
+            {
+                return 0;
+            }
+            return virq_resources().at(index)->virq();
+        }
+        return 0;
+    }
+
     Result<void> Clint::enable_irq(driver::hwirq_t hw_irq) noexcept {
         loggers::INTERRUPT::ERROR("Clint[%u] 不支持 enable hwirq=%u",
                                   identifier(), hw_irq);
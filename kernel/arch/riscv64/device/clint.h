@@ -39,6 +39,15 @@ namespace riscv {
         driver::virq_t software_virq() const noexcept;
         [[nodiscard]]
         driver::virq_t clock_virq() const noexcept;
+        /**
+         * @brief 获取指定 hart 的定时器 virq.
+         *
+         * virq 资源按 target_harts 的顺序成对排列 (软件中断, 定时器中断).
+         *
+         * @return virq_t 该 hart 不归本 Clint 管理时返回 0
+         */
+        [[nodiscard]]
+        driver::virq_t clock_virq(device::cpuid_t hart_id) const noexcept;
         [[nodiscard]]
         Result<void> enable_irq(driver::hwirq_t hw_irq) noexcept override;
         [[nodiscard]]
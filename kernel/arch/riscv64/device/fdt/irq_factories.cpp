@@ -207,6 +207,9 @@ namespace riscv::fdt {
                     clint.attach_to_parent_domain(model.interrupt(), *domain);
                 propagate(attach_res);
                 model.set_clock_virq(clint.clock_virq());
+                for (auto hart : clint.target_harts()) {
+                    model.set_clock_virq(hart, clint.clock_virq(hart));
+                }
                 return static_cast<driver::DriverBase *>(
                     device_owner_res.value().get());
             }
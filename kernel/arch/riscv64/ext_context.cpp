@@ -146,4 +146,24 @@ namespace rv64 {
     void copy_ext_context(ExtContext &dst, const ExtContext &src) noexcept {
         memcpy(&dst, &src, sizeof(dst));
     }
+
+    // sstatus.FS 随 trap 上下文保存与恢复, 直接反映线程返回用户态后的状态
+    bool ext_context_dirty(const Context &uctx) noexcept {
+        return uctx.sstatus.fs == XSStatus::DIRTY;
+    }
+
+    void ext_context_clean(Context &uctx) noexcept {
+        if (uctx.sstatus.fs != XSStatus::OFF) {
+            uctx.sstatus.fs = XSStatus::CLEAN;
+        }
+    }
+
+    void ext_context_disable(Context &uctx) noexcept {
+        // 首条浮点指令将触发非法指令异常
+        uctx.sstatus.fs = XSStatus::OFF;
+    }
+
+    void ext_context_enable(Context &uctx) noexcept {
+        uctx.sstatus.fs = XSStatus::CLEAN;
+    }
 }  // namespace rv64
@@ -16,6 +16,7 @@
 #include <device/model.h>
 #include <env.h>
 #include <logger.h>
+#include <smp/smp.h>
 #include <sus/logger.h>
 #include <sus/types.h>
 #include <syscall/syscall.h>
@@ -696,7 +697,8 @@ namespace exception {
                             "缺页异常可尝试处理: addr=%p, page=%p, tm_pgd=%p",
                             fault_addr.addr(), fault_page.addr(),
                             tm->pgd().addr());
-                        processed |= tm->on_np({fault_addr});
+                        processed |= tm->on_np(
+                            {fault_addr, scause.cause == STORE_PAGE_FAULT});
 
                         // for debug:
                         if (processed) {
@@ -765,10 +767,6 @@ namespace exception {
                     }
 
                     PageMan::RWX rwx = PageMan::rwx(*pte);
-                    loggers::EXCEPTION::ERROR(
-                        "A/D 位异常不可恢复: addr=%p, A=%d, D=%d, rwx=0x%lx",
-                        fault_addr.addr(), pte->a, pte->d,
-                        static_cast<unsigned long>(rwx));
                     if ((scause.cause == STORE_PAGE_FAULT) &&
                         PageMan::is_writable(rwx))
                     {
@@ -778,10 +776,16 @@ namespace exception {
 
                     processed = updated;
                     if (updated) {
-                        PageMan::flush_tlb();
+                        PageMan::flush_tlb_page(fault_addr.page_align_down());
                         loggers::EXCEPTION::DEBUG(
                             "修复 A/D 位后重试: addr=%p, A=%d, D=%d",
                             fault_addr.addr(), pte->a, pte->d);
+                    } else {
+                        loggers::EXCEPTION::ERROR(
+                            "A/D 位异常不可恢复: addr=%p, A=%d, D=%d, "
+                            "rwx=0x%lx",
+                            fault_addr.addr(), pte->a, pte->d,
+                            static_cast<unsigned long>(rwx));
                     }
                     break;
                 }
@@ -837,6 +841,13 @@ namespace exception {
             "进入非法指令异常处理程序: sepc=0x%016lx, stval=0x%016lx", sepc,
             stval);
         (void)scause;
+        // FS=OFF 时任何浮点指令都会陷入, 先当作首次使用装载扩展上下文;
+        // 若确为非法指令, 重新执行时 FS 已非 OFF, 会再次陷入并走下面的路径
+        if (from_umode(ctx) && ctx->sstatus.fs == XSStatus::OFF &&
+            schd::Scheduler::inst().ext_context_fault(ctx))
+        {
+            return true;
+        }
         if (from_umode(ctx)) {
             VirAddr fault_pc(sepc);
             if (is_user_vaddr(fault_pc)) {
@@ -963,6 +974,9 @@ namespace interrupt {
                 }
                 return;
             }
+            case riscv::IntC::SOFTWARE_LOCAL_IRQ_S:
+                // 核间中断已在 handle_trap 取锁前处理
+                return;
             case riscv::IntC::EXTERNAL_LOCAL_IRQ: {
                 auto post_res = riscv_intc.post_external();
                 if (!post_res.has_value()) {
@@ -981,6 +995,15 @@ namespace interrupt {
 
 extern "C" void handle_trap(csr_scause_t scause, umb_t sepc, umb_t stval,
                             Context *ctx) {
+    if (scause.interrupt &&
+        scause.cause == riscv::IntC::SOFTWARE_LOCAL_IRQ_S)
+    {
+        // 核间请求不依赖大内核锁, 先于取锁处理
+        Hart::clear_ipi();
+        SMP::handle_ipi();
+    }
+    BigKernelLock::acquire();
+
     if (!scause.interrupt) {
         loggers::EXCEPTION::DEBUG(
             "trap: cause=%llu sepc=%p stval=%p ctx=%p sp(before fault)=%p "
@@ -1023,6 +1046,8 @@ extern "C" void handle_trap(csr_scause_t scause, umb_t sepc, umb_t stval,
             csr_set_sscratch(new_sscratch);
         }
     }
+
+    BigKernelLock::release();
 }
 
 extern "C" void isr_entry(void);
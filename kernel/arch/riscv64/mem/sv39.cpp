@@ -117,6 +117,33 @@ void SV39PageMan::__switch_root(PhyAddr __root) {
     new_satp.asid = 0;  // TODO: ASID支持
     new_satp.ppn  = SV39PageMan::to_ppn(__root);
     csr_set_satp(new_satp);
+    // 写 satp 本身不会使旧地址空间的 TLB 项失效
+    flush_tlb();
+}
+
+void SV39PageMan::__switch_root(PhyAddr __root, uint16_t asid) {
+    csr_satp_t new_satp;
+    new_satp.mode = SATPMode::SV39;
+    new_satp.asid = asid;
+    new_satp.ppn  = SV39PageMan::to_ppn(__root);
+    csr_set_satp(new_satp);
+}
+
+size_t SV39PageMan::asid_bits() {
+    // ASIDLEN 由实现决定: 写入全 1 后读回的位即为可用位
+    csr_satp_t old_satp   = csr_get_satp();
+    csr_satp_t probe_satp = old_satp;
+    probe_satp.asid       = 0xFFFF;
+    csr_set_satp(probe_satp);
+    umb_t asid = csr_get_satp().asid;
+    csr_set_satp(old_satp);
+
+    size_t bits = 0;
+    while ((asid & 1) != 0) {
+        bits++;
+        asid >>= 1;
+    }
+    return bits;
 }
 
 void SV39PageMan::__kernel_switch_root(PhyAddr __root) {
@@ -126,3 +153,18 @@ void SV39PageMan::__kernel_switch_root(PhyAddr __root) {
 void SV39PageMan::flush_tlb() {
     asm volatile("sfence.vma");
 }
+
+void SV39PageMan::flush_tlb_page(VirAddr vaddr) {
+    asm volatile("sfence.vma %0, zero" ::"r"(vaddr.arith()) : "memory");
+}
+
+void SV39PageMan::flush_tlb_asid(uint16_t asid) {
+    asm volatile("sfence.vma zero, %0" ::"r"(static_cast<umb_t>(asid))
+                 : "memory");
+}
+
+void SV39PageMan::flush_tlb_asid_page(VirAddr vaddr, uint16_t asid) {
+    asm volatile("sfence.vma %0, %1" ::"r"(vaddr.arith()),
+                 "r"(static_cast<umb_t>(asid))
+                 : "memory");
+}
@@ -222,6 +222,21 @@ namespace rv64 {
             set_cow(pte, false);
         }
 
+        /**
+         * @brief 读取并清除访问位
+         *
+         * 清除后的下一次访问会经 INVALID_AD 异常重新置位.
+         * 调用者负责失效对应的 TLB 表项.
+         */
+        static bool test_and_clear_young(PTE *pte) {
+            if (pte == nullptr) {
+                return false;
+            }
+            bool young = pte->a;
+            pte->a     = false;
+            return young;
+        }
+
         static void set_paddr(PTE *pte, PhyAddr paddr) {
             if (pte != nullptr) {
                 pte->ppn = to_ppn(paddr);
@@ -321,6 +336,113 @@ namespace rv64 {
             unexpect_return(ErrCode::INVALID_PTE);
         }
 
+    private:
+        static constexpr umb_t level_shift(size_t level) {
+            return 30 - 9 * level;
+        }
+
+        static constexpr PageSize leaf_size(size_t level) {
+            switch (level) {
+                case 0:  return PageSize::_1G;
+                case 1:  return PageSize::_2M;
+                default: return PageSize::_4K;
+            }
+        }
+
+        template <typename Fn>
+        static bool walk_table(PTE *pt, size_t depth, umb_t base, umb_t vstart,
+                               umb_t vend, Fn &fn) {
+            constexpr size_t total_levels = level(PageSize::_4K);
+            const umb_t span  = 1ul << level_shift(depth);
+            const umb_t first = (vstart - base) >> level_shift(depth);
+            for (umb_t idx = first; idx < PTE_CNT; idx++) {
+                umb_t entry_base = base + idx * span;
+                if (entry_base >= vend) {
+                    break;
+                }
+                PTE &pte = pt[idx];
+                if (!pte.v) {
+                    continue;
+                }
+                if (pte.rwx != RWX::P) {
+                    if (!fn(VirAddr(entry_base), &pte, leaf_size(depth))) {
+                        return false;
+                    }
+                    // 回调可能把大页拆成了下级页表, 此时继续向下遍历
+                    if (!pte.v || pte.rwx != RWX::P) {
+                        continue;
+                    }
+                }
+                if (depth + 1 >= total_levels) {
+                    continue;
+                }
+                umb_t sub_start = vstart > entry_base ? vstart : entry_base;
+                if (!walk_table(_as<PTE>(from_ppn(pte.ppn)), depth + 1,
+                                entry_base, sub_start, vend, fn))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+        /**
+         * @brief 按地址升序访问与 [vstart, vend) 相交的全部叶子页表项.
+         *
+         * 跳过无效的上级表项, 代价与实际存在的页表数成正比, 而非区间长度.
+         * fn 形如 bool(VirAddr leaf_base, PTE *pte, PageSize size),
+         * 返回 false 时停止遍历. 大页叶子的起点可能早于 vstart.
+         * 回调可以把大页叶子拆分为下级页表, 遍历会继续进入新页表.
+         * 仅支持低半部 (用户) 地址.
+         */
+        template <typename Fn>
+        void walk_leaves(VirAddr vstart, VirAddr vend, Fn &&fn) {
+            if (vend <= vstart) {
+                return;
+            }
+            walk_table(root(), 0, 0, vstart.page_align_down().arith(),
+                       vend.arith(), fn);
+        }
+
+        /**
+         * @brief 获取 vaddr 所在的最后一级页表, 缺失的中间页表会被分配.
+         *
+         * @return 最后一级页表首项; 路径被大页占用返回 BUSY,
+         * 分配失败返回分配器错误
+         */
+        [[nodiscard]]
+        Result<PTE *> ensure_leaf_table(VirAddr vaddr) {
+            umb_t vpn[3];
+            make_vpn<PageSize::_4K>(vaddr, vpn);
+            constexpr size_t total_levels = level(PageSize::_4K);
+
+            PTE *pt = root();
+            for (size_t depth = 0; depth + 1 < total_levels; depth++) {
+                PTE &pte = pt[vpn[depth]];
+                if (!pte.v) {
+                    auto new_page_res = new_page();
+                    propagate(new_page_res);
+                    PhyAddr new_pt = new_page_res.value();
+                    memset(_convert(new_pt).addr(), 0, PAGESIZE);
+                    pte.value = 0;
+                    pte.ppn   = to_ppn(new_pt);
+                    pte.v     = true;
+                } else if (pte.rwx != RWX::P) {
+                    unexpect_return(ErrCode::BUSY);
+                }
+                pt = _as<PTE>(from_ppn(pte.ppn));
+            }
+            return pt;
+        }
+
+        /**
+         * @brief vaddr 在最后一级页表中的下标.
+         */
+        static constexpr size_t leaf_index(VirAddr vaddr) {
+            return (vaddr.arith() >> 12) & (PTE_CNT - 1);
+        }
+
         template <PageSize size>
         void map_page(VirAddr vaddr, PhyAddr paddr, PageFlags flags) {
             // 当size为_NULL时, 无法映射任何页, 因此直接返回
@@ -408,6 +530,50 @@ namespace rv64 {
                 flags.g, flags.p);
         }
 
+        /**
+         * @brief 确保 vaddr 处可以直接放置 size 大小的叶子页表项.
+         *
+         * 目标表项为空时直接返回 true; 若其指向一张全空的下级页表,
+         * 回收该页表并清空表项. 路径或目标上存在任何有效映射时返回 false.
+         */
+        template <PageSize size>
+        bool prepare_leaf_slot(VirAddr vaddr) {
+            static_assert(size != PageSize::_NULL);
+            constexpr int tot_levels = level(size);
+            umb_t vpn[tot_levels];
+            make_vpn<size>(vaddr, vpn);
+
+            PTE *pt = root();
+            for (int level = 0; level < tot_levels - 1; level++) {
+                PTE &pte = pt[vpn[level]];
+                if (!pte.v) {
+                    return true;
+                }
+                if (pte.rwx != RWX::P) {
+                    return false;
+                }
+                pt = _as<PTE>(from_ppn(pte.ppn));
+            }
+
+            PTE &slot = pt[vpn[tot_levels - 1]];
+            if (!slot.v) {
+                return true;
+            }
+            if (slot.rwx != RWX::P) {
+                return false;
+            }
+            PhyAddr table = from_ppn(slot.ppn);
+            PTE *entries  = _as<PTE>(table);
+            for (size_t i = 0; i < PTE_CNT; i++) {
+                if (entries[i].v) {
+                    return false;
+                }
+            }
+            slot.value = 0;
+            GFP::page_putpage(table);
+            return true;
+        }
+
         template <bool use_hugepage>
         void map_range(const VirAddr vstart, const PhyAddr pstart,
                        size_t range_sz, PageFlags flags) {
@@ -605,6 +771,10 @@ namespace rv64 {
         // 更换页表根
         static void __switch_root(PhyAddr __root);
         static void __kernel_switch_root(PhyAddr __root);
+        // 以指定 ASID 更换页表根, 不刷新 TLB
+        static void __switch_root(PhyAddr __root, uint16_t asid);
+        // 硬件实现的 ASID 位数, 0 表示不支持
+        static size_t asid_bits();
 
         inline void switch_root() {
             __switch_root(__root);
@@ -617,6 +787,12 @@ namespace rv64 {
 
         // 刷新TLB
         static void flush_tlb();
+        // 刷新当前地址空间中单个虚拟页的TLB项
+        static void flush_tlb_page(VirAddr vaddr);
+        // 刷新指定 ASID 的全部非全局TLB项
+        static void flush_tlb_asid(uint16_t asid);
+        // 刷新指定 ASID 中单个虚拟页的TLB项
+        static void flush_tlb_asid_page(VirAddr vaddr, uint16_t asid);
     };
 
     static_assert(ArchPageManTrait<SV39PageMan>);
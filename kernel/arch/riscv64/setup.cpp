@@ -61,7 +61,8 @@ Result<void> Initialization::init_clock() {
         unexpect_return(ErrCode::NULLPTR);
     }
 
-    auto clock_virq = device_model.clock_virq();
+    auto clock_virq = device_model.clock_virq(
+        static_cast<device::cpuid_t>(ctx->hart_id()));
     if (clock_virq == 0) {
         loggers::SUSTCORE::ERROR("DeviceModel 未提供有效 clock_virq");
         unexpect_return(ErrCode::INVALID_PARAM);
@@ -86,6 +87,56 @@ extern "C" void c_setup(void) {
     while (true);
 }
 
+extern "C" SecondaryBootParams __secondary_boot;
+SecondaryBootParams __secondary_boot = {};
+
+extern "C" void _secondary_start(void);
+extern "C" void secondary_post_init(void);
+
+/**
+ * @brief 从 hart 开启分页后的 C 入口, 栈与 tp 已由 _secondary_start 设置.
+ */
+extern "C" void c_secondary_setup(void) {
+    Interrupt::init();
+    secondary_post_init();
+    while (true);
+}
+
+Result<void> Hart::start(size_t hart, void *stack_top) {
+    __secondary_boot.satp  = csr_get_satp().value;
+    __secondary_boot.sp    = reinterpret_cast<umb_t>(stack_top);
+    __secondary_boot.tp    = reinterpret_cast<umb_t>(&env::hart_context(hart));
+    __secondary_boot.entry = reinterpret_cast<umb_t>(&c_secondary_setup);
+    // 对方在关闭分页时直接读取内存中的参数块
+    asm volatile("fence rw, rw" ::: "memory");
+
+    umb_t start_pa = KVA2PA(reinterpret_cast<addr_t>(&_secondary_start));
+    SBIRet ret     = sbi_hart_start(hart, start_pa, 0);
+    if (ret.error != 0) {
+        loggers::SUSTCORE::ERROR("SBI hart_start 失败: hart=%u err=%ld",
+                                 static_cast<unsigned>(hart),
+                                 static_cast<long>(ret.error));
+        unexpect_return(ErrCode::FAILURE);
+    }
+    void_return();
+}
+
+void Hart::send_ipi(size_t hart) {
+    sbi_send_ipi(1ul << hart, 0);
+}
+
+void Hart::clear_ipi() {
+    csr_sip_t sip = csr_get_sip();
+    sip.ssip      = 0;
+    csr_set_sip(sip);
+}
+
+void Hart::enable_ipi() {
+    csr_sie_t sie = csr_get_sie();
+    sie.ssie      = 1;
+    csr_set_sie(sie);
+}
+
 void Initialization::pre_init(void) {}
 
 void Initialization::init_fpu(void) {
@@ -93,7 +144,7 @@ void Initialization::init_fpu(void) {
     sstatus.fs            = XSStatus::INITIAL;
     csr_set_sstatus(sstatus);
     loggers::SUSTCORE::INFO(
-        "已启用 RISC-V 浮点指令支持(FS=INITIAL), 当前尚未支持上下文保存");
+        "已启用 RISC-V 浮点指令支持(FS=INITIAL), 用户线程首次使用时装载浮点上下文");
 }
 
 void Initialization::init_simd(void) {
@@ -25,7 +25,7 @@ static void __raw_spin_lock(raw_spinlock_t *lock) {
         "  amoswap.w.aq %0, %0, (%1) \n"  // swap lock & tmp
         "  bnez %0, 1b               \n"  // if tmp is still 1, then the lock is
                                           // still unreleased
-        : "=&r"(tmp)
+        : "+r"(tmp)
         : "r"(lock)
         : "memory");
     // at this time, the lock is acquired
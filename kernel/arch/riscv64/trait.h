@@ -41,6 +41,13 @@ namespace rv64 {
     void restore_ext_context(const ExtContext &ctx) noexcept;
     void copy_ext_context(ExtContext &dst, const ExtContext &src) noexcept;
 
+    // 懒惰切换扩展上下文, uctx 为线程的用户态 trap 上下文
+    [[nodiscard]]
+    bool ext_context_dirty(const Context &uctx) noexcept;
+    void ext_context_clean(Context &uctx) noexcept;
+    void ext_context_disable(Context &uctx) noexcept;
+    void ext_context_enable(Context &uctx) noexcept;
+
     struct Interrupt {
         /**
          * @brief 初始化IVT
@@ -72,6 +79,46 @@ namespace rv64 {
         static void idle();
     };
     static_assert(IdleTrait<Idle>);
+
+    /**
+     * @brief 从 hart 启动参数, 由 _secondary_start 在关闭分页时按物理地址读取.
+     */
+    struct SecondaryBootParams {
+        umb_t satp;
+        umb_t sp;
+        umb_t tp;
+        umb_t entry;
+    };
+    static_assert(offsetof(SecondaryBootParams, satp) == SECONDARY_SATP_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, sp) == SECONDARY_SP_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, tp) == SECONDARY_TP_OFFSET);
+    static_assert(offsetof(SecondaryBootParams, entry) ==
+                  SECONDARY_ENTRY_OFFSET);
+
+    struct Hart {
+        /**
+         * @brief 通过 SBI HSM 拉起 hart, 使其以 stack_top 为栈进入内核.
+         *
+         * 调用方须已设置好该 hart 的 Hart 上下文槽.
+         */
+        static Result<void> start(size_t hart, void *stack_top);
+
+        /**
+         * @brief 向 hart 发送软件中断.
+         */
+        static void send_ipi(size_t hart);
+
+        /**
+         * @brief 清除当前 hart 未决的软件中断.
+         */
+        static void clear_ipi();
+
+        /**
+         * @brief 允许当前 hart 接收软件中断.
+         */
+        static void enable_ipi();
+    };
+    static_assert(HartTrait<Hart>);
 }  // namespace rv64
 
 #include <arch/riscv64/mem/pageman.h>
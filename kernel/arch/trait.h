@@ -222,6 +222,17 @@ concept ArchPageManTrait = requires(T root, size_t size, VirAddr vaddr,
     {
         root.unmap_page(vaddr)
     } -> std::same_as<void>;
+    // 获取最后一级页表
+    {
+        root.ensure_leaf_table(vaddr)
+    } -> std::same_as<Result<typename T::PTE *>>;
+    {
+        T::leaf_index(vaddr)
+    } -> std::same_as<size_t>;
+    // 为大页叶子腾出表项
+    {
+        root.template prepare_leaf_slot<T::PageSize::_4K>(vaddr)
+    } -> std::same_as<bool>;
     // 范围映射
     {
         root.template map_range<false>(vaddr, paddr, size, flags)
@@ -254,6 +265,23 @@ concept ArchPageManTrait = requires(T root, size_t size, VirAddr vaddr,
     {
         T::flush_tlb()
     } -> std::same_as<void>;
+    {
+        T::flush_tlb_page(vaddr)
+    } -> std::same_as<void>;
+    // 按 ASID 刷新TLB
+    {
+        T::flush_tlb_asid(uint16_t{})
+    } -> std::same_as<void>;
+    {
+        T::flush_tlb_asid_page(vaddr, uint16_t{})
+    } -> std::same_as<void>;
+    // ASID 支持
+    {
+        T::asid_bits()
+    } -> std::same_as<size_t>;
+    {
+        T::__switch_root(paddr, uint16_t{})
+    } -> std::same_as<void>;
     // 获得页表根
     {
         root.get_root()
@@ -317,3 +345,20 @@ concept IdleTrait = requires() {
         T::idle()
     } -> std::same_as<void>;
 };
+
+// 多核启动与核间中断 Trait
+template <typename T>
+concept HartTrait = requires(size_t hart, void *stack_top) {
+    {
+        T::start(hart, stack_top)
+    } -> std::same_as<Result<void>>;
+    {
+        T::send_ipi(hart)
+    } -> std::same_as<void>;
+    {
+        T::clear_ipi()
+    } -> std::same_as<void>;
+    {
+        T::enable_ipi()
+    } -> std::same_as<void>;
+};
@@ -52,6 +52,7 @@ namespace blk {
                 return;
             _initialized = true;
             new (&_INSTANCE) BlkManager();
+            BufferCache::register_shrinker();
         }
         static bool initialized() {
             return _initialized;
@@ -13,10 +13,70 @@
 #include <env.h>
 #include <bio/request.h>
 #include <logger.h>
+#include <mem/reclaim.h>
 
 #include <cstring>
+#include <utility>
 
 namespace blk {
+    namespace {
+        /**
+         * @brief 全部块缓存的登记表, 回收时据此遍历.
+         */
+        struct CacheRegistry {
+            std::vector<BufferCache *> caches;
+            /// 下一次回收从该下标开始, 使各设备轮流被收缩
+            size_t cursor = 0;
+            SpinLocker lock;
+        };
+
+        CacheRegistry cache_registry;
+
+        void register_cache(BufferCache *cache) {
+            GuardedLock guard(cache_registry.lock);
+            cache_registry.caches.push_back(cache);
+        }
+
+        void unregister_cache(BufferCache *cache) {
+            GuardedLock guard(cache_registry.lock);
+            std::erase(cache_registry.caches, cache);
+        }
+
+        /**
+         * @brief 块缓存: 丢弃干净且无人引用的块.
+         */
+        class BufferShrinker final : public IShrinker {
+        public:
+            [[nodiscard]]
+            const char *name() const noexcept override {
+                return "buffer_cache";
+            }
+
+            [[nodiscard]]
+            size_t count() noexcept override {
+                GuardedLock guard(cache_registry.lock);
+                size_t count = 0;
+                for (auto *cache : cache_registry.caches) {
+                    count += cache->reclaimable();
+                }
+                return count;
+            }
+
+            size_t scan(size_t nr) noexcept override {
+                GuardedLock guard(cache_registry.lock);
+                size_t freed = 0;
+                size_t count = cache_registry.caches.size();
+                for (size_t i = 0; i < count && freed < nr; ++i) {
+                    size_t idx  = cache_registry.cursor++ % count;
+                    freed      += cache_registry.caches[idx]->shrink(nr - freed);
+                }
+                return freed;
+            }
+        };
+
+        BufferShrinker buffer_shrinker;
+    }  // namespace
+
     size_t BufferHandler::write(size_t offset, const void *data, size_t len) {
         if (_buf == nullptr || _buf->data == nullptr) {
             return 0;
@@ -53,19 +113,22 @@ namespace blk {
         : _devno(devno), _blksz(blksz), _request_layer(request_layer) {
         assert(_blksz != 0);
         assert(_request_layer.get() != nullptr);
+        register_cache(this);
     }
 
     BufferCache::~BufferCache() {
+        unregister_cache(this);
         delete _request_layer.get();
         _request_layer = util::owner<BlockRequestLayer *>(nullptr);
-        for (size_t i = 0; i < MAX_CACHE_SIZE; ++i) {
-            if (_buffers[i].get() == nullptr) {
+        for (auto &slot : _buffers) {
+            if (slot.get() == nullptr) {
                 continue;
             }
-            delete[] _buffers[i]->data;
-            delete _buffers[i].get();
-            _buffers[i] = util::owner<Buffer *>(nullptr);
+            delete[] slot->data;
+            delete slot.get();
+            slot = util::owner<Buffer *>(nullptr);
         }
+        _buffers.clear();
         _mapping.clear();
     }
 
@@ -87,7 +150,7 @@ namespace blk {
     }
 
     Result<void> BufferCache::clear_slot(size_t idx) {
-        if (idx >= MAX_CACHE_SIZE) {
+        if (idx >= _buffers.size()) {
             unexpect_return(ErrCode::OUT_OF_BOUNDARY);
         }
         Buffer *buffer = _buffers[idx].get();
@@ -116,46 +179,21 @@ namespace blk {
         delete[] buffer->data;
         delete buffer;
         _buffers[idx] = util::owner<Buffer *>(nullptr);
+        // 收回末尾的空槽, 使缓存收缩后向量也随之变短
+        while (!_buffers.empty() && _buffers.back().get() == nullptr) {
+            _buffers.pop_back();
+        }
         void_return();
     }
 
-    Result<size_t> BufferCache::find_free() {
-        for (size_t i = 0; i < MAX_CACHE_SIZE; ++i) {
+    size_t BufferCache::find_free() {
+        for (size_t i = 0; i < _buffers.size(); ++i) {
             if (_buffers[i].get() == nullptr) {
                 return i;
             }
         }
-
-        // prefer clean buffers for eviction
-        for (size_t i = 0; i < MAX_CACHE_SIZE; ++i) {
-            Buffer *buffer = _buffers[i].get();
-            if (buffer == nullptr || buffer->refcnt != 0 || buffer->inflight ||
-                buffer->dirty) {
-                continue;
-            }
-            auto clear_res = clear_slot(i);
-            propagate(clear_res);
-            return i;
-        }
-        // fallback: evict any buffer (including dirty)
-        for (size_t i = 0; i < MAX_CACHE_SIZE; ++i) {
-            Buffer *buffer = _buffers[i].get();
-            if (buffer == nullptr || buffer->refcnt != 0 || buffer->inflight) {
-                continue;
-            }
-            if (buffer->dirty) {
-                loggers::SUSTCORE::WARN(
-                    "BufferCache: evicting DIRTY buffer devno=%u blkno=%u idx=%u",
-                    static_cast<unsigned>(_devno),
-                    static_cast<unsigned>(buffer->blkno),
-                    static_cast<unsigned>(i));
-            }
-            auto clear_res = clear_slot(i);
-            propagate(clear_res);
-            return i;
-        }
-
-        unexpect_return(ErrCode::BUSY);
+        _buffers.emplace_back(nullptr);
+        return _buffers.size() - 1;
     }
 
     Result<size_t> BufferCache::find_buffer(lba_t blkno) {
@@ -166,39 +204,66 @@ namespace blk {
         return *map_res.value();
     }
 
-    Result<size_t> BufferCache::ensure_buffer(lba_t blkno) {
-        auto found_res = find_buffer(blkno);
-        if (found_res.has_value()) {
-            return found_res.value();
-        }
-        if (found_res.error() != ErrCode::ENTRY_NOT_FOUND) {
-            propagate_return(found_res);
+    Result<BufferHandler> BufferCache::handler_at(size_t idx) {
+        GuardedLock guard(_lock);
+        if (idx >= _buffers.size() || _buffers[idx].get() == nullptr) {
+            unexpect_return(ErrCode::ENTRY_NOT_FOUND);
         }
+        return BufferHandler(util::nnullforce(_buffers[idx].get()), *this);
+    }
 
-        auto free_res = find_free();
-        propagate(free_res);
+    Result<BufferHandler> BufferCache::ensure_buffer(lba_t blkno) {
+        {
+            GuardedLock guard(_lock);
+            auto found_res = find_buffer(blkno);
+            if (found_res.has_value()) {
+                return BufferHandler(
+                    util::nnullforce(_buffers[found_res.value()].get()),
+                    *this);
+            }
+        }
 
-        auto *buffer = new Buffer{
-            .blkno    = blkno,
-            .data     = new char[_blksz],
-            .dirty    = false,
-            .valid    = false,
-            .inflight = false,
-            .refcnt   = 0,
-            .wait_wd  = wait::alloc_reason(),
+        auto make_buffer = [&]() -> Buffer * {
+            auto *buffer = new Buffer{
+                .blkno    = blkno,
+                .data     = new char[_blksz],
+                .dirty    = false,
+                .valid    = false,
+                .inflight = false,
+                .refcnt   = 0,
+                .wait_wd  = wait::alloc_reason(),
+            };
+            if (buffer == nullptr || buffer->data == nullptr) {
+                delete[] (buffer == nullptr ? nullptr : buffer->data);
+                delete buffer;
+                return nullptr;
+            }
+            return buffer;
         };
-        if (buffer == nullptr || buffer->data == nullptr) {
-            delete[] (buffer == nullptr ? nullptr : buffer->data);
-            delete buffer;
+        Buffer *buffer = make_buffer();
+        if (buffer == nullptr && Reclaim::direct_reclaim()) {
+            buffer = make_buffer();
+        }
+        if (buffer == nullptr) {
             unexpect_return(ErrCode::OUT_OF_MEMORY);
         }
 
-        size_t idx    = free_res.value();
+        GuardedLock guard(_lock);
+        // 分配期间其他线程可能已装入同一块
+        auto found_res = find_buffer(blkno);
+        if (found_res.has_value()) {
+            delete[] buffer->data;
+            delete buffer;
+            return BufferHandler(
+                util::nnullforce(_buffers[found_res.value()].get()), *this);
+        }
+
+        size_t idx    = find_free();
         _buffers[idx] = util::owner<Buffer *>(buffer);
         _mapping.insert_or_assign(blkno, idx);
         env::inst().system_memory_info(env::key::set()).buffer_pages +=
             page_align_up(_blksz) / PAGESIZE;
-        return idx;
+        return BufferHandler(util::nnullforce(buffer), *this);
     }
 
     FutureResult<void> BufferCache::sync(BufferHandler &handler) {
@@ -256,13 +321,19 @@ namespace blk {
     }
 
     FutureResult<void> BufferCache::sync_all() {
-        for (size_t i = 0; i < MAX_CACHE_SIZE; ++i) {
-            Buffer *buffer = _buffers[i].get();
-            if (buffer == nullptr) {
+        // 写回会阻塞, 每次只在锁内取得一个块的句柄
+        for (size_t i = 0;; ++i) {
+            {
+                GuardedLock guard(_lock);
+                if (i >= _buffers.size()) {
+                    break;
+                }
+            }
+            auto handler_res = handler_at(i);
+            if (!handler_res.has_value()) {
                 continue;
             }
-            BufferHandler handler(util::nnullforce(buffer), *this);
-            auto sync_future = sync(handler);
+            auto sync_future = sync(handler_res.value());
             auto sync_res    = wait::blocking_wait_for(sync_future);
             if (!sync_res.has_value()) {
                 return make_void_future(std::unexpected(sync_res.error()));
@@ -278,7 +349,12 @@ namespace blk {
             return make_void_future(std::unexpected(sync_res.error()));
         }
 
-        for (size_t i = 0; i < MAX_CACHE_SIZE; ++i) {
+        GuardedLock guard(_lock);
+        // clear_slot 会收回末尾空槽, 因此倒序遍历
+        for (size_t i = _buffers.size(); i-- > 0;) {
+            if (i >= _buffers.size()) {
+                continue;
+            }
             Buffer *buffer = _buffers[i].get();
             if (buffer == nullptr || buffer->refcnt != 0 || buffer->inflight) {
                 continue;
@@ -291,16 +367,59 @@ namespace blk {
         return make_void_future({});
     }
 
-    FutureResult<BufferHandler> BufferCache::get_buffer_async(lba_t blkno) {
-        auto idx_res = ensure_buffer(blkno);
-        if (!idx_res.has_value()) {
-            return make_handler_future(std::unexpected(idx_res.error()));
+    size_t BufferCache::reclaimable() {
+        GuardedLock guard(_lock);
+        size_t count = 0;
+        for (auto &slot : _buffers) {
+            Buffer *buffer = slot.get();
+            if (buffer != nullptr && buffer->refcnt == 0 &&
+                !buffer->inflight && !buffer->dirty)
+            {
+                count++;
+            }
         }
+        return count;
+    }
 
-        Buffer *buffer = _buffers[idx_res.value()].get();
-        if (buffer == nullptr) {
-            return make_handler_future(std::unexpected(ErrCode::UNKNOWN_ERROR));
+    size_t BufferCache::shrink(size_t nr) {
+        GuardedLock guard(_lock);
+        size_t freed = 0;
+        // 脏块留给回写, 只丢弃干净块
+        for (size_t i = _buffers.size(); i-- > 0 && freed < nr;) {
+            if (i >= _buffers.size()) {
+                continue;
+            }
+            Buffer *buffer = _buffers[i].get();
+            if (buffer == nullptr || buffer->refcnt != 0 || buffer->inflight ||
+                buffer->dirty)
+            {
+                continue;
+            }
+            if (clear_slot(i).has_value()) {
+                freed++;
+            }
         }
+        return freed;
+    }
+
+    void BufferCache::register_shrinker() noexcept {
+        auto register_res = Reclaim::register_shrinker(buffer_shrinker);
+        if (!register_res.has_value()) {
+            loggers::DEVICE::ERROR("登记 %s shrinker 失败: err=%s",
+                                   buffer_shrinker.name(),
+                                   to_cstring(register_res.error()));
+        }
+    }
+
+    FutureResult<BufferHandler> BufferCache::get_buffer_async(lba_t blkno) {
+        auto handler_res = ensure_buffer(blkno);
+        if (!handler_res.has_value()) {
+            return make_handler_future(std::unexpected(handler_res.error()));
+        }
+
+        // 持有句柄期间该块不会被回收
+        BufferHandler handler = std::move(handler_res.value());
+        Buffer *buffer        = handler.get();
 
         if (buffer->inflight) {
             loggers::DEVICE::DEBUG("buffer wait inflight: dev=%lu blk=%lu",
@@ -312,8 +431,7 @@ namespace blk {
             }
         }
         if (buffer->valid) {
-            return make_handler_future(
-                BufferHandler(util::nnullforce(buffer), *this));
+            return make_handler_future(std::move(handler));
         }
 
         buffer->inflight = true;
@@ -348,7 +466,6 @@ namespace blk {
         }
 
         buffer->valid = true;
-        return make_handler_future(
-            BufferHandler(util::nnullforce(buffer), *this));
+        return make_handler_future(std::move(handler));
     }
 }  // namespace blk
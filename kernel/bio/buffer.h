@@ -12,6 +12,7 @@
 #pragma once
 
 #include <bio/block.h>
+#include <spinlock.h>
 #include <string.h>
 #include <sus/nonnull.h>
 #include <sus/owner.h>
@@ -21,6 +22,7 @@
 
 #include <cassert>
 #include <unordered_map>
+#include <vector>
 
 namespace blk {
     class BufferCache;
@@ -267,23 +269,29 @@ namespace blk {
         size_t _devno;
         size_t _blksz;
         util::owner<BlockRequestLayer *> _request_layer;
-        static constexpr size_t MAX_CACHE_SIZE = 8192;
-        util::owner<Buffer *> _buffers[MAX_CACHE_SIZE];
+        // 缓存不设上限, 按需增长, 在内存压力下由 shrink 收缩
+        std::vector<util::owner<Buffer *>> _buffers;
         std::unordered_map<lba_t, size_t> _mapping;  // 块位置到缓存索引的映射
+        // 保护 _buffers 与 _mapping, 回收线程可能与文件系统并发访问
+        SpinLocker _lock;
         [[nodiscard]]
         FutureResult<void> make_void_future(Result<void> result);
         [[nodiscard]]
         FutureResult<BufferHandler> make_handler_future(
             Result<BufferHandler> result);
+        // 以下三者须持有 _lock 调用
         [[nodiscard]]
         Result<void> clear_slot(size_t idx);
         [[nodiscard]]
-        Result<size_t> find_free();
+        size_t find_free();
         [[nodiscard]]
         Result<size_t> find_buffer(lba_t blkno);
-        // 确保指定块号的缓存存在, 不存在则创建
+        // 确保指定块号的缓存存在, 不存在则创建; 返回的句柄使其不会被回收
         [[nodiscard]]
-        Result<size_t> ensure_buffer(lba_t blkno);
+        Result<BufferHandler> ensure_buffer(lba_t blkno);
+        // 取得下标处块的句柄, 空槽返回 ENTRY_NOT_FOUND
+        [[nodiscard]]
+        Result<BufferHandler> handler_at(size_t idx);
 
     public:
         // 获取块大小
@@ -322,6 +330,24 @@ namespace blk {
         [[nodiscard]]
         FutureResult<void> tidy();
 
+        /**
+         * @brief 统计可直接丢弃的块: 干净、无引用且没有未完成请求.
+         */
+        [[nodiscard]]
+        size_t reclaimable();
+
+        /**
+         * @brief 丢弃至多 nr 个可直接丢弃的块, 供内存压力回收调用.
+         *
+         * @return 实际丢弃的块数
+         */
+        size_t shrink(size_t nr);
+
+        /**
+         * @brief 向 Reclaim 登记全部块缓存共用的 shrinker.
+         */
+        static void register_shrinker() noexcept;
+
         /**
          * @brief 异步获取指定逻辑块的缓存句柄.
          *
@@ -19,45 +19,40 @@
 
 namespace cap {
     namespace kop {
-        Storage<KOP<Capability>> capability_raw;
-        Storage<KOP<CGroup>> cgroup_raw;
-        Storage<LockedObject<IrqSaveGuardedLock, KOP<Capability>>>
-            capability_storage;
-        Storage<LockedObject<IrqSaveGuardedLock, KOP<CGroup>>> cgroup_storage;
+        Storage<KOP<Capability>> capability_storage;
+        Storage<KOP<CGroup>> cgroup_storage;
 
         [[nodiscard]]
-        LockedObject<IrqSaveGuardedLock, KOP<Capability>> &capability() {
+        KOP<Capability> &capability() {
             return capability_storage.ref();
         }
 
         [[nodiscard]]
-        LockedObject<IrqSaveGuardedLock, KOP<CGroup>> &cgroup() {
+        KOP<CGroup> &cgroup() {
             return cgroup_storage.ref();
         }
     }  // namespace kop
 
     void init_kop() {
-        kop::capability_raw.construct();
-        kop::cgroup_raw.construct();
-        kop::capability_storage.construct(kop::capability_raw.get());
-        kop::cgroup_storage.construct(kop::cgroup_raw.get());
+        kop::capability_storage.construct("capability");
+        kop::cgroup_storage.construct("cgroup");
     }
 
     void *Capability::operator new(size_t size) {
         assert(size == sizeof(Capability));
-        return kop::capability().get()->alloc();
+        return kop::capability().alloc();
     }
 
     void Capability::operator delete(void *ptr) {
-        kop::capability().get()->free(static_cast<Capability *>(ptr));
+        kop::capability().free(static_cast<Capability *>(ptr));
     }
 
     void *CGroup::operator new(size_t size) {
         assert(size == sizeof(CGroup));
-        return kop::cgroup().get()->alloc();
+        return kop::cgroup().alloc();
     }
 
     void CGroup::operator delete(void *ptr) {
-        kop::cgroup().get()->free(static_cast<CGroup *>(ptr));
+        kop::cgroup().free(static_cast<CGroup *>(ptr));
     }
 }  // namespace cap
@@ -26,7 +26,7 @@ namespace device {
     using driver::ClockEventInfo;
     using driver::ExpireAction;
     using driver::ExpireHandle;
-    using driver::ExpireActionQueue;
+    using driver::TimerWheel;
     using driver::TimeKeeper;
     using driver::IrqTrigger;
     using driver::IrqResolveResult;
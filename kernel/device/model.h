@@ -132,6 +132,22 @@ namespace device {
             _clock_virq = virq;
         }
 
+        /**
+         * @brief 回写指定 hart 的 clock virq.
+         *
+         * 每个 hart 的本地定时器中断位于各自的本地中断域中,
+         * 未单独登记的 hart 回落到全局 clock virq.
+         *
+         * @param hart hart ID
+         * @param virq 该 hart 时钟中断对应的全局 virq.
+         */
+        void set_clock_virq(cpuid_t hart, driver::virq_t virq) {
+            if (_hart_clock_virqs.size() <= hart) {
+                _hart_clock_virqs.resize(hart + 1, 0);
+            }
+            _hart_clock_virqs[hart] = virq;
+        }
+
         void set_platform(util::owner<Platform *> platform) noexcept {
             if (_platform.get() != nullptr) {
                 delete _platform.get();
@@ -149,6 +165,20 @@ namespace device {
             return _clock_virq;
         }
 
+        /**
+         * @brief 获取指定 hart 的 clock virq.
+         *
+         * @param hart hart ID
+         * @return virq_t clock virq.
+         */
+        [[nodiscard]]
+        driver::virq_t clock_virq(cpuid_t hart) const {
+            if (hart < _hart_clock_virqs.size() && _hart_clock_virqs[hart] != 0) {
+                return _hart_clock_virqs[hart];
+            }
+            return _clock_virq;
+        }
+
         [[nodiscard]]
         Result<void> register_provider(
             util::owner<DeviceProvider *> provider) noexcept {
@@ -236,6 +266,7 @@ namespace device {
             util::owner<Platform *>(nullptr);
         driver::IrqManager _interrupt;
         driver::virq_t _clock_virq = 0;
+        std::vector<driver::virq_t> _hart_clock_virqs;
     };
 
     class KernelProvider : public DeviceProvider {
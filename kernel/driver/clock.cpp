@@ -17,6 +17,8 @@
 #include <task/task.h>
 #include <task/wait.h>
 
+#include <algorithm>
+
 namespace driver {
     namespace {
         [[nodiscard]]
@@ -25,157 +27,285 @@ namespace driver {
         }
     }  // namespace
 
-    ExpireActionQueue::ExpireActionQueue() noexcept {
-        for (uint16_t index = 0; index < MAX_HEAP_ACTIONS; index++) {
-            _slots[index].next_free = index + 1 < MAX_HEAP_ACTIONS
-                                          ? index + 1
-                                          : ExpireHandle::INVALID_SLOT;
+    TimerWheel::TimerWheel(size_t slack_ns) noexcept
+        : _slack_ns(slack_ns == 0 ? 1 : slack_ns) {
+        for (auto &head : _heads) {
+            head = NIL;
         }
-        _free_head = 0;
     }
 
-    bool ExpireActionQueue::empty() const noexcept {
-        return _heap_size == 0;
+    TimerWheel::~TimerWheel() noexcept {
+        for (size_t index = 0; index < _chunk_count; index++) {
+            delete _chunks[index];
+        }
     }
 
-    size_t ExpireActionQueue::size() const noexcept {
-        return _heap_size;
+    Result<void> TimerWheel::reserve(size_t nodes) noexcept {
+        while (_free_count < nodes) {
+            auto *chunk = new_chunk();
+            if (chunk == nullptr) {
+                unexpect_return(ErrCode::OUT_OF_MEMORY);
+            }
+            if (!add_chunk(chunk)) {
+                delete chunk;
+                unexpect_return(ErrCode::OUT_OF_MEMORY);
+            }
+        }
+        void_return();
     }
 
-    Result<ExpireHandle> ExpireActionQueue::push(
-        const ExpireAction &action) noexcept {
-        if (_free_head == ExpireHandle::INVALID_SLOT ||
-            _heap_size >= MAX_HEAP_ACTIONS)
-        {
-            unexpect_return(ErrCode::OUT_OF_MEMORY);
+    bool TimerWheel::low_on_nodes() const noexcept {
+        return _free_count < LOW_FREE_NODES && _chunk_count < MAX_CHUNKS;
+    }
+
+    TimerWheel::NodeChunk *TimerWheel::new_chunk() noexcept {
+        return new NodeChunk();
+    }
+
+    bool TimerWheel::add_chunk(NodeChunk *chunk) noexcept {
+        if (_chunk_count == MAX_CHUNKS) {
+            return false;
+        }
+        size_t first            = _chunk_count * CHUNK_NODES;
+        _chunks[_chunk_count++] = chunk;
+        for (size_t index = CHUNK_NODES; index-- > 0;) {
+            chunk->nodes[index].next = _free_head;
+            _free_head = static_cast<uint16_t>(first + index);
         }
+        _free_count += CHUNK_NODES;
+        return true;
+    }
 
-        uint16_t slot_id = _free_head;
-        auto &slot       = _slots[slot_id];
-        _free_head       = slot.next_free;
+    bool TimerWheel::empty() const noexcept {
+        return _size == 0;
+    }
+
+    size_t TimerWheel::size() const noexcept {
+        return _size;
+    }
 
-        slot.action     = action;
-        slot.heap_index = static_cast<uint16_t>(_heap_size);
-        slot.active     = true;
+    size_t TimerWheel::slack_ns() const noexcept {
+        return _slack_ns;
+    }
 
-        _heap[_heap_size++] = slot_id;
-        shift_up(slot.heap_index);
+    void TimerWheel::set_slack(size_t slack_ns) noexcept {
+        slack_ns = slack_ns == 0 ? 1 : slack_ns;
+        if (slack_ns == _slack_ns) {
+            return;
+        }
+
+        // 先全部摘下, 换算当前单位后再按新粒度放回
+        size_t total = _chunk_count * CHUNK_NODES;
+        for (size_t id = 0; id < total; id++) {
+            if (node(static_cast<uint16_t>(id)).active) {
+                unlink(static_cast<uint16_t>(id));
+            }
+        }
+        _base     = _base * _slack_ns / slack_ns;
+        _slack_ns = slack_ns;
+        for (size_t id = 0; id < total; id++) {
+            auto &entry = node(static_cast<uint16_t>(id));
+            if (!entry.active) {
+                continue;
+            }
+            entry.unit = std::max(unit_of(entry.action.expireTime), _base);
+            link(static_cast<uint16_t>(id));
+        }
+    }
+
+    Result<ExpireHandle> TimerWheel::push(const ExpireAction &action) noexcept {
+        auto id_res = alloc_node();
+        propagate(id_res);
+
+        uint16_t id  = id_res.value();
+        auto &entry  = node(id);
+        entry.action = action;
+        // 已经到期的动作放在当前单位, 下一次 pop_due 即弹出
+        entry.unit   = std::max(unit_of(action.expireTime), _base);
+        entry.active = true;
+        link(id);
+        _size++;
 
         return ExpireHandle{
-            .slot       = slot_id,
-            .generation = slot.generation,
+            .slot       = id,
+            .generation = entry.generation,
         };
     }
 
-    bool ExpireActionQueue::cancel(ExpireHandle handle) noexcept {
-        if (!handle.valid() || handle.slot >= MAX_HEAP_ACTIONS) {
+    bool TimerWheel::cancel(ExpireHandle handle) noexcept {
+        if (!handle.valid() || handle.slot >= _chunk_count * CHUNK_NODES) {
             return false;
         }
 
-        auto &slot = _slots[handle.slot];
-        if (!slot.active || slot.generation != handle.generation) {
+        auto &entry = node(handle.slot);
+        if (!entry.active || entry.generation != handle.generation) {
             return false;
         }
 
-        (void)remove_at(slot.heap_index);
+        unlink(handle.slot);
+        free_node(handle.slot);
+        _size--;
         return true;
     }
 
-    std::optional<ExpireAction> ExpireActionQueue::peek() const noexcept {
-        if (_heap_size == 0) {
+    std::optional<size_t> TimerWheel::next_expiry() const noexcept {
+        auto unit = next_unit();
+        if (!unit.has_value()) {
             return std::nullopt;
         }
-        return _slots[_heap[0]].action;
+        return *unit * _slack_ns;
     }
 
-    PopDueResult ExpireActionQueue::pop_due(size_t now_ns) noexcept {
+    PopDueResult TimerWheel::pop_due(size_t now_ns) noexcept {
         PopDueResult result{};
-        while (_heap_size > 0 && result.count < MAX_DUE_ACTIONS) {
-            uint16_t slot_id = _heap[0];
-            if (_slots[slot_id].action.expireTime > now_ns) {
+        size_t target = now_ns / _slack_ns;
+        while (_base <= target) {
+            // 第 0 层当前槽中的动作恰好在 _base 到期
+            uint16_t &head = _heads[_base & (LEVEL_SLOTS - 1)];
+            while (head != NIL && result.count < MAX_DUE_ACTIONS) {
+                uint16_t id                    = head;
+                result.entries[result.count++] = node(id).action;
+                unlink(id);
+                free_node(id);
+                _size--;
+            }
+            if (head != NIL || _base == target) {
                 break;
             }
-            result.entries[result.count++] = remove_at(0);
+
+            // 中间没有需要处理的槽时直接跳到 target, 空转不随时间长度增长
+            auto next = next_unit();
+            if (!next.has_value() || *next > target) {
+                _base = target;
+                break;
+            }
+            _base = *next;
+            for (size_t level = LEVELS - 1; level > 0; level--) {
+                size_t mask = (1ul << (level * LEVEL_BITS)) - 1;
+                if ((_base & mask) == 0) {
+                    cascade(level);
+                }
+            }
         }
         return result;
     }
 
-    ExpireAction ExpireActionQueue::remove_at(size_t heap_index) noexcept {
-        uint16_t slot_id = _heap[heap_index];
-        auto removed     = _slots[slot_id].action;
+    TimerWheel::Node &TimerWheel::node(uint16_t id) noexcept {
+        return _chunks[id / CHUNK_NODES]->nodes[id % CHUNK_NODES];
+    }
 
-        _heap_size--;
-        if (heap_index != _heap_size) {
-            _heap[heap_index] = _heap[_heap_size];
-            _slots[_heap[heap_index]].heap_index =
-                static_cast<uint16_t>(heap_index);
+    const TimerWheel::Node &TimerWheel::node(uint16_t id) const noexcept {
+        return _chunks[id / CHUNK_NODES]->nodes[id % CHUNK_NODES];
+    }
 
-            if (heap_index > 0 &&
-                later(_heap[(heap_index - 1) / 2], _heap[heap_index]))
-            {
-                shift_up(heap_index);
-            } else {
-                shift_down(heap_index);
-            }
+    Result<uint16_t> TimerWheel::alloc_node() noexcept {
+        // 可能位于 ISR 中, 不在这里扩容
+        if (_free_head == NIL) {
+            unexpect_return(ErrCode::OUT_OF_MEMORY);
         }
 
-        auto &slot       = _slots[slot_id];
-        slot.active      = false;
-        slot.next_free   = _free_head;
-        slot.heap_index  = 0;
-        slot.generation += 1;
-        _free_head       = slot_id;
+        uint16_t id = _free_head;
+        _free_head  = node(id).next;
+        _free_count--;
+        return id;
+    }
 
-        return removed;
+    void TimerWheel::free_node(uint16_t id) noexcept {
+        auto &entry       = node(id);
+        entry.active      = false;
+        entry.generation += 1;
+        entry.prev        = NIL;
+        entry.next        = _free_head;
+        _free_head        = id;
+        _free_count++;
     }
 
-    void ExpireActionQueue::shift_up(size_t index) noexcept {
-        while (index > 0) {
-            size_t parent = (index - 1) / 2;
-            if (!later(_heap[parent], _heap[index])) {
-                break;
-            }
-            swap_heap_nodes(parent, index);
-            index = parent;
+    void TimerWheel::link(uint16_t id) noexcept {
+        auto &entry = node(id);
+        // 最高的不同位决定层: 之上的位与当前单位相同, 槽号取该层的 6 位
+        size_t diff  = entry.unit ^ _base;
+        size_t level = diff == 0 ? 0
+                                 : static_cast<size_t>(63 - __builtin_clzll(diff)) /
+                                       LEVEL_BITS;
+        size_t slot   = (entry.unit >> (level * LEVEL_BITS)) & (LEVEL_SLOTS - 1);
+        size_t bucket = level * LEVEL_SLOTS + slot;
+
+        entry.bucket = static_cast<uint16_t>(bucket);
+        entry.prev   = NIL;
+        entry.next   = _heads[bucket];
+        if (entry.next != NIL) {
+            node(entry.next).prev = id;
         }
+        _heads[bucket]     = id;
+        _occupied[level] |= 1ul << slot;
     }
 
-    void ExpireActionQueue::shift_down(size_t index) noexcept {
-        while (true) {
-            size_t left     = index * 2 + 1;
-            size_t right    = left + 1;
-            size_t smallest = index;
-
-            if (left < _heap_size && later(_heap[smallest], _heap[left])) {
-                smallest = left;
-            }
-            if (right < _heap_size && later(_heap[smallest], _heap[right])) {
-                smallest = right;
-            }
-            if (smallest == index) {
-                break;
-            }
+    void TimerWheel::unlink(uint16_t id) noexcept {
+        auto &entry = node(id);
+        if (entry.prev != NIL) {
+            node(entry.prev).next = entry.next;
+        } else {
+            _heads[entry.bucket] = entry.next;
+        }
+        if (entry.next != NIL) {
+            node(entry.next).prev = entry.prev;
+        }
+        if (_heads[entry.bucket] == NIL) {
+            _occupied[entry.bucket / LEVEL_SLOTS] &=
+                ~(1ul << (entry.bucket % LEVEL_SLOTS));
+        }
+        entry.prev = NIL;
+        entry.next = NIL;
+    }
 
-            swap_heap_nodes(index, smallest);
-            index = smallest;
+    void TimerWheel::cascade(size_t level) noexcept {
+        size_t slot   = (_base >> (level * LEVEL_BITS)) & (LEVEL_SLOTS - 1);
+        size_t bucket = level * LEVEL_SLOTS + slot;
+        uint16_t id   = _heads[bucket];
+
+        _heads[bucket]     = NIL;
+        _occupied[level] &= ~(1ul << slot);
+        // 槽中动作与 _base 的高位已相同, 重新放置必然落到更低的层
+        while (id != NIL) {
+            uint16_t next = node(id).next;
+            link(id);
+            id = next;
         }
     }
 
-    void ExpireActionQueue::swap_heap_nodes(size_t lhs, size_t rhs) noexcept {
-        uint16_t lhs_slot           = _heap[lhs];
-        uint16_t rhs_slot           = _heap[rhs];
-        _heap[lhs]                  = rhs_slot;
-        _heap[rhs]                  = lhs_slot;
-        _slots[rhs_slot].heap_index = static_cast<uint16_t>(lhs);
-        _slots[lhs_slot].heap_index = static_cast<uint16_t>(rhs);
+    std::optional<size_t> TimerWheel::next_unit() const noexcept {
+        // 低层的动作总是早于高层, 找到第一个非空层即可
+        for (size_t level = 0; level < LEVELS; level++) {
+            size_t shift = level * LEVEL_BITS;
+            size_t index = (_base >> shift) & (LEVEL_SLOTS - 1);
+            // 第 0 层含当前槽 (可能留有未弹完的动作), 高层的动作只在之后的槽
+            size_t first = level == 0 ? index : index + 1;
+            if (first >= LEVEL_SLOTS) {
+                continue;
+            }
+            uint64_t pending = _occupied[level] & (~0ul << first);
+            if (pending == 0) {
+                continue;
+            }
+            size_t slot        = static_cast<size_t>(__builtin_ctzll(pending));
+            size_t upper_shift = shift + LEVEL_BITS;
+            size_t upper =
+                upper_shift >= 64 ? 0 : (_base >> upper_shift) << upper_shift;
+            return upper | (slot << shift);
+        }
+        return std::nullopt;
     }
 
-    bool ExpireActionQueue::later(uint16_t lhs, uint16_t rhs) const noexcept {
-        return _slots[lhs].action.expireTime > _slots[rhs].action.expireTime;
+    size_t TimerWheel::unit_of(size_t ns) const noexcept {
+        return ns / _slack_ns + (ns % _slack_ns != 0 ? 1 : 0);
     }
 
     TimeKeeper::TimeKeeper(ClockSource *source, Alarm *alarm) noexcept
         : _source(source), _alarm(alarm), _queue() {
+        if (!_queue.reserve(INITIAL_NODES).has_value()) {
+            loggers::TIMER::ERROR("TimeKeeper 预分配 %lu 个定时器节点失败",
+                                  static_cast<unsigned long>(INITIAL_NODES));
+        }
         if (alarm != nullptr) {
             alarm->set_handler(this_call(this, &TimeKeeper::on_timer_irq));
         }
@@ -186,7 +316,39 @@ namespace driver {
         if (_source == nullptr || _alarm == nullptr) {
             unexpect_return(ErrCode::INVALID_PARAM);
         }
+        grow_queue();
+        return insert(action);
+    }
 
+    void TimeKeeper::grow_queue() noexcept {
+        {
+            InterruptGuard guard;
+            guard.enter();
+            if (!_queue.low_on_nodes()) {
+                return;
+            }
+        }
+
+        auto *chunk = TimerWheel::new_chunk();
+        if (chunk == nullptr) {
+            // 仍可使用剩余的空闲节点, 真正耗尽时由 insert 报错
+            loggers::TIMER::WARN("TimeKeeper 扩充定时器节点池失败");
+            return;
+        }
+        bool added = false;
+        {
+            InterruptGuard guard;
+            guard.enter();
+            // 期间其他路径可能已经扩容, 多出的一块留作余量
+            added = _queue.add_chunk(chunk);
+        }
+        if (!added) {
+            delete chunk;
+        }
+    }
+
+    Result<ExpireHandle> TimeKeeper::insert(
+        const ExpireAction &action) noexcept {
         InterruptGuard guard;
         guard.enter();
 
@@ -202,16 +364,15 @@ namespace driver {
             return ExpireHandle{};
         }
 
-        auto old_root   = _queue.peek();
+        auto old_next   = _queue.next_expiry();
         auto handle_res = _queue.push(action);
         if (!handle_res.has_value()) {
             propagate_return(handle_res);
         }
 
-        auto new_root = _queue.peek();
-        if (!old_root.has_value() ||
-            (new_root.has_value() &&
-             new_root->expireTime != old_root->expireTime))
+        auto new_next = _queue.next_expiry();
+        if (!old_next.has_value() ||
+            (new_next.has_value() && *new_next != *old_next))
         {
             rearm_timer_locked();
         }
@@ -243,6 +404,124 @@ namespace driver {
         return removed;
     }
 
+    void TimeKeeper::set_slack(units::time slack) noexcept {
+        InterruptGuard guard;
+        guard.enter();
+        _queue.set_slack(to_ns_size(slack));
+        if (_source != nullptr && _alarm != nullptr) {
+            rearm_timer_locked();
+        }
+        loggers::TIMER::INFO("TimeKeeper slack 设为 %lu ns",
+                             static_cast<unsigned long>(_queue.slack_ns()));
+    }
+
+    Result<void> TimeKeeper::start_tick(units::time period) noexcept {
+        if (_source == nullptr || _alarm == nullptr ||
+            period.to_nanoseconds() <= 0)
+        {
+            unexpect_return(ErrCode::INVALID_PARAM);
+        }
+
+        InterruptGuard guard;
+        guard.enter();
+        if (_tick_handle.valid()) {
+            (void)_queue.cancel(_tick_handle);
+            _tick_handle.reset();
+        }
+        _tick_period_ns = to_ns_size(period);
+        _last_tick_ns   = to_ns_size(_source->to_ns(_source->now()));
+        _tick_stopped   = false;
+
+        auto handle_res = _queue.push(ExpireAction{
+            .expireTime   = _last_tick_ns + _tick_period_ns,
+            .expireAction = expact::SCHD,
+            .expireArg0   = _tick_period_ns,
+            .expireArg1   = expact::schd::TICK,
+        });
+        propagate(handle_res);
+        _tick_handle = handle_res.value();
+        rearm_timer_locked();
+        void_return();
+    }
+
+    void TimeKeeper::stop_tick() noexcept {
+        if (_tick_stopped || _tick_period_ns == 0) {
+            return;
+        }
+
+        InterruptGuard guard;
+        guard.enter();
+        _tick_stopped = true;
+        if (_tick_handle.valid()) {
+            (void)_queue.cancel(_tick_handle);
+            _tick_handle.reset();
+        }
+        rearm_timer_locked();
+        loggers::TIMER::DEBUG("TimeKeeper 停止 tick: last=%lu",
+                              static_cast<unsigned long>(_last_tick_ns));
+    }
+
+    void TimeKeeper::restart_tick() noexcept {
+        if (!_tick_stopped) {
+            return;
+        }
+
+        InterruptGuard guard;
+        guard.enter();
+        _tick_stopped = false;
+        // 跳过停止期间的节拍, 错过的周期数留给下一次 tick 补记
+        size_t now_ns  = to_ns_size(_source->to_ns(_source->now()));
+        size_t periods = (now_ns - _last_tick_ns) / _tick_period_ns + 1;
+        size_t next    = _last_tick_ns + periods * _tick_period_ns;
+        arm_tick_locked(next);
+        rearm_timer_locked();
+        loggers::TIMER::DEBUG("TimeKeeper 恢复 tick: now=%lu next=%lu",
+                              static_cast<unsigned long>(now_ns),
+                              static_cast<unsigned long>(next));
+    }
+
+    void TimeKeeper::arm_tick_locked(size_t expire_ns) noexcept {
+        auto handle_res = _queue.push(ExpireAction{
+            .expireTime   = expire_ns,
+            .expireAction = expact::SCHD,
+            .expireArg0   = _tick_period_ns,
+            .expireArg1   = expact::schd::TICK,
+        });
+        if (!handle_res.has_value()) {
+            loggers::SUSTCORE::ERROR("调度 tick 入队失败: err=%s",
+                                     to_cstring(handle_res.error()));
+            _tick_handle.reset();
+            return;
+        }
+        _tick_handle = handle_res.value();
+    }
+
+    void TimeKeeper::run_tick(units::time now) noexcept {
+        size_t now_ns  = to_ns_size(now);
+        size_t elapsed = now_ns - _last_tick_ns;
+        size_t ticks   = elapsed / _tick_period_ns;
+        TimerTickEvent tick_event{
+            .last  = units::time::from_nanoseconds(
+                static_cast<int64_t>(_last_tick_ns)),
+            .now   = now,
+            .delta = units::time::from_nanoseconds(
+                static_cast<int64_t>(elapsed)),
+            .ticks = ticks == 0 ? 1 : ticks,
+        };
+        _last_tick_ns = now_ns;
+        _tick_handle.reset();
+
+        schd::Scheduler::inst().do_tick(tick_event);
+
+        // do_tick 可能经由负载均衡入队线程, 期间若已恢复 tick 则不再重复排入
+        InterruptGuard guard;
+        guard.enter();
+        if (!_tick_stopped && !_tick_handle.valid()) {
+            arm_tick_locked(now_ns + _tick_period_ns);
+            rearm_timer_locked();
+        }
+    }
+
     void TimeKeeper::on_timer_irq(const ClockEvent &event) noexcept {
         if (_source == nullptr || _alarm == nullptr) {
             loggers::TIMER::ERROR("TimeKeeper 收到 timer IRQ 时未初始化");
@@ -274,16 +553,18 @@ namespace driver {
     }
 
     void TimeKeeper::rearm_timer_locked() noexcept {
-        auto next_opt = _queue.peek();
+        auto next_opt = _queue.next_expiry();
         if (!next_opt.has_value()) {
-            loggers::TIMER::DEBUG("TimeKeeper 队列为空, 不重编程 timer");
+            // tick 停止后队列可能为空; 仍要重编程, 否则已挂起的中断会反复触发
+            loggers::TIMER::DEBUG("TimeKeeper 队列为空, timer 推迟到最远");
+            _alarm->set_next_event(MAX_IDLE_DELTA);
             return;
         }
 
         units::time now      = _source->to_ns(_source->now());
         units::time deadline = units::time::from_nanoseconds(
-            static_cast<int64_t>(next_opt->expireTime));
-        units::time delta = next_opt->expireTime <= to_ns_size(now)
+            static_cast<int64_t>(*next_opt));
+        units::time delta = *next_opt <= to_ns_size(now)
                                 ? units::time::from_nanoseconds(1)
                                 : deadline - now;
         loggers::TIMER::DEBUG(
@@ -324,7 +605,7 @@ namespace driver {
                         static_cast<int>(fractional_part));
 
                     units::time next_interval = interval * 2;
-                    auto enqueue_res          = enqueue(ExpireAction{
+                    auto enqueue_res          = insert(ExpireAction{
                                  .expireTime = static_cast<size_t>(
                             (event.now + next_interval).to_nanoseconds()),
                                  .expireAction = expact::SCHD,
@@ -340,26 +621,7 @@ namespace driver {
                     return;
                 }
 
-                TimerTickEvent tick_event{
-                    .last  = event.last,
-                    .now   = event.now,
-                    .delta = event.now - event.last,
-                };
-                schd::Scheduler::inst().do_tick(tick_event);
-
-                units::time period = units::time::from_nanoseconds(
-                    static_cast<int64_t>(action.expireArg0));
-                auto enqueue_res = enqueue(ExpireAction{
-                    .expireTime = static_cast<size_t>(
-                        (event.now + period).to_nanoseconds()),
-                    .expireAction = expact::SCHD,
-                    .expireArg0   = action.expireArg0,
-                    .expireArg1   = expact::schd::TICK,
-                });
-                if (!enqueue_res.has_value()) {
-                    loggers::SUSTCORE::ERROR("调度 tick 重新入队失败: err=%s",
-                                             to_cstring(enqueue_res.error()));
-                }
+                run_tick(event.now);
                 return;
             }
             case expact::WAKEUP: {
@@ -181,38 +181,123 @@ namespace driver {
     };
 
     /**
-     * @brief 保存到期动作的小根堆.
+     * @brief 保存到期动作的分层时间轮.
+     *
+     * 到期时间按 slack 向上取整为单位, 同一单位内的动作在同一次中断中处理,
+     * 且不会早于原定时间触发. 第 L 层的每个槽覆盖 64^L 个单位,
+     * 动作按到期单位与当前单位的最高不同位放入对应层;
+     * 时间推进到高层槽的起点时, 把该槽的动作逐级下放.
+     * 插入与取消都是 O(1), 每个动作至多被下放 LEVELS - 1 次.
+     *
+     * 节点池只在 reserve/add_chunk 中扩充, push 本身从不分配堆内存,
+     * 因此可以在关中断或 ISR 中调用; 空闲节点耗尽时 push 返回错误.
      */
-    class ExpireActionQueue {
+    class TimerWheel {
     public:
+        /// 节点按块分配, 块数受句柄 16 位槽号限制
+        static constexpr size_t CHUNK_NODES = 256;
+        /// 空闲节点少于该值时, 应在可分配内存的上下文中扩充节点池
+        static constexpr size_t LOW_FREE_NODES = CHUNK_NODES / 8;
+
+        struct NodeChunk;
+
+        static constexpr size_t LEVEL_BITS  = 6;
+        static constexpr size_t LEVEL_SLOTS = 1ul << LEVEL_BITS;
+        /// 11 层共 66 位, 覆盖任意 64 位到期单位, 无需处理溢出
+        static constexpr size_t LEVELS = 11;
+        /// 默认 slack: 50us 内的到期动作合并到同一次中断
+        static constexpr size_t DEFAULT_SLACK_NS = 50'000;
+
         /**
-         * @brief 判断队列是否为空.
+         * @brief 构造一个空时间轮.
          *
-         * @return true 队列为空.
-         * @return false 队列非空.
+         * @param slack_ns 到期时间的取整粒度（纳秒）, 为 0 时按 1 处理.
+         */
+        explicit TimerWheel(size_t slack_ns = DEFAULT_SLACK_NS) noexcept;
+        ~TimerWheel() noexcept;
+
+        TimerWheel(const TimerWheel &)            = delete;
+        TimerWheel &operator=(const TimerWheel &) = delete;
+
+        /**
+         * @brief 扩充节点池直到至少有 nodes 个空闲节点.
+         *
+         * 会分配堆内存, 调用方须独占时间轮且处于可分配内存的上下文.
+         *
+         * @param nodes 需要的空闲节点数.
+         * @return Result<void> 节点块分配失败或块数已达上限时返回错误.
+         */
+        [[nodiscard]]
+        Result<void> reserve(size_t nodes) noexcept;
+
+        /**
+         * @brief 空闲节点是否已低于 LOW_FREE_NODES 且仍可扩充.
+         */
+        [[nodiscard]]
+        bool low_on_nodes() const noexcept;
+
+        /**
+         * @brief 分配一块尚未并入任何时间轮的节点.
+         *
+         * @return NodeChunk* 新节点块, 分配失败时为 nullptr.
+         */
+        [[nodiscard]]
+        static NodeChunk *new_chunk() noexcept;
+
+        /**
+         * @brief 把预先分配的节点块并入节点池, 不分配内存.
+         *
+         * @param chunk new_chunk 返回的节点块.
+         * @return true 已并入, 所有权转移给时间轮.
+         * @return false 块数已达上限, 调用方负责释放 chunk.
+         */
+        [[nodiscard]]
+        bool add_chunk(NodeChunk *chunk) noexcept;
+
+        /**
+         * @brief 判断时间轮是否为空.
+         *
+         * @return true 时间轮为空.
+         * @return false 时间轮非空.
          */
         [[nodiscard]]
         bool empty() const noexcept;
 
         /**
-         * @brief 获取队列长度.
+         * @brief 获取时间轮中的动作数.
          *
-         * @return size_t 当前队列中的动作数.
+         * @return size_t 当前挂起的动作数.
          */
         [[nodiscard]]
         size_t size() const noexcept;
 
+        /**
+         * @brief 获取 slack.
+         *
+         * @return size_t 到期时间的取整粒度（纳秒）.
+         */
+        [[nodiscard]]
+        size_t slack_ns() const noexcept;
+
+        /**
+         * @brief 修改 slack, 已挂起的动作按新粒度重新放置, 代价 O(n).
+         *
+         * @param slack_ns 新的取整粒度（纳秒）, 为 0 时按 1 处理.
+         */
+        void set_slack(size_t slack_ns) noexcept;
+
         /**
          * @brief 插入一个到期动作.
          *
          * @param action 待插入动作.
-         * @return Result<ExpireHandle> 插入后可用于取消的稳定句柄.
+         * @return Result<ExpireHandle> 插入后可用于取消的稳定句柄;
+         * 节点池已空时返回 OUT_OF_MEMORY.
          */
         [[nodiscard]]
         Result<ExpireHandle> push(const ExpireAction &action) noexcept;
 
         /**
-         * @brief 根据句柄取消一个动作并真正移出队列.
+         * @brief 根据句柄取消一个动作并真正移出时间轮.
          *
          * @param handle 待取消动作句柄.
          * @return true 成功移除.
@@ -222,15 +307,20 @@ namespace driver {
         bool cancel(ExpireHandle handle) noexcept;
 
         /**
-         * @brief 查看当前最早到期动作.
+         * @brief 下一次需要处理时间轮的时刻.
          *
-         * @return std::optional<ExpireAction> 最早到期动作.
+         * 最早的动作位于第 0 层时即其取整后的到期时间;
+         * 位于高层时是该槽的起点, 届时下放后再给出精确时间.
+         *
+         * @return std::optional<size_t> 时刻（纳秒）, 时间轮为空时为空.
          */
         [[nodiscard]]
-        std::optional<ExpireAction> peek() const noexcept;
+        std::optional<size_t> next_expiry() const noexcept;
 
         /**
-         * @brief 弹出所有到期时间不晚于 now_ns 的动作.
+         * @brief 推进到 now_ns 并弹出已到期的动作.
+         *
+         * 一次最多弹出 MAX_DUE_ACTIONS 个, 剩余的已到期动作留待下次弹出.
          *
          * @param now_ns 当前时间（纳秒）.
          * @return PopDueResult 已到期动作集合.
@@ -239,66 +329,93 @@ namespace driver {
         PopDueResult pop_due(size_t now_ns) noexcept;
 
     private:
-        static constexpr size_t MAX_HEAP_ACTIONS = 32;
+        static constexpr size_t MAX_CHUNKS =
+            ExpireHandle::INVALID_SLOT / CHUNK_NODES;
+        static constexpr uint16_t NIL = ExpireHandle::INVALID_SLOT;
 
-        struct ExpireSlot {
+        struct Node {
             ExpireAction action{};
-            uint16_t heap_index = 0;
-            uint16_t next_free  = ExpireHandle::INVALID_SLOT;
+            size_t unit         = 0;
+            uint16_t prev       = NIL;
+            uint16_t next       = NIL;
+            uint16_t bucket     = 0;
             uint16_t generation = 1;
             bool active         = false;
         };
 
-    public:
-        ExpireActionQueue() noexcept;
+        [[nodiscard]]
+        Node &node(uint16_t id) noexcept;
+
+        [[nodiscard]]
+        const Node &node(uint16_t id) const noexcept;
 
-    private:
         /**
-         * @brief 删除堆中指定位置的动作.
+         * @brief 从空闲链表取一个节点.
          *
-         * @param heap_index 目标堆下标.
-         * @return ExpireAction 被移除的动作.
+         * @return Result<uint16_t> 节点编号.
          */
         [[nodiscard]]
-        ExpireAction remove_at(size_t heap_index) noexcept;
+        Result<uint16_t> alloc_node() noexcept;
+
+        /**
+         * @brief 归还节点并使旧句柄失效.
+         *
+         * @param id 节点编号.
+         */
+        void free_node(uint16_t id) noexcept;
+
+        /**
+         * @brief 按节点的到期单位与当前单位放入对应的槽.
+         *
+         * @param id 节点编号.
+         */
+        void link(uint16_t id) noexcept;
 
         /**
-         * @brief 将指定节点向上调整以恢复小根堆性质.
+         * @brief 把节点从所在的槽中摘下.
          *
-         * @param index 新插入节点下标.
+         * @param id 节点编号.
          */
-        void shift_up(size_t index) noexcept;
+        void unlink(uint16_t id) noexcept;
 
         /**
-         * @brief 将指定节点向下调整以恢复小根堆性质.
+         * @brief 把第 level 层中当前单位所在的槽整体下放.
          *
-         * @param index 根节点下标.
+         * @param level 层号, 不小于 1.
          */
-        void shift_down(size_t index) noexcept;
+        void cascade(size_t level) noexcept;
 
         /**
-         * @brief 交换两个堆节点并同步槽位中的 heap_index.
+         * @brief 下一个需要处理的单位, 含义同 next_expiry.
          *
-         * @param lhs 左节点下标.
-         * @param rhs 右节点下标.
+         * @return std::optional<size_t> 单位, 时间轮为空时为空.
          */
-        void swap_heap_nodes(size_t lhs, size_t rhs) noexcept;
+        [[nodiscard]]
+        std::optional<size_t> next_unit() const noexcept;
 
         /**
-         * @brief 比较两个槽位动作的到期时间.
+         * @brief 把纳秒时间向上取整为单位.
          *
-         * @param lhs 左槽位编号.
-         * @param rhs 右槽位编号.
-         * @return true 左动作更晚到期.
-         * @return false 左动作不晚于右动作.
+         * @param ns 时间（纳秒）.
+         * @return size_t 单位.
          */
         [[nodiscard]]
-        bool later(uint16_t lhs, uint16_t rhs) const noexcept;
+        size_t unit_of(size_t ns) const noexcept;
+
+        NodeChunk *_chunks[MAX_CHUNKS]{};
+        size_t _chunk_count = 0;
+        uint16_t _heads[LEVELS * LEVEL_SLOTS]{};
+        uint64_t _occupied[LEVELS]{};
+        uint16_t _free_head = NIL;
+        size_t _free_count  = 0;
+        size_t _size        = 0;
+        // 已推进到的单位, 小于等于它的动作都已到期
+        size_t _base     = 0;
+        size_t _slack_ns = DEFAULT_SLACK_NS;
+    };
 
-        uint16_t _heap[MAX_HEAP_ACTIONS]{};
-        ExpireSlot _slots[MAX_HEAP_ACTIONS]{};
-        uint16_t _free_head = ExpireHandle::INVALID_SLOT;
-        size_t _heap_size   = 0;
+    struct TimerWheel::NodeChunk {
+        Node nodes[CHUNK_NODES];
     };
 
     /**
@@ -317,6 +434,9 @@ namespace driver {
         /**
          * @brief 新增一个到期动作.
          *
+         * 节点池不足时先在开中断处扩充, 只能在任务上下文调用;
+         * 中断处理中的重新入队走 insert, 只使用已有的空闲节点.
+         *
          * @param action 待提交动作.
          * @return Result<ExpireHandle> 若动作入队成功则返回取消句柄.
          */
@@ -333,6 +453,46 @@ namespace driver {
         [[nodiscard]]
         bool cancel(ExpireHandle handle) noexcept;
 
+        /**
+         * @brief 设置到期动作的 slack: 相距不超过它的到期动作合并为一次中断.
+         *
+         * @param slack 取整粒度.
+         */
+        void set_slack(units::time slack) noexcept;
+
+        /**
+         * @brief 启动周期性调度 tick.
+         *
+         * @param period tick 周期.
+         * @return Result<void> tick 动作入队结果.
+         */
+        [[nodiscard]]
+        Result<void> start_tick(units::time period) noexcept;
+
+        /**
+         * @brief 停止周期性调度 tick (NO_HZ).
+         *
+         * 之后 timer 只按队列中最早的到期动作编程,
+         * 错过的 tick 在恢复后的第一次 tick 中一并补记.
+         */
+        void stop_tick() noexcept;
+
+        /**
+         * @brief 恢复周期性调度 tick, 下一次 tick 仍对齐原来的节拍.
+         */
+        void restart_tick() noexcept;
+
+        /**
+         * @brief 周期 tick 是否已被停止.
+         *
+         * @return true 已停止.
+         * @return false 正在运行或尚未启动.
+         */
+        [[nodiscard]]
+        constexpr bool tick_stopped() const noexcept {
+            return _tick_stopped;
+        }
+
         /**
          * @brief 处理一次 Alarm 到期中断.
          *
@@ -360,12 +520,49 @@ namespace driver {
             return _alarm;
         }
 
+        /// 队列为空时 timer 最远推迟的时间, 同时借此清除已挂起的时钟中断
+        static constexpr units::time MAX_IDLE_DELTA =
+            units::time::from_seconds(1);
+
     private:
+        /// 初始化时预分配的节点数, 保证 tick 与早期定时器无需扩容
+        static constexpr size_t INITIAL_NODES = TimerWheel::CHUNK_NODES;
+
+        /**
+         * @brief 空闲节点不足时分配一块节点, 在关中断后并入队列.
+         *
+         * 分配发生在开中断处, 不得在 ISR 中调用.
+         */
+        void grow_queue() noexcept;
+
+        /**
+         * @brief 把到期动作放入队列, 不扩充节点池.
+         *
+         * @param action 待提交动作.
+         * @return Result<ExpireHandle> 取消句柄; 节点池已空时返回错误.
+         */
+        [[nodiscard]]
+        Result<ExpireHandle> insert(const ExpireAction &action) noexcept;
+
         /**
          * @brief 根据当前队列根重新编程下一次 timer.
          */
         void rearm_timer() noexcept;
 
+        /**
+         * @brief 在已关闭本地中断的上下文中排入下一次 tick.
+         *
+         * @param expire_ns tick 到期时间（纳秒）.
+         */
+        void arm_tick_locked(size_t expire_ns) noexcept;
+
+        /**
+         * @brief 执行一次 tick: 通知调度器, 未停止时排入下一次 tick.
+         *
+         * @param now 当前时间.
+         */
+        void run_tick(units::time now) noexcept;
+
         /**
          * @brief 在已关闭本地中断的上下文中重编程下一次 timer.
          */
@@ -382,7 +579,12 @@ namespace driver {
 
         ClockSource *_source = nullptr;
         Alarm *_alarm = nullptr;
-        ExpireActionQueue _queue{};
+        TimerWheel _queue{};
+
+        ExpireHandle _tick_handle{};
+        size_t _tick_period_ns = 0;
+        size_t _last_tick_ns   = 0;
+        bool _tick_stopped     = false;
     };
 
 }  // namespace driver
@@ -12,6 +12,7 @@
 #include <device/resource.h>
 #include <driver/virtio/virtio.h>
 #include <logger.h>
+#include <mem/compaction.h>
 #include <mem/gfp.h>
 #include <device/pci.h>
 #include <sus/raii.h>
@@ -1087,7 +1088,7 @@ namespace virtio {
 
     Result<DmaBuffer> VirtioDriverBase::alloc_dma_buffer(size_t size) noexcept {
         const auto page_count = page_align_up(size) / PAGESIZE;
-        auto page_res         = GFP::get_free_page(page_count);
+        auto page_res         = Compaction::alloc_contiguous(page_count);
         propagate(page_res);
         auto paddr = page_res.value();
         auto kaddr = convert<KpaAddr>(paddr).addr();
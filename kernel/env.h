@@ -198,6 +198,29 @@ namespace env {
             return _current_pcb;
         }
 
+        /**
+         * @brief 获取扩展寄存器 (浮点/向量) 中装载的是哪个线程的状态.
+         *
+         * 仅作指针比较使用, 线程可能已被回收;
+         * 需同时核对该线程的 ext_ctx_live 与 ext_ctx_hart.
+         *
+         * @return task::TCB* 最近一次装载扩展上下文的线程
+         */
+        [[nodiscard]]
+        constexpr task::TCB *ext_owner() const noexcept {
+            return _ext_owner;
+        }
+
+        /**
+         * @brief 获取扩展寄存器所属线程的引用槽.
+         *
+         * @return task::TCB*& 扩展寄存器所属线程引用槽
+         */
+        [[nodiscard]]
+        constexpr task::TCB *&ext_owner() noexcept {
+            return _ext_owner;
+        }
+
         /**
          * @brief 获取当前 hart 绑定的任务地址空间.
          *
@@ -335,6 +358,7 @@ namespace env {
             _rq           = schd::RQ{};
             _current_tcb  = nullptr;
             _current_pcb  = nullptr;
+            _ext_owner    = nullptr;
             _tmm          = nullptr;
             _trap_context = nullptr;
             _cpu          = nullptr;
@@ -353,6 +377,7 @@ namespace env {
         schd::RQ _rq{};
         task::TCB *_current_tcb       = nullptr;
         task::PCB *_current_pcb       = nullptr;
+        task::TCB *_ext_owner         = nullptr;
         TaskMemoryManager *_tmm       = nullptr;
         Context *_trap_context        = nullptr;
         device::Cpu *_cpu             = nullptr;
@@ -459,8 +484,12 @@ namespace env {
     void init_hart();
 
     /**
-     * @brief 获取当前 hart 的 Hart 上下文指针.
+     * @brief 获取指定 hart 的 Hart 上下文.
+     *
+     * 用于启动从 hart 与跨 hart 查看运行状态, 当前 hart 直接使用 hart_ctx.
      *
-     * @return HartContext* 当前 hart 的 Hart 上下文指针
+     * @param hart_id 目标 hart ID, 须小于 MAX_HARTS
+     * @return HartContext& 该 hart 的 Hart 上下文
      */
+    HartContext &hart_context(size_t hart_id);
 }  // namespace env
@@ -27,6 +27,7 @@
 #include <exe/task.h>
 #include <kinit.h>
 #include <logger.h>
+#include <mem/reclaim.h>
 #include <object/perm.h>
 #include <sus/logger.h>
 #include <sus/owner.h>
@@ -37,6 +38,7 @@
 #include <task/scheduler.h>
 #include <task/task.h>
 #include <task/wait.h>
+#include <test/framework.h>
 #include <vfs/device.h>
 #include <vfs/ext4.h>
 #include <vfs/procfs.h>
@@ -243,6 +245,16 @@ namespace {
         void_return();
     }
 
+#ifdef __CONF_KERNEL_TESTS
+    void run_runtime_tests() {
+        loggers::SUSTCORE::INFO("开始运行内核运行时测试");
+        TestFramework framework;
+        collect_runtime_tests(framework);
+        framework.run_all();
+        loggers::SUSTCORE::INFO("内核运行时测试完成");
+    }
+#endif
+
     [[noreturn]]
     void block_kinit_forever() {
         auto block_wd  = wait::alloc_reason();
@@ -268,6 +280,19 @@ void kinit_runtime_entry() {
     }
     loggers::SUSTCORE::INFO("已初始化 VFS");
 
+#ifdef __CONF_KERNEL_TESTS
+    // 在 kreclaimd 启动前运行, 避免后台回收干扰页缓存统计
+    run_runtime_tests();
+#endif
+
+    // 各缓存的 shrinker 已在 VFS 与块设备初始化时登记
+    init_res = Reclaim::start();
+    if (!init_res.has_value()) {
+        loggers::SUSTCORE::FATAL("kinit 启动 kreclaimd 失败: %s",
+                                 to_cstring(init_res.error()));
+        panic("kinit 启动 kreclaimd 失败");
+    }
+
     init_res = init_driver_model();
     if (!init_res.has_value()) {
         loggers::SUSTCORE::FATAL("kinit 初始化 DriverModel 失败: %s",
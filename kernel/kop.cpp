@@ -10,6 +10,7 @@
  */
 
 #include <cap/capability.h>
+#include <object/page_index.h>
 #include <task/task.h>
 #include <vfs/tarfs.h>
 
@@ -17,6 +18,7 @@
 void init_kop()
 {
     cap::init_kop();
+    cap::init_page_index_kop();
     task::init_kop();
     tarfs::init_kop();
 }
@@ -34,6 +34,7 @@ extern "C" char __la_boot_stack, __la_boot_stack_top;
 #include <mem/kaddr.h>
 #include <mem/slub.h>
 #include <mem/vma.h>
+#include <smp/smp.h>
 #include <sus/logger.h>
 #include <sus/nonnull.h>
 #include <sus/path.h>
@@ -71,6 +72,11 @@ namespace env {
         return _env;
     }
 
+    HartContext &hart_context(size_t hart_id) {
+        assert(hart_id < MAX_HARTS);
+        return __hart_context[hart_id].ctx;
+    }
+
     void construct() {
         // call the constructor here
         new (&_env) Environment();
@@ -125,6 +131,32 @@ namespace env {
 }  // namespace env
 
 namespace {
+    /**
+     * @brief 将一段可用内存交给 RawGFPImpl, 跳过页描述符表自身占用的页.
+     *
+     * @param area 可用内存区域
+     */
+    void add_free_area(PhyArea area) {
+        PhyArea storage = MemMap::storage_area();
+        if (storage.nullable() || storage.end <= area.begin ||
+            area.end <= storage.begin)
+        {
+            size_t pages = area.size() / PAGESIZE;
+            if (pages != 0) {
+                RawGFPImpl::put_page(area.begin, pages);
+            }
+            return;
+        }
+
+        if (area.begin < storage.begin) {
+            RawGFPImpl::put_page(area.begin,
+                                 (storage.begin - area.begin) / PAGESIZE);
+        }
+        if (storage.end < area.end) {
+            RawGFPImpl::put_page(storage.end, (area.end - storage.end) / PAGESIZE);
+        }
+    }
+
     [[nodiscard]]
     void *bootinfo_fdt_ptr(const BootInfoHeader *bootinfo) noexcept {
         auto fdt_pa = bootinfo_fdt(bootinfo);
@@ -146,19 +178,10 @@ namespace {
         }
 
         constexpr units::time kTickPeriod = units::time::from_milliseconds(10);
-        units::time now =
-            time_keeper->source()->to_ns(time_keeper->source()->now());
-        auto enqueue_res = time_keeper->enqueue(device::ExpireAction{
-            .expireTime =
-                static_cast<size_t>((now + kTickPeriod).to_nanoseconds()),
-            .expireAction = device::expact::SCHD,
-            .expireArg0 =
-                static_cast<size_t>(kTickPeriod.to_nanoseconds()),
-            .expireArg1 = device::expact::schd::TICK,
-        });
-        if (!enqueue_res.has_value()) {
+        auto start_res = time_keeper->start_tick(kTickPeriod);
+        if (!start_res.has_value()) {
             loggers::SUSTCORE::FATAL("无法注册调度 tick 动作: err=%s",
-                                     to_cstring(enqueue_res.error()));
+                                     to_cstring(start_res.error()));
             panic("无法注册调度 tick 动作");
         }
     }
@@ -347,11 +370,13 @@ void env_setup() {
             total_free_pages += reg.area.size() / PAGESIZE;
         }
     }
-    e.system_memory_info(env::key::set()).mem_total_pages = total_free_pages;
-
     loggers::SUSTCORE::INFO("初始化GFP");
     GFP::pre_init();
 
+    // 页描述符表占用的页不计入可用内存
+    total_free_pages -= MemMap::storage_area().size() / PAGESIZE;
+    e.system_memory_info(env::key::set()).mem_total_pages = total_free_pages;
+
     loggers::SUSTCORE::INFO("将内存区域加入到GFP中");
     for (size_t i = 0; i < bootinfo_ptr->region_cnt; i++) {
         const auto &reg = bootinfo_regions(bootinfo_ptr)[i];
@@ -366,7 +391,7 @@ void env_setup() {
         loggers::SUSTCORE::INFO("桥接阶段加入可用内存区域 [%p, %p), 共 %u 页",
                                 reg.area.begin.addr(), reg.area.end.addr(),
                                 static_cast<unsigned>(pages));
-        RawGFPImpl::put_page(reg.area.begin, pages);
+        add_free_area(reg.area);
     }
 
     // 初始化 ker_paddr 与 PageMan
@@ -428,7 +453,7 @@ void env_setup() {
     init_kop();
 
     void *copied_fdt =
-        Allocator::INSTANCE().get()->malloc(static_cast<size_t>(dtb_size));
+        Allocator::INSTANCE().malloc(static_cast<size_t>(dtb_size));
     if (copied_fdt == nullptr) {
         panic("无法复制 FDT");
     }
@@ -463,7 +488,7 @@ void env_setup() {
             "回收 BOOT_RECLAIMABLE 内存区域 [%p, %p), 共 %u 页",
             reg.area.begin.addr(), reg.area.end.addr(),
             static_cast<unsigned>(pages));
-        RawGFPImpl::put_page(reg.area.begin, pages);
+        add_free_area(reg.area);
     }
 
     loggers::SUSTCORE::INFO("桥接代码完成! 进入 post-init 阶段");
@@ -537,6 +562,8 @@ void init_device_model() {
 
 extern "C" void post_init(void) {
     loggers::SUSTCORE::INFO("已进入 post-init 阶段");
+    // 从此刻起内核态由大内核锁串行, 启动 hart 先持有它
+    BigKernelLock::acquire();
 
     // 初始化 cholder
     loggers::SUSTCORE::INFO("初始化能力系统");
@@ -569,7 +596,13 @@ extern "C" void post_init(void) {
         while (true);
     }
 
+    Hart::enable_ipi();
+    SMP::mark_online();
+
 #ifdef __CONF_KERNEL_RUN_MODULES
+    loggers::SUSTCORE::INFO("拉起其余 hart");
+    SMP::boot_secondary();
+
     loggers::SUSTCORE::INFO("开始切入调度器");
     schd::Scheduler::inst().bootstrap_tasks();
 #endif
@@ -577,6 +610,28 @@ extern "C" void post_init(void) {
     while (true);
 }
 
+extern "C" void secondary_post_init(void) {
+    BigKernelLock::acquire();
+    env::init_hart();
+    Initialization::post_init();
+    Hart::enable_ipi();
+
+    auto idle_res = task::TaskManager::inst().create_idle_thread();
+    if (!idle_res.has_value()) {
+        loggers::SUSTCORE::ERROR("hart %lu 创建idle内核线程失败! 错误码: %s",
+                                 env::hart_ctx->hart_id(),
+                                 to_cstring(idle_res.error()));
+        while (true);
+    }
+    env::hart_ctx->current_tcb() = nullptr;
+    env::hart_ctx->current_pcb() = nullptr;
+    schd::Scheduler::inst().init_hart(idle_res.value());
+    register_scheduler_tick_action();
+
+    SMP::mark_online();
+    schd::Scheduler::inst().bootstrap_tasks();
+}
+
 extern "C" void redive(void);
 
 void kernel_setup() {
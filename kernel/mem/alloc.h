@@ -17,6 +17,7 @@
 using Allocator = slub::SlubMalloc;
 static_assert(AllocatorTrait<Allocator>, "Allocator 不满足 AllocatorTrait");
 
+// KOP 自带 per-hart 弹匣与内部锁, 可直接在多线程间共享
 template <typename ObjType>
-using KOP = slub::Slub<ObjType>;
+using KOP = slub::SlubCache<ObjType>;
 static_assert(KOPTrait<KOP<int>, int>, "KOP 不满足 KOPTrait");
@@ -73,9 +73,9 @@ public:
     SimpleKOP()  = default;
     ~SimpleKOP() = default;
     T *alloc() {
-        return (T *)Allocator::INSTANCE().get()->malloc(sizeof(T));
+        return (T *)Allocator::INSTANCE().malloc(sizeof(T));
     }
     void free(T *obj) {
-        Allocator::INSTANCE().get()->free((void *)obj);
+        Allocator::INSTANCE().free((void *)obj);
     }
 };
@@ -0,0 +1,130 @@
+/**
+ * @file asid.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 地址空间标识符 (ASID) 分配
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <env.h>
+#include <logger.h>
+#include <mem/asid.h>
+#include <spinlock.h>
+
+#include <atomic>
+
+namespace {
+    constexpr size_t BITMAP_WORDS = AsidAllocator::MAX_ASIDS / 64;
+
+    struct AsidState {
+        bool initialized = false;
+        // 当前代可用的 ASID 数量, 不超过 MAX_ASIDS
+        size_t limit = 0;
+        size_t next  = 1;
+        // 代号从 1 开始, 保证有效上下文的值非 0
+        std::atomic<uint64_t> generation{1};
+        uint64_t rollovers = 0;
+        uint64_t used[BITMAP_WORDS]{};
+        // 轮转后尚未刷新本地 TLB 的 hart 位图, 由各 hart 下次切换时清除
+        uint64_t flush_pending = 0;
+        SpinLocker lock;
+    };
+
+    AsidState asid_state;
+
+    [[nodiscard]]
+    uint64_t make_context(uint64_t generation, uint16_t asid) noexcept {
+        return (generation << AsidAllocator::ASID_SHIFT) | asid;
+    }
+
+    [[nodiscard]]
+    bool test_and_set(size_t asid) noexcept {
+        uint64_t bit = 1ul << (asid % 64);
+        if ((asid_state.used[asid / 64] & bit) != 0) {
+            return false;
+        }
+        asid_state.used[asid / 64] |= bit;
+        return true;
+    }
+}  // namespace
+
+void AsidAllocator::init() noexcept {
+    size_t bits = PageMan::asid_bits();
+    if (bits > ASID_SHIFT) {
+        bits = ASID_SHIFT;
+    }
+    // 只有 1 个 ASID 时它已被保留, 等同于不支持
+    asid_state.limit       = bits <= 1 ? 0 : (1ul << bits);
+    asid_state.initialized = true;
+    loggers::PAGING::INFO("ASID: 硬件支持 %lu 位, 可用 %lu 个",
+                          static_cast<unsigned long>(bits),
+                          static_cast<unsigned long>(
+                              asid_state.limit == 0 ? 0
+                                                    : asid_state.limit - 1));
+}
+
+uint16_t AsidAllocator::allocate() noexcept {
+    auto &state = asid_state;
+    for (size_t i = 0; i < state.limit; i++) {
+        size_t asid = state.next;
+        state.next  = state.next + 1 >= state.limit ? 1 : state.next + 1;
+        if (asid != 0 && test_and_set(asid)) {
+            return static_cast<uint16_t>(asid);
+        }
+    }
+
+    // 本代已分配完, 进入下一代
+    for (auto &word : state.used) {
+        word = 0;
+    }
+    state.generation.fetch_add(1, std::memory_order_relaxed);
+    state.rollovers++;
+    // 其他 hart 仍在以旧代 ASID 运行并不断回填 TLB, 此时刷新无济于事;
+    // 改为各自在下一次切换时整体刷新, 之后才可能装入新代的 ASID
+    state.flush_pending = ~0ul;
+    state.next          = 2;
+    test_and_set(1);
+    return 1;
+}
+
+void AsidAllocator::switch_to(PhyAddr root, AsidContext &ctx) noexcept {
+    IrqSaveGuardedLock guard(asid_state.lock);
+    if (!asid_state.initialized) {
+        init();
+    }
+    uint64_t self = 1ul << env::hart_ctx->hart_id();
+    ctx.harts    |= self;
+    if (asid_state.limit == 0) {
+        PageMan::__switch_root(root);
+        return;
+    }
+
+    uint16_t asid = 0;
+    if (!live(ctx, asid)) {
+        asid      = allocate();
+        ctx.value = make_context(
+            asid_state.generation.load(std::memory_order_relaxed), asid);
+    }
+    PageMan::__switch_root(root, asid);
+    if ((asid_state.flush_pending & self) != 0) {
+        // 本 hart 可能残留旧代同号 ASID 的翻译, 装入新代 ASID 后整体刷新
+        asid_state.flush_pending &= ~self;
+        PageMan::flush_tlb();
+    }
+}
+
+bool AsidAllocator::live(const AsidContext &ctx, uint16_t &asid) noexcept {
+    uint64_t generation = asid_state.generation.load(std::memory_order_relaxed);
+    if (ctx.value == 0 || (ctx.value >> ASID_SHIFT) != generation) {
+        return false;
+    }
+    asid = static_cast<uint16_t>(ctx.value & (MAX_ASIDS - 1));
+    return true;
+}
+
+uint64_t AsidAllocator::rollovers() noexcept {
+    return asid_state.rollovers;
+}
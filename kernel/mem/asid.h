@@ -0,0 +1,69 @@
+/**
+ * @file asid.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 地址空间标识符 (ASID) 分配
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <arch/description.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 地址空间持有的 ASID 上下文.
+ *
+ * 高位为分配时的代号, 低 ASID_SHIFT 位为 ASID. 值为 0 表示从未分配.
+ * 代号与分配器当前代号不同时, 该 ASID 已失效, 需要在下次切换时重新分配.
+ */
+struct AsidContext {
+    uint64_t value = 0;
+    /// 切换到过该地址空间的 hart 位图, 这些 hart 可能残留它的 TLB 项
+    uint64_t harts = 0;
+};
+
+/**
+ * @brief 按代号轮转的 ASID 分配器.
+ *
+ * ASID 0 保留给未分配 ASID 的地址空间 (如内核页表), 切换到它们时仍整体刷新.
+ * 一代内的 ASID 分配完后进入下一代: 清空分配位图, 每个 hart 在下一次切换时
+ * 整体刷新本地 TLB, 旧代的上下文在下一次切换时重新分配. 地址空间销毁时不归还 ASID,
+ * 以免其残留的 TLB 项被新持有者看到.
+ */
+class AsidAllocator {
+public:
+    static constexpr size_t ASID_SHIFT = 16;
+    static constexpr size_t MAX_ASIDS  = 1ul << ASID_SHIFT;
+
+private:
+    static void init() noexcept;
+    static uint16_t allocate() noexcept;
+
+public:
+    /**
+     * @brief 以 ctx 的 ASID 切换到页表根 root.
+     *
+     * ctx 的 ASID 已失效时重新分配; 硬件不支持 ASID 时退化为切换并整体刷新.
+     */
+    static void switch_to(PhyAddr root, AsidContext &ctx) noexcept;
+
+    /**
+     * @brief 查询 ctx 在当前代中的 ASID.
+     *
+     * @return true ctx 持有有效 ASID, 结果写入 asid
+     */
+    [[nodiscard]]
+    static bool live(const AsidContext &ctx, uint16_t &asid) noexcept;
+
+    /**
+     * @brief 已发生的代号轮转次数.
+     */
+    [[nodiscard]]
+    static uint64_t rollovers() noexcept;
+};
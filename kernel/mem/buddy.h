@@ -14,23 +14,32 @@
 #include <arch/trait.h>
 #include <logger.h>
 #include <mem/gfp_def.h>
+#include <mem/memmap.h>
+#include <sus/list.h>
 #include <sustcore/addr.h>
 
 #include <cstddef>
 
+/**
+ * @brief Buddy 页框分配器.
+ *
+ * 空闲块以首页的 Page 描述符为节点挂入各阶空闲链表,
+ * 描述符上的 PG_BUDDY 标志与 order 记录块的状态, 不再需要额外的节点池.
+ * 释放时由伙伴地址直接查询描述符, 每一级合并都是 O(1).
+ * 公开接口由一把关中断的区域锁串行, 中断处理程序中同样可以直接调用.
+ */
 class BuddyAllocator {
 public:
-    struct FreeBlock {
-        PhyAddr paddr;
-        size_t order;
-        FreeBlock *prev;
-        FreeBlock *next;
+    static constexpr int MAX_BUDDY_ORDER = 15;
+
+    /**
+     * @brief 各阶空闲块数量的快照.
+     */
+    struct BuddyStats {
+        size_t free_blocks[MAX_BUDDY_ORDER + 1];
+        size_t free_pages;
     };
 
-    static constexpr int MAX_BUDDY_ORDER           = 15;
-    static constexpr size_t FREEBLOCK_POOL_SIZE    = 512;
-    static constexpr size_t FREEBLOCK_EXPAND_PAGES = 4;
-
     static void pre_init();
     static Result<PhyAddr> get_free_page(size_t frame_count);
     static Result<PhyAddr> get_free_pages_in_order(size_t order);
@@ -39,48 +48,28 @@ public:
     static void __print_memory_layout() {
         loggers::BUDDY::DEBUG("Buddy Allocator Memory Layout:");
         for (int order = 0; order <= MAX_BUDDY_ORDER; ++order) {
-            size_t count = 0;
-            for (FreeBlock *node = free_area[order]; node != nullptr;
-                 node             = node->next)
-            {
-                ++count;
-            }
-
             loggers::BUDDY::DEBUG("Order %d: %u blocks", order,
-                                  static_cast<unsigned>(count));
-            for (FreeBlock *node = free_area[order]; node != nullptr;
-                 node             = node->next)
-            {
+                                  static_cast<unsigned>(free_area[order].size()));
+            for (Page &page : free_area[order]) {
+                PhyAddr paddr = MemMap::paddr_of(&page);
                 loggers::BUDDY::DEBUG("    Free block at [%p, %p)",
-                                      node->paddr.addr(),
-                                      (node->paddr +
-                                       (1ul << (order + 12))).addr());
+                                      paddr.addr(),
+                                      (paddr + block_size_for_order(
+                                                   static_cast<size_t>(order)))
+                                          .addr());
             }
         }
     }
 
 private:
-    struct FreeBlockPool {
-        size_t bitmap[8];
-        size_t used;
-        FreeBlockPool *next;
-        FreeBlockPool *prev;
-    };
-
-    static_assert(sizeof(FreeBlockPool) <= sizeof(FreeBlock) * 4,
-                  "FreeBlockPool 头必须位于池头四个块内");
+    using FreeList = util::IntrusiveList<Page>;
 
-    inline static FreeBlock _buddy_pool0[FREEBLOCK_POOL_SIZE];
-    inline static FreeBlockPool *_pool_head = nullptr;
-    inline static FreeBlockPool *_pool_tail = nullptr;
-    inline static FreeBlock *free_area[MAX_BUDDY_ORDER + 1] = {};
+    inline static FreeList free_area[MAX_BUDDY_ORDER + 1] = {};
     inline static size_t _free_pages = 0;
 
-    static constexpr size_t FREEBLOCK_HEADER_BLOCKS = 4;
-    static constexpr size_t FREEBLOCK_HEADER_BYTES  =
-        sizeof(FreeBlock) * FREEBLOCK_HEADER_BLOCKS;
-
+    // 以下函数要求调用方已持有区域锁
     static void add_memory_range(PhyAddr paddr, size_t pages);
+    static void free_block(PhyAddr paddr, int order);
 
     static constexpr int pages2order(size_t count) {
         switch (count) {
@@ -105,38 +94,9 @@ private:
         return 1ul << (order + 12);
     }
 
-    static constexpr size_t block_index(size_t used) {
-        return used - FREEBLOCK_HEADER_BLOCKS;
-    }
-
-    static constexpr size_t bit_index(size_t idx) {
-        return idx / (sizeof(size_t) * 8);
-    }
-
-    static constexpr size_t bit_mask(size_t idx) {
-        return 1ul << (idx % (sizeof(size_t) * 8));
-    }
-
-    static PhyArea pool0_area() noexcept;
-    static FreeBlockPool *pool0_head() noexcept;
-    static FreeBlockPool *runtime_pool(PhyAddr paddr) noexcept;
-    static FreeBlock *runtime_block(PhyAddr paddr) noexcept;
-
-    static void init_pool0() noexcept;
-    static void init_pool(FreeBlockPool *pool, PhyAddr pool_paddr) noexcept;
-    static PhyAddr pool_to_pa(const FreeBlockPool *pool) noexcept;
-    static FreeBlock *pool_to_blocks(const FreeBlockPool *pool) noexcept;
-    static void attach_pool(FreeBlockPool *pool) noexcept;
-    static bool pool_needs_expand(const FreeBlockPool *pool) noexcept;
-    static Result<void> maybe_expand_pool() noexcept;
-    static Result<void> add_new_pool() noexcept;
-
-    static Result<FreeBlock *> alloc_freeblock() noexcept;
-    static void free_freeblock(FreeBlock *block) noexcept;
-
-    static void link_block(FreeBlock *node) noexcept;
-    static void unlink_block(FreeBlock *node) noexcept;
-    static FreeBlock *find_buddy_node(FreeBlock *node) noexcept;
+    static void link_block(Page *page, size_t order) noexcept;
+    static void unlink_block(Page *page) noexcept;
+    static Page *find_buddy_node(Page *page) noexcept;
 
     static Result<PhyAddr> fetch_frame_order(size_t order);
 
@@ -145,6 +105,23 @@ public:
     static size_t free_pages() noexcept {
         return _free_pages;
     }
+
+    [[nodiscard]]
+    static BuddyStats get_stats() noexcept;
+
+    /**
+     * @brief 计算指定阶的外部碎片指数 (千分比).
+     *
+     * 与 Linux extfrag_index 相同: 存在不小于该阶的空闲块时返回 -1000,
+     * 表示分配会成功; 否则越接近 1000 表示失败越是由碎片而非内存不足导致.
+     *
+     * @param stats 空闲块快照
+     * @param order 目标阶
+     * @return int 碎片指数, 范围 [-1000, 1000]
+     */
+    [[nodiscard]]
+    static int fragmentation_index(const BuddyStats &stats,
+                                   size_t order) noexcept;
 };
 
 static_assert(RawGFP<BuddyAllocator>, "Buddy 不满足 RawGFP");
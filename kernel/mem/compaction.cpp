@@ -0,0 +1,280 @@
+/**
+ * @file compaction.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 物理内存整理
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <logger.h>
+#include <mem/buddy.h>
+#include <mem/compaction.h>
+#include <mem/memmap.h>
+#include <mem/reclaim.h>
+#include <mem/vma.h>
+#include <spinlock.h>
+#include <vfs/vfs.h>
+
+#include <atomic>
+#include <vector>
+
+namespace {
+    struct CompactionState {
+        Compaction::Stats stats{};
+        // 整理全程只允许一个执行者, 其余调用方直接放弃
+        std::atomic<bool> running{false};
+        SpinLocker lock;
+    };
+
+    CompactionState compaction_state;
+
+    /// 块中存在无法迁移的页
+    constexpr size_t UNMOVABLE = static_cast<size_t>(-1);
+
+    struct Candidate {
+        size_t pfn;
+        size_t movable;
+    };
+
+    [[nodiscard]]
+    size_t order_for(size_t page_count) noexcept {
+        size_t order = 0;
+        while ((1ul << order) < page_count) {
+            ++order;
+        }
+        return order;
+    }
+
+    [[nodiscard]]
+    bool has_free_block(size_t order) noexcept {
+        auto stats = BuddyAllocator::get_stats();
+        for (size_t i = order; i <= BuddyAllocator::MAX_BUDDY_ORDER; ++i) {
+            if (stats.free_blocks[i] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 计算腾空从 pfn 开始的 pages 页需要迁移的页数.
+     *
+     * 调用前已清空页缓存池, 引用计数为 0 又不在 buddy 中的页
+     * 不归 GFP 管理 (内核镜像、空洞或裸分配), 与 slab 页一样不可迁移.
+     * 引用计数为 1 的页只是可能可迁移, 内核自用页要到迁移时才能排除.
+     */
+    [[nodiscard]]
+    size_t block_cost(size_t pfn, size_t pages) noexcept {
+        size_t movable = 0;
+        size_t i       = 0;
+        while (i < pages) {
+            Page *page = MemMap::page_of(PhyAddr((pfn + i) * PAGESIZE));
+            if (page->test(Page::PG_BUDDY)) {
+                i += 1ul << page->order;
+                continue;
+            }
+            if (page->refcount != 1 || page->test(Page::PG_RESERVED) ||
+                page->test(Page::PG_SLAB))
+            {
+                return UNMOVABLE;
+            }
+            movable++;
+            i++;
+        }
+        return movable;
+    }
+
+    /**
+     * @brief 挑选需要迁移页数最少的若干个对齐块, 按代价升序排列.
+     *
+     * @return 候选块数
+     */
+    size_t pick_candidates(size_t order, Candidate (&out)[Compaction::MAX_CANDIDATES]) {
+        const size_t pages = 1ul << order;
+        const size_t first = MemMap::base_pfn();
+        const size_t last  = first + MemMap::page_count();
+        size_t count       = 0;
+        for (size_t pfn = (first + pages - 1) & ~(pages - 1); pfn + pages <= last;
+             pfn += pages)
+        {
+            size_t movable = block_cost(pfn, pages);
+            if (movable == UNMOVABLE) {
+                continue;
+            }
+            if (count == Compaction::MAX_CANDIDATES &&
+                movable >= out[count - 1].movable)
+            {
+                continue;
+            }
+            // 插入排序, 候选数很少
+            size_t pos = count < Compaction::MAX_CANDIDATES ? count++ : count - 1;
+            while (pos > 0 && out[pos - 1].movable > movable) {
+                out[pos] = out[pos - 1];
+                pos--;
+            }
+            out[pos] = Candidate{pfn, movable};
+        }
+        return count;
+    }
+
+    /**
+     * @brief 为迁移提供目标页, 分到目标块内的页先扣住, 整理结束后再归还.
+     *
+     * 直接向 RawGFPImpl 逐页申请: pcp 成批补充时整块取走 PCP_BATCH 页,
+     * 恰好吃掉整理要拼出的块. 扣住的页同时阻止目标块中已空闲的部分
+     * 被迁移自身再次占用.
+     */
+    class MigrateTarget {
+    private:
+        PhyArea _block;
+        std::vector<PhyAddr> _held{};
+
+    public:
+        explicit MigrateTarget(const PhyArea &block) : _block(block) {}
+
+        MigrateTarget(const MigrateTarget &)            = delete;
+        MigrateTarget &operator=(const MigrateTarget &) = delete;
+
+        ~MigrateTarget() {
+            for (PhyAddr paddr : _held) {
+                RawGFPImpl::put_page(paddr, 1);
+            }
+        }
+
+        [[nodiscard]]
+        Result<PhyAddr> alloc() {
+            while (true) {
+                auto page_res = RawGFPImpl::get_free_page(1);
+                propagate(page_res);
+                PhyAddr paddr = page_res.value();
+                if (!within(_block, paddr)) {
+                    // 与 GFP::get_free_page 一致, 交出的页引用计数为 1
+                    MemMap::page_of(paddr)->refcount = 1;
+                    return paddr;
+                }
+                _held.push_back(paddr);
+            }
+        }
+    };
+
+    /**
+     * @brief 把目标块内的页缓存页与匿名页迁出.
+     *
+     * @return 迁移的页数
+     */
+    size_t migrate_block(size_t pfn, size_t pages) {
+        PhyArea block(PhyAddr(pfn * PAGESIZE), PhyAddr((pfn + pages) * PAGESIZE));
+        MigrateTarget target(block);
+        size_t migrated = 0;
+
+        // 页缓存页由描述符直接找到所属 vnode
+        for (size_t i = 0; i < pages; ++i) {
+            PhyAddr paddr = block.begin + i * PAGESIZE;
+            Page *page    = MemMap::page_of(paddr);
+            if (!page->test(Page::PG_PAGECACHE) || page->refcount != 1) {
+                continue;
+            }
+            auto dst_res = target.alloc();
+            if (!dst_res.has_value()) {
+                return migrated;
+            }
+            if (VINode::migrate_cached_page(paddr, dst_res.value())) {
+                migrated++;
+            } else {
+                GFP::put_page(dst_res.value(), 1);
+            }
+        }
+
+        migrated += TaskMemoryManager::migrate_pages(
+            block, [&target]() { return target.alloc(); });
+        return migrated;
+    }
+
+    bool run(size_t order, bool background) noexcept {
+        if (order == 0 || order > Compaction::MAX_ORDER) {
+            return has_free_block(order);
+        }
+        if (compaction_state.running.exchange(true, std::memory_order_acquire)) {
+            return false;
+        }
+
+        // 清空各 hart 的页缓存池, 让池中的页回到 buddy 参与合并
+        GFP::drain_all_pcp();
+        GFP::drain_zero_pool();
+        bool success    = has_free_block(order);
+        size_t migrated = 0;
+        if (!success) {
+            Candidate candidates[Compaction::MAX_CANDIDATES];
+            size_t count = pick_candidates(order, candidates);
+            for (size_t i = 0; i < count && !success; ++i) {
+                migrated += migrate_block(candidates[i].pfn, 1ul << order);
+                // 旧页先进入当前 hart 的空闲页链表, 归还后才能合并
+                GFP::drain_pcp();
+                success = has_free_block(order);
+            }
+        }
+
+        {
+            IrqSaveGuardedLock guard(compaction_state.lock);
+            auto &stats = compaction_state.stats;
+            if (background) {
+                stats.background_runs++;
+            } else {
+                stats.direct_runs++;
+            }
+            if (success) {
+                stats.successes++;
+            }
+            stats.pages_migrated += migrated;
+        }
+        loggers::MEMORY::DEBUG("Compaction: order=%lu migrated=%lu success=%d",
+                               order, migrated, success);
+        compaction_state.running.store(false, std::memory_order_release);
+        return success;
+    }
+}  // namespace
+
+bool Compaction::compact(size_t order) noexcept {
+    return run(order, false);
+}
+
+Result<PhyAddr> Compaction::alloc_contiguous(size_t page_count,
+                                             unsigned flags) noexcept {
+    auto page_res = GFP::get_free_page(page_count, flags);
+    if (page_res.has_value() || page_res.error() != ErrCode::OUT_OF_MEMORY ||
+        page_count <= 1)
+    {
+        return page_res;
+    }
+
+    size_t order = order_for(page_count);
+    if (compact(order)) {
+        page_res = GFP::get_free_page(page_count, flags);
+        if (page_res.has_value()) {
+            return page_res;
+        }
+    }
+    // 空闲页本身不足时没有迁移的目标页, 回收一批再整理
+    if (Reclaim::direct_reclaim() && compact(order)) {
+        page_res = GFP::get_free_page(page_count, flags);
+    }
+    return page_res;
+}
+
+void Compaction::background() noexcept {
+    auto stats = BuddyAllocator::get_stats();
+    if (BuddyAllocator::fragmentation_index(stats, BACKGROUND_ORDER) <
+        BACKGROUND_FRAG_THRESHOLD)
+    {
+        return;
+    }
+    run(BACKGROUND_ORDER, true);
+}
+
+Compaction::Stats Compaction::get_stats() noexcept {
+    IrqSaveGuardedLock guard(compaction_state.lock);
+    return compaction_state.stats;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file compaction.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 物理内存整理
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <mem/gfp.h>
+#include <sustcore/addr.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+
+/**
+ * @brief 通过迁移可移动页拼出高阶空闲块.
+ *
+ * 挑选需要迁移页数最少的对齐块, 把其中的匿名页与页缓存页搬到块外,
+ * 旧页归还后在 buddy 中合并为目标阶的空闲块.
+ * 页描述符上没有匿名页的反向映射, 匿名页通过扫描各地址空间的页表找到.
+ */
+class Compaction {
+public:
+    /// 只为不超过该阶的请求整理, 更高阶的块几乎不可能腾空
+    static constexpr size_t MAX_ORDER = 9;
+    /// 每次整理最多尝试的候选块数
+    static constexpr size_t MAX_CANDIDATES = 4;
+    /// kreclaimd 保证存在的最小空闲块阶数, 覆盖 virtio 队列等常见 DMA 请求
+    static constexpr size_t BACKGROUND_ORDER = 4;
+    /// 该阶的碎片指数 (千分比) 超过阈值时才在后台整理
+    static constexpr int BACKGROUND_FRAG_THRESHOLD = 500;
+
+    /**
+     * @brief 统计信息的快照.
+     */
+    struct Stats {
+        /// 分配失败触发的整理次数
+        size_t direct_runs;
+        /// kreclaimd 发起的整理次数
+        size_t background_runs;
+        /// 整理后得到目标阶空闲块的次数
+        size_t successes;
+        /// 累计迁移的页数
+        size_t pages_migrated;
+    };
+
+    /**
+     * @brief 整理出至少一个 order 阶的空闲块.
+     *
+     * 同一时刻只有一个整理在进行, 并发调用直接返回 false.
+     *
+     * @return true buddy 中已有不小于 order 阶的空闲块
+     */
+    static bool compact(size_t order) noexcept;
+
+    /**
+     * @brief 分配物理连续页, 失败时整理并重试.
+     *
+     * 整理仍不够时先直接回收一批, 为迁移腾出目标页后再整理一次.
+     */
+    [[nodiscard]]
+    static Result<PhyAddr> alloc_contiguous(size_t page_count,
+                                            unsigned flags = GFP_NONE) noexcept;
+
+    /**
+     * @brief 由 kreclaimd 周期调用, BACKGROUND_ORDER 阶碎片严重时整理.
+     */
+    static void background() noexcept;
+
+    [[nodiscard]]
+    static Stats get_stats() noexcept;
+};
@@ -9,12 +9,113 @@
  *
  */
 
+#include <arch/description.h>
+#if defined(__ARCH_riscv64__)
+#include <arch/riscv64/ctxlayout.h>
+#elif defined(__ARCH_loongarch64__)
+#include <arch/loongarch64/ctxlayout.h>
+#endif
 #include <env.h>
 #include <logger.h>
+#include <spinlock.h>
 #include <sustcore/addr.h>
 #include <mem/gfp.h>
+#include <smp/smp.h>
+#include <sus/list.h>
 #include <sus/types.h>
 
+#include <atomic>
+#include <utility>
+
+namespace {
+    /**
+     * @brief 单个 hart 私有的 0 阶空闲页链表.
+     *
+     * 只在关闭抢占的前提下由所属 hart 访问,
+     * busy 用于识别同一 hart 上中断处理程序的重入.
+     * 链表头部是最近释放的热页, 尾部是最冷的页.
+     */
+    struct PageCpuList {
+        util::IntrusiveList<Page> pages{};
+        bool busy = false;
+    };
+
+    PageCpuList pcp_lists[MAX_HARTS]{};
+
+    /**
+     * @brief 占用当前 hart 的空闲页链表.
+     *
+     * @return PageCpuList* 无 hart 上下文或发生重入时返回 nullptr
+     */
+    PageCpuList *acquire_pcp() {
+        if (env::hart_ctx == nullptr || !MemMap::initialized()) {
+            return nullptr;
+        }
+        size_t hart = env::hart_ctx->hart_id();
+        if (hart >= MAX_HARTS) {
+            return nullptr;
+        }
+        PageCpuList *pcp = &pcp_lists[hart];
+        if (pcp->busy) {
+            return nullptr;
+        }
+        pcp->busy = true;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        return pcp;
+    }
+
+    void release_pcp(PageCpuList *pcp) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        pcp->busy = false;
+    }
+
+    /**
+     * @brief 从 RawGFPImpl 补充 PCP_BATCH 页.
+     *
+     * 优先整块申请以减少 buddy 操作次数, 碎片化时退化为逐页申请.
+     */
+    void pcp_refill(PageCpuList &pcp) {
+        auto block_res = RawGFPImpl::get_free_page(GFP::PCP_BATCH);
+        if (block_res.has_value()) {
+            Page *page = MemMap::page_of(block_res.value());
+            for (size_t i = 0; i < GFP::PCP_BATCH; i++) {
+                pcp.pages.push_back(page[i]);
+            }
+            return;
+        }
+        for (size_t i = 0; i < GFP::PCP_BATCH; i++) {
+            auto res = RawGFPImpl::get_free_page(1);
+            if (!res.has_value()) {
+                return;
+            }
+            pcp.pages.push_back(*MemMap::page_of(res.value()));
+        }
+    }
+
+    /**
+     * @brief 将链表尾部最冷的 n 页归还 RawGFPImpl.
+     */
+    void pcp_drain(PageCpuList &pcp, size_t n) {
+        while (n-- > 0 && !pcp.pages.empty()) {
+            Page *page = &pcp.pages.back();
+            pcp.pages.pop_back();
+            RawGFPImpl::put_page(MemMap::paddr_of(page), 1);
+        }
+    }
+
+    /**
+     * @brief 预清零页池.
+     *
+     * 池中的页引用计数为 0, 由 idle 线程在锁外清零后放入.
+     */
+    struct ZeroPool {
+        util::IntrusiveList<Page> pages{};
+        SpinLocker lock;
+    };
+
+    ZeroPool zero_pool;
+}  // namespace
+
 PhyAddr LinearGrowGFP::baseaddr = PhyAddr::null;
 PhyAddr LinearGrowGFP::curaddr = PhyAddr::null;
 PhyAddr LinearGrowGFP::boundary = PhyAddr::null;
@@ -37,6 +138,145 @@ void GFP::page_putpage(PhyAddr addr) {
     }
 }
 
+Result<PhyAddr> GFP::pcp_get_page() {
+    PreemptGuard guard;
+    guard.enter();
+
+    PageCpuList *pcp = acquire_pcp();
+    if (pcp == nullptr) {
+        return RawGFPImpl::get_free_page(1);
+    }
+    if (pcp->pages.empty()) {
+        pcp_refill(*pcp);
+    }
+    if (pcp->pages.empty()) {
+        release_pcp(pcp);
+        unexpect_return(ErrCode::OUT_OF_MEMORY);
+    }
+    Page *page = &pcp->pages.front();
+    pcp->pages.pop_front();
+    release_pcp(pcp);
+    return MemMap::paddr_of(page);
+}
+
+void GFP::pcp_put_page(Page *page) {
+    PreemptGuard guard;
+    guard.enter();
+
+    PageCpuList *pcp = acquire_pcp();
+    if (pcp == nullptr) {
+        RawGFPImpl::put_page(MemMap::paddr_of(page), 1);
+        return;
+    }
+    pcp->pages.push_front(*page);
+    if (pcp->pages.size() > PCP_HIGH) {
+        pcp_drain(*pcp, PCP_BATCH);
+    }
+    release_pcp(pcp);
+}
+
+void GFP::drain_pcp() {
+    PreemptGuard guard;
+    guard.enter();
+
+    PageCpuList *pcp = acquire_pcp();
+    if (pcp == nullptr) {
+        return;
+    }
+    pcp_drain(*pcp, pcp->pages.size());
+    release_pcp(pcp);
+}
+
+void GFP::drain_all_pcp() {
+    drain_pcp();
+    SMP::sync_others(SMP::online_mask(), SMP::IPI_DRAIN_PCP);
+}
+
+size_t GFP::pcp_pages() {
+    size_t total = 0;
+    for (const auto &pcp : pcp_lists) {
+        total += pcp.pages.size();
+    }
+    return total;
+}
+
+void GFP::clear_pages(PhyAddr addr, size_t page_count) {
+    auto *words      = convert<KpaAddr>(addr).as<uint64_t>();
+    const size_t cnt = page_count * PAGESIZE / sizeof(uint64_t);
+    for (size_t i = 0; i < cnt; i += 8) {
+        words[i]     = 0;
+        words[i + 1] = 0;
+        words[i + 2] = 0;
+        words[i + 3] = 0;
+        words[i + 4] = 0;
+        words[i + 5] = 0;
+        words[i + 6] = 0;
+        words[i + 7] = 0;
+    }
+}
+
+PhyAddr GFP::zero_pool_get_page() {
+    IrqSaveGuardedLock guard(zero_pool.lock);
+    if (zero_pool.pages.empty()) {
+        return PhyAddr::null;
+    }
+    Page *page = &zero_pool.pages.front();
+    zero_pool.pages.pop_front();
+    return MemMap::paddr_of(page);
+}
+
+bool GFP::refill_zero_pool() {
+    if (!MemMap::initialized()) {
+        return false;
+    }
+    size_t zeroed = 0;
+    while (zeroed < ZERO_POOL_BATCH) {
+        {
+            IrqSaveGuardedLock guard(zero_pool.lock);
+            if (zero_pool.pages.size() >= ZERO_POOL_HIGH) {
+                break;
+            }
+        }
+        // 直接取 buddy 中的冷页, 不占用各 hart 的热页链表;
+        // RawGFPImpl 的区域锁关闭中断, idle 线程在这里被打断也是安全的
+        auto res = RawGFPImpl::get_free_page(1);
+        if (!res.has_value()) {
+            break;
+        }
+        PhyAddr paddr = res.value();
+        Page *page    = MemMap::page_of(paddr);
+        if (page == nullptr) {
+            RawGFPImpl::put_page(paddr, 1);
+            break;
+        }
+        clear_pages(paddr, 1);
+
+        IrqSaveGuardedLock guard(zero_pool.lock);
+        zero_pool.pages.push_back(*page);
+        zeroed++;
+    }
+    return zeroed != 0;
+}
+
+size_t GFP::zero_pool_pages() {
+    IrqSaveGuardedLock guard(zero_pool.lock);
+    return zero_pool.pages.size();
+}
+
+void GFP::drain_zero_pool() {
+    // 锁内只摘下整条链表, 逐页归还放到锁外, 不延长关中断的时间
+    auto take = []() {
+        IrqSaveGuardedLock guard(zero_pool.lock);
+        return util::IntrusiveList<Page>(std::move(zero_pool.pages));
+    };
+    util::IntrusiveList<Page> pages = take();
+    while (!pages.empty()) {
+        Page *page = &pages.front();
+        pages.pop_front();
+        RawGFPImpl::put_page(MemMap::paddr_of(page), 1);
+    }
+}
+
 void LinearGrowGFP::pre_init() {
     PhyAddr _baseaddr = PhyAddr::null;
     // 从regions中找到大小最大的可用内存区域, 作为线性增长GFP的内存池
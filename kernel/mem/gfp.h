@@ -13,8 +13,8 @@
 
 #include <mem/buddy.h>
 #include <mem/gfp_def.h>
+#include <mem/memmap.h>
 #include <sustcore/addr.h>
-#include <atomic>
 
 /**
  * @brief 当前 GFP 使用的底层裸页框分配器. 
@@ -24,75 +24,78 @@
  */
 using RawGFPImpl = BuddyAllocator;
 
+/**
+ * @brief GFP 分配标志.
+ */
+enum GFPFlags : unsigned {
+    GFP_NONE = 0,
+    // 返回的页内容全部为 0
+    GFP_ZERO = 1u << 0,
+};
+
 /**
  * @brief 带引用计数管理的页框分配器接口. 
  *
  * GFP 是内核的统一页框分配器,
  * 其实际通过RawGFPImpl实现页的分配与归还,
- * 并为每个页维护一个引用计数, 以实现 COW 功能.
+ * 并在每个页的 Page 描述符中维护引用计数, 以实现 COW 功能.
  */
 class GFP {
-private:
-    // 最大追踪 4GB 内存
-    constexpr static size_t MAX_TRACKED_MEMORY = 4ull * 1024 * 1024 * 1024;
-    constexpr static size_t MAX_TRACKED_PAGES  = MAX_TRACKED_MEMORY / PAGESIZE;
-
-    /**
-     * @brief 每个物理页的引用计数. 
-     *
-     * 数组下标由物理地址除以 PAGESIZE 得到. 值为 0 表示该页当前
-     * 未由 GFP 管理或已归还底层分配器. 
-     *
-     * TODO: 使用根据当前设备动态决定的refcounts表, 或是使用哈希表
-     */
-    inline static std::atomic<size_t> refcounts[MAX_TRACKED_PAGES] = {};
-
-    /**
-     * @brief 将物理地址转换为引用计数表下标. 
-     *
-     * @param addr 需要查询的物理地址. 
-     * @return 物理页在 refcounts 中的下标. 
-     */
-    static size_t topfn(PhyAddr addr) {
-        return addr.page_align_down().arith() / PAGESIZE;
-    }
-
-    /**
-     * @brief 判断一段物理页是否在引用计数表可跟踪范围内. 
-     *
-     * @param addr 起始物理地址. 
-     * @param page_count 页数. 
-     * @return true 表示整段页都可被 refcounts 跟踪. 
-     */
-    static bool tracked(PhyAddr addr, size_t page_count = 1) {
-        size_t pfn = topfn(addr);
-        return pfn < MAX_TRACKED_PAGES && page_count <= MAX_TRACKED_PAGES - pfn;
-    }
-
 public:
+    // 每个 hart 的 0 阶空闲页链表超过该页数时成批归还 RawGFPImpl
+    static constexpr size_t PCP_HIGH  = 64;
+    // 每次与 RawGFPImpl 交换的页数
+    static constexpr size_t PCP_BATCH = 16;
+    // 预清零页池的容量上限
+    static constexpr size_t ZERO_POOL_HIGH  = 256;
+    // idle 线程每轮最多清零的页数
+    static constexpr size_t ZERO_POOL_BATCH = 16;
+
     /**
-     * @brief 初始化 pre-init 阶段的底层裸页框分配器. 
+     * @brief 建立页描述符表并初始化 pre-init 阶段的底层裸页框分配器. 
      */
     static void pre_init() {
+        MemMap::init();
         RawGFPImpl::pre_init();
     }
 
     /**
      * @brief 分配连续物理页并初始化引用计数. 
      *
+     * 单页 GFP_ZERO 请求优先从预清零页池取页, 池空时才在当前路径上清零.
+     *
      * @param page_count 需要分配的 4KiB 页数. 
+     * @param flags GFPFlags 的组合. 
      * @return 成功时返回起始物理地址;失败时返回底层分配器错误. 
      */
-    static Result<PhyAddr> get_free_page(size_t page_count = 1) {
-        auto res = RawGFPImpl::get_free_page(page_count);
-        if (!res.has_value()) {
-            unexpect_return(res.error());
+    static Result<PhyAddr> get_free_page(size_t page_count = 1,
+                                         unsigned flags    = GFP_NONE) {
+        PhyAddr paddr = PhyAddr::null;
+        if (page_count == 1 && (flags & GFP_ZERO) != 0) {
+            paddr = zero_pool_get_page();
         }
-        PhyAddr paddr = res.value();
-        if (tracked(paddr, page_count)) {
-            size_t pfn = topfn(paddr);
+        if (!paddr.nonnull()) {
+            auto res = page_count == 1 ? pcp_get_page()
+                                       : RawGFPImpl::get_free_page(page_count);
+            if (res.has_value()) {
+                paddr = res.value();
+                if ((flags & GFP_ZERO) != 0) {
+                    clear_pages(paddr, page_count);
+                }
+            } else if (page_count == 1) {
+                // 内存紧张时回收预清零页池中的页
+                paddr = zero_pool_get_page();
+                if (!paddr.nonnull()) {
+                    unexpect_return(res.error());
+                }
+            } else {
+                unexpect_return(res.error());
+            }
+        }
+        if (MemMap::covers(paddr, page_count)) {
+            Page *page = MemMap::page_of(paddr);
             for (size_t i = 0; i < page_count; ++i) {
-                refcounts[pfn + i] = 1;
+                page[i].refcount = 1;
             }
         }
         return paddr;
@@ -106,8 +109,9 @@ public:
     /**
      * @brief 释放连续物理页的一次引用. 
      *
-     * 对可跟踪页, 本函数逐页降低引用计数, 仅将引用计数归零的连续页段
-     * 归还给 RawGFPImpl. 对不可跟踪页, 直接委托 RawGFPImpl 释放. 
+     * 对有描述符的页, 本函数逐页降低引用计数, 仅将引用计数归零的连续页段
+     * 清除归属后归还给 RawGFPImpl; 单页释放先进入当前 hart 的 0 阶空闲页链表.
+     * 对没有描述符的页, 直接委托 RawGFPImpl 释放. 
      *
      * @param addr 起始物理地址. 
      * @param page_count 页数. 
@@ -116,19 +120,31 @@ public:
         if (!addr.nonnull()) {
             return;
         }
-        if (!tracked(addr, page_count)) {
+        if (!MemMap::covers(addr, page_count)) {
             RawGFPImpl::put_page(addr, page_count);
             return;
         }
 
-        size_t pfn       = topfn(addr);
+        Page *page = MemMap::page_of(addr);
+        if (page_count == 1) {
+            if (page->refcount > 0) {
+                page->refcount--;
+            }
+            if (page->refcount == 0) {
+                page->clear_owner();
+                pcp_put_page(page);
+            }
+            return;
+        }
+
         size_t run_start = 0;
         size_t run_len   = 0;
         for (size_t i = 0; i < page_count; ++i) {
-            if (refcounts[pfn + i] > 0) {
-                refcounts[pfn + i]--;
+            if (page[i].refcount > 0) {
+                page[i].refcount--;
             }
-            if (refcounts[pfn + i] == 0) {
+            if (page[i].refcount == 0) {
+                page[i].clear_owner();
                 if (run_len == 0) {
                     run_start = i;
                 }
@@ -148,22 +164,67 @@ public:
      */
     static void page_putpage(PhyAddr addr);
 
+    /**
+     * @brief 将当前 hart 的 0 阶空闲页链表全部归还 RawGFPImpl.
+     *
+     * 需要观察 buddy 真实状态 (合并结果、碎片统计) 时调用.
+     */
+    static void drain_pcp();
+
+    /**
+     * @brief 将所有在线 hart 的 0 阶空闲页链表归还 RawGFPImpl.
+     *
+     * 其他 hart 通过核间中断各自归还, 全部完成后返回.
+     * 正在操作自身链表时被打断的 hart 本次跳过.
+     */
+    static void drain_all_pcp();
+
+    /**
+     * @brief 所有 hart 的 0 阶空闲页链表中的页数之和.
+     *
+     * 这些页对 RawGFPImpl 而言已分配, 但实际处于空闲状态.
+     */
+    [[nodiscard]]
+    static size_t pcp_pages();
+
+    /**
+     * @brief 清零若干空闲页补充预清零页池.
+     *
+     * 由 idle 线程在 CPU 空闲时调用, 每次最多处理 ZERO_POOL_BATCH 页.
+     *
+     * @return true 本次清零了至少一页, 池可能仍未填满
+     */
+    static bool refill_zero_pool();
+
+    /**
+     * @brief 预清零页池中的页数.
+     */
+    [[nodiscard]]
+    static size_t zero_pool_pages();
+
+    /**
+     * @brief 将预清零页池中的页全部归还 RawGFPImpl.
+     *
+     * 内存整理前调用, 使池中的页可以参与 buddy 合并.
+     */
+    static void drain_zero_pool();
+
     /**
      * @brief 增加连续物理页的引用计数. 
      *
      * COW 建立共享映射时调用本函数, 表示另一个地址空间也引用了这些
-     * 物理页. 不可跟踪页会被忽略. 
+     * 物理页. 没有描述符的页会被忽略. 
      *
      * @param addr 起始物理地址. 
      * @param page_count 页数. 
      */
     static void keep_page(PhyAddr addr, size_t page_count = 1) {
-        if (!tracked(addr, page_count)) {
+        if (!MemMap::covers(addr, page_count)) {
             return;
         }
-        size_t pfn = topfn(addr);
+        Page *page = MemMap::page_of(addr);
         for (size_t i = 0; i < page_count; ++i) {
-            refcounts[pfn + i]++;
+            page[i].refcount++;
         }
     }
 
@@ -171,12 +232,42 @@ public:
      * @brief 查询物理页当前引用计数. 
      *
      * @param addr 需要查询的物理地址. 
-     * @return 可跟踪页返回实际引用计数;不可跟踪页按独占页处理, 返回 1. 
+     * @return 有描述符的页返回实际引用计数;其余页按独占页处理, 返回 1. 
      */
     static size_t ref_count(PhyAddr addr) {
-        if (!tracked(addr, 1)) {
+        Page *page = MemMap::page_of(addr.page_align_down());
+        if (page == nullptr) {
             return 1;
         }
-        return refcounts[topfn(addr)];
+        return page->refcount;
     }
+
+private:
+    /**
+     * @brief 从当前 hart 的 0 阶空闲页链表取出一页.
+     *
+     * 链表为空时先从 RawGFPImpl 成批补充 PCP_BATCH 页;
+     * 无 hart 上下文或发生中断重入时直接向 RawGFPImpl 申请,
+     * 其内部的区域锁关闭中断, 不会与被打断的补充或归还交错.
+     */
+    static Result<PhyAddr> pcp_get_page();
+
+    /**
+     * @brief 将一个引用计数已归零的页放回当前 hart 的 0 阶空闲页链表.
+     *
+     * 链表超过 PCP_HIGH 时把最冷的 PCP_BATCH 页归还 RawGFPImpl.
+     */
+    static void pcp_put_page(Page *page);
+
+    /**
+     * @brief 从预清零页池取出一页.
+     *
+     * @return PhyAddr 池为空时返回 PhyAddr::null
+     */
+    static PhyAddr zero_pool_get_page();
+
+    /**
+     * @brief 按机器字清零连续物理页.
+     */
+    static void clear_pages(PhyAddr addr, size_t page_count);
 };
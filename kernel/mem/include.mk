@@ -1 +1 @@
-sources += alloc.cpp gfp.cpp kaddr.cpp buddy.cpp slub.cpp vma.cpp
+sources += alloc.cpp gfp.cpp kaddr.cpp buddy.cpp memmap.cpp slub.cpp vma.cpp vma_tree.cpp tlb.cpp asid.cpp lz4.cpp zram.cpp reclaim.cpp compaction.cpp
@@ -0,0 +1,214 @@
+/**
+ * @file lz4.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief LZ4 块格式压缩与解压
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/lz4.h>
+
+#include <cstring>
+
+namespace {
+    constexpr size_t MIN_MATCH = 4;
+    // 最后一个匹配必须在距末尾 MFLIMIT 字节之前开始
+    constexpr size_t MFLIMIT = 12;
+    // 块末尾至少保留 LAST_LITERALS 字节字面量
+    constexpr size_t LAST_LITERALS = 5;
+    constexpr size_t MAX_OFFSET    = 65535;
+    constexpr size_t HASH_BITS     = 10;
+    constexpr size_t RUN_MASK      = 15;
+
+    [[nodiscard]]
+    uint32_t read32(const uint8_t *p) noexcept {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    [[nodiscard]]
+    size_t hash32(uint32_t v) noexcept {
+        return (v * 2654435761U) >> (32 - HASH_BITS);
+    }
+
+    /**
+     * @brief 写出长度字段超过 15 的部分.
+     */
+    [[nodiscard]]
+    bool put_length(uint8_t *dst, size_t cap, size_t &op,
+                    size_t len) noexcept {
+        while (len >= 255) {
+            if (op >= cap) {
+                return false;
+            }
+            dst[op++] = 255;
+            len      -= 255;
+        }
+        if (op >= cap) {
+            return false;
+        }
+        dst[op++] = static_cast<uint8_t>(len);
+        return true;
+    }
+
+    /**
+     * @brief 写出一个序列. match_len 为 0 表示最后的纯字面量序列.
+     */
+    [[nodiscard]]
+    bool put_sequence(uint8_t *dst, size_t cap, size_t &op,
+                      const uint8_t *literals, size_t lit_len, size_t offset,
+                      size_t match_len) noexcept {
+        if (op >= cap) {
+            return false;
+        }
+        size_t token_pos = op++;
+        size_t ml_code   = match_len == 0 ? 0 : match_len - MIN_MATCH;
+        uint8_t token =
+            static_cast<uint8_t>((lit_len < RUN_MASK ? lit_len : RUN_MASK) << 4);
+        token |= static_cast<uint8_t>(ml_code < RUN_MASK ? ml_code : RUN_MASK);
+        dst[token_pos] = token;
+
+        if (lit_len >= RUN_MASK &&
+            !put_length(dst, cap, op, lit_len - RUN_MASK))
+        {
+            return false;
+        }
+        if (cap - op < lit_len) {
+            return false;
+        }
+        memcpy(dst + op, literals, lit_len);
+        op += lit_len;
+        if (match_len == 0) {
+            return true;
+        }
+
+        if (cap - op < 2) {
+            return false;
+        }
+        dst[op++] = static_cast<uint8_t>(offset & 0xFF);
+        dst[op++] = static_cast<uint8_t>(offset >> 8);
+        if (ml_code >= RUN_MASK &&
+            !put_length(dst, cap, op, ml_code - RUN_MASK))
+        {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 读取长度字段超过 15 的部分.
+     */
+    [[nodiscard]]
+    bool get_length(const uint8_t *src, size_t len, size_t &ip,
+                    size_t &value) noexcept {
+        while (true) {
+            if (ip >= len) {
+                return false;
+            }
+            uint8_t b = src[ip++];
+            value    += b;
+            if (b != 255) {
+                return true;
+            }
+        }
+    }
+}  // namespace
+
+namespace lz4 {
+    size_t compress(const uint8_t *src, size_t len, uint8_t *dst,
+                    size_t cap) noexcept {
+        // 表项保存位置 + 1, 0 表示空
+        uint16_t table[1u << HASH_BITS]{};
+        size_t op     = 0;
+        size_t anchor = 0;
+        size_t ip     = 0;
+
+        if (len > MAX_OFFSET) {
+            return 0;
+        }
+        if (len >= MFLIMIT + 1) {
+            const size_t limit     = len - MFLIMIT;
+            const size_t match_end = len - LAST_LITERALS;
+            while (ip < limit) {
+                uint32_t seq = read32(src + ip);
+                size_t h     = hash32(seq);
+                size_t ref   = table[h];
+                table[h]     = static_cast<uint16_t>(ip + 1);
+                if (ref == 0 || read32(src + ref - 1) != seq) {
+                    ip++;
+                    continue;
+                }
+                ref--;
+
+                size_t match_len = MIN_MATCH;
+                while (ip + match_len < match_end &&
+                       src[ref + match_len] == src[ip + match_len])
+                {
+                    match_len++;
+                }
+                if (!put_sequence(dst, cap, op, src + anchor, ip - anchor,
+                                  ip - ref, match_len))
+                {
+                    return 0;
+                }
+                ip     += match_len;
+                anchor  = ip;
+            }
+        }
+        if (!put_sequence(dst, cap, op, src + anchor, len - anchor, 0, 0)) {
+            return 0;
+        }
+        return op;
+    }
+
+    Result<size_t> decompress(const uint8_t *src, size_t len, uint8_t *dst,
+                              size_t cap) noexcept {
+        size_t ip = 0;
+        size_t op = 0;
+        while (ip < len) {
+            uint8_t token  = src[ip++];
+            size_t lit_len = token >> 4;
+            if (lit_len == RUN_MASK && !get_length(src, len, ip, lit_len)) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            if (len - ip < lit_len || cap - op < lit_len) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            memcpy(dst + op, src + ip, lit_len);
+            ip += lit_len;
+            op += lit_len;
+            if (ip == len) {
+                break;
+            }
+
+            if (len - ip < 2) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            size_t offset = src[ip] | (static_cast<size_t>(src[ip + 1]) << 8);
+            ip           += 2;
+            if (offset == 0 || offset > op) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            size_t match_len = token & RUN_MASK;
+            if (match_len == RUN_MASK && !get_length(src, len, ip, match_len))
+            {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            match_len += MIN_MATCH;
+            if (cap - op < match_len) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            // 匹配可以与输出重叠, 必须逐字节复制
+            const uint8_t *match = dst + op - offset;
+            for (size_t i = 0; i < match_len; ++i) {
+                dst[op + i] = match[i];
+            }
+            op += match_len;
+        }
+        return op;
+    }
+}  // namespace lz4
@@ -0,0 +1,49 @@
+/**
+ * @file lz4.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief LZ4 块格式压缩与解压
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lz4 {
+    /**
+     * @brief 以 LZ4 块格式压缩 src.
+     *
+     * 贪心匹配, 哈希表放在栈上, 只适合页大小量级的输入 (不超过 64K).
+     *
+     * @param src 输入
+     * @param len 输入长度
+     * @param dst 输出缓冲区
+     * @param cap 输出缓冲区容量
+     * @return 压缩后的长度; 输出放不下时返回 0
+     */
+    [[nodiscard]]
+    size_t compress(const uint8_t *src, size_t len, uint8_t *dst,
+                    size_t cap) noexcept;
+
+    /**
+     * @brief 解压 LZ4 块.
+     *
+     * 对输入做完整的边界检查, 损坏的数据不会越界读写.
+     *
+     * @param src 压缩数据
+     * @param len 压缩数据长度
+     * @param dst 输出缓冲区
+     * @param cap 输出缓冲区容量
+     * @return 解压后的长度; 数据损坏或输出放不下返回 INVALID_PARAM
+     */
+    [[nodiscard]]
+    Result<size_t> decompress(const uint8_t *src, size_t len, uint8_t *dst,
+                              size_t cap) noexcept;
+}  // namespace lz4
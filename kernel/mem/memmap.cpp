@@ -0,0 +1,94 @@
+/**
+ * @file memmap.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 物理页描述符表实现
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <env.h>
+#include <logger.h>
+#include <mem/memmap.h>
+#include <sus/logger.h>
+
+#include <new>
+
+namespace {
+    [[nodiscard]]
+    bool managed_region(const MemRegion &region) noexcept {
+        return region.status == MemRegion::MemoryStatus::FREE ||
+               region.status == MemRegion::MemoryStatus::BOOT_RECLAIMABLE;
+    }
+}  // namespace
+
+void MemMap::init() {
+    auto *bootinfo = env::inst().bootinfo();
+    assert(bootinfo != nullptr);
+
+    // 覆盖范围取所有可能交给 GFP 的区域的外包
+    PhyAddr lowest  = PhyAddr::null;
+    PhyAddr highest = PhyAddr::null;
+    bool found      = false;
+    for (size_t i = 0; i < bootinfo->region_cnt; i++) {
+        const auto &region = bootinfo_regions(bootinfo)[i];
+        if (!managed_region(region) || region.area.nullable()) {
+            continue;
+        }
+        PhyAddr begin = region.area.begin.page_align_down();
+        PhyAddr end   = region.area.end.page_align_up();
+        if (!found || begin < lowest) {
+            lowest = begin;
+        }
+        if (!found || highest < end) {
+            highest = end;
+        }
+        found = true;
+    }
+    if (!found) {
+        panic("BootInfo 中没有可用内存区域");
+    }
+
+    const size_t page_count    = (highest - lowest) / PAGESIZE;
+    const size_t storage_bytes = page_align_up(page_count * sizeof(Page));
+
+    // 从最低的足够大的 FREE 区域头部切出描述符表
+    PhyAddr storage = PhyAddr::null;
+    for (size_t i = 0; i < bootinfo->region_cnt; i++) {
+        const auto &region = bootinfo_regions(bootinfo)[i];
+        if (region.status != MemRegion::MemoryStatus::FREE) {
+            continue;
+        }
+        PhyArea area = page_align_inward(region.area);
+        if (area.nullable() || area.size() < storage_bytes) {
+            continue;
+        }
+        if (!storage.nonnull() || area.begin < storage) {
+            storage = area.begin;
+        }
+    }
+    if (!storage.nonnull()) {
+        panic("无法为页描述符表找到足够大的内存区域");
+    }
+
+    _base_pfn   = lowest.arith() / PAGESIZE;
+    _page_count = page_count;
+    _storage    = PhyArea(storage, storage + storage_bytes);
+
+    auto *pages = convert<KpaAddr>(storage).as<Page>();
+    for (size_t i = 0; i < page_count; i++) {
+        new (&pages[i]) Page{};
+    }
+    _pages = pages;
+
+    for (size_t off = 0; off < storage_bytes; off += PAGESIZE) {
+        page_of(storage + off)->set(Page::PG_RESERVED);
+    }
+
+    loggers::MEMORY::INFO(
+        "页描述符表覆盖 [%p, %p), 共 %lu 页, 占用 [%p, %p)", lowest.addr(),
+        highest.addr(), static_cast<unsigned long>(page_count),
+        _storage.begin.addr(), _storage.end.addr());
+}
@@ -0,0 +1,166 @@
+/**
+ * @file memmap.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 物理页描述符表
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sus/list.h>
+#include <sustcore/addr.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 物理页描述符.
+ *
+ * 每个受管物理页对应一个 Page, 集中保存引用计数、buddy 状态与归属信息,
+ * 各分配器可以由物理地址 O(1) 定位到描述符.
+ */
+struct Page {
+    enum Flags : uint16_t {
+        // 不由 GFP 管理的页, 如描述符表自身占用的页
+        PG_RESERVED  = 1u << 0,
+        // buddy 空闲块的首页, order 有效
+        PG_BUDDY     = 1u << 1,
+        // slab 页, owner 指向所属 Slub
+        PG_SLAB      = 1u << 2,
+        // 页缓存页, owner 指向所属 VINode
+        PG_PAGECACHE = 1u << 3,
+    };
+
+    // buddy 空闲链表链接
+    util::ListHead<Page> list_head{};
+    // GFP 引用计数, 0 表示页位于 buddy 中或未被管理
+    std::atomic<uint32_t> refcount{0};
+    uint16_t flags = 0;
+    // 空闲块阶数, 仅对 PG_BUDDY 页有效
+    uint8_t order  = 0;
+    void *owner    = nullptr;
+
+    [[nodiscard]]
+    bool test(Flags flag) const noexcept {
+        return (flags & flag) != 0;
+    }
+
+    void set(Flags flag) noexcept {
+        flags |= flag;
+    }
+
+    void clear(Flags flag) noexcept {
+        flags &= static_cast<uint16_t>(~flag);
+    }
+
+    /**
+     * @brief 设置页的归属.
+     *
+     * @param flag PG_SLAB 或 PG_PAGECACHE
+     * @param new_owner 归属对象
+     */
+    void set_owner(Flags flag, void *new_owner) noexcept {
+        clear_owner();
+        set(flag);
+        owner = new_owner;
+    }
+
+    void clear_owner() noexcept {
+        clear(PG_SLAB);
+        clear(PG_PAGECACHE);
+        owner = nullptr;
+    }
+};
+
+static_assert(util::IntrusiveListNodeTrait<Page, &Page::list_head>,
+              "Page fails to be a valid intrusive list node");
+static_assert(sizeof(Page) == 32, "Page 描述符应保持 32 字节");
+
+/**
+ * @brief 物理页描述符表.
+ *
+ * 启动时依据 BootInfo 中的可用区域确定覆盖的页框范围,
+ * 并从最低的足够大的 FREE 区域切出描述符表存储.
+ * 该区域位于引导阶段已建立 KPA 映射的低端内存中.
+ */
+class MemMap {
+private:
+    inline static Page *_pages       = nullptr;
+    inline static size_t _base_pfn   = 0;
+    inline static size_t _page_count = 0;
+    inline static PhyArea _storage{PhyAddr::null, PhyAddr::null};
+
+public:
+    /**
+     * @brief 根据 BootInfo 建立描述符表.
+     *
+     * 必须在任何页交给 RawGFPImpl 之前调用.
+     */
+    static void init();
+
+    [[nodiscard]]
+    static bool initialized() noexcept {
+        return _pages != nullptr;
+    }
+
+    /**
+     * @brief 判断一段物理页是否都有描述符.
+     *
+     * @param addr 起始物理地址
+     * @param page_count 页数
+     * @return true 整段页都在描述符表覆盖范围内
+     */
+    [[nodiscard]]
+    static bool covers(PhyAddr addr, size_t page_count = 1) noexcept {
+        size_t pfn = addr.arith() / PAGESIZE;
+        return _pages != nullptr && pfn >= _base_pfn &&
+               pfn - _base_pfn < _page_count &&
+               page_count <= _page_count - (pfn - _base_pfn);
+    }
+
+    /**
+     * @brief 获取物理页的描述符.
+     *
+     * @param addr 物理地址
+     * @return Page* 所在页的描述符; 不在覆盖范围内时返回 nullptr
+     */
+    [[nodiscard]]
+    static Page *page_of(PhyAddr addr) noexcept {
+        if (!covers(addr)) {
+            return nullptr;
+        }
+        return &_pages[addr.arith() / PAGESIZE - _base_pfn];
+    }
+
+    /**
+     * @brief 获取描述符对应的物理页地址.
+     */
+    [[nodiscard]]
+    static PhyAddr paddr_of(const Page *page) noexcept {
+        return PhyAddr((_base_pfn + static_cast<size_t>(page - _pages)) *
+                       PAGESIZE);
+    }
+
+    /**
+     * @brief 描述符表自身占用的物理区域, 不得交给 RawGFPImpl.
+     */
+    [[nodiscard]]
+    static PhyArea storage_area() noexcept {
+        return _storage;
+    }
+
+    [[nodiscard]]
+    static size_t base_pfn() noexcept {
+        return _base_pfn;
+    }
+
+    [[nodiscard]]
+    static size_t page_count() noexcept {
+        return _page_count;
+    }
+};
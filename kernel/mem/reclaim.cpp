@@ -0,0 +1,183 @@
+/**
+ * @file reclaim.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 内存压力回收
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <env.h>
+#include <logger.h>
+#include <mem/compaction.h>
+#include <mem/gfp.h>
+#include <mem/reclaim.h>
+#include <mem/slub.h>
+#include <mem/vma.h>
+#include <spinlock.h>
+#include <task/scheduler.h>
+#include <task/task.h>
+
+#include <algorithm>
+
+namespace {
+    struct ReclaimState {
+        IShrinker *shrinkers[Reclaim::MAX_SHRINKERS]{};
+        size_t shrinker_count = 0;
+        Reclaim::Stats stats{};
+        SpinLocker lock;
+    };
+
+    ReclaimState reclaim_state;
+
+    /**
+     * @brief 匿名页: 把冷页换出到 zram.
+     */
+    class AnonShrinker final : public IShrinker {
+    public:
+        [[nodiscard]]
+        const char *name() const noexcept override {
+            return "anon";
+        }
+
+        [[nodiscard]]
+        size_t count() noexcept override {
+            return env::inst().system_memory_info().anon_pages;
+        }
+
+        size_t scan(size_t nr) noexcept override {
+            return TaskMemoryManager::reclaim(nr);
+        }
+    };
+
+    AnonShrinker anon_shrinker;
+
+    void add_reclaimed(size_t reclaimed) noexcept {
+        IrqSaveGuardedLock guard(reclaim_state.lock);
+        reclaim_state.stats.reclaimed += reclaimed;
+    }
+
+    void kreclaimd(void *) {
+        auto *self = schd::Scheduler::inst().current_tcb();
+        while (true) {
+            if (Reclaim::free_pages() < Reclaim::low_watermark()) {
+                {
+                    IrqSaveGuardedLock guard(reclaim_state.lock);
+                    reclaim_state.stats.background_runs++;
+                }
+                // 回收到高水位为止, 各 shrinker 都无可回收时放弃本轮
+                while (Reclaim::free_pages() < Reclaim::high_watermark()) {
+                    if (Reclaim::shrink(Reclaim::BATCH) == 0) {
+                        break;
+                    }
+                    schd::Scheduler::inst().yield();
+                }
+            }
+            // 回收之后空闲页最多, 此时整理最容易拼出高阶块
+            Compaction::background();
+            auto sleep_res = task::block_current_for_nanosleep(
+                util::nnullforce(self), Reclaim::POLL_INTERVAL_NS);
+            if (!sleep_res.has_value()) {
+                loggers::MEMORY::ERROR("kreclaimd 休眠失败: %s",
+                                       to_cstring(sleep_res.error()));
+                schd::Scheduler::inst().yield();
+            }
+        }
+    }
+}  // namespace
+
+Result<void> Reclaim::register_shrinker(IShrinker &shrinker) noexcept {
+    IrqSaveGuardedLock guard(reclaim_state.lock);
+    if (reclaim_state.shrinker_count == MAX_SHRINKERS) {
+        unexpect_return(ErrCode::OUT_OF_BOUNDARY);
+    }
+    reclaim_state.shrinkers[reclaim_state.shrinker_count++] = &shrinker;
+    void_return();
+}
+
+size_t Reclaim::free_pages() noexcept {
+    // 与 /proc/meminfo 的 MemFree 口径一致
+    return BuddyAllocator::free_pages() + GFP::pcp_pages() +
+           GFP::zero_pool_pages();
+}
+
+size_t Reclaim::low_watermark() noexcept {
+    return env::inst().system_memory_info().mem_total_pages / LOW_RATIO;
+}
+
+size_t Reclaim::high_watermark() noexcept {
+    return low_watermark() * 2;
+}
+
+size_t Reclaim::shrink(size_t nr) noexcept {
+    // shrinker 只增不减, 拷贝一份后即可在锁外调用
+    IShrinker *shrinkers[MAX_SHRINKERS];
+    size_t shrinker_count;
+    {
+        IrqSaveGuardedLock guard(reclaim_state.lock);
+        shrinker_count = reclaim_state.shrinker_count;
+        for (size_t i = 0; i < shrinker_count; ++i) {
+            shrinkers[i] = reclaim_state.shrinkers[i];
+        }
+    }
+
+    size_t counts[MAX_SHRINKERS];
+    size_t total = 0;
+    for (size_t i = 0; i < shrinker_count; ++i) {
+        counts[i]  = shrinkers[i]->count();
+        total     += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    size_t reclaimed = 0;
+    for (size_t i = 0; i < shrinker_count; ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        // 份额向上取整, 小缓存也能被收缩
+        size_t share = (nr * counts[i] + total - 1) / total;
+        share        = std::min(share, counts[i]);
+        size_t freed = shrinkers[i]->scan(share);
+        if (freed != 0) {
+            loggers::MEMORY::DEBUG("Reclaim::shrink: %s share=%lu freed=%lu",
+                                   shrinkers[i]->name(), share, freed);
+        }
+        reclaimed += freed;
+    }
+    add_reclaimed(reclaimed);
+    return reclaimed;
+}
+
+bool Reclaim::direct_reclaim() noexcept {
+    {
+        IrqSaveGuardedLock guard(reclaim_state.lock);
+        reclaim_state.stats.direct_runs++;
+    }
+    return shrink(BATCH) != 0;
+}
+
+Result<void> Reclaim::start() noexcept {
+    auto register_res = register_shrinker(anon_shrinker);
+    propagate(register_res);
+    auto slab_res = slub::register_shrinker();
+    propagate(slab_res);
+
+    auto thread_res = task::TaskManager::inst().create_kernel_thread(
+        kreclaimd, nullptr, schd::ClassType::RR);
+    propagate(thread_res);
+    if (!schd::Scheduler::inst().wakeup_new(thread_res.value().get())) {
+        unexpect_return(ErrCode::FAILURE);
+    }
+    loggers::MEMORY::INFO("kreclaimd 已启动: low=%lu high=%lu pages",
+                          low_watermark(), high_watermark());
+    void_return();
+}
+
+Reclaim::Stats Reclaim::get_stats() noexcept {
+    IrqSaveGuardedLock guard(reclaim_state.lock);
+    return reclaim_state.stats;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file reclaim.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 内存压力回收
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+
+/**
+ * @brief 可回收缓存的回收回调.
+ *
+ * 各缓存不再自设容量上限, 而是向 Reclaim 登记一个 shrinker,
+ * 空闲内存跌破水位时按各自的可回收对象数成比例地被要求收缩.
+ * 实现必须是静态生存期的对象, 登记后不会被注销.
+ */
+class IShrinker {
+public:
+    virtual ~IShrinker() = default;
+
+    [[nodiscard]]
+    virtual const char *name() const noexcept = 0;
+
+    /**
+     * @brief 估计当前可回收的对象数, 只作为分配回收份额的权重.
+     */
+    [[nodiscard]]
+    virtual size_t count() noexcept = 0;
+
+    /**
+     * @brief 回收至多 nr 个对象.
+     *
+     * 可能回写脏数据并让出 CPU, 调用方不得持有自旋锁.
+     *
+     * @return 实际回收的对象数
+     */
+    virtual size_t scan(size_t nr) noexcept = 0;
+};
+
+/**
+ * @brief 以 buddy 空闲页为水位驱动的回收框架.
+ *
+ * kreclaimd 线程周期性检查空闲页, 跌破低水位后持续回收到高水位;
+ * 分配失败的路径可调用 direct_reclaim 同步回收一批后重试.
+ */
+class Reclaim {
+public:
+    /// 空闲页低于总页数的 1/LOW_RATIO 时开始后台回收,
+    /// 回到该水位的两倍以上时停止
+    static constexpr size_t LOW_RATIO = 32;
+    /// 每轮回收向全部 shrinker 请求的对象总数
+    static constexpr size_t BATCH = 32;
+    /// 可登记的 shrinker 数上限
+    static constexpr size_t MAX_SHRINKERS = 8;
+    /// kreclaimd 检查水位的周期
+    static constexpr size_t POLL_INTERVAL_NS = 100'000'000;
+
+    /**
+     * @brief 统计信息的快照.
+     */
+    struct Stats {
+        /// kreclaimd 因跌破低水位而开始回收的次数
+        size_t background_runs;
+        /// 分配失败触发的直接回收次数
+        size_t direct_runs;
+        /// 累计回收的对象数
+        size_t reclaimed;
+    };
+
+    [[nodiscard]]
+    static Result<void> register_shrinker(IShrinker &shrinker) noexcept;
+
+    /**
+     * @brief 可立即分配的页数: buddy 空闲页加上各级页缓存池.
+     */
+    [[nodiscard]]
+    static size_t free_pages() noexcept;
+    [[nodiscard]]
+    static size_t low_watermark() noexcept;
+    [[nodiscard]]
+    static size_t high_watermark() noexcept;
+
+    /**
+     * @brief 按可回收对象数的比例向各 shrinker 分摊 nr 个对象的回收.
+     *
+     * @return 实际回收的对象数
+     */
+    static size_t shrink(size_t nr) noexcept;
+
+    /**
+     * @brief 分配失败时同步回收一批.
+     *
+     * @return true 回收到了对象, 值得重试分配
+     */
+    static bool direct_reclaim() noexcept;
+
+    /**
+     * @brief 创建 kreclaimd 线程, 须在调度器启动后调用.
+     */
+    [[nodiscard]]
+    static Result<void> start() noexcept;
+
+    [[nodiscard]]
+    static Stats get_stats() noexcept;
+};
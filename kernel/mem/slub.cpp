@@ -10,24 +10,153 @@
  *
  */
 
+#include <env.h>
+#include <mem/reclaim.h>
 #include <mem/slub.h>
 
 namespace slub {
+    namespace {
+        struct CacheRegistry {
+            ISlabCache *caches[MAX_SLAB_CACHES]{};
+            size_t count = 0;
+            SpinLocker lock;
+        };
+
+        CacheRegistry cache_registry;
+
+        /**
+         * @brief 弹匣中的对象归还后可能空出的 slab 数, 按整 slab 向上取整估算.
+         */
+        [[nodiscard]]
+        size_t cached_slabs(const SlubStats &stats) {
+            if (stats.objects_cached == 0 || stats.objects_per_slab == 0) {
+                return 0;
+            }
+            return (stats.objects_cached + stats.objects_per_slab - 1) /
+                   stats.objects_per_slab;
+        }
+
+        struct CacheList {
+            ISlabCache *caches[MAX_SLAB_CACHES]{};
+            size_t count = 0;
+        };
+
+        /**
+         * @brief 在锁内复制登记表, 之后的 drain/shrink 在锁外进行.
+         *
+         * 具名缓存随所属子系统常驻, 不会在回收途中注销.
+         */
+        [[nodiscard]]
+        CacheList snapshot_caches() {
+            CacheList list{};
+            IrqSaveGuardedLock guard(cache_registry.lock);
+            list.count = cache_registry.count;
+            for (size_t i = 0; i < list.count; i++) {
+                list.caches[i] = cache_registry.caches[i];
+            }
+            return list;
+        }
+
+        /**
+         * @brief 空 slab: 先收缩 kmalloc 各尺寸类, 再收缩具名缓存.
+         *
+         * count 只读统计, 把弹匣中可能空出的 slab 一并计入;
+         * 真正归还弹匣与释放 slab 都在 scan 中、登记表锁外完成.
+         */
+        class SlabShrinker final : public IShrinker {
+        public:
+            [[nodiscard]]
+            const char *name() const noexcept override {
+                return "slab";
+            }
+
+            [[nodiscard]]
+            size_t count() noexcept override {
+                auto kmalloc = SlubMalloc::INSTANCE().get_stats();
+                size_t total = 0;
+                for (const auto &cls : kmalloc.classes) {
+                    total += cls.slab.empty_slabs + cached_slabs(cls.slab);
+                }
+                CacheList list = snapshot_caches();
+                for (size_t i = 0; i < list.count; i++) {
+                    SlubStats stats  = list.caches[i]->get_stats();
+                    total           += stats.empty_slabs + cached_slabs(stats);
+                }
+                return total;
+            }
+
+            size_t scan(size_t nr) noexcept override {
+                // shrink 会先归还各 hart 的弹匣
+                size_t released = SlubMalloc::INSTANCE().shrink(nr);
+                CacheList list  = snapshot_caches();
+                for (size_t i = 0; i < list.count && released < nr; i++) {
+                    released += list.caches[i]->shrink(nr - released);
+                }
+                return released;
+            }
+        };
+
+        SlabShrinker slab_shrinker;
+    }  // namespace
+
     Storage<SlubMalloc> SlubMalloc::_INSTANCE_STORAGE;
-    Storage<LockedObject<IrqSaveGuardedLock, SlubMalloc>>
-        SlubMalloc::_INSTANCE_LOCKED_STORAGE;
     bool SlubMalloc::_initialized = false;
-    Slub<SlubMalloc::AllocRecord> *SlubMalloc::AllocRecord::ALLOC_RECORD_SLUB =
+    Slub<SlubMalloc::LargeRecord> *SlubMalloc::LargeRecord::LARGE_RECORD_SLUB =
         nullptr;
 
-    void *SlubMalloc::AllocRecord::operator new(size_t sz) {
-        assert(sz == sizeof(AllocRecord));
-        assert(ALLOC_RECORD_SLUB != nullptr);
-        return ALLOC_RECORD_SLUB->alloc();
+    size_t current_hart_slot() {
+        if (env::hart_ctx == nullptr) {
+            return NO_HART;
+        }
+        return env::hart_ctx->hart_id();
+    }
+
+    void register_cache(ISlabCache *cache) {
+        IrqSaveGuardedLock guard(cache_registry.lock);
+        if (cache_registry.count == MAX_SLAB_CACHES) {
+            loggers::SLUB::WARN("具名缓存过多, %s 不会出现在 slabinfo 中",
+                                cache->name());
+            return;
+        }
+        cache_registry.caches[cache_registry.count++] = cache;
+    }
+
+    void unregister_cache(ISlabCache *cache) {
+        IrqSaveGuardedLock guard(cache_registry.lock);
+        for (size_t i = 0; i < cache_registry.count; i++) {
+            if (cache_registry.caches[i] == cache) {
+                cache_registry.caches[i] =
+                    cache_registry.caches[--cache_registry.count];
+                cache_registry.caches[cache_registry.count] = nullptr;
+                return;
+            }
+        }
+    }
+
+    std::vector<SlabCacheInfo> cache_snapshot() {
+        // 在锁外预留空间, 避免持锁时进入 kmalloc
+        std::vector<SlabCacheInfo> infos;
+        infos.reserve(MAX_SLAB_CACHES);
+        IrqSaveGuardedLock guard(cache_registry.lock);
+        for (size_t i = 0; i < cache_registry.count; i++) {
+            infos.push_back({.name  = cache_registry.caches[i]->name(),
+                             .stats = cache_registry.caches[i]->get_stats()});
+        }
+        return infos;
+    }
+
+    Result<void> register_shrinker() {
+        return Reclaim::register_shrinker(slab_shrinker);
+    }
+
+    void *SlubMalloc::LargeRecord::operator new(size_t sz) {
+        assert(sz == sizeof(LargeRecord));
+        assert(LARGE_RECORD_SLUB != nullptr);
+        return LARGE_RECORD_SLUB->alloc();
     }
 
-    void SlubMalloc::AllocRecord::operator delete(void *ptr) {
-        assert(ALLOC_RECORD_SLUB != nullptr);
-        ALLOC_RECORD_SLUB->free(static_cast<AllocRecord *>(ptr));
+    void SlubMalloc::LargeRecord::operator delete(void *ptr) {
+        assert(LARGE_RECORD_SLUB != nullptr);
+        LARGE_RECORD_SLUB->free(static_cast<LargeRecord *>(ptr));
     }
 }  // namespace slub
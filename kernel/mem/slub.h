@@ -12,6 +12,12 @@
 
 #pragma once
 
+#include <arch/description.h>
+#if defined(__ARCH_riscv64__)
+#include <arch/riscv64/ctxlayout.h>
+#elif defined(__ARCH_loongarch64__)
+#include <arch/loongarch64/ctxlayout.h>
+#endif
 #include <driver/int/guard.h>
 #include <guard.h>
 #include <logger.h>
@@ -21,8 +27,10 @@
 #include <storage.h>
 #include <sus/list.h>
 #include <sustcore/addr.h>
+#include <sustcore/errcode.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -30,6 +38,7 @@
 #include <new>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace slub {
     template <typename ObjType>
@@ -40,11 +49,58 @@ namespace slub {
     constexpr size_t ALIGN          = 16;
     constexpr int SLAB_KMAX         = 2048;
 
+    // 每个缓存默认保留的空 slab 数, 超出的空 slab 立即归还 GFP
+    constexpr size_t EMPTY_SLAB_LIMIT = 2;
+
     struct SlubStats {
         size_t total_slabs;
         size_t objects_inuse;
         size_t objects_total;
         size_t memory_usage_bytes;
+        size_t objects_per_slab;
+        // 暂存在各 hart 弹匣中的空闲对象, 不计入 objects_inuse
+        size_t objects_cached;
+        // 单个对象的请求大小, 与 objects_inuse 一起估算浪费的字节数
+        size_t object_size;
+        size_t empty_slabs;
+        size_t partial_slabs;
+        size_t full_slabs;
+        // 累计归还 GFP 的 slab 数
+        size_t released_slabs;
+    };
+
+    /**
+     * @brief kmalloc 的 slab 尺寸类.
+     *
+     * 在相邻 2 的幂之间插入 1.5 倍的中间档, 降低非 2 的幂请求的内部碎片.
+     * 超过最后一档的请求按实际页数直接向 GFP 申请.
+     * 2048/3072 档在单页 slab 中只能容纳一个对象, 与整页分配等价, 因此不设.
+     */
+    constexpr size_t KMALLOC_SIZES[] = {8,   16,  32,  64,  96,   128, 192,
+                                        256, 384, 512, 768, 1024, 1536};
+    constexpr size_t KMALLOC_CLASSES =
+        sizeof(KMALLOC_SIZES) / sizeof(KMALLOC_SIZES[0]);
+
+    /**
+     * @brief 单个 kmalloc 尺寸类的统计信息.
+     */
+    struct KmallocClassStats {
+        size_t obj_size;
+        SlubStats slab;
+        // 在用对象数与它们的请求字节数之和, 用于计算该档当前的内部碎片
+        size_t allocs;
+        size_t requested_bytes;
+    };
+
+    /**
+     * @brief kmalloc 统计快照.
+     */
+    struct KmallocStats {
+        KmallocClassStats classes[KMALLOC_CLASSES];
+        // 按页直接分配的大对象
+        size_t large_allocs;
+        size_t large_pages;
+        size_t large_requested_bytes;
     };
 
     void init_chrono_overhead();
@@ -67,6 +123,8 @@ namespace slub {
         void *freelist{};
         size_t inuse{};
         size_t total{};
+        // slab 中单个对象的实际大小, SlubMalloc 释放时据此反查所属尺寸类
+        size_t obj_size{};
         SlabState state{};
 
         SlabHeader()
@@ -74,6 +132,7 @@ namespace slub {
               freelist(nullptr),
               inuse(0),
               total(0),
+              obj_size(0),
               state(SlabState::EMPTY) {}
     };
 
@@ -81,6 +140,20 @@ namespace slub {
         util::IntrusiveListNodeTrait<SlabHeader, &SlabHeader::list_head>,
         "SlabHeader fails to be a valid intrusive list node");
 
+    // slab 固定占一页且以 SlabHeader 开头, 因此 slab 中的对象地址永远不会页对齐
+    static_assert(PAGES_PER_SLAB == 1, "slab_header_of 假定每个 slab 仅占一页");
+
+    /**
+     * @brief 获取 slab 对象所在 slab 的头部.
+     *
+     * @param p slab 中的对象地址
+     * @return SlabHeader* 对象所属 slab 的头部
+     */
+    inline SlabHeader *slab_header_of(void *p) {
+        auto ptr = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<SlabHeader *>(align_down(ptr, SLAB_BYTES));
+    }
+
     template <typename ObjType>
     struct size_of_type : public std::size_constant<sizeof(ObjType)> {};
 
@@ -90,6 +163,16 @@ namespace slub {
     template <typename ObjType>
     concept HugeObjectType = (size_of_type<ObjType>::value >= SLAB_KMAX);
 
+    /**
+     * @brief 需要逐个记录请求大小的对象类型 (kmalloc 尺寸类).
+     *
+     * 这类 slab 在 SlabHeader 之后为每个对象保留一个 uint16_t,
+     * 释放时据此扣减该档的请求字节数.
+     */
+    template <typename ObjType>
+    concept RequestTrackedType =
+        requires { requires static_cast<bool>(ObjType::TRACK_REQUEST); };
+
     template <typename ObjType>
     class Slub {
     protected:
@@ -119,40 +202,105 @@ namespace slub {
 
         static_assert(is_pow2(obj_align_), "obj_align_ must be power-of-two");
 
+        static constexpr size_t request_bytes_ =
+            RequestTrackedType<ObjType> ? sizeof(uint16_t) : 0;
+
+        // 请求表紧跟 SlabHeader, 对象区再按 obj_align_ 对齐,
+        // 对齐最多浪费 obj_align_ - 1 字节
+        constexpr static size_t objs_per_slab_ =
+            request_bytes_ == 0
+                ? (slab_bytes_ - align_up(sizeof(SlabHeader), obj_align_)) /
+                      obj_size_
+                : (slab_bytes_ - sizeof(SlabHeader) - (obj_align_ - 1)) /
+                      (obj_size_ + request_bytes_);
+
+        constexpr static size_t objs_offset_ = align_up(
+            sizeof(SlabHeader) + objs_per_slab_ * request_bytes_, obj_align_);
+
     public:
         Slub() = default;
 
         ObjType *alloc();
         void free(ObjType *ptr);
 
+        /**
+         * @brief 对象在所属 slab 请求表中的槽位.
+         *
+         * @param p 本类型 slab 中的对象地址
+         */
+        [[nodiscard]]
+        static uint16_t &request_slot(void *p)
+            requires RequestTrackedType<ObjType>
+        {
+            auto base = reinterpret_cast<uintptr_t>(slab_header_of(p));
+            size_t idx =
+                (reinterpret_cast<uintptr_t>(p) - base - objs_offset_) /
+                obj_size_;
+            return reinterpret_cast<uint16_t *>(base + sizeof(SlabHeader))[idx];
+        }
+
+        /**
+         * @brief 设置保留的空 slab 数, 超出部分立即归还 GFP.
+         */
+        void set_empty_limit(size_t limit) {
+            empty_limit_ = limit;
+            shrink(limit);
+        }
+
+        [[nodiscard]]
+        size_t empty_limit() const {
+            return empty_limit_;
+        }
+
+        [[nodiscard]]
+        size_t empty_slabs() const {
+            return empty.size();
+        }
+
+        /**
+         * @brief 归还空 slab 直到只剩 keep 个.
+         *
+         * @return size_t 归还的 slab 数
+         */
+        size_t shrink(size_t keep = 0) {
+            size_t released = 0;
+            while (empty.size() > keep) {
+                release_slab(&empty.front());
+                released++;
+            }
+            return released;
+        }
+
         [[nodiscard]]
         SlubStats get_stats() const {
             size_t total_slabs   = partial.size() + full.size() + empty.size();
             size_t objects_total = 0;
             if (total_slabs > 0) {
-                auto base = static_cast<uintptr_t>(0);
-                auto cur  = align_up(base + sizeof(SlabHeader), obj_align_);
-                auto end  = base + slab_bytes_;
-                size_t per_slab = 0;
-                while (cur + obj_size_ <= end) {
-                    per_slab++;
-                    cur += obj_size_;
-                }
-                objects_total = total_slabs * per_slab;
+                objects_total = total_slabs * objs_per_slab_;
             }
             return {.total_slabs=total_slabs,
                     .objects_inuse=inuse_objects_,
                     .objects_total=objects_total,
-                    .memory_usage_bytes=total_slabs * slab_bytes_};
+                    .memory_usage_bytes=total_slabs * slab_bytes_,
+                    .objects_per_slab=objs_per_slab_,
+                    .objects_cached=0,
+                    .object_size=raw_obj_size_,
+                    .empty_slabs=empty.size(),
+                    .partial_slabs=partial.size(),
+                    .full_slabs=full.size(),
+                    .released_slabs=released_slabs_};
         }
 
     private:
         util::IntrusiveList<SlabHeader> partial{};
         util::IntrusiveList<SlabHeader> full{};
         util::IntrusiveList<SlabHeader> empty{};
-        size_t inuse_objects_ = 0;
+        size_t inuse_objects_  = 0;
+        size_t empty_limit_    = EMPTY_SLAB_LIMIT;
+        size_t released_slabs_ = 0;
 
         SlabHeader *new_slab();
+        void release_slab(SlabHeader *slab);
         void init_slab_headers(SlabHeader *slab);
         SlabHeader *slab_of(void *p);
 
@@ -172,6 +320,23 @@ namespace slub {
     public:
         Slub() = default;
 
+        // 大对象释放时直接归还 GFP, 不存在空 slab
+        void set_empty_limit(size_t) {}
+
+        [[nodiscard]]
+        size_t empty_limit() const {
+            return 0;
+        }
+
+        [[nodiscard]]
+        size_t empty_slabs() const {
+            return 0;
+        }
+
+        size_t shrink(size_t = 0) {
+            return 0;
+        }
+
         ObjType *alloc() {
             auto gfp_res = GFP::get_free_page(obj_pages);
             if (!gfp_res.has_value()) {
@@ -202,29 +367,33 @@ namespace slub {
                 .objects_inuse=inuse_objects_,
                 .objects_total=inuse_objects_,
                 .memory_usage_bytes=inuse_objects_ * obj_pages * PAGESIZE,
+                .objects_per_slab=1,
+                .objects_cached=0,
+                .object_size=sizeof(ObjType),
+                .empty_slabs=0,
+                .partial_slabs=0,
+                .full_slabs=inuse_objects_,
+                .released_slabs=0,
             };
         }
     };
 
     template <typename ObjType>
     SlabHeader *Slub<ObjType>::slab_of(void *p) {
-        auto ptr  = reinterpret_cast<uintptr_t>(p);
-        auto base = align_down(ptr, slab_bytes_);
-        return reinterpret_cast<SlabHeader *>(base);
+        return slab_header_of(p);
     }
 
     template <typename ObjType>
     void Slub<ObjType>::init_slab_headers(SlabHeader *slab) {
         auto base       = reinterpret_cast<uintptr_t>(slab);
-        auto slab_start = align_up(base + sizeof(SlabHeader), obj_align_);
+        auto slab_start = base + objs_offset_;
 
-        constexpr size_t total =
-            (slab_bytes_ - align_up(sizeof(SlabHeader), obj_align_)) /
-            obj_size_;
+        constexpr size_t total = objs_per_slab_;
         static_assert(total > 0, "每个 slab 至少应包含一个对象");
 
-        slab->total = total;
-        slab->inuse = 0;
+        slab->total    = total;
+        slab->inuse    = 0;
+        slab->obj_size = obj_size_;
 
         void *head = nullptr;
         for (size_t i = total; i > 0; i--) {
@@ -247,9 +416,24 @@ namespace slub {
         auto kpaddr = convert<KpaAddr>(paddr);
         auto *slab  = new (kpaddr.addr()) SlabHeader{};
         init_slab_headers(slab);
+        if (Page *page = MemMap::page_of(paddr); page != nullptr) {
+            page->set_owner(Page::PG_SLAB, this);
+        }
         return slab;
     }
 
+    template <typename ObjType>
+    void Slub<ObjType>::release_slab(SlabHeader *slab) {
+        assert(slab->state == SlabHeader::SlabState::EMPTY);
+        empty.erase(typename decltype(empty)::iterator(slab));
+        auto paddr = convert<PhyAddr>((KpaAddr)slab);
+        if (Page *page = MemMap::page_of(paddr); page != nullptr) {
+            page->clear_owner();
+        }
+        GFP::put_page(paddr, pages_);
+        released_slabs_++;
+    }
+
     template <typename ObjType>
     void Slub<ObjType>::to_empty(SlabHeader *slab) {
         if (slab->state == SlabHeader::SlabState::PARTIAL) {
@@ -329,6 +513,8 @@ namespace slub {
         inuse_objects_--;
         if (slab_header->inuse == 0) {
             to_empty(slab_header);
+            // 保留最近变空的 slab, 其缓存行更可能仍然是热的
+            shrink(empty_limit_);
         } else if (slab_header->inuse == slab_header->total - 1) {
             to_partial(slab_header);
         }
@@ -343,103 +529,419 @@ namespace slub {
         inner_free(ptr);
     }
 
-    template <size_t sz>
-    class SizedSlub {
+    constexpr size_t MAGAZINE_SIZE  = 16;
+    constexpr size_t MAGAZINE_BATCH = MAGAZINE_SIZE / 2;
+    constexpr size_t NO_HART        = static_cast<size_t>(-1);
+
+    /**
+     * @brief 获取当前 hart 的编号.
+     *
+     * @return size_t hart ID; hart 上下文尚未建立时返回 NO_HART
+     */
+    size_t current_hart_slot();
+
+    /**
+     * @brief 单个 hart 私有的对象弹匣.
+     *
+     * 平时只在关闭抢占的前提下由所属 hart 访问.
+     * busy 是弹匣的占有标记: 同一 hart 上中断处理程序重入, 或其他 hart
+     * 正在 drain 该弹匣时, 所属 hart 抢不到标记, 直接走加锁路径.
+     */
+    struct Magazine {
+        void *objs[MAGAZINE_SIZE]{};
+        size_t count = 0;
+        std::atomic<bool> busy{false};
+    };
+
+    /**
+     * @brief 具名对象缓存的公共接口, 供 slabinfo 与内存回收遍历.
+     */
+    class ISlabCache {
+    public:
+        virtual ~ISlabCache() = default;
+
+        [[nodiscard]]
+        virtual const char *name() const = 0;
+        [[nodiscard]]
+        virtual SlubStats get_stats() const = 0;
+        [[nodiscard]]
+        virtual size_t empty_slabs() const = 0;
+
+        /**
+         * @brief 归还各 hart 弹匣后, 释放至多 nr 个空 slab.
+         *
+         * @return size_t 释放的 slab 数
+         */
+        virtual size_t shrink(size_t nr) = 0;
+    };
+
+    /// 可登记的具名缓存数上限
+    constexpr size_t MAX_SLAB_CACHES = 32;
+
+    struct SlabCacheInfo {
+        const char *name;
+        SlubStats stats;
+    };
+
+    void register_cache(ISlabCache *cache);
+    void unregister_cache(ISlabCache *cache);
+
+    /**
+     * @brief 获取全部具名缓存的统计快照.
+     */
+    [[nodiscard]]
+    std::vector<SlabCacheInfo> cache_snapshot();
+
+    /**
+     * @brief 向内存回收框架登记 slab shrinker.
+     *
+     * 回收时先收缩 kmalloc 各尺寸类, 再收缩具名缓存.
+     */
+    [[nodiscard]]
+    Result<void> register_shrinker();
+
+    /**
+     * @brief 带 per-hart 弹匣的 Slub 缓存.
+     *
+     * 分配与释放优先在当前 hart 的弹匣上完成, 只需关闭抢占;
+     * 弹匣空或满时持锁与 slab 链表成批交换 MAGAZINE_BATCH 个对象.
+     * 大对象每次都要整页分配, 弹匣没有收益, 直接走加锁路径.
+     * 带名字构造的缓存会登记到 slabinfo, 并参与内存压力下的收缩.
+     */
+    template <typename ObjType>
+    class SlubCache : public ISlabCache {
     private:
-        class Object {
-            char data[sz];
-        };
+        const char *_name = nullptr;
+        Storage<Slub<ObjType>> _raw_slub;
+        Storage<LockedObject<IrqSaveGuardedLock, Slub<ObjType>>> _slub_storage;
+        Magazine _magazines[MAX_HARTS]{};
 
-        Storage<Slub<Object>> _raw_slub;
-        Storage<LockedObject<IrqSaveGuardedLock, Slub<Object>>> _slub_storage;
+        [[nodiscard]]
+        LockedObject<IrqSaveGuardedLock, Slub<ObjType>> &slub() {
+            return _slub_storage.ref();
+        }
 
         [[nodiscard]]
-        LockedObject<IrqSaveGuardedLock, Slub<Object>> &slub() {
+        const LockedObject<IrqSaveGuardedLock, Slub<ObjType>> &slub() const {
             return _slub_storage.ref();
         }
 
+        /**
+         * @brief 占用当前 hart 的弹匣.
+         *
+         * @return Magazine* 当前 hart 的弹匣; 无 hart 上下文或发生重入时返回 nullptr
+         */
+        Magazine *acquire_magazine() {
+            size_t hart = current_hart_slot();
+            if (hart >= MAX_HARTS) {
+                return nullptr;
+            }
+            Magazine *mag = &_magazines[hart];
+            if (mag->busy.exchange(true, std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return mag;
+        }
+
+        static void release_magazine(Magazine *mag) {
+            mag->busy.store(false, std::memory_order_release);
+        }
+
+        /**
+         * @brief 从 slab 链表成批取出对象填充弹匣.
+         */
+        void refill(Magazine &mag) {
+            auto handle = slub().get();
+            while (mag.count < MAGAZINE_BATCH) {
+                void *obj = handle->alloc();
+                if (obj == nullptr) {
+                    return;
+                }
+                mag.objs[mag.count++] = obj;
+            }
+        }
+
+        /**
+         * @brief 将弹匣底部 n 个对象成批归还 slab 链表.
+         *
+         * 底部是最早放入的对象, 顶部保留最近释放、更可能仍在缓存中的对象.
+         */
+        void flush(Magazine &mag, size_t n) {
+            n = std::min(n, mag.count);
+            {
+                auto handle = slub().get();
+                for (size_t i = 0; i < n; i++) {
+                    handle->free(static_cast<ObjType *>(mag.objs[i]));
+                }
+            }
+            for (size_t i = n; i < mag.count; i++) {
+                mag.objs[i - n] = mag.objs[i];
+            }
+            mag.count -= n;
+        }
+
     public:
-        SizedSlub() {
-            static_assert(is_pow2(sz));
+        SlubCache() {
             _raw_slub.construct();
             _slub_storage.construct(_raw_slub.get());
         }
 
-        void *malloc() {
-            return static_cast<void *>(slub().get()->alloc());
+        explicit SlubCache(const char *name) : SlubCache() {
+            _name = name;
+            register_cache(this);
         }
 
-        void free(void *ptr) {
-            slub().get()->free(static_cast<Object *>(ptr));
+        ~SlubCache() override {
+            if (_name != nullptr) {
+                unregister_cache(this);
+            }
+        }
+
+        SlubCache(const SlubCache &)            = delete;
+        SlubCache &operator=(const SlubCache &) = delete;
+
+        ObjType *alloc() {
+            if constexpr (HugeObjectType<ObjType>) {
+                return slub().get()->alloc();
+            }
+
+            PreemptGuard guard;
+            guard.enter();
+
+            Magazine *mag = acquire_magazine();
+            if (mag == nullptr) {
+                return slub().get()->alloc();
+            }
+
+            if (mag->count == 0) {
+                refill(*mag);
+            }
+            ObjType *obj = nullptr;
+            if (mag->count > 0) {
+                obj = static_cast<ObjType *>(mag->objs[--mag->count]);
+            }
+            release_magazine(mag);
+            return obj;
+        }
+
+        void free(ObjType *ptr) {
+            if (!ptr) {
+                loggers::SLUB::WARN("can't free null pointer");
+                return;
+            }
+            if constexpr (HugeObjectType<ObjType>) {
+                slub().get()->free(ptr);
+                return;
+            }
+
+            PreemptGuard guard;
+            guard.enter();
+
+            Magazine *mag = acquire_magazine();
+            if (mag == nullptr) {
+                slub().get()->free(ptr);
+                return;
+            }
+
+            if (mag->count == MAGAZINE_SIZE) {
+                flush(*mag, MAGAZINE_BATCH);
+            }
+            mag->objs[mag->count++] = ptr;
+            release_magazine(mag);
+        }
+
+        /**
+         * @brief 将所有 hart 弹匣中的对象归还 slab 链表.
+         *
+         * 逐个抢占弹匣的 busy 标记后代为清空; 所属 hart 此时正在使用的
+         * 弹匣本次跳过, 其中至多 MAGAZINE_SIZE 个对象留待下次回收.
+         */
+        void drain() {
+            PreemptGuard guard;
+            guard.enter();
+
+            for (auto &mag : _magazines) {
+                if (mag.busy.exchange(true, std::memory_order_acquire)) {
+                    continue;
+                }
+                if (mag.count > 0) {
+                    flush(mag, mag.count);
+                }
+                release_magazine(&mag);
+            }
+        }
+
+        [[nodiscard]]
+        const char *name() const override {
+            return _name;
+        }
+
+        /**
+         * @brief 设置保留的空 slab 数, 超出部分立即归还 GFP.
+         */
+        void set_empty_limit(size_t limit) {
+            slub().get()->set_empty_limit(limit);
+        }
+
+        [[nodiscard]]
+        size_t empty_slabs() const override {
+            return slub().get()->empty_slabs();
+        }
+
+        size_t shrink(size_t nr) override {
+            drain();
+            auto handle  = slub().get();
+            size_t empty = handle->empty_slabs();
+            return handle->shrink(empty > nr ? empty - nr : 0);
+        }
+
+        /**
+         * @brief 获取统计信息.
+         *
+         * 其他 hart 的弹匣计数未加同步, 仅作为近似值.
+         */
+        [[nodiscard]]
+        SlubStats get_stats() const override {
+            SlubStats stats = slub().get()->get_stats();
+            size_t cached   = 0;
+            for (const auto &mag : _magazines) {
+                cached += mag.count;
+            }
+            stats.objects_cached = cached;
+            stats.objects_inuse -= std::min(cached, stats.objects_inuse);
+            return stats;
         }
     };
 
-    class SlubMalloc {
+    template <size_t sz>
+    class SizedSlub {
     private:
-        static constexpr size_t KMAX = 2048;
-        static constexpr size_t KMIN = 8;
+        class Object {
+        public:
+            static constexpr bool TRACK_REQUEST = true;
+
+        private:
+            char data[sz];
+        };
 
-        struct AllocRecord {
+        SlubCache<Object> _cache{};
+
+    public:
+        SizedSlub() {
+            static_assert(sz % sizeof(void *) == 0,
+                          "slab 对象大小必须按指针大小对齐");
+            static_assert(sz <= UINT16_MAX, "请求大小须能放入 uint16_t");
+        }
+
+        void *malloc(size_t request) {
+            Object *obj = _cache.alloc();
+            if (obj != nullptr) {
+                Slub<Object>::request_slot(obj) =
+                    static_cast<uint16_t>(request);
+            }
+            return static_cast<void *>(obj);
+        }
+
+        /**
+         * @return size_t 该对象分配时的请求大小
+         */
+        size_t free(void *ptr) {
+            size_t request = Slub<Object>::request_slot(ptr);
+            _cache.free(static_cast<Object *>(ptr));
+            return request;
+        }
+
+        void drain() {
+            _cache.drain();
+        }
+
+        [[nodiscard]]
+        size_t empty_slabs() const {
+            return _cache.empty_slabs();
+        }
+
+        size_t shrink(size_t nr) {
+            return _cache.shrink(nr);
+        }
+
+        [[nodiscard]]
+        SlubStats get_stats() const {
+            return _cache.get_stats();
+        }
+    };
+
+    class SlubMalloc {
+    private:
+        static constexpr size_t KMAX = KMALLOC_SIZES[KMALLOC_CLASSES - 1];
+        static constexpr size_t KMIN = KMALLOC_SIZES[0];
+
+        /**
+         * @brief 大对象分配记录.
+         *
+         * 小对象的尺寸由所在 slab 的 SlabHeader 给出;
+         * 大对象直接来自 GFP, 首地址页对齐, 需要额外记录页数.
+         * 记录按页框号散列到 _large_records 的桶中, 查找期望 O(1).
+         */
+        struct LargeRecord {
             void *ptr;
-            size_t size;
-            util::ListHead<AllocRecord> list_head{};
-            static Slub<AllocRecord> *ALLOC_RECORD_SLUB;
+            size_t pages;
+            size_t bytes;
+            util::ListHead<LargeRecord> list_head{};
+            static Slub<LargeRecord> *LARGE_RECORD_SLUB;
 
-            constexpr AllocRecord(void *ptr, size_t size)
-                : ptr(ptr), size(size) {}
-            constexpr AllocRecord() : AllocRecord(nullptr, 0) {}
+            constexpr LargeRecord(void *ptr, size_t pages, size_t bytes)
+                : ptr(ptr), pages(pages), bytes(bytes) {}
+            constexpr LargeRecord() : LargeRecord(nullptr, 0, 0) {}
 
             void *operator new(size_t sz);
             void operator delete(void *ptr);
         };
 
+        static constexpr size_t LARGE_RECORD_BUCKETS = 256;
+
         SizedSlub<8> _slub8{};
         SizedSlub<16> _slub16{};
         SizedSlub<32> _slub32{};
         SizedSlub<64> _slub64{};
+        SizedSlub<96> _slub96{};
         SizedSlub<128> _slub128{};
+        SizedSlub<192> _slub192{};
         SizedSlub<256> _slub256{};
+        SizedSlub<384> _slub384{};
         SizedSlub<512> _slub512{};
+        SizedSlub<768> _slub768{};
         SizedSlub<1024> _slub1024{};
-        SizedSlub<2048> _slub2048{};
+        SizedSlub<1536> _slub1536{};
+
+        Slub<LargeRecord> _large_record_slub{};
+        util::IntrusiveList<LargeRecord> _large_records[LARGE_RECORD_BUCKETS]{};
+
+        // 小对象路径由各尺寸类的 SlubCache 自行同步, 这里只需原子计数
+        std::atomic<size_t> _class_allocs[KMALLOC_CLASSES]{};
+        std::atomic<size_t> _class_requested_bytes[KMALLOC_CLASSES]{};
 
-        Slub<AllocRecord> _alloc_record_slub{};
-        util::IntrusiveList<AllocRecord> _alloc_records{};
+        // 保护大对象记录表与大对象统计
+        mutable SpinLocker _large_lock{};
+        size_t _large_allocs          = 0;
+        size_t _large_pages           = 0;
+        size_t _large_requested_bytes = 0;
 
         static Storage<SlubMalloc> _INSTANCE_STORAGE;
-        static Storage<LockedObject<IrqSaveGuardedLock, SlubMalloc>>
-            _INSTANCE_LOCKED_STORAGE;
         static bool _initialized;
 
+        /**
+         * @brief 获取能容纳 sz 字节的最小尺寸类下标.
+         *
+         * @param sz 请求大小, 不得超过 KMAX
+         * @return size_t KMALLOC_SIZES 中的下标
+         */
         [[nodiscard]]
-        bool contains_small_size(size_t sz) const {
-            switch (sz) {
-                case 8:
-                case 16:
-                case 32:
-                case 64:
-                case 128:
-                case 256:
-                case 512:
-                case 1024:
-                case 2048: return true;
-                default:   return false;
-            }
-        }
-
-        [[nodiscard]]
-        static size_t up2pow(size_t n) {
-            n--;
-            n |= n >> 1;
-            n |= n >> 2;
-            n |= n >> 4;
-            n |= n >> 8;
-            n |= n >> 16;
-            if constexpr (sizeof(size_t) == 8) {
-                n |= n >> 32;
+        static constexpr size_t class_index(size_t sz) {
+            size_t idx = 0;
+            while (KMALLOC_SIZES[idx] < sz) {
+                idx++;
             }
-            n++;
-            return n;
+            return idx;
         }
 
         [[nodiscard]]
@@ -448,117 +950,185 @@ namespace slub {
                             (rsz + PAGESIZE - 1) / PAGESIZE);
         }
 
-        bool add_record(void *ptr, size_t rsz) {
-            auto *record  = new AllocRecord(ptr, rsz);
-            size_t before = _alloc_records.size();
-            auto inserted = _alloc_records.insert(_alloc_records.end(), *record);
-            size_t after  = _alloc_records.size();
-            if (inserted == _alloc_records.end()) {
-                loggers::MEMORY::ERROR(
-                    "无法记录分配: ptr=%p size=%u record=%p (size before=%lu after=%lu)",
-                    ptr, static_cast<unsigned int>(rsz), record,
-                    (unsigned long)before, (unsigned long)after);
-                delete record;
-                return false;
-            }
-            return true;
+        /**
+         * @brief 判断指针是否来自大对象路径.
+         *
+         * slab 对象之前总有 SlabHeader, 永远不会页对齐;
+         * 大对象直接由 GFP 分配, 总是页对齐.
+         */
+        [[nodiscard]]
+        static bool is_large_object(void *ptr) {
+            auto addr = reinterpret_cast<uintptr_t>(ptr);
+            return align_down(addr, PAGESIZE) == addr;
+        }
+
+        [[nodiscard]]
+        util::IntrusiveList<LargeRecord> &large_bucket(void *ptr) {
+            auto pfn = reinterpret_cast<uintptr_t>(ptr) / PAGESIZE;
+            return _large_records[pfn % LARGE_RECORD_BUCKETS];
         }
 
-        AllocRecord *get_record(void *ptr) {
-            size_t checked = 0;
-            for (auto &rec : _alloc_records) {
-                checked++;
+        LargeRecord *find_large_record(void *ptr) {
+            for (auto &rec : large_bucket(ptr)) {
                 if (rec.ptr == ptr) {
                     return &rec;
                 }
             }
-            auto sz = _alloc_records.size();
-            if (sz != checked) {
-                loggers::MEMORY::INFO(
-                    "alloc_records size mismatch: expected=%lu iterated=%lu",
-                    (unsigned long)sz, (unsigned long)checked);
-            }
             return nullptr;
         }
 
-        void remove_record(AllocRecord *record) {
-            size_t before = _alloc_records.size();
-            _alloc_records.remove(*record);
-            size_t after = _alloc_records.size();
-            if (before == after) {
-                loggers::MEMORY::ERROR(
-                    "remove_record: record=%p NOT found in list (size=%lu)",
-                    (void *)record, (unsigned long)before);
-            }
-            delete record;
-        }
-
-        void *large_malloc(size_t rsz) {
+        /**
+         * @brief 按实际页数分配大对象, 不再向上取整到 2 的幂.
+         *
+         * 页框在锁外取得与归还; _large_lock 覆盖记录的分配释放、记录表与统计.
+         */
+        void *large_malloc(size_t sz) {
             loggers::MEMORY::DEBUG("转交到large_malloc途径分配");
-            assert(is_pow2(rsz));
-            const size_t pages = get_pages(rsz);
+            const size_t pages = get_pages(sz);
             auto gfp_res       = GFP::get_free_page(pages);
             if (!gfp_res.has_value()) {
                 loggers::SLUB::ERROR("无法分配大对象内存");
                 return nullptr;
             }
-            return convert<KpaAddr>(gfp_res.value()).addr();
+            void *ptr = convert<KpaAddr>(gfp_res.value()).addr();
+            {
+                // 记录来自无锁的 Slub<LargeRecord>, 分配与登记都要在锁内完成
+                IrqSaveGuardedLock guard(_large_lock);
+                auto *record = new LargeRecord(ptr, pages, sz);
+                if (record != nullptr) {
+                    large_bucket(ptr).push_back(*record);
+                    _large_allocs++;
+                    _large_pages           += pages;
+                    _large_requested_bytes += sz;
+                    return ptr;
+                }
+            }
+            loggers::SLUB::ERROR("无法分配大对象记录");
+            GFP::put_page(gfp_res.value(), pages);
+            return nullptr;
+        }
+
+        void large_free(void *ptr) {
+            size_t pages = 0;
+            {
+                IrqSaveGuardedLock guard(_large_lock);
+                auto *record = find_large_record(ptr);
+                if (record == nullptr) {
+                    loggers::MEMORY::ERROR("未查询到大对象%p的分配记录", ptr);
+                    return;
+                }
+                auto &bucket = large_bucket(ptr);
+                bucket.erase(
+                    typename util::IntrusiveList<LargeRecord>::iterator(record));
+                pages                   = record->pages;
+                _large_allocs--;
+                _large_pages           -= record->pages;
+                _large_requested_bytes -= record->bytes;
+                delete record;
+            }
+            // 记录已摘除, 其余线程无法再找到该对象, 可以在锁外归还页框
+            GFP::put_page(convert<PhyAddr>((KpaAddr)ptr), pages);
         }
 
-        void *small_malloc(size_t rsz) {
-            assert(contains_small_size(rsz));
-            switch (rsz) {
-                case 8:    return _slub8.malloc();
-                case 16:   return _slub16.malloc();
-                case 32:   return _slub32.malloc();
-                case 64:   return _slub64.malloc();
-                case 128:  return _slub128.malloc();
-                case 256:  return _slub256.malloc();
-                case 512:  return _slub512.malloc();
-                case 1024: return _slub1024.malloc();
-                case 2048: return _slub2048.malloc();
+        void *small_malloc(size_t idx, size_t sz) {
+            switch (KMALLOC_SIZES[idx]) {
+                case 8:    return _slub8.malloc(sz);
+                case 16:   return _slub16.malloc(sz);
+                case 32:   return _slub32.malloc(sz);
+                case 64:   return _slub64.malloc(sz);
+                case 96:   return _slub96.malloc(sz);
+                case 128:  return _slub128.malloc(sz);
+                case 192:  return _slub192.malloc(sz);
+                case 256:  return _slub256.malloc(sz);
+                case 384:  return _slub384.malloc(sz);
+                case 512:  return _slub512.malloc(sz);
+                case 768:  return _slub768.malloc(sz);
+                case 1024: return _slub1024.malloc(sz);
+                case 1536: return _slub1536.malloc(sz);
                 default:
-                    loggers::SLUB::ERROR("不支持的对象大小: %d", rsz);
+                    loggers::SLUB::ERROR("不支持的对象大小: %d",
+                                         KMALLOC_SIZES[idx]);
                     return nullptr;
             }
         }
 
-        void free_inner(void *ptr, size_t rsz) {
-            if (rsz >= KMAX) {
-                auto pages = get_pages(rsz);
-                GFP::put_page(convert<PhyAddr>((KpaAddr)ptr), pages);
-                return;
-            }
-
-            assert(contains_small_size(rsz));
+        /**
+         * @return size_t 对象分配时的请求大小
+         */
+        Result<size_t> small_free(void *ptr, size_t rsz) {
             switch (rsz) {
-                case 8:    _slub8.free(ptr); return;
-                case 16:   _slub16.free(ptr); return;
-                case 32:   _slub32.free(ptr); return;
-                case 64:   _slub64.free(ptr); return;
-                case 128:  _slub128.free(ptr); return;
-                case 256:  _slub256.free(ptr); return;
-                case 512:  _slub512.free(ptr); return;
-                case 1024: _slub1024.free(ptr); return;
-                case 2048: _slub2048.free(ptr); return;
+                case 8:    return _slub8.free(ptr);
+                case 16:   return _slub16.free(ptr);
+                case 32:   return _slub32.free(ptr);
+                case 64:   return _slub64.free(ptr);
+                case 96:   return _slub96.free(ptr);
+                case 128:  return _slub128.free(ptr);
+                case 192:  return _slub192.free(ptr);
+                case 256:  return _slub256.free(ptr);
+                case 384:  return _slub384.free(ptr);
+                case 512:  return _slub512.free(ptr);
+                case 768:  return _slub768.free(ptr);
+                case 1024: return _slub1024.free(ptr);
+                case 1536: return _slub1536.free(ptr);
                 default:
                     loggers::SLUB::ERROR("不支持的对象大小: %d", rsz);
-                    return;
+                    unexpect_return(ErrCode::INVALID_PARAM);
+            }
+        }
+
+        [[nodiscard]]
+        SlubStats class_slab_stats(size_t idx) const {
+            switch (KMALLOC_SIZES[idx]) {
+                case 8:    return _slub8.get_stats();
+                case 16:   return _slub16.get_stats();
+                case 32:   return _slub32.get_stats();
+                case 64:   return _slub64.get_stats();
+                case 96:   return _slub96.get_stats();
+                case 128:  return _slub128.get_stats();
+                case 192:  return _slub192.get_stats();
+                case 256:  return _slub256.get_stats();
+                case 384:  return _slub384.get_stats();
+                case 512:  return _slub512.get_stats();
+                case 768:  return _slub768.get_stats();
+                case 1024: return _slub1024.get_stats();
+                case 1536: return _slub1536.get_stats();
+                default:   return {};
+            }
+        }
+
+        size_t class_shrink(size_t idx, size_t nr) {
+            switch (KMALLOC_SIZES[idx]) {
+                case 8:    return _slub8.shrink(nr);
+                case 16:   return _slub16.shrink(nr);
+                case 32:   return _slub32.shrink(nr);
+                case 64:   return _slub64.shrink(nr);
+                case 96:   return _slub96.shrink(nr);
+                case 128:  return _slub128.shrink(nr);
+                case 192:  return _slub192.shrink(nr);
+                case 256:  return _slub256.shrink(nr);
+                case 384:  return _slub384.shrink(nr);
+                case 512:  return _slub512.shrink(nr);
+                case 768:  return _slub768.shrink(nr);
+                case 1024: return _slub1024.shrink(nr);
+                case 1536: return _slub1536.shrink(nr);
+                default:   return 0;
             }
         }
 
     public:
         SlubMalloc() {
-            AllocRecord::ALLOC_RECORD_SLUB = &_alloc_record_slub;
-            loggers::MEMORY::INFO(
-                "SlubMalloc 初始化完成: records=%lu alloc_record_inuse=%lu",
-                (unsigned long)_alloc_records.size(),
-                (unsigned long)_alloc_record_slub.get_stats().objects_inuse);
+            LargeRecord::LARGE_RECORD_SLUB = &_large_record_slub;
+            loggers::MEMORY::INFO("SlubMalloc 初始化完成");
         }
 
-        static LockedObject<IrqSaveGuardedLock, SlubMalloc> &INSTANCE() {
+        /**
+         * @brief 获取全局 kmalloc 实例.
+         *
+         * 实例内部自行同步: 小对象走各尺寸类的 per-hart 弹匣, 大对象路径持锁.
+         */
+        static SlubMalloc &INSTANCE() {
             assert(_initialized);
-            return _INSTANCE_LOCKED_STORAGE.ref();
+            return _INSTANCE_STORAGE.ref();
         }
 
         static void init() {
@@ -566,37 +1136,112 @@ namespace slub {
                 return;
             }
             _INSTANCE_STORAGE.construct();
-            _INSTANCE_LOCKED_STORAGE.construct(_INSTANCE_STORAGE.get());
             _initialized = true;
         }
 
         void *malloc(size_t sz) {
-            const size_t rsz = std::max(up2pow(sz), KMIN);
-            assert(contains_small_size(rsz) || rsz >= KMAX);
-
-            void *ptr = (rsz >= KMAX) ? large_malloc(rsz) : small_malloc(rsz);
+            void *ptr = nullptr;
+            if (sz > KMAX) {
+                ptr = large_malloc(sz);
+            } else {
+                const size_t idx = class_index(std::max(sz, KMIN));
+                ptr              = small_malloc(idx, sz);
+                if (ptr != nullptr) {
+                    _class_allocs[idx].fetch_add(1, std::memory_order_relaxed);
+                    _class_requested_bytes[idx].fetch_add(
+                        sz, std::memory_order_relaxed);
+                }
+            }
             if (ptr == nullptr) {
                 loggers::MEMORY::ERROR("无法分配内存!");
                 return nullptr;
             }
-            if (!add_record(ptr, rsz)) {
-                free_inner(ptr, rsz);
-                assert(false);
-                return nullptr;
-            }
             return ptr;
         }
 
         void free(void *ptr) {
-            auto *record = get_record(ptr);
-            if (record == nullptr) {
-                loggers::MEMORY::ERROR(
-                    "未查询到地址%p分配记录 (list size=%lu)", ptr,
-                    (unsigned long)_alloc_records.size());
+            if (ptr == nullptr) {
                 return;
             }
-            free_inner(ptr, record->size);
-            remove_record(record);
+            if (is_large_object(ptr)) {
+                large_free(ptr);
+                return;
+            }
+            auto *slab    = slab_header_of(ptr);
+            auto free_res = small_free(ptr, slab->obj_size);
+            if (free_res.has_value()) {
+                const size_t idx = class_index(slab->obj_size);
+                _class_allocs[idx].fetch_sub(1, std::memory_order_relaxed);
+                _class_requested_bytes[idx].fetch_sub(
+                    free_res.value(), std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief 将所有 hart 各尺寸类弹匣中的对象归还 slab 链表.
+         */
+        void drain() {
+            _slub8.drain();
+            _slub16.drain();
+            _slub32.drain();
+            _slub64.drain();
+            _slub96.drain();
+            _slub128.drain();
+            _slub192.drain();
+            _slub256.drain();
+            _slub384.drain();
+            _slub512.drain();
+            _slub768.drain();
+            _slub1024.drain();
+            _slub1536.drain();
+        }
+
+        /**
+         * @brief 各尺寸类保留的空 slab 总数.
+         */
+        [[nodiscard]]
+        size_t empty_slabs() const {
+            size_t total = 0;
+            for (size_t i = 0; i < KMALLOC_CLASSES; i++) {
+                total += class_slab_stats(i).empty_slabs;
+            }
+            return total;
+        }
+
+        /**
+         * @brief 从小尺寸类开始释放至多 nr 个空 slab.
+         *
+         * @return size_t 释放的 slab 数
+         */
+        size_t shrink(size_t nr) {
+            size_t released = 0;
+            for (size_t i = 0; i < KMALLOC_CLASSES && released < nr; i++) {
+                released += class_shrink(i, nr - released);
+            }
+            return released;
+        }
+
+        /**
+         * @brief 获取各尺寸类与大对象路径的统计快照.
+         */
+        [[nodiscard]]
+        KmallocStats get_stats() const {
+            KmallocStats stats{};
+            for (size_t i = 0; i < KMALLOC_CLASSES; i++) {
+                stats.classes[i] = {
+                    .obj_size = KMALLOC_SIZES[i],
+                    .slab     = class_slab_stats(i),
+                    .allocs =
+                        _class_allocs[i].load(std::memory_order_relaxed),
+                    .requested_bytes = _class_requested_bytes[i].load(
+                        std::memory_order_relaxed),
+                };
+            }
+            IrqSaveGuardedLock guard(_large_lock);
+            stats.large_allocs          = _large_allocs;
+            stats.large_pages           = _large_pages;
+            stats.large_requested_bytes = _large_requested_bytes;
+            return stats;
         }
     };
 
@@ -0,0 +1,98 @@
+/**
+ * @file tlb.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief TLB 定向失效
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/tlb.h>
+#include <smp/smp.h>
+
+namespace {
+    [[nodiscard]]
+    bool is_active(PageMan &pman) noexcept {
+        return pman.get_root() == PageMan::read_root();
+    }
+
+    /**
+     * @brief 让其他运行过该地址空间的 hart 整体刷新 TLB.
+     *
+     * 核间请求不携带地址范围, 对方一律整体刷新.
+     */
+    void flush_others(const AsidContext &ctx) noexcept {
+        if (SMP::online_count() > 1) {
+            SMP::flush_tlb_others(ctx.harts);
+        }
+    }
+
+    /**
+     * @brief 失效整个地址空间.
+     */
+    void flush_all(PageMan &pman, const AsidContext &ctx) noexcept {
+        uint16_t asid = 0;
+        if (AsidAllocator::live(ctx, asid)) {
+            PageMan::flush_tlb_asid(asid);
+        } else if (is_active(pman)) {
+            PageMan::flush_tlb();
+        }
+        flush_others(ctx);
+    }
+}  // namespace
+
+void flush_tlb_range(PageMan &pman, const AsidContext &ctx, VirAddr vaddr,
+                     size_t size) noexcept {
+    if (size == 0) {
+        return;
+    }
+    VirAddr begin = vaddr.page_align_down();
+    VirAddr end   = (vaddr + size).page_align_up();
+    if ((end - begin) / PAGESIZE > TLBGather::FULL_FLUSH_THRESHOLD) {
+        flush_all(pman, ctx);
+        return;
+    }
+
+    uint16_t asid = 0;
+    if (AsidAllocator::live(ctx, asid)) {
+        for (VirAddr page = begin; page < end; page += PAGESIZE) {
+            PageMan::flush_tlb_asid_page(page, asid);
+        }
+    } else if (is_active(pman)) {
+        for (VirAddr page = begin; page < end; page += PAGESIZE) {
+            PageMan::flush_tlb_page(page);
+        }
+    }
+    flush_others(ctx);
+}
+
+void TLBGather::add(VirAddr vaddr, size_t size) noexcept {
+    if (_full || size == 0) {
+        return;
+    }
+    VirAddr end = vaddr + size;
+    if (_end <= _begin) {
+        _begin = vaddr;
+        _end   = end;
+        return;
+    }
+    if (vaddr < _begin) {
+        _begin = vaddr;
+    }
+    if (_end < end) {
+        _end = end;
+    }
+}
+
+void TLBGather::flush() noexcept {
+    if (_full) {
+        flush_all(_pman, _asid);
+    } else if (_begin < _end) {
+        flush_tlb_range(_pman, _asid, _begin, _end - _begin);
+    }
+    _full  = false;
+    _begin = VirAddr::null;
+    _end   = VirAddr::null;
+}
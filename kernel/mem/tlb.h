@@ -0,0 +1,75 @@
+/**
+ * @file tlb.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief TLB 定向失效
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <arch/description.h>
+#include <mem/asid.h>
+#include <sustcore/addr.h>
+
+#include <cstddef>
+
+/**
+ * @brief 失效地址空间 (pman, asid) 中 [vaddr, vaddr + size) 的 TLB 项.
+ *
+ * 地址空间持有有效 ASID 时只失效该 ASID 的项. 否则它以 ASID 0 运行,
+ * 不是当前 hart 的活动页表时什么也不做, 因为切换到它时会整体刷新.
+ * 涉及的页数超过 TLBGather::FULL_FLUSH_THRESHOLD 时退化为按 ASID 或整体刷新.
+ */
+void flush_tlb_range(PageMan &pman, const AsidContext &asid, VirAddr vaddr,
+                     size_t size) noexcept;
+
+/**
+ * @brief 收集一次页表修改涉及的地址范围, 析构或 flush() 时统一失效.
+ *
+ * 多次 add() 合并为覆盖它们的单个区间, 调用方无需逐页刷新.
+ */
+class TLBGather {
+public:
+    /// 超过该页数时逐页失效不再划算, 改为整体刷新
+    static constexpr size_t FULL_FLUSH_THRESHOLD = 32;
+
+private:
+    PageMan &_pman;
+    const AsidContext &_asid;
+    VirAddr _begin = VirAddr::null;
+    VirAddr _end   = VirAddr::null;
+    bool _full     = false;
+
+public:
+    TLBGather(PageMan &pman, const AsidContext &asid) noexcept
+        : _pman(pman), _asid(asid) {}
+    ~TLBGather() {
+        flush();
+    }
+
+    TLBGather(const TLBGather &)            = delete;
+    TLBGather &operator=(const TLBGather &) = delete;
+
+    /**
+     * @brief 记录 [vaddr, vaddr + size) 需要失效.
+     */
+    void add(VirAddr vaddr, size_t size) noexcept;
+    void add(const VirArea &varea) noexcept {
+        add(varea.begin, varea.size());
+    }
+    /**
+     * @brief 记录整个地址空间需要失效.
+     */
+    void add_all() noexcept {
+        _full = true;
+    }
+
+    /**
+     * @brief 立即失效已收集的范围并清空记录.
+     */
+    void flush() noexcept;
+};
@@ -11,19 +11,189 @@
 
 #include <env.h>
 #include <mem/gfp.h>
+#include <mem/reclaim.h>
+#include <mem/tlb.h>
 #include <mem/vma.h>
+#include <spinlock.h>
 #include <sus/logger.h>
 #include <sus/owner.h>
 #include <sus/range.h>
 #include <sustcore/addr.h>
 #include <sustcore/errcode.h>
+#include <task/scheduler.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 
 namespace {
+    // 全局递增, 保证不同地址空间 (包括复用同一地址的) 不会共享版本号
+    std::atomic<uint64_t> vma_generation{0};
+    std::atomic<size_t> np_fault_count{0};
+    std::atomic<size_t> fault_around_pages{0};
+
+    struct TMMEntry {
+        TaskMemoryManager *tmm;
+        /// 锁外扫描中的引用数, 归零前地址空间不能析构
+        size_t pins;
+        /// 已被 release, 由最后一次 unpin 负责析构
+        bool dying;
+        /// 析构后是否归还页目录页
+        bool put_pgd;
+    };
+
+    /**
+     * @brief 全部地址空间的登记表, 回收时据此扫描页表.
+     *
+     * 锁只保护登记表本身: 扫描、压缩与 TLB 击落都要在锁外进行,
+     * 扫描前在锁内给地址空间加引用. release 时若仍有引用,
+     * 析构推迟到最后一次 unpin, 释放方不必等待.
+     */
+    struct TMMRegistry {
+        std::vector<TMMEntry> tmms;
+        /// 下一次回收从该下标开始, 使各地址空间轮流被扫描
+        size_t cursor = 0;
+        SpinLocker lock;
+    };
+
+    TMMRegistry tmm_registry;
+
+    /// 每次在锁内取出的地址空间数
+    constexpr size_t PIN_BATCH = 16;
+
+    [[nodiscard]]
+    TMMEntry *find_entry(TaskMemoryManager *tmm) {
+        for (auto &entry : tmm_registry.tmms) {
+            if (entry.tmm == tmm) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void erase_entry(TMMEntry *entry) {
+        tmm_registry.tmms.erase(tmm_registry.tmms.begin() +
+                                (entry - tmm_registry.tmms.data()));
+    }
+
+    void register_tmm(TaskMemoryManager *tmm) {
+        // 扩容在锁外完成: 持锁时只在已有容量内追加, 旧缓冲区出锁后释放
+        std::vector<TMMEntry> spare;
+        while (true) {
+            size_t need = 0;
+            {
+                IrqSaveGuardedLock guard(tmm_registry.lock);
+                auto &tmms = tmm_registry.tmms;
+                if (tmms.size() < tmms.capacity()) {
+                    tmms.push_back(TMMEntry{tmm, 0, false, false});
+                    break;
+                }
+                if (spare.capacity() > tmms.size()) {
+                    spare.clear();
+                    for (const auto &entry : tmms) {
+                        spare.push_back(entry);
+                    }
+                    spare.push_back(TMMEntry{tmm, 0, false, false});
+                    tmms.swap(spare);
+                    break;
+                }
+                need = std::max<size_t>(PIN_BATCH, tmms.capacity() * 2);
+            }
+            spare.reserve(need);
+        }
+    }
+
+    /**
+     * @brief 把地址空间标记为待析构.
+     *
+     * @return 是否已无扫描引用, 可由调用方立即析构
+     */
+    [[nodiscard]]
+    bool retire_tmm(TaskMemoryManager *tmm, bool put_pgd) {
+        IrqSaveGuardedLock guard(tmm_registry.lock);
+        TMMEntry *entry = find_entry(tmm);
+        if (entry == nullptr) {
+            return true;
+        }
+        if (entry->pins == 0) {
+            erase_entry(entry);
+            return true;
+        }
+        // 不再被新的扫描取出, 由最后一次 unpin 析构
+        entry->dying   = true;
+        entry->put_pgd = put_pgd;
+        return false;
+    }
+
+    /**
+     * @brief 从 pos 起取出至多 PIN_BATCH 个地址空间并加引用.
+     *
+     * wrap 为真时下标对登记表长度取模, 否则到表尾为止;
+     * 每检查一个表项消耗一个 budget, 没有更多表项时 budget 置 0.
+     *
+     * @return 取出的个数
+     */
+    size_t pin_tmms(size_t &pos, size_t &budget, bool wrap,
+                    TaskMemoryManager **out) {
+        IrqSaveGuardedLock guard(tmm_registry.lock);
+        size_t size  = tmm_registry.tmms.size();
+        size_t count = 0;
+        while (count < PIN_BATCH && budget > 0) {
+            if (size == 0 || (!wrap && pos >= size)) {
+                budget = 0;
+                break;
+            }
+            auto &entry = tmm_registry.tmms[pos % size];
+            pos++;
+            budget--;
+            if (entry.dying) {
+                continue;
+            }
+            entry.pins++;
+            out[count++] = entry.tmm;
+        }
+        return count;
+    }
+
+    void unpin_tmms(TaskMemoryManager **tmms, size_t count) {
+        TMMEntry retired[PIN_BATCH];
+        size_t nr_retired = 0;
+        {
+            IrqSaveGuardedLock guard(tmm_registry.lock);
+            for (size_t i = 0; i < count; ++i) {
+                TMMEntry *entry = find_entry(tmms[i]);
+                assert(entry != nullptr && entry->pins > 0);
+                entry->pins--;
+                if (entry->dying && entry->pins == 0) {
+                    retired[nr_retired++] = *entry;
+                    erase_entry(entry);
+                }
+            }
+        }
+        // 释放方已经离开, 这里代为析构
+        for (size_t i = 0; i < nr_retired; ++i) {
+            TaskMemoryManager::destroy(retired[i].tmm, retired[i].put_pgd);
+        }
+    }
+
+    [[nodiscard]]
+    uint64_t next_generation() noexcept {
+        return vma_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    [[nodiscard]]
+    VMACache *current_vma_cache() noexcept {
+        if (!schd::Scheduler::initialized()) {
+            return nullptr;
+        }
+        auto *tcb = schd::Scheduler::inst().current_tcb();
+        return tcb == nullptr ? nullptr : &tcb->vma_cache;
+    }
+
     [[nodiscard]]
-    bool less_by_begin(const VMA &lhs, const VMA &rhs) noexcept {
-        return lhs.varea.begin < rhs.varea.begin;
+    bool vma_contains(const VMA &vma, VirAddr vaddr) noexcept {
+        return within(vma.varea, vaddr) ||
+               (vma.varea.size() == 0 && vma.varea.begin == vaddr);
     }
 
     bool valid_user_area(const VirArea &varea) {
@@ -55,16 +225,74 @@ namespace {
         }
         return vma.mem_offset + (aligned_vaddr - vma.varea.begin);
     }
+
+    constexpr size_t HUGE_PAGE_SIZE = cap::MemoryPayload::HUGE_PAGE_SIZE;
+
+    VirAddr huge_align_down(VirAddr vaddr) {
+        return VirAddr(vaddr.arith() & ~(HUGE_PAGE_SIZE - 1));
+    }
+
+    /**
+     * @brief 判断 VMA 是否适合使用透明大页.
+     *
+     * 只对私有匿名的堆与数据映射启用; 栈向下增长、代码段由文件提供,
+     * 共享映射的页由多个地址空间按 4K 粒度引用, 都不使用大页.
+     */
+    bool thp_candidate(const VMA &vma, const cap::MemoryPayload &memory) {
+        if (memory.shared || memory.file_backed()) {
+            return false;
+        }
+        return vma.type == VMA::Type::HEAP || vma.type == VMA::Type::DATA;
+    }
+
+    /**
+     * @brief 读缺页是否以共享零页满足.
+     */
+    bool zero_page_candidate(const cap::MemoryPayload &memory) {
+        return !memory.shared && !memory.continuity && !memory.file_backed();
+    }
+
+    /**
+     * @brief payload 的页能否被换出. 逐页条件由 MemoryPayload::swappable 判断.
+     */
+    bool swap_candidate(const cap::MemoryPayload &memory) {
+        return zero_page_candidate(memory) && memory.map_count == 1;
+    }
+
+    /**
+     * @brief 页能否迁移: 与换出条件相同, 另外不拆散透明大页.
+     */
+    bool migratable(const cap::MemoryPayload &memory, size_t offset) {
+        if (!memory.swappable(offset)) {
+            return false;
+        }
+        auto page_res = memory.find_page_entry(offset);
+        return page_res.has_value() &&
+               (page_res.value().flags & cap::PhyPage::PP_HUGE) == 0;
+    }
 }  // namespace
 
 TaskMemoryManager::TaskMemoryManager(PhyAddr _pgd)
-    : vma_list(), _pgd(_pgd), _pman(_pgd) {
+    : vma_list(),
+      _vma_tree(),
+      _generation(next_generation()),
+      _asid(),
+      _pgd(_pgd),
+      _pman(_pgd) {
     auto init_res = PageMan::init_task_root(_pgd);
     assert(init_res.has_value());
+    register_tmm(this);
 }
 
 TaskMemoryManager::TaskMemoryManager(ExistingPgdTag, PhyAddr _pgd)
-    : vma_list(), _pgd(_pgd), _pman(_pgd) {}
+    : vma_list(),
+      _vma_tree(),
+      _generation(next_generation()),
+      _asid(),
+      _pgd(_pgd),
+      _pman(_pgd) {
+    register_tmm(this);
+}
 
 Result<util::owner<TaskMemoryManager *>> TaskMemoryManager::from_existing_pgd(
     PhyAddr pgd) noexcept {
@@ -79,14 +307,35 @@ Result<util::owner<TaskMemoryManager *>> TaskMemoryManager::from_existing_pgd(
     return util::owner<TaskMemoryManager *>(tmm);
 }
 
+void TaskMemoryManager::release(util::owner<TaskMemoryManager *> tmm,
+                                bool put_pgd) noexcept {
+    if (tmm.get() == nullptr) {
+        return;
+    }
+    if (retire_tmm(tmm.get(), put_pgd)) {
+        destroy(tmm.get(), put_pgd);
+    }
+}
+
+void TaskMemoryManager::destroy(TaskMemoryManager *tmm, bool put_pgd) noexcept {
+    PhyAddr pgd = tmm->pgd();
+    delete tmm;
+    if (put_pgd) {
+        GFP::page_putpage(pgd);
+    }
+}
+
 TaskMemoryManager::~TaskMemoryManager() {
+    TLBGather tlb(_pman, _asid);
+    _vma_tree.clear();
     while (!vma_list.empty()) {
         VMA &vma = vma_list.front();
         vma_list.pop_front();
         unmap_pages(vma.varea);
+        tlb.add(page_outer_area(vma.varea));
         delete util::owner(&vma);
     }
-    _pman.flush_tlb();
+    tlb.flush();
     // TODO: 释放页表
     // 后续统一通过 GFP::page_putpage() 回收整棵页表中的页表页。
 }
@@ -105,18 +354,96 @@ Result<util::nonnull<VMA *>> TaskMemoryManager::add_vma(
     }
 
     VMA *vma = new VMA(this, type, growth, varea, memory, prot, mem_offset);
-    auto it  = vma_list.begin();
-    for (; it != vma_list.end(); ++it) {
-        if (varea.begin < it->varea.begin) {
+    link_vma(*vma);
+    layout_changed();
+    return util::nonnull(*vma);
+}
+
+void TaskMemoryManager::link_vma(VMA &vma) noexcept {
+    // 起点相同的 VMA 排在已有 VMA 之后
+    VMA *prev = _vma_tree.floor(vma.varea.begin);
+    auto pos  = vma_list.begin();
+    if (prev != nullptr) {
+        pos = util::IntrusiveList<VMA>::iterator(prev);
+        ++pos;
+    }
+    vma_list.insert(pos, vma);
+    _vma_tree.insert(vma);
+}
+
+void TaskMemoryManager::layout_changed() noexcept {
+    _generation = next_generation();
+}
+
+void TaskMemoryManager::vma_resized(VMA &vma) noexcept {
+    VMA *prev = VMATree::prev(&vma);
+    VMA *next = VMATree::next(&vma);
+    bool ordered =
+        (prev == nullptr || prev->varea.begin <= vma.varea.begin) &&
+        (next == nullptr || vma.varea.begin <= next->varea.begin);
+    if (ordered) {
+        _vma_tree.refresh(vma);
+    } else {
+        // 越过了空 VMA 的起点, 重新排序
+        _vma_tree.erase(vma);
+        vma_list.erase(util::IntrusiveList<VMA>::iterator(&vma));
+        link_vma(vma);
+    }
+    layout_changed();
+}
+
+template <typename Pred>
+VMA *TaskMemoryManager::find_vma(VirAddr vaddr, Pred &&pred) const {
+    // 非空 VMA 互不重叠: 自起点不大于 vaddr 的最后一个 VMA 向前,
+    // 越过空 VMA 后遇到的第一个非空 VMA 之前不可能再有包含 vaddr 的 VMA
+    VMA *found = nullptr;
+    for (VMA *vma = _vma_tree.floor(vaddr); vma != nullptr;
+         vma      = VMATree::prev(vma))
+    {
+        bool contains = vma_contains(*vma, vaddr);
+        if (contains && pred(*vma)) {
+            found = vma;
+        }
+        if (vma->varea.size() != 0 && (!contains || vma->varea.begin < vaddr))
+        {
             break;
         }
     }
-    if (it == vma_list.end()) {
-        vma_list.push_back(*vma);
-    } else {
-        vma_list.insert(it, *vma);
+    return found;
+}
+
+VMA *TaskMemoryManager::find_intersecting(const VirArea &varea,
+                                          const VMA *skip) const {
+    if (varea.nullable()) {
+        return nullptr;
     }
-    return util::nonnull(*vma);
+    VMA *anchor = _vma_tree.floor(varea.begin);
+    for (VMA *vma = anchor; vma != nullptr; vma = VMATree::prev(vma)) {
+        if (vma->varea.size() == 0 || vma == skip) {
+            continue;
+        }
+        if (is_intersecting(vma->varea, varea)) {
+            return vma;
+        }
+        break;
+    }
+    VMA *vma = anchor == nullptr ? _vma_tree.first() : VMATree::next(anchor);
+    for (; vma != nullptr && vma->varea.begin < varea.end;
+         vma = VMATree::next(vma))
+    {
+        if (vma->varea.size() != 0 && vma != skip) {
+            return vma;
+        }
+    }
+    return nullptr;
+}
+
+Result<VirAddr> TaskMemoryManager::find_unmapped_area(const VirArea &window,
+                                                      size_t size) const {
+    if (!valid_user_area(window)) {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+    return _vma_tree.find_gap(window, page_align_up(size));
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::clone_vma(
@@ -129,45 +456,59 @@ Result<util::nonnull<VMA *>> TaskMemoryManager::clone_vma(
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::locate(VirAddr vaddr) {
-    for (auto &vma : vma_list) {
-        if (within(vma.varea, vaddr) ||
-            (vma.varea.size() == 0 && vma.varea.begin == vaddr))
-        {
-            return util::nonnull(vma);
-        }
+    // 同一线程的连续缺页/用户缓冲区访问通常落在同一 VMA
+    VMACache *cache = current_vma_cache();
+    if (cache != nullptr && cache->tmm == this &&
+        cache->generation == _generation && cache->vma != nullptr &&
+        within(cache->vma->varea, vaddr))
+    {
+        return util::nonnull(*cache->vma);
     }
-    unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+
+    VMA *vma = find_vma(vaddr, [](const VMA &) { return true; });
+    if (vma == nullptr) {
+        unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    }
+    if (cache != nullptr) {
+        *cache = VMACache{this, _generation, vma};
+    }
+    return util::nonnull(*vma);
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::locate_range(
     const VirArea &varea) {
-    for (auto &vma : vma_list) {
-        if (is_intersecting(vma.varea, varea)) {
-            return util::nonnull(vma);
-        }
+    VMA *vma = find_intersecting(varea, nullptr);
+    if (vma == nullptr) {
+        unexpect_return(ErrCode::ENTRY_NOT_FOUND);
     }
-    unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    return util::nonnull(*vma);
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::locate_memory(
     cap::MemoryPayload *memory, VirAddr vaddr) {
-    for (auto &vma : vma_list) {
-        if (vma.memory_payload() == memory &&
-            (within(vma.varea, vaddr) ||
-             (vma.varea.size() == 0 && vma.varea.begin == vaddr)))
-        {
-            return util::nonnull(vma);
-        }
+    VMA *vma = find_vma(vaddr, [memory](const VMA &candidate) {
+        return candidate.memory_payload() == memory;
+    });
+    if (vma == nullptr) {
+        unexpect_return(ErrCode::ENTRY_NOT_FOUND);
     }
-    unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    return util::nonnull(*vma);
 }
 
 Result<void> TaskMemoryManager::remove_vma(util::nonnull<VMA *> vma) {
-    return __check_vma(vma).and_then([this](VMA *vma) {
+    TLBGather tlb(_pman, _asid);
+    return remove_vma(vma, tlb);
+}
+
+Result<void> TaskMemoryManager::remove_vma(util::nonnull<VMA *> vma,
+                                           TLBGather &tlb) {
+    return __check_vma(vma).and_then([this, &tlb](VMA *vma) {
+        tlb.add(page_outer_area(vma->varea));
         unmap_pages(vma->varea);
-        vma_list.remove(*vma);
+        _vma_tree.erase(*vma);
+        vma_list.erase(util::IntrusiveList<VMA>::iterator(vma));
+        layout_changed();
         delete util::owner(vma);
-        _pman.flush_tlb();
         void_return();
     });
 }
@@ -180,8 +521,15 @@ Result<void> TaskMemoryManager::remove_vma_range(const VirArea &varea) {
         unexpect_return(ErrCode::INVALID_PARAM);
     }
 
-    auto it = vma_list.begin();
-    while (it != vma_list.end()) {
+    VMA *first = find_intersecting(varea, nullptr);
+    if (first == nullptr) {
+        void_return();
+    }
+    // 只有 varea 覆盖的页会被解除映射
+    TLBGather tlb(_pman, _asid);
+    tlb.add(page_outer_area(varea));
+    auto it = util::IntrusiveList<VMA>::iterator(first);
+    while (it != vma_list.end() && it->varea.begin < varea.end) {
         VMA *vma = &*it;
         ++it;
         if (!is_intersecting(vma->varea, varea)) {
@@ -201,7 +549,7 @@ Result<void> TaskMemoryManager::remove_vma_range(const VirArea &varea) {
         const size_t cut_size   = static_cast<size_t>(cut_end - cut_begin);
 
         if (cut_begin == old_area.begin && cut_end == old_area.end) {
-            auto remove_res = remove_vma(util::nnullforce(vma));
+            auto remove_res = remove_vma(util::nnullforce(vma), tlb);
             propagate(remove_res);
             continue;
         }
@@ -209,11 +557,13 @@ Result<void> TaskMemoryManager::remove_vma_range(const VirArea &varea) {
             unmap_pages(VirArea(cut_begin, cut_end));
             vma->varea.begin = cut_end;
             vma->mem_offset += cut_size;
+            vma_resized(*vma);
             continue;
         }
         if (cut_end == old_area.end) {
             unmap_pages(VirArea(cut_begin, cut_end));
             vma->varea.end = cut_begin;
+            vma_resized(*vma);
             continue;
         }
 
@@ -222,12 +572,12 @@ Result<void> TaskMemoryManager::remove_vma_range(const VirArea &varea) {
                   vma->mem_offset + cut_offset + cut_size);
         unmap_pages(VirArea(cut_begin, cut_end));
         vma->varea.end = cut_begin;
+        vma_resized(*vma);
         auto add_res = add_vma(right.type, right.growth, right.varea,
                                right.memory_payload(), right.prot,
                                right.mem_offset);
         propagate(add_res);
     }
-    _pman.flush_tlb();
     void_return();
 }
 
@@ -245,6 +595,19 @@ void TaskMemoryManager::unmap_pages(const VirArea &varea) {
             continue;
         }
 
+        if (query_res.value().size != PageMan::PageSize::_4K) {
+            // 大页只被部分覆盖时先拆分, 避免连带解除范围外的映射
+            VirAddr huge_begin = huge_align_down(vaddr);
+            if (huge_begin < map_area.begin ||
+                map_area.end < huge_begin + HUGE_PAGE_SIZE)
+            {
+                auto split_res = split_huge_mapping(vaddr);
+                if (!split_res.has_value()) {
+                    loggers::PAGING::ERROR("unmap_pages: 拆分大页失败: addr=%p",
+                                           vaddr.addr());
+                }
+            }
+        }
         _pman.unmap_page(vaddr);
     }
 }
@@ -288,29 +651,29 @@ Result<VirArea> TaskMemoryManager::grow_vma(util::nonnull<VMA *> vma,
         unexpect_return(ErrCode::INVALID_PARAM);
     }
 
-    if (!varea.nullable()) {
-        for (auto &other : vma_list) {
-            if (&other != target && is_intersecting(other.varea, varea)) {
-                unexpect_return(ErrCode::BUSY);
-            }
-        }
+    if (find_intersecting(varea, target) != nullptr) {
+        unexpect_return(ErrCode::BUSY);
     }
 
+    // 扩展不会改动已有映射, 只有收缩需要失效 TLB
+    TLBGather tlb(_pman, _asid);
     if (shrink_up) {
         VirArea unmap_area = page_inner_area(VirArea(varea.end, old_area.end));
         if (!unmap_area.nullable()) {
             unmap_pages(unmap_area);
+            tlb.add(unmap_area);
         }
     } else if (shrink_down) {
         VirArea unmap_area =
             page_inner_area(VirArea(old_area.begin, varea.begin));
         if (!unmap_area.nullable()) {
             unmap_pages(unmap_area);
+            tlb.add(unmap_area);
         }
     }
 
     target->varea = varea;
-    _pman.flush_tlb();
+    vma_resized(*target);
     return target->varea;
 }
 
@@ -327,12 +690,14 @@ Result<void> TaskMemoryManager::protect_memory_cow(cap::MemoryPayload *memory) {
     if (memory == nullptr || memory->shared) {
         void_return();
     }
+    TLBGather tlb(_pman, _asid);
     for (auto &vma : vma_list) {
         if (vma.memory_payload() != memory) {
             continue;
         }
         VirArea map_area  = page_outer_area(vma.varea);
         size_t page_count = map_area.size() / PAGESIZE;
+        tlb.add(map_area);
         for (size_t i = 0; i < page_count; ++i) {
             VirAddr vaddr  = map_area.begin + i * PAGESIZE;
             auto query_res = _pman.query_page(vaddr);
@@ -344,7 +709,11 @@ Result<void> TaskMemoryManager::protect_memory_cow(cap::MemoryPayload *memory) {
             }
             auto qres = query_res.value();
             if (qres.size != PageMan::PageSize::_4K) {
-                unexpect_return(ErrCode::NOT_SUPPORTED);
+                auto split_res = split_huge_mapping(vaddr);
+                propagate(split_res);
+                query_res = _pman.query_page(vaddr);
+                propagate(query_res);
+                qres = query_res.value();
             }
             PageMan::RWX rwx = PageMan::rwx(*qres.pte);
             if (PageMan::is_writable(rwx)) {
@@ -352,7 +721,6 @@ Result<void> TaskMemoryManager::protect_memory_cow(cap::MemoryPayload *memory) {
             }
         }
     }
-    _pman.flush_tlb();
     void_return();
 }
 
@@ -368,6 +736,7 @@ void TaskMemoryManager::unmap_memory_tail(cap::MemoryPayload *memory,
         if (new_end < vma.varea.end) {
             unmap_pages(VirArea(new_end, vma.varea.end));
             vma.varea.end = new_end;
+            vma_resized(vma);
         }
     }
 }
@@ -407,20 +776,17 @@ Result<cap::MemoryPayload *> TaskMemoryManager::cloned_memory_for(
 
 Result<TaskMemoryManager::VMAQueryResult> TaskMemoryManager::query_vaddr(
     VirAddr vaddr, CapIdx mem_cap) const {
-    for (const auto &vma : vma_list) {
-        if (within(vma.varea, vaddr) ||
-            (vma.varea.size() == 0 && vma.varea.begin == vaddr))
-        {
-            return VMAQueryResult{
-                .type    = vma.type,
-                .prot    = vma.prot,
-                .start   = vma.varea.begin,
-                .size    = vma.size(),
-                .mem_cap = mem_cap,
-            };
-        }
+    const VMA *vma = find_vma(vaddr, [](const VMA &) { return true; });
+    if (vma == nullptr) {
+        unexpect_return(ErrCode::ENTRY_NOT_FOUND);
     }
-    unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    return VMAQueryResult{
+        .type    = vma->type,
+        .prot    = vma->prot,
+        .start   = vma->varea.begin,
+        .size    = vma->size(),
+        .mem_cap = mem_cap,
+    };
 }
 
 std::vector<TaskMemoryManager::VMAQueryResult> TaskMemoryManager::query_vspace(
@@ -450,6 +816,266 @@ std::vector<TaskMemoryManager::VMAQueryResult> TaskMemoryManager::query_vspace(
     return results;
 }
 
+void TaskMemoryManager::map_resident_page(const VMA &vma,
+                                          const cap::MemoryPayload &memory,
+                                          VirAddr aligned_vaddr,
+                                          const cap::PhyPage &page) {
+    PageMan::RWX rwx = VMA::prot_to_rwx(vma.prot);
+    // 是否需要 cow 标记
+    bool cow_page = !memory.shared && PageMan::is_writable(rwx) &&
+                    page.refcount > 1;
+    PageMan::RWX map_rwx = cow_page ? PageMan::without_write(rwx) : rwx;
+
+    _pman.map_page<PageMan::PageSize::_4K>(
+        aligned_vaddr, page.addr, PageMan::page_flags(map_rwx, true, false));
+    if (cow_page) {
+        // cow 需要 cow 标记
+        auto query_res = _pman.query_page(aligned_vaddr);
+        if (query_res.has_value()) {
+            PageMan::protect_cow(query_res.value().pte, rwx);
+        }
+    }
+}
+
+size_t TaskMemoryManager::fault_around(const VMA &vma,
+                                       const cap::MemoryPayload &memory,
+                                       VirAddr aligned_vaddr, TLBGather &tlb) {
+    constexpr size_t WINDOW_SIZE = FAULT_AROUND_PAGES * PAGESIZE;
+    VirArea vma_pages = page_outer_area(vma.varea);
+    VirAddr window    = VirAddr(aligned_vaddr.arith() & ~(WINDOW_SIZE - 1));
+    VirAddr begin     = std::max(window, vma_pages.begin);
+    VirAddr end       = std::min(window + WINDOW_SIZE, vma_pages.end);
+
+    size_t mapped = 0;
+    for (VirAddr vaddr = begin; vaddr < end; vaddr += PAGESIZE) {
+        if (vaddr == aligned_vaddr) {
+            continue;
+        }
+        // 只取已驻留的页, 不为预映射分配内存或读文件
+        auto page_res =
+            memory.find_page_entry(memory_offset_for_page(vma, vaddr));
+        if (!page_res.has_value()) {
+            continue;
+        }
+        auto query_res = _pman.query_page(vaddr);
+        if (query_res.has_value() ||
+            query_res.error() != ErrCode::PAGE_NOT_PRESENT)
+        {
+            continue;
+        }
+        map_resident_page(vma, memory, vaddr, page_res.value());
+        tlb.add(vaddr, PAGESIZE);
+        mapped++;
+    }
+    return mapped;
+}
+
+void TaskMemoryManager::activate() noexcept {
+    AsidAllocator::switch_to(_pgd, _asid);
+}
+
+TaskMemoryManager::FaultStats TaskMemoryManager::get_fault_stats() noexcept {
+    return FaultStats{
+        .faults       = np_fault_count.load(std::memory_order_relaxed),
+        .around_pages = fault_around_pages.load(std::memory_order_relaxed),
+    };
+}
+
+size_t TaskMemoryManager::swap_out_cold(size_t budget) {
+    struct Victim {
+        cap::MemoryPayload *memory;
+        size_t offset;
+    };
+    Victim victims[RECLAIM_BATCH];
+    size_t swapped = 0;
+
+    TLBGather tlb(_pman, _asid);
+    for (auto &vma : vma_list) {
+        auto *memory     = vma.memory_payload();
+        VirArea map_area = page_outer_area(vma.varea);
+        if (memory == nullptr || !swap_candidate(*memory) ||
+            map_area.nullable())
+        {
+            continue;
+        }
+
+        VirAddr cursor = map_area.begin;
+        while (cursor < map_area.end && swapped < budget) {
+            size_t count = 0;
+            bool stopped = false;
+            _pman.walk_leaves(
+                cursor, map_area.end,
+                [&](VirAddr vaddr, PageMan::PTE *pte,
+                    PageMan::PageSize size) -> bool {
+                    cursor = vaddr + PageMan::psize(size);
+                    // 大页整体换出代价过高, 只换出 4K 页
+                    if (size != PageMan::PageSize::_4K) {
+                        return true;
+                    }
+                    // 最近访问过的页给第二次机会
+                    if (PageMan::test_and_clear_young(pte)) {
+                        tlb.add(vaddr, PAGESIZE);
+                        return true;
+                    }
+                    size_t offset = memory_offset_for_page(vma, vaddr);
+                    if (!memory->swappable(offset)) {
+                        return true;
+                    }
+                    pte->value = 0;
+                    tlb.add(vaddr, PAGESIZE);
+                    victims[count++] = Victim{memory, offset};
+                    stopped = count == RECLAIM_BATCH ||
+                              swapped + count >= budget;
+                    return !stopped;
+                });
+            if (!stopped) {
+                cursor = map_area.end;
+            }
+
+            // 旧映射必须先从 TLB 中消失, 物理页才能释放
+            tlb.flush();
+            for (size_t i = 0; i < count; ++i) {
+                // 不可压缩的页仍留在 payload 中, 再次访问时只需重新映射
+                const Victim &victim = victims[i];
+                if (victim.memory->swap_out(victim.offset).has_value()) {
+                    swapped++;
+                }
+            }
+        }
+        if (swapped >= budget) {
+            break;
+        }
+    }
+    return swapped;
+}
+
+size_t TaskMemoryManager::reclaim(size_t target) noexcept {
+    size_t budget;
+    {
+        IrqSaveGuardedLock guard(tmm_registry.lock);
+        budget = tmm_registry.tmms.size();
+    }
+
+    TaskMemoryManager *batch[PIN_BATCH];
+    size_t reclaimed = 0;
+    while (reclaimed < target && budget > 0) {
+        size_t count =
+            pin_tmms(tmm_registry.cursor, budget, true, batch);
+        for (size_t i = 0; i < count && reclaimed < target; ++i) {
+            reclaimed += batch[i]->swap_out_cold(target - reclaimed);
+        }
+        unpin_tmms(batch, count);
+    }
+    if (reclaimed != 0) {
+        loggers::PAGING::DEBUG("TM::reclaim: target=%lu reclaimed=%lu",
+                               target, reclaimed);
+    }
+    return reclaimed;
+}
+
+size_t TaskMemoryManager::migrate_from(
+    const PhyArea &block, const std::function<Result<PhyAddr>()> &alloc) {
+    struct Victim {
+        cap::MemoryPayload *memory;
+        size_t offset;
+        VirAddr vaddr;
+        PageMan::PTE *pte;
+        PageMan::PTE saved;
+    };
+    Victim victims[RECLAIM_BATCH];
+    size_t migrated = 0;
+
+    TLBGather tlb(_pman, _asid);
+    for (auto &vma : vma_list) {
+        auto *memory     = vma.memory_payload();
+        VirArea map_area = page_outer_area(vma.varea);
+        if (memory == nullptr || !swap_candidate(*memory) ||
+            map_area.nullable())
+        {
+            continue;
+        }
+
+        VirAddr cursor = map_area.begin;
+        while (cursor < map_area.end) {
+            size_t count = 0;
+            bool stopped = false;
+            _pman.walk_leaves(
+                cursor, map_area.end,
+                [&](VirAddr vaddr, PageMan::PTE *pte,
+                    PageMan::PageSize size) -> bool {
+                    cursor = vaddr + PageMan::psize(size);
+                    if (size != PageMan::PageSize::_4K ||
+                        !within(block, PageMan::get_physical_address(*pte)))
+                    {
+                        return true;
+                    }
+                    size_t offset = memory_offset_for_page(vma, vaddr);
+                    if (!migratable(*memory, offset)) {
+                        return true;
+                    }
+                    // 先撤下映射, 复制期间的访问不会写到旧页
+                    victims[count++] = Victim{memory, offset, vaddr, pte, *pte};
+                    pte->value       = 0;
+                    tlb.add(vaddr, PAGESIZE);
+                    stopped = count == RECLAIM_BATCH;
+                    return !stopped;
+                });
+            if (!stopped) {
+                cursor = map_area.end;
+            }
+
+            tlb.flush();
+            for (size_t i = 0; i < count; ++i) {
+                Victim &victim = victims[i];
+                PhyAddr src    = PageMan::get_physical_address(victim.saved);
+                PhyAddr dst    = PhyAddr::null;
+                if (auto dst_res = alloc(); dst_res.has_value()) {
+                    dst = dst_res.value();
+                    memcpy(convert<KpaAddr>(dst).addr(),
+                           convert<KpaAddr>(src).addr(), PAGESIZE);
+                    auto replace_res =
+                        victim.memory->replace_page(victim.offset, dst);
+                    if (!replace_res.has_value()) {
+                        GFP::put_page(dst, 1);
+                        dst = PhyAddr::null;
+                    }
+                }
+                // 迁移失败时恢复原映射
+                *victim.pte = victim.saved;
+                if (dst.nonnull()) {
+                    PageMan::set_paddr(victim.pte, dst);
+                    migrated++;
+                }
+                tlb.add(victim.vaddr, PAGESIZE);
+            }
+            tlb.flush();
+        }
+    }
+    return migrated;
+}
+
+size_t TaskMemoryManager::migrate_pages(
+    const PhyArea &block,
+    const std::function<Result<PhyAddr>()> &alloc) noexcept {
+    // 与 reclaim 相同, 页复制与 TLB 击落都在登记表锁外进行
+    TaskMemoryManager *batch[PIN_BATCH];
+    size_t pos      = 0;
+    size_t budget   = static_cast<size_t>(-1);
+    size_t migrated = 0;
+    while (budget > 0) {
+        size_t count = pin_tmms(pos, budget, false, batch);
+        for (size_t i = 0; i < count; ++i) {
+            migrated += batch[i]->migrate_from(block, alloc);
+        }
+        unpin_tmms(batch, count);
+    }
+    if (migrated != 0) {
+        loggers::PAGING::DEBUG("TM::migrate_pages: block=[%p, %p) migrated=%lu",
+                               block.begin.addr(), block.end.addr(), migrated);
+    }
+    return migrated;
+}
+
 bool TaskMemoryManager::on_np(const NoPresentEvent &e) {
     loggers::PAGING::DEBUG(
         "TM::on_np: access_address=%p, tm_pgd=%p, pman_root=%p",
@@ -471,50 +1097,48 @@ bool TaskMemoryManager::on_np(const NoPresentEvent &e) {
         return false;
     }
 
+    // 读缺页映射零页即可, 不值得为其分配整个大页
+    bool use_zero = !e.write && zero_page_candidate(*memory);
+    if (!use_zero && thp_candidate(*vma, *memory) &&
+        try_map_huge(*vma, *memory, e.access_address))
+    {
+        np_fault_count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
     // locate the page in memory
     VirAddr aligned_vaddr = e.access_address.page_align_down();
     size_t mem_offset     = memory_offset_for_page(*vma, aligned_vaddr);
-    // 保证这个页在 vma->memory 中存在
-    auto ensure_res       = memory->ensure_page(mem_offset);
-    if (!ensure_res.has_value()) {
-        loggers::TASK::ERROR("无法处理缺页异常: err=%d", ensure_res.error());
-        return false;
+    // 保证这个页在 vma->memory 中存在, 一次查询同时取得地址与共享计数
+    auto ensure_entry = [&] {
+        return use_zero ? memory->ensure_read_page_entry(mem_offset)
+                        : memory->ensure_page_entry(mem_offset);
+    };
+    auto entry_res = ensure_entry();
+    if (!entry_res.has_value() &&
+        entry_res.error() == ErrCode::OUT_OF_MEMORY &&
+        Reclaim::direct_reclaim())
+    {
+        // 直接回收一批后重试一次
+        entry_res = ensure_entry();
     }
-    auto page_res = memory->lookup_page(mem_offset);
-    if (!page_res.has_value()) {
-        loggers::TASK::ERROR("缺页补页后查询失败: err=%d", page_res.error());
+    if (!entry_res.has_value()) {
+        loggers::TASK::ERROR("无法处理缺页异常: err=%d", entry_res.error());
         return false;
     }
-    PhyAddr paddr = page_res.value();
-    assert(paddr.nonnull());
-
-    // load the page
-    PageMan::RWX rwx  = VMA::prot_to_rwx(vma->prot);
-    auto refcount_res = memory->page_refcount(mem_offset);
-    if (!refcount_res.has_value()) {
-        loggers::PAGING::ERROR("TM::on_np: 无法获取页共享计数: addr=%p err=%d",
-                               aligned_vaddr.addr(), refcount_res.error());
-        return false;
-    }
-    // 是否需要 cow 标记
-    bool cow_page = !memory->shared && PageMan::is_writable(rwx) && refcount_res.value() > 1;
-    PageMan::RWX map_rwx = cow_page ? PageMan::without_write(rwx) : rwx;
+    assert(entry_res.value().addr.nonnull());
 
-    // 映射该页
-    _pman.map_page<PageMan::PageSize::_4K>(
-        aligned_vaddr, paddr, PageMan::page_flags(map_rwx, true, false));
-    if (cow_page) {
-        // cow 需要 cow 标记
-        auto query_res = _pman.query_page(aligned_vaddr);
-        if (query_res.has_value()) {
-            PageMan::protect_cow(query_res.value().pte, rwx);
-        }
-    }
-    // 刷新 tlb
-    _pman.flush_tlb();
-    loggers::PAGING::DEBUG("TM::on_np: mapped addr=%p page=%p cow=%d",
+    // 映射该页, 并顺带映射窗口内已驻留的相邻页
+    TLBGather tlb(_pman, _asid);
+    map_resident_page(*vma, *memory, aligned_vaddr, entry_res.value());
+    tlb.add(aligned_vaddr, PAGESIZE);
+    size_t around = fault_around(*vma, *memory, aligned_vaddr, tlb);
+    np_fault_count.fetch_add(1, std::memory_order_relaxed);
+    fault_around_pages.fetch_add(around, std::memory_order_relaxed);
+    tlb.flush();
+    loggers::PAGING::DEBUG("TM::on_np: mapped addr=%p page=%p around=%lu",
                            e.access_address.addr(), aligned_vaddr.addr(),
-                           cow_page);
+                           around);
 
     // 调试: 使用当前硬件页表根再次查询该页
     // PhyAddr hw_root = PageMan::read_root();
@@ -558,9 +1182,16 @@ bool TaskMemoryManager::on_wp(VirAddr fault_addr) {
     }
     auto qres = query_res.value();
     if (qres.size != PageMan::PageSize::_4K) {
-        loggers::PAGING::ERROR("TM::on_wp: COW 暂不支持大页: addr=%p",
-                               aligned_vaddr.addr());
-        return false;
+        auto split_res = split_huge_mapping(aligned_vaddr);
+        if (split_res.has_value()) {
+            query_res = _pman.query_page(aligned_vaddr);
+        }
+        if (!split_res.has_value() || !query_res.has_value()) {
+            loggers::PAGING::ERROR("TM::on_wp: 拆分大页失败: addr=%p",
+                                   aligned_vaddr.addr());
+            return false;
+        }
+        qres = query_res.value();
     }
     if (!PageMan::is_cow(*qres.pte)) {
         loggers::PAGING::ERROR("TM::on_wp: 写保护页不是 COW 页: addr=%p",
@@ -590,13 +1221,15 @@ bool TaskMemoryManager::on_wp(VirAddr fault_addr) {
                             PageMan::is_user_accessible(*qres.pte),
                             PageMan::is_global(*qres.pte),
                             PageMan::is_present(*qres.pte)));
-    PageMan::flush_tlb();
+    // 被拆分的大页叶子同样包含该地址, 按页失效即可
+    flush_tlb_range(_pman, _asid, aligned_vaddr, PAGESIZE);
     loggers::PAGING::DEBUG("TM::on_wp: resolved cow addr=%p page=%p",
                           fault_addr.addr(), aligned_vaddr.addr());
     return true;
 }
 
 Result<void> TaskMemoryManager::clone_to_cow(TaskMemoryManager &dst) {
+    TLBGather tlb(_pman, _asid);
     for (auto &vma : vma_list) {
         auto *source = vma.memory_payload();
         if (source == nullptr) {
@@ -613,58 +1246,134 @@ Result<void> TaskMemoryManager::clone_to_cow(TaskMemoryManager &dst) {
         }
         auto clone_res = clone_vma_pages_to_cow(vma, map_area, dst);
         propagate(clone_res);
+        tlb.add(map_area);
     }
-    _pman.flush_tlb();
-    dst.pman().flush_tlb();
+    // dst 是新建的地址空间, 不存在需要失效的旧项
     void_return();
 }
 
 Result<void> TaskMemoryManager::clone_vma_pages_to_cow(const VMA &vma,
                                                        const VirArea &map_area,
                                                        TaskMemoryManager &dst) {
-    size_t page_count = map_area.size() / PAGESIZE;
-    for (size_t i = 0; i < page_count; ++i) {
-        VirAddr vaddr  = map_area.begin + i * PAGESIZE;
-        auto query_res = _pman.query_page(vaddr);
-        if (!query_res.has_value()) {
-            if (query_res.error() == ErrCode::PAGE_NOT_PRESENT) {
-                continue;
+    auto *memory = vma.memory_payload();
+    if (memory == nullptr) {
+        unexpect_return(ErrCode::NULLPTR);
+    }
+
+    // 只访问实际存在的页表, 子进程的最后一级页表按 2M 区域缓存,
+    // 每页只需一次表项复制, 不再逐页从根开始查询与映射
+    ErrCode err          = ErrCode::SUCCESS;
+    PageMan::PTE *dst_pt = nullptr;
+    VirAddr dst_pt_base  = VirAddr::null;
+    _pman.walk_leaves(
+        map_area.begin, map_area.end,
+        [&](VirAddr vaddr, PageMan::PTE *pte, PageMan::PageSize size) -> bool {
+            if (size != PageMan::PageSize::_4K) {
+                // COW 以 4K 为粒度, fork 时先把父进程的大页拆开,
+                // 遍历随后进入拆分出的页表
+                auto split_res = split_huge_mapping(vaddr);
+                if (!split_res.has_value()) {
+                    err = split_res.error();
+                    return false;
+                }
+                return true;
             }
-            propagate_return(query_res);
-        }
 
-        auto qres = query_res.value();
-        if (qres.size != PageMan::PageSize::_4K) {
-            loggers::PAGING::ERROR("clone_to_cow: COW 暂不支持大页: addr=%p",
-                                   vaddr.addr());
-            unexpect_return(ErrCode::NOT_SUPPORTED);
-        }
+            VirAddr table_base = huge_align_down(vaddr);
+            if (dst_pt == nullptr || table_base != dst_pt_base) {
+                auto table_res = dst.pman().ensure_leaf_table(vaddr);
+                if (!table_res.has_value()) {
+                    err = table_res.error();
+                    return false;
+                }
+                dst_pt      = table_res.value();
+                dst_pt_base = table_base;
+            }
 
-        PhyAddr paddr    = PageMan::get_physical_address(*qres.pte);
-        PageMan::RWX rwx = PageMan::rwx(*qres.pte);
-        auto *memory     = vma.memory_payload();
-        if (memory == nullptr) {
-            unexpect_return(ErrCode::NULLPTR);
-        }
-        bool cow_page    = !memory->shared && (PageMan::is_writable(rwx) ||
-                                             PageMan::is_cow(*qres.pte));
-        PageMan::RWX child_rwx = cow_page ? PageMan::without_write(rwx) : rwx;
+            PageMan::PTE *child = &dst_pt[PageMan::leaf_index(vaddr)];
+            *child              = *pte;
+
+            PageMan::RWX rwx = PageMan::rwx(*pte);
+            if (!memory->shared &&
+                (PageMan::is_writable(rwx) || PageMan::is_cow(*pte)))
+            {
+                PageMan::protect_cow(pte, rwx);
+                PageMan::protect_cow(child, rwx);
+            }
+            return true;
+        });
+    if (err != ErrCode::SUCCESS) {
+        unexpect_return(err);
+    }
+    void_return();
+}
+
+bool TaskMemoryManager::try_map_huge(VMA &vma, cap::MemoryPayload &memory,
+                                     VirAddr fault_addr) {
+    VirAddr huge_vaddr = huge_align_down(fault_addr);
+    if (huge_vaddr < vma.varea.begin ||
+        vma.varea.end < huge_vaddr + HUGE_PAGE_SIZE)
+    {
+        return false;
+    }
+    size_t mem_offset = memory_offset_for_page(vma, huge_vaddr);
+    if (mem_offset % HUGE_PAGE_SIZE != 0) {
+        return false;
+    }
+    if (!_pman.prepare_leaf_slot<PageMan::PageSize::_2M>(huge_vaddr)) {
+        return false;
+    }
 
-        dst.pman().map_page<PageMan::PageSize::_4K>(
-            vaddr, paddr,
-            PageMan::page_flags(
-                child_rwx, PageMan::is_user_accessible(*qres.pte),
-                PageMan::is_global(*qres.pte), PageMan::is_present(*qres.pte)));
+    auto huge_res = memory.ensure_huge_page(mem_offset);
+    if (!huge_res.has_value()) {
+        loggers::PAGING::DEBUG("TM::on_np: 大页不可用, 回退到 4K: addr=%p err=%s",
+                               huge_vaddr.addr(),
+                               to_cstring(huge_res.error()));
+        return false;
+    }
 
-        if (cow_page) {
-            PageMan::protect_cow(qres.pte, rwx);
+    PageMan::RWX rwx = VMA::prot_to_rwx(vma.prot);
+    _pman.map_page<PageMan::PageSize::_2M>(
+        huge_vaddr, huge_res.value(), PageMan::page_flags(rwx, true, false));
+    // prepare_leaf_slot 可能回收了下级页表, 按地址失效不覆盖非叶子项
+    _pman.flush_tlb();
+    loggers::PAGING::DEBUG("TM::on_np: mapped huge addr=%p page=%p",
+                           fault_addr.addr(), huge_vaddr.addr());
+    return true;
+}
 
-            auto dst_query_res = dst.pman().query_page(vaddr);
-            if (!dst_query_res.has_value()) {
-                propagate_return(dst_query_res);
-            }
-            PageMan::protect_cow(dst_query_res.value().pte, rwx);
+Result<void> TaskMemoryManager::split_huge_mapping(VirAddr vaddr) {
+    auto query_res = _pman.query_page(vaddr);
+    propagate(query_res);
+    auto qres = query_res.value();
+    if (qres.size == PageMan::PageSize::_4K) {
+        void_return();
+    }
+    if (qres.size != PageMan::PageSize::_2M) {
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
+
+    VirAddr huge_vaddr = huge_align_down(vaddr);
+    PageMan::PTE leaf  = *qres.pte;
+    PhyAddr huge_paddr = PageMan::get_physical_address(leaf);
+    bool cow           = PageMan::is_cow(leaf);
+    // 用户页从不是全局页, 不沿用大页表项中与 HUGE 复用的位
+    PageMan::PageFlags flags =
+        PageMan::page_flags(PageMan::rwx(leaf), PageMan::is_user_accessible(leaf),
+                            false, PageMan::is_present(leaf));
+
+    _pman.unmap_page(huge_vaddr);
+    for (size_t i = 0; i < cap::MemoryPayload::HUGE_PAGE_PAGES; ++i) {
+        VirAddr page_vaddr = huge_vaddr + i * PAGESIZE;
+        _pman.map_page<PageMan::PageSize::_4K>(page_vaddr,
+                                               huge_paddr + i * PAGESIZE, flags);
+        if (cow) {
+            auto page_res = _pman.query_page(page_vaddr);
+            propagate(page_res);
+            PageMan::set_cow(page_res.value().pte, true);
         }
     }
+    loggers::PAGING::DEBUG("TM::split_huge_mapping: addr=%p paddr=%p",
+                           huge_vaddr.addr(), huge_paddr.addr());
     void_return();
 }
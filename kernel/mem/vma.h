@@ -13,6 +13,9 @@
 
 #include <fwd.h>
 #include <arch/description.h>
+#include <mem/asid.h>
+#include <mem/tlb.h>
+#include <mem/vma_tree.h>
 #include <object/memory.h>
 #include <sus/list.h>
 #include <sus/nonnull.h>
@@ -101,6 +104,7 @@ struct VMA {
     size_t mem_offset          = 0;
     VirArea varea;
     util::ListHead<VMA> list_head = {};
+    VMATreeNode tree_node         = {};
 
     constexpr VMA() = default;
     /**
@@ -127,6 +131,7 @@ struct VMA {
           varea(varea),
           list_head({}) {
         assert(memory != nullptr);
+        memory->map_count++;
     }
     /**
      * @brief 从已有 VMA 克隆元数据并绑定到指定 Memory. 
@@ -144,6 +149,7 @@ struct VMA {
           varea(other.varea),
           list_head({}) {
         assert(memory != nullptr);
+        memory->map_count++;
     }
     VMA(const VMA &other)            = delete;
     VMA &operator=(const VMA &other) = delete;
@@ -154,6 +160,9 @@ struct VMA {
      */
     ~VMA() {
         if (memory != nullptr) {
+            if (auto *payload = memory_payload(); payload != nullptr) {
+                payload->map_count--;
+            }
             delete memory.get();
             memory = util::owner<cap::Capability *>(nullptr);
         }
@@ -187,9 +196,33 @@ constexpr const char *to_string(VMA::Type type) {
 
 // Task Memory
 class TaskMemoryManager {
+public:
+    /// 缺页时预映射的对齐窗口页数
+    static constexpr size_t FAULT_AROUND_PAGES = 16;
+    /// 每批最多换出的页数
+    static constexpr size_t RECLAIM_BATCH = 32;
+
+    /**
+     * @brief 缺页处理统计的快照.
+     */
+    struct FaultStats {
+        /// on_np 成功处理的缺页次数
+        size_t faults;
+        /// fault-around 预先映射的页数, 即至多可避免的缺页次数
+        size_t around_pages;
+    };
+
 private:
     struct ExistingPgdTag {};
+    /// 回收扫描可能仍持有引用, 只能经由 release/destroy 析构
+    ~TaskMemoryManager();
     util::IntrusiveList<VMA> vma_list;
+    /// 与 vma_list 同序的地址索引
+    VMATree _vma_tree;
+    /// VMA 布局版本, 每次增删或调整 VMA 范围都会更换
+    uint64_t _generation;
+    /// 该地址空间的 ASID, 首次切换时分配
+    AsidContext _asid;
     PhyAddr _pgd;
     PageMan _pman;
 
@@ -201,8 +234,83 @@ private:
     }
 
     void unmap_pages(const VirArea &varea);
+    /**
+     * @brief 将 VMA 按起点顺序链入 vma_list 与地址索引.
+     */
+    void link_vma(VMA &vma) noexcept;
+    /**
+     * @brief 记录 VMA 布局变化, 使所有线程的 VMACache 失效.
+     */
+    void layout_changed() noexcept;
+    /**
+     * @brief VMA 范围被原地修改后同步索引.
+     */
+    void vma_resized(VMA &vma) noexcept;
+    /**
+     * @brief 按 vma_list 顺序查找第一个包含 vaddr 且满足 pred 的 VMA.
+     *
+     * 空 VMA 仅在起点等于 vaddr 时视为包含.
+     */
+    template <typename Pred>
+    [[nodiscard]]
+    VMA *find_vma(VirAddr vaddr, Pred &&pred) const;
+    /**
+     * @brief 按 vma_list 顺序查找第一个与 varea 相交的 VMA.
+     *
+     * @param skip 需要忽略的 VMA, 可为空
+     */
+    [[nodiscard]]
+    VMA *find_intersecting(const VirArea &varea, const VMA *skip) const;
     Result<void> clone_vma_pages_to_cow(const VMA &vma, const VirArea &map_area,
                                         TaskMemoryManager &dst);
+    /**
+     * @brief 尝试以透明大页满足缺页.
+     *
+     * @return true 已建立 2M 映射; false 不满足条件或大页分配失败, 应回退到 4K 页
+     */
+    bool try_map_huge(VMA &vma, cap::MemoryPayload &memory, VirAddr fault_addr);
+    /**
+     * @brief 以 VMA 权限映射 payload 中已存在的一页.
+     *
+     * 页仍处于 COW 共享状态时映射为写保护并打上 COW 标记. 调用方负责刷新 TLB.
+     */
+    void map_resident_page(const VMA &vma, const cap::MemoryPayload &memory,
+                           VirAddr aligned_vaddr, const cap::PhyPage &page);
+    /**
+     * @brief 预映射缺页地址所在对齐窗口内 payload 已驻留的页.
+     *
+     * 只映射尚无页表项的页, 不会分配新页或读取文件.
+     *
+     * @param tlb 收集新映射页的失效范围
+     * @return 新映射的页数
+     */
+    size_t fault_around(const VMA &vma, const cap::MemoryPayload &memory,
+                        VirAddr aligned_vaddr, TLBGather &tlb);
+    /**
+     * @brief 将 vaddr 所在的 2M 叶子映射拆分为 512 个属性相同的 4K 映射.
+     *
+     * vaddr 处已是 4K 映射时不做任何操作. 调用方负责刷新 TLB.
+     */
+    Result<void> split_huge_mapping(VirAddr vaddr);
+    /**
+     * @brief 把该地址空间中至多 budget 个冷匿名页压缩换出到 ZRam.
+     *
+     * 只考虑 4K 映射; 访问位被置位的页只清除访问位, 留到下一轮.
+     *
+     * @return 换出的页数
+     */
+    size_t swap_out_cold(size_t budget);
+    /**
+     * @brief 把该地址空间中物理地址落在 block 内的可迁移匿名页搬到新页.
+     *
+     * 可迁移的条件与可换出相同, 且不拆散透明大页.
+     * 页表项原地改写为新页, 保留权限与访问/脏位.
+     *
+     * @param alloc 提供迁移目标页, 不得返回 block 内的页
+     * @return 迁移的页数
+     */
+    size_t migrate_from(const PhyArea &block,
+                        const std::function<Result<PhyAddr>()> &alloc);
 
 public:
     TaskMemoryManager(PhyAddr _pgd);
@@ -210,7 +318,22 @@ public:
     [[nodiscard]]
     static Result<util::owner<TaskMemoryManager *>> from_existing_pgd(
         PhyAddr pgd) noexcept;
-    ~TaskMemoryManager();
+
+    /**
+     * @brief 释放地址空间, 代替 delete.
+     *
+     * 回收扫描仍持有引用时只做标记, 由最后一次解除引用的扫描完成析构,
+     * 调用方不会阻塞.
+     *
+     * @param put_pgd 析构后是否一并归还页目录页
+     */
+    static void release(util::owner<TaskMemoryManager *> tmm,
+                        bool put_pgd = true) noexcept;
+
+    /**
+     * @brief 立即析构, 只能在登记表中已无该地址空间时调用.
+     */
+    static void destroy(TaskMemoryManager *tmm, bool put_pgd) noexcept;
 
     /**
      * @brief 创建一个 Memory-backed VMA. 
@@ -233,6 +356,16 @@ public:
                                          size_t mem_offset = 0);
     Result<util::nonnull<VMA *>> locate(VirAddr vaddr);
     Result<util::nonnull<VMA *>> locate_range(const VirArea &varea);
+    /**
+     * @brief 在 window 内查找最低的、长度至少为 size 的未映射区间.
+     *
+     * @param window 搜索范围.
+     * @param size 需要的长度, 结果按页对齐.
+     * @return 区间起点; 空间不足时返回 OUT_OF_MEMORY.
+     */
+    [[nodiscard]]
+    Result<VirAddr> find_unmapped_area(const VirArea &window,
+                                       size_t size) const;
     /**
      * @brief 定位指定 Memory 在某虚拟地址处的 VMA. 
      *
@@ -252,6 +385,10 @@ public:
      * 生命周期管理. 
      */
     Result<void> remove_vma(util::nonnull<VMA *> vma);
+    /**
+     * @brief 同上, 但只将失效范围记入 tlb, 由调用方统一刷新.
+     */
+    Result<void> remove_vma(util::nonnull<VMA *> vma, TLBGather &tlb);
     Result<void> remove_vma_range(const VirArea &varea);
     Result<VirArea> grow_vma(util::nonnull<VMA *> vma, const VirArea &varea);
     /**
@@ -323,6 +460,35 @@ public:
         return _pman;
     }
 
+    /**
+     * @brief 在当前 hart 上切换到该地址空间, 按需分配 ASID.
+     *
+     * 持有有效 ASID 时不刷新 TLB.
+     */
+    void activate() noexcept;
+
+    [[nodiscard]]
+    static FaultStats get_fault_stats() noexcept;
+
+    /**
+     * @brief 从上次停下的地址空间起轮流扫描, 换出冷匿名页.
+     *
+     * @param target 期望换出的页数
+     * @return 实际换出的页数
+     */
+    static size_t reclaim(size_t target) noexcept;
+
+    /**
+     * @brief 在全部地址空间中迁移物理地址落在 block 内的匿名页.
+     *
+     * 供内存整理腾空目标块使用.
+     *
+     * @return 迁移的页数
+     */
+    static size_t migrate_pages(
+        const PhyArea &block,
+        const std::function<Result<PhyAddr>()> &alloc) noexcept;
+
     // On No Present Pages
     bool on_np(const NoPresentEvent &e);
     // write protection
@@ -0,0 +1,332 @@
+/**
+ * @file vma_tree.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief VMA 地址索引
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/vma.h>
+#include <mem/vma_tree.h>
+
+#include <algorithm>
+
+namespace {
+    [[nodiscard]]
+    VMATreeNode &node_of(VMA *vma) noexcept {
+        return vma->tree_node;
+    }
+
+    [[nodiscard]]
+    int height_of(const VMA *vma) noexcept {
+        return vma == nullptr ? 0 : vma->tree_node.height;
+    }
+
+    /**
+     * @brief 一段按地址排序的非空 VMA 序列的摘要.
+     */
+    struct Span {
+        bool has;
+        VirAddr begin;
+        VirAddr end;
+        size_t gap;
+    };
+
+    [[nodiscard]]
+    Span span_of(const VMA *vma) noexcept {
+        if (vma == nullptr || !vma->tree_node.has_span) {
+            return Span{false, VirAddr::null, VirAddr::null, 0};
+        }
+        const auto &node = vma->tree_node;
+        return Span{true, node.min_begin, node.max_end, node.max_gap};
+    }
+
+    /**
+     * @brief 拼接前后相邻的两段序列.
+     */
+    [[nodiscard]]
+    Span join(const Span &front, const Span &back) noexcept {
+        if (!front.has) {
+            return back;
+        }
+        if (!back.has) {
+            return front;
+        }
+        size_t between =
+            back.begin > front.end ? static_cast<size_t>(back.begin - front.end)
+                                   : 0;
+        return Span{true, front.begin, std::max(front.end, back.end),
+                    std::max(std::max(front.gap, back.gap), between)};
+    }
+
+    void update(VMA *vma) noexcept {
+        auto &node  = node_of(vma);
+        node.height = 1 + std::max(height_of(node.left), height_of(node.right));
+
+        Span span = span_of(node.left);
+        if (vma->varea.size() != 0) {
+            span = join(span, Span{true, vma->varea.begin, vma->varea.end, 0});
+        }
+        span = join(span, span_of(node.right));
+
+        node.has_span  = span.has;
+        node.min_begin = span.begin;
+        node.max_end   = span.end;
+        node.max_gap   = span.gap;
+    }
+
+    [[nodiscard]]
+    VMA *leftmost(VMA *vma) noexcept {
+        while (vma != nullptr && vma->tree_node.left != nullptr) {
+            vma = vma->tree_node.left;
+        }
+        return vma;
+    }
+
+    [[nodiscard]]
+    VMA *rightmost(VMA *vma) noexcept {
+        while (vma != nullptr && vma->tree_node.right != nullptr) {
+            vma = vma->tree_node.right;
+        }
+        return vma;
+    }
+
+    /**
+     * @brief 按地址顺序在子树中查找空洞.
+     *
+     * cursor 为子树之前所有非空 VMA 的最高终点 (不低于窗口下界),
+     * 返回时推进到子树之后.
+     */
+    bool search_gap(const VMA *vma, VirAddr &cursor, VirAddr limit,
+                    size_t size, VirAddr &out) noexcept {
+        if (vma == nullptr || !vma->tree_node.has_span) {
+            return false;
+        }
+        const auto &node = vma->tree_node;
+        size_t lead =
+            node.min_begin > cursor ? static_cast<size_t>(node.min_begin - cursor)
+                                    : 0;
+        // 子树之前与子树内部都没有足够大的空洞, 整棵跳过
+        if (lead < size && node.max_gap < size) {
+            cursor = std::max(cursor, node.max_end);
+            return false;
+        }
+
+        if (search_gap(node.left, cursor, limit, size, out)) {
+            return true;
+        }
+        if (vma->varea.size() != 0) {
+            VirAddr candidate = cursor.page_align_up();
+            if (candidate < vma->varea.begin &&
+                static_cast<size_t>(vma->varea.begin - candidate) >= size &&
+                candidate <= limit &&
+                static_cast<size_t>(limit - candidate) >= size)
+            {
+                out = candidate;
+                return true;
+            }
+            cursor = std::max(cursor, vma->varea.end);
+            if (cursor >= limit) {
+                return false;
+            }
+        }
+        return search_gap(node.right, cursor, limit, size, out);
+    }
+}  // namespace
+
+void VMATree::replace_child(VMA *parent, VMA *old_child,
+                            VMA *new_child) noexcept {
+    if (parent == nullptr) {
+        _root = new_child;
+    } else if (node_of(parent).left == old_child) {
+        node_of(parent).left = new_child;
+    } else {
+        node_of(parent).right = new_child;
+    }
+    if (new_child != nullptr) {
+        node_of(new_child).parent = parent;
+    }
+}
+
+VMA *VMATree::rotate_left(VMA *node) noexcept {
+    VMA *pivot          = node_of(node).right;
+    node_of(node).right = node_of(pivot).left;
+    if (node_of(pivot).left != nullptr) {
+        node_of(node_of(pivot).left).parent = node;
+    }
+    replace_child(node_of(node).parent, node, pivot);
+    node_of(pivot).left  = node;
+    node_of(node).parent = pivot;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+VMA *VMATree::rotate_right(VMA *node) noexcept {
+    VMA *pivot         = node_of(node).left;
+    node_of(node).left = node_of(pivot).right;
+    if (node_of(pivot).right != nullptr) {
+        node_of(node_of(pivot).right).parent = node;
+    }
+    replace_child(node_of(node).parent, node, pivot);
+    node_of(pivot).right = node;
+    node_of(node).parent = pivot;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+VMA *VMATree::rebalance(VMA *node) noexcept {
+    update(node);
+    auto &links = node_of(node);
+    int balance = height_of(links.left) - height_of(links.right);
+    if (balance > 1) {
+        VMA *left = links.left;
+        if (height_of(node_of(left).left) < height_of(node_of(left).right)) {
+            rotate_left(left);
+        }
+        return rotate_right(node);
+    }
+    if (balance < -1) {
+        VMA *right = links.right;
+        if (height_of(node_of(right).right) < height_of(node_of(right).left)) {
+            rotate_right(right);
+        }
+        return rotate_left(node);
+    }
+    return node;
+}
+
+void VMATree::fixup(VMA *node) noexcept {
+    // 增强信息依赖全部后代, 因此总是一路更新到根
+    while (node != nullptr) {
+        node = node_of(rebalance(node)).parent;
+    }
+}
+
+void VMATree::insert(VMA &vma) noexcept {
+    node_of(&vma) = VMATreeNode{};
+    VMA *parent   = nullptr;
+    VMA *cur      = _root;
+    bool as_left  = false;
+    while (cur != nullptr) {
+        parent  = cur;
+        // 起点相同的 VMA 放在右侧, 保持插入顺序
+        as_left = vma.varea.begin < cur->varea.begin;
+        cur     = as_left ? node_of(cur).left : node_of(cur).right;
+    }
+
+    node_of(&vma).parent = parent;
+    if (parent == nullptr) {
+        _root = &vma;
+    } else if (as_left) {
+        node_of(parent).left = &vma;
+    } else {
+        node_of(parent).right = &vma;
+    }
+    fixup(&vma);
+}
+
+void VMATree::erase(VMA &vma) noexcept {
+    auto &links   = node_of(&vma);
+    VMA *fix_from = nullptr;
+
+    if (links.left == nullptr || links.right == nullptr) {
+        VMA *child = links.left != nullptr ? links.left : links.right;
+        fix_from   = links.parent;
+        replace_child(links.parent, &vma, child);
+    } else {
+        VMA *succ = leftmost(links.right);
+        if (succ != links.right) {
+            fix_from = node_of(succ).parent;
+            replace_child(node_of(succ).parent, succ, node_of(succ).right);
+            node_of(succ).right         = links.right;
+            node_of(links.right).parent = succ;
+        } else {
+            fix_from = succ;
+        }
+        node_of(succ).left         = links.left;
+        node_of(links.left).parent = succ;
+        replace_child(links.parent, &vma, succ);
+    }
+
+    links = VMATreeNode{};
+    fixup(fix_from);
+}
+
+void VMATree::refresh(VMA &vma) noexcept {
+    fixup(&vma);
+}
+
+VMA *VMATree::floor(VirAddr vaddr) const noexcept {
+    VMA *found = nullptr;
+    VMA *cur   = _root;
+    while (cur != nullptr) {
+        if (cur->varea.begin <= vaddr) {
+            found = cur;
+            cur   = cur->tree_node.right;
+        } else {
+            cur = cur->tree_node.left;
+        }
+    }
+    return found;
+}
+
+VMA *VMATree::first() const noexcept {
+    return leftmost(_root);
+}
+
+VMA *VMATree::next(const VMA *vma) noexcept {
+    const auto &links = vma->tree_node;
+    if (links.right != nullptr) {
+        return leftmost(links.right);
+    }
+    const VMA *child = vma;
+    VMA *parent      = links.parent;
+    while (parent != nullptr && parent->tree_node.right == child) {
+        child  = parent;
+        parent = parent->tree_node.parent;
+    }
+    return parent;
+}
+
+VMA *VMATree::prev(const VMA *vma) noexcept {
+    const auto &links = vma->tree_node;
+    if (links.left != nullptr) {
+        return rightmost(links.left);
+    }
+    const VMA *child = vma;
+    VMA *parent      = links.parent;
+    while (parent != nullptr && parent->tree_node.left == child) {
+        child  = parent;
+        parent = parent->tree_node.parent;
+    }
+    return parent;
+}
+
+Result<VirAddr> VMATree::find_gap(const VirArea &window,
+                                  size_t size) const noexcept {
+    if (size == 0 || window.nullable() || window.size() < size) {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+    VirAddr cursor = window.begin;
+    VirAddr found  = VirAddr::null;
+    if (search_gap(_root, cursor, window.end, size, found)) {
+        return found;
+    }
+    // 最后一个 VMA 之后的尾部空间
+    VirAddr candidate = cursor.page_align_up();
+    if (candidate <= window.end &&
+        static_cast<size_t>(window.end - candidate) >= size)
+    {
+        return candidate;
+    }
+    unexpect_return(ErrCode::OUT_OF_MEMORY);
+}
+
+size_t VMATree::max_gap() const noexcept {
+    return _root == nullptr ? 0 : _root->tree_node.max_gap;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file vma_tree.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief VMA 地址索引
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sustcore/addr.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+
+struct VMA;
+class TaskMemoryManager;
+
+/**
+ * @brief VMA 在地址索引树中的侵入式节点.
+ *
+ * 除 AVL 链接外, 每个节点还维护以它为根的子树中非空 VMA 的
+ * 最低起点、最高终点与相邻 VMA 间的最大空洞, 用于快速查找空闲区间.
+ */
+struct VMATreeNode {
+    VMA *parent = nullptr;
+    VMA *left   = nullptr;
+    VMA *right  = nullptr;
+    int height  = 0;
+    /// 子树中是否存在非空 VMA, 为 false 时以下三项无意义.
+    bool has_span     = false;
+    VirAddr min_begin = VirAddr::null;
+    VirAddr max_end   = VirAddr::null;
+    size_t max_gap    = 0;
+};
+
+/**
+ * @brief 按起始地址排序的 VMA AVL 树.
+ *
+ * 只保存排序与增强信息, 不拥有 VMA. 起点相同的 VMA 按插入顺序排列,
+ * 与 TaskMemoryManager 的 vma_list 顺序一致.
+ * VMA 的 varea 被原地修改后必须调用 refresh(), 修改不得改变其相对顺序.
+ */
+class VMATree {
+private:
+    VMA *_root = nullptr;
+
+    void replace_child(VMA *parent, VMA *old_child, VMA *new_child) noexcept;
+    VMA *rotate_left(VMA *node) noexcept;
+    VMA *rotate_right(VMA *node) noexcept;
+    VMA *rebalance(VMA *node) noexcept;
+    /**
+     * @brief 自 node 向上重算高度与增强信息并恢复平衡.
+     */
+    void fixup(VMA *node) noexcept;
+
+public:
+    VMATree() = default;
+
+    VMATree(const VMATree &)            = delete;
+    VMATree &operator=(const VMATree &) = delete;
+
+    void insert(VMA &vma) noexcept;
+    void erase(VMA &vma) noexcept;
+    /**
+     * @brief VMA 范围原地变化后更新增强信息.
+     */
+    void refresh(VMA &vma) noexcept;
+
+    /**
+     * @brief 丢弃整棵树, 不修改各 VMA 的节点.
+     */
+    void clear() noexcept {
+        _root = nullptr;
+    }
+
+    /**
+     * @brief 查找起点不大于 vaddr 的最后一个 VMA.
+     */
+    [[nodiscard]]
+    VMA *floor(VirAddr vaddr) const noexcept;
+    [[nodiscard]]
+    VMA *first() const noexcept;
+    [[nodiscard]]
+    static VMA *next(const VMA *vma) noexcept;
+    [[nodiscard]]
+    static VMA *prev(const VMA *vma) noexcept;
+
+    /**
+     * @brief 在 window 内查找最低的、长度至少为 size 的页对齐空闲区间.
+     *
+     * @return 区间起点; 没有足够大的空洞时返回 OUT_OF_MEMORY
+     */
+    [[nodiscard]]
+    Result<VirAddr> find_gap(const VirArea &window, size_t size) const noexcept;
+
+    /**
+     * @brief 任意两个相邻非空 VMA 之间的最大空洞.
+     */
+    [[nodiscard]]
+    size_t max_gap() const noexcept;
+};
+
+/**
+ * @brief 线程私有的最近命中 VMA 缓存.
+ *
+ * 仅当 tmm 与 generation 均与当前地址空间一致时 vma 才有效,
+ * 地址空间的任何布局变化都会更换 generation.
+ */
+struct VMACache {
+    const TaskMemoryManager *tmm = nullptr;
+    uint64_t generation          = 0;
+    VMA *vma                     = nullptr;
+};
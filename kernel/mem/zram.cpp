@@ -0,0 +1,132 @@
+/**
+ * @file zram.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 内存内压缩交换区
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <driver/clock.h>
+#include <env.h>
+#include <logger.h>
+#include <mem/lz4.h>
+#include <mem/zram.h>
+#include <spinlock.h>
+
+#include <cstring>
+
+namespace {
+    struct ZRamState {
+        ZRam::Stats stats{};
+        SpinLocker lock;
+    };
+
+    ZRamState zram_state;
+
+    /**
+     * @brief 句柄指向的内存块: 压缩长度后紧跟压缩数据.
+     */
+    [[nodiscard]]
+    uint8_t *handle_block(ZRam::Handle handle) noexcept {
+        return reinterpret_cast<uint8_t *>(handle);
+    }
+
+    [[nodiscard]]
+    size_t block_length(const uint8_t *block) noexcept {
+        size_t len;
+        memcpy(&len, block, sizeof(len));
+        return len;
+    }
+
+    [[nodiscard]]
+    size_t now_ns() noexcept {
+        auto *time_keeper =
+            env::hart_ctx != nullptr ? env::hart_ctx->time_keeper() : nullptr;
+        if (time_keeper == nullptr || time_keeper->source() == nullptr) {
+            return 0;
+        }
+        return static_cast<size_t>(
+            time_keeper->source()
+                ->to_ns(time_keeper->source()->now())
+                .to_nanoseconds());
+    }
+}  // namespace
+
+Result<ZRam::Handle> ZRam::store(PhyAddr page) noexcept {
+    const auto *src =
+        static_cast<const uint8_t *>(convert<KpaAddr>(page).addr());
+
+    // 压缩与分配都在锁外进行, 锁只保护统计, 不延长关中断的时间
+    auto *buffer = new uint8_t[sizeof(size_t) + MAX_STORED_SIZE];
+    if (buffer == nullptr) {
+        unexpect_return(ErrCode::OUT_OF_MEMORY);
+    }
+    size_t len = lz4::compress(src, PAGESIZE, buffer + sizeof(size_t),
+                               MAX_STORED_SIZE);
+    if (len == 0) {
+        delete[] buffer;
+        IrqSaveGuardedLock guard(zram_state.lock);
+        zram_state.stats.rejects++;
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
+
+    // 按压缩后的大小重新分配; 失败时保留上限大小的缓冲区
+    auto *block = new uint8_t[sizeof(size_t) + len];
+    if (block == nullptr) {
+        block = buffer;
+    } else {
+        memcpy(block + sizeof(size_t), buffer + sizeof(size_t), len);
+        delete[] buffer;
+    }
+    memcpy(block, &len, sizeof(len));
+
+    IrqSaveGuardedLock guard(zram_state.lock);
+    zram_state.stats.stored_pages++;
+    zram_state.stats.compr_bytes += len;
+    zram_state.stats.swap_outs++;
+    return reinterpret_cast<Handle>(block);
+}
+
+Result<void> ZRam::load(Handle handle, PhyAddr page) noexcept {
+    size_t start   = now_ns();
+    uint8_t *block = handle_block(handle);
+    size_t len     = block_length(block);
+    auto *dst      = static_cast<uint8_t *>(convert<KpaAddr>(page).addr());
+
+    auto res = lz4::decompress(block + sizeof(size_t), len, dst, PAGESIZE);
+    if (!res.has_value() || res.value() != PAGESIZE) {
+        // 压缩数据只由 store 写入, 损坏意味着内存被踩
+        loggers::PAGING::ERROR("ZRam::load: 压缩数据损坏: handle=%p",
+                               reinterpret_cast<void *>(handle));
+        unexpect_return(ErrCode::IO_ERROR);
+    }
+    drop(handle);
+
+    size_t elapsed = now_ns() - start;
+    IrqSaveGuardedLock guard(zram_state.lock);
+    zram_state.stats.swap_ins++;
+    zram_state.stats.swapin_ns_total += elapsed;
+    if (elapsed > zram_state.stats.swapin_ns_max) {
+        zram_state.stats.swapin_ns_max = elapsed;
+    }
+    void_return();
+}
+
+void ZRam::drop(Handle handle) noexcept {
+    uint8_t *block = handle_block(handle);
+    size_t len     = block_length(block);
+    {
+        IrqSaveGuardedLock guard(zram_state.lock);
+        zram_state.stats.stored_pages--;
+        zram_state.stats.compr_bytes -= len;
+    }
+    delete[] block;
+}
+
+ZRam::Stats ZRam::get_stats() noexcept {
+    IrqSaveGuardedLock guard(zram_state.lock);
+    return zram_state.stats;
+}
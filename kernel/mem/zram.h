@@ -0,0 +1,74 @@
+/**
+ * @file zram.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 内存内压缩交换区
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sustcore/addr.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+
+/**
+ * @brief 以 LZ4 压缩保存被换出的匿名页.
+ *
+ * 每个换出页对应一块按压缩后大小分配的内核堆内存, 句柄即其地址.
+ * 压缩后仍超过 MAX_STORED_SIZE 的页视为不可压缩, 拒绝换出.
+ */
+class ZRam {
+public:
+    /// 换出页的句柄, 非 0
+    using Handle = addr_t;
+
+    /// 压缩后超过该字节数的页不值得保存
+    static constexpr size_t MAX_STORED_SIZE = PAGESIZE * 3 / 4;
+
+    /**
+     * @brief 统计信息的快照.
+     */
+    struct Stats {
+        /// 当前保存的页数
+        size_t stored_pages;
+        /// 当前保存的压缩数据字节数
+        size_t compr_bytes;
+        /// 累计换出页数
+        size_t swap_outs;
+        /// 累计换入页数
+        size_t swap_ins;
+        /// 因不可压缩被拒绝的页数
+        size_t rejects;
+        /// 累计换入耗时
+        size_t swapin_ns_total;
+        /// 单次换入的最大耗时
+        size_t swapin_ns_max;
+    };
+
+    /**
+     * @brief 压缩保存一页, 不释放原页.
+     *
+     * @return 句柄; 不可压缩返回 NOT_SUPPORTED, 内存不足返回 OUT_OF_MEMORY
+     */
+    [[nodiscard]]
+    static Result<Handle> store(PhyAddr page) noexcept;
+
+    /**
+     * @brief 把句柄对应的数据解压到 page 并释放句柄.
+     */
+    [[nodiscard]]
+    static Result<void> load(Handle handle, PhyAddr page) noexcept;
+
+    /**
+     * @brief 丢弃句柄对应的数据.
+     */
+    static void drop(Handle handle) noexcept;
+
+    [[nodiscard]]
+    static Stats get_stats() noexcept;
+};
@@ -1 +1 @@
-sources += intobj.cpp vfile.cpp vdir.cpp vmount.cpp notif.cpp task.cpp endpoint.cpp memory.cpp pipe.cpp
+sources += intobj.cpp vfile.cpp vdir.cpp vmount.cpp notif.cpp task.cpp endpoint.cpp memory.cpp page_index.cpp pipe.cpp
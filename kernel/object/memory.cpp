@@ -11,13 +11,16 @@
 
 #include <mem/gfp.h>
 #include <env.h>
+#include <mem/compaction.h>
 #include <mem/vma.h>
+#include <mem/zram.h>
 #include <object/memory.h>
 #include <object/perm.h>
 #include <object/vfile.h>
 #include <logger.h>
 #include <sustcore/errcode.h>
 
+#include <atomic>
 #include <cstring>
 
 namespace {
@@ -43,6 +46,16 @@ namespace {
         }
     }
 
+    /**
+     * @brief 条目是否计入 anon_pages/mapped_pages.
+     *
+     * 共享零页不属于任何 payload, 读缺页装入时不计数, 释放时也不扣减.
+     */
+    [[nodiscard]]
+    bool backed_entry(const cap::PhyPage &page) noexcept {
+        return (page.flags & cap::PhyPage::PP_ZERO) == 0;
+    }
+
     /**
      * @brief 将 Memory 内偏移向下对齐到页边界. 
      */
@@ -77,29 +90,65 @@ namespace {
     }
 
     /**
-     * @brief 查询指定 offvpn 对应页记录. 
+     * @brief 判断页记录是否已被压缩换出.
+     */
+    [[nodiscard]]
+    bool swapped(const cap::PhyPage &page) noexcept {
+        return (page.flags & cap::PhyPage::PP_SWAPPED) != 0;
+    }
+
+    /**
+     * @brief 释放页记录持有的物理页或换出数据.
+     */
+    void release_entry(const cap::PhyPage &page) noexcept {
+        if (swapped(page)) {
+            ZRam::drop(page.addr.arith());
+            return;
+        }
+        GFP::put_page(page.addr, 1);
+    }
+
+    /**
+     * @brief 把已换出的页记录解压回新分配的物理页.
+     */
+    [[nodiscard]]
+    Result<void> swap_in_entry(cap::PhyPage &page) noexcept {
+        auto page_res = GFP::get_free_page(1);
+        propagate(page_res);
+        PhyAddr paddr = page_res.value();
+        auto load_res = ZRam::load(page.addr.arith(), paddr);
+        if (!load_res.has_value()) {
+            GFP::put_page(paddr, 1);
+            propagate_return(load_res);
+        }
+        page = cap::PhyPage{paddr, 1};
+        void_return();
+    }
+
+    /**
+     * @brief 查询指定 offvpn 对应页记录, 已换出的页视为不存在. 
      */
     [[nodiscard]]
     Result<std::reference_wrapper<cap::PhyPage>> lookup_page_entry(
         cap::MemoryPayload &memory, size_t offvpn) noexcept {
-        auto it = memory.phy_pages.find(offvpn);
-        if (it == memory.phy_pages.end()) {
+        auto *page = memory.phy_pages.find(offvpn);
+        if (page == nullptr || swapped(*page)) {
             unexpect_return(ErrCode::PAGE_NOT_PRESENT);
         }
-        return std::ref(it->second);
+        return std::ref(*page);
     }
 
     /**
-     * @brief 查询指定 offvpn 对应只读页记录. 
+     * @brief 查询指定 offvpn 对应只读页记录, 已换出的页视为不存在. 
      */
     [[nodiscard]]
     Result<std::reference_wrapper<const cap::PhyPage>> lookup_page_entry(
         const cap::MemoryPayload &memory, size_t offvpn) noexcept {
-        auto it = memory.phy_pages.find(offvpn);
-        if (it == memory.phy_pages.end()) {
+        const auto *page = memory.phy_pages.find(offvpn);
+        if (page == nullptr || swapped(*page)) {
             unexpect_return(ErrCode::PAGE_NOT_PRESENT);
         }
-        return std::cref(it->second);
+        return std::cref(*page);
     }
 
     /**
@@ -131,13 +180,19 @@ namespace {
         if (pages == 0) {
             void_return();
         }
-        auto paddr_res = GFP::get_free_page(pages);
+        auto paddr_res = Compaction::alloc_contiguous(pages);
         propagate(paddr_res);
         PhyAddr base = paddr_res.value();
         for (size_t i = 0; i < pages; ++i) {
-            memory->phy_pages.insert_or_assign(i,
-                                               cap::PhyPage{.addr=base + i * PAGESIZE,
-                                                            .refcount=1});
+            auto insert_res = memory->phy_pages.insert(
+                i, cap::PhyPage{.addr = base + i * PAGESIZE, .refcount = 1});
+            if (!insert_res.has_value()) {
+                memory->phy_pages.clear();
+                for (size_t j = 0; j < pages; ++j) {
+                    GFP::put_page(base + j * PAGESIZE, 1);
+                }
+                propagate_return(insert_res);
+            }
         }
         void_return();
     }
@@ -179,13 +234,14 @@ namespace cap {
     }
 
     void MemoryPayload::destruct() {
-        adjust_backed_pages(file_backed(),
-                            -static_cast<ssize_t>(phy_pages.size()));
+        size_t backed = 0;
+        phy_pages.for_each([&](size_t, PhyPage &page) {
+            backed += backed_entry(page) ? 1 : 0;
+            release_entry(page);
+        });
+        adjust_backed_pages(file_backed(), -static_cast<ssize_t>(backed));
         adjust_committed_pages(
             -static_cast<ssize_t>(page_align_up(memsz) / PAGESIZE));
-        for (auto &page : phy_pages) {
-            GFP::put_page(page.second.addr, 1);
-        }
         delete this;
     }
 
@@ -200,10 +256,39 @@ namespace cap {
         auto *cloned = new MemoryPayload(memsz, shared, continuity, growth,
                                          cloned_file, file_offset,
                                          file_backed_len);
-        for (auto &page : phy_pages) {
-            GFP::keep_page(page.second.addr, 1);
-            page.second.refcount++;
-            cloned->phy_pages.insert_or_assign(page.first, page.second);
+        bool failed = false;
+        phy_pages.for_each([&](size_t offvpn, PhyPage &page) {
+            if (failed) {
+                return;
+            }
+            // 换出数据不能共享, 先换入再按 COW 共享
+            if (swapped(page) && !swap_in_entry(page).has_value()) {
+                failed = true;
+                return;
+            }
+            PhyPage shared_page = page;
+            shared_page.refcount++;
+            if (!cloned->phy_pages.insert(offvpn, shared_page).has_value()) {
+                failed = true;
+                return;
+            }
+            GFP::keep_page(page.addr, 1);
+            page.refcount++;
+        });
+        if (failed) {
+            // 撤销已建立的共享, 由调用方按空 payload 处理
+            cloned->phy_pages.for_each([&](size_t offvpn, PhyPage &page) {
+                auto *origin = phy_pages.find(offvpn);
+                assert(origin != nullptr);
+                origin->refcount--;
+                GFP::put_page(page.addr, 1);
+            });
+            cloned->phy_pages.clear();
+            cloned->destruct();
+            loggers::PAGING::ERROR(
+                "MemoryPayload::clone_payload: 页索引节点分配或换入失败: mem=%p",
+                this);
+            return nullptr;
         }
         return cloned;
     }
@@ -216,20 +301,48 @@ namespace cap {
             .transform(std::mem_fn(&PhyPage::addr));
     }
 
+    Result<PhyPage> MemoryPayload::find_page_entry(
+        size_t offset) const noexcept {
+        if (page_align_down(offset) >= memsz) {
+            unexpect_return(ErrCode::OUT_OF_BOUNDARY);
+        }
+        return lookup_page_entry(*this, offset_to_offvpn(offset))
+            .transform([](const PhyPage &page) { return page; });
+    }
+
     Result<PhyAddr> MemoryPayload::ensure_page(size_t offset) {
-        auto lookup_res = lookup_page(offset);
-        if (lookup_res.has_value()) {
-            return lookup_res.value();
+        return ensure_page_entry(offset).transform(std::mem_fn(&PhyPage::addr));
+    }
+
+    Result<PhyPage> MemoryPayload::ensure_page_entry(size_t offset) {
+        if (page_align_down(offset) >= memsz) {
+            unexpect_return(ErrCode::OUT_OF_BOUNDARY);
         }
-        if (lookup_res.error() != ErrCode::PAGE_NOT_PRESENT) {
-            propagate_return(lookup_res);
+        size_t offvpn = offset_to_offvpn(offset);
+        if (auto *page = phy_pages.find(offvpn); page != nullptr) {
+            if (swapped(*page)) {
+                auto swap_res = swap_in_entry(*page);
+                propagate(swap_res);
+                loggers::PAGING::DEBUG(
+                    "MemoryPayload::ensure_page: mem=%p offvpn=%lu swapin=%p",
+                    this, offvpn, page->addr.addr());
+            }
+            return *page;
         }
 
-        size_t offvpn = offset_to_offvpn(offset);
-        auto page_res = GFP::get_free_page(1);
+        if (file_backed()) {
+            auto cache_res = map_cached_page(offvpn);
+            if (cache_res.has_value()) {
+                return cache_res.value();
+            }
+            if (cache_res.error() != ErrCode::NOT_SUPPORTED) {
+                propagate_return(cache_res);
+            }
+        }
+
+        auto page_res = GFP::get_free_page(1, GFP_ZERO);
         propagate(page_res);
         PhyAddr paddr = page_res.value();
-        memset(convert<KpaAddr>(paddr).addr(), 0, PAGESIZE);
         if (file_backed()) {
             cap::VFileObject file_obj(util::nnullforce(file.get()));
             size_t page_file_offset = offvpn_to_offset(offvpn);
@@ -237,14 +350,7 @@ namespace cap {
                 GFP::put_page(paddr, 1);
                 unexpect_return(ErrCode::OUT_OF_BOUNDARY);
             }
-            size_t read_len = PAGESIZE;
-            if (file_backed_len != static_cast<size_t>(-1)) {
-                if (page_file_offset >= file_backed_len) {
-                    read_len = 0;
-                } else if (file_backed_len - page_file_offset < read_len) {
-                    read_len = file_backed_len - page_file_offset;
-                }
-            }
+            size_t read_len = file_read_len(page_file_offset);
             if (read_len != 0) {
                 auto read_res = file_obj.read(file_offset + page_file_offset,
                                               convert<KpaAddr>(paddr).addr(),
@@ -255,12 +361,201 @@ namespace cap {
                 }
             }
         }
-        phy_pages.insert_or_assign(offvpn, PhyPage{paddr, 1});
+        auto insert_res = phy_pages.insert(offvpn, PhyPage{paddr, 1});
+        if (!insert_res.has_value()) {
+            GFP::put_page(paddr, 1);
+            propagate_return(insert_res);
+        }
         adjust_backed_pages(file_backed(), 1);
         loggers::PAGING::DEBUG(
             "MemoryPayload::ensure_page: mem=%p offvpn=%lu paddr=%p", this,
             offvpn, paddr.addr());
-        return paddr;
+        return *insert_res.value();
+    }
+
+    size_t MemoryPayload::file_read_len(size_t page_file_offset) const noexcept {
+        if (file_backed_len == static_cast<size_t>(-1)) {
+            return PAGESIZE;
+        }
+        if (page_file_offset >= file_backed_len) {
+            return 0;
+        }
+        size_t remain = file_backed_len - page_file_offset;
+        return remain < PAGESIZE ? remain : PAGESIZE;
+    }
+
+    Result<PhyPage> MemoryPayload::map_cached_page(size_t offvpn) {
+        // shared Memory 的写入经 sync 回写文件, 仍使用独立副本;
+        // 文件只覆盖部分页时页缓存中多余的文件内容不能暴露, 同样需要复制
+        size_t page_file_offset = offvpn_to_offset(offvpn);
+        if (shared || continuity ||
+            page_file_offset > static_cast<size_t>(-1) - file_offset ||
+            (file_offset + page_file_offset) % PAGESIZE != 0 ||
+            file_read_len(page_file_offset) != PAGESIZE)
+        {
+            unexpect_return(ErrCode::NOT_SUPPORTED);
+        }
+
+        cap::VFileObject file_obj(util::nnullforce(file.get()));
+        auto pin_res = file_obj.pin_page(
+            static_cast<off_t>(file_offset + page_file_offset));
+        propagate(pin_res);
+        PhyAddr paddr = pin_res.value();
+
+        // refcount 2 把页缓存计为另一个共享者, 首次写入时由 fork 复制
+        auto insert_res = phy_pages.insert(
+            offvpn, PhyPage{paddr, 2, PhyPage::PP_PAGECACHE});
+        if (!insert_res.has_value()) {
+            GFP::put_page(paddr, 1);
+            propagate_return(insert_res);
+        }
+        adjust_backed_pages(true, 1);
+        loggers::PAGING::DEBUG(
+            "MemoryPayload::ensure_page: mem=%p offvpn=%lu pagecache=%p",
+            this, offvpn, paddr.addr());
+        return *insert_res.value();
+    }
+
+    Result<PhyPage> MemoryPayload::ensure_read_page_entry(size_t offset) {
+        if (page_align_down(offset) >= memsz) {
+            unexpect_return(ErrCode::OUT_OF_BOUNDARY);
+        }
+        size_t offvpn    = offset_to_offvpn(offset);
+        const auto *page = phy_pages.find(offvpn);
+        if (page != nullptr && !swapped(*page)) {
+            return *page;
+        }
+        // 已换出的页必须换入原内容, 不能以零页代替
+        if (page != nullptr || shared || continuity || file_backed()) {
+            return ensure_page_entry(offset);
+        }
+
+        auto zero_res = zero_page();
+        propagate(zero_res);
+        PhyAddr zero = zero_res.value();
+        // refcount 2 把零页计为另一个共享者, 首次写入时由 fork 换成私有页
+        auto insert_res =
+            phy_pages.insert(offvpn, PhyPage{zero, 2, PhyPage::PP_ZERO});
+        propagate(insert_res);
+        GFP::keep_page(zero, 1);
+        loggers::PAGING::DEBUG(
+            "MemoryPayload::ensure_read_page_entry: mem=%p offvpn=%lu zero",
+            this, offvpn);
+        return *insert_res.value();
+    }
+
+    Result<PhyAddr> MemoryPayload::zero_page() noexcept {
+        static std::atomic<addr_t> zero_addr{NULL_ADDR};
+        addr_t cur = zero_addr.load(std::memory_order_acquire);
+        if (cur != NULL_ADDR) {
+            return PhyAddr(cur);
+        }
+
+        auto page_res = GFP::get_free_page(1, GFP_ZERO);
+        propagate(page_res);
+        PhyAddr page = page_res.value();
+        if (!zero_addr.compare_exchange_strong(cur, page.arith(),
+                                               std::memory_order_acq_rel))
+        {
+            // 其他 CPU 已经装好零页
+            GFP::put_page(page, 1);
+            return PhyAddr(cur);
+        }
+        loggers::PAGING::INFO("MemoryPayload: 共享零页=%p", page.addr());
+        return page;
+    }
+
+    Result<PhyAddr> MemoryPayload::ensure_huge_page(size_t offset) {
+        if (offset % HUGE_PAGE_SIZE != 0 || offset > memsz ||
+            memsz - offset < HUGE_PAGE_SIZE)
+        {
+            unexpect_return(ErrCode::INVALID_PARAM);
+        }
+        if (shared || file_backed()) {
+            unexpect_return(ErrCode::NOT_SUPPORTED);
+        }
+
+        size_t first_offvpn = offset_to_offvpn(offset);
+        size_t present      = 0;
+        bool contiguous     = true;
+        PhyAddr base        = PhyAddr::null;
+        phy_pages.for_each(
+            first_offvpn, first_offvpn + HUGE_PAGE_PAGES - 1,
+            [&](size_t offvpn, PhyPage &page) {
+                size_t i = offvpn - first_offvpn;
+                if (present++ == 0) {
+                    base = page.addr - i * PAGESIZE;
+                }
+                if (page.addr != base + i * PAGESIZE || page.refcount != 1 ||
+                    (page.flags & PhyPage::PP_HUGE) == 0)
+                {
+                    contiguous = false;
+                }
+            });
+        if (present == HUGE_PAGE_PAGES && contiguous &&
+            base.aligned<HUGE_PAGE_SIZE>())
+        {
+            return base;
+        }
+        if (present != 0) {
+            unexpect_return(ErrCode::NOT_SUPPORTED);
+        }
+
+        auto block_res = GFP::get_free_page(HUGE_PAGE_PAGES, GFP_ZERO);
+        propagate(block_res);
+        base = block_res.value();
+        assert(base.aligned<HUGE_PAGE_SIZE>());
+        for (size_t i = 0; i < HUGE_PAGE_PAGES; ++i) {
+            auto insert_res = phy_pages.insert(
+                first_offvpn + i,
+                PhyPage{base + i * PAGESIZE, 1, PhyPage::PP_HUGE});
+            if (!insert_res.has_value()) {
+                for (size_t j = 0; j < i; ++j) {
+                    phy_pages.erase(first_offvpn + j);
+                }
+                for (size_t j = 0; j < HUGE_PAGE_PAGES; ++j) {
+                    GFP::put_page(base + j * PAGESIZE, 1);
+                }
+                propagate_return(insert_res);
+            }
+        }
+        adjust_backed_pages(false, static_cast<ssize_t>(HUGE_PAGE_PAGES));
+        loggers::PAGING::DEBUG(
+            "MemoryPayload::ensure_huge_page: mem=%p offvpn=%lu paddr=%p", this,
+            first_offvpn, base.addr());
+        return base;
+    }
+
+    bool MemoryPayload::swappable(size_t offset) const noexcept {
+        if (shared || continuity || file_backed() || map_count > 1 ||
+            page_align_down(offset) >= memsz)
+        {
+            return false;
+        }
+        constexpr uint32_t UNSWAPPABLE =
+            PhyPage::PP_ZERO | PhyPage::PP_PAGECACHE | PhyPage::PP_SWAPPED;
+        const auto *page = phy_pages.find(offset_to_offvpn(offset));
+        return page != nullptr && page->refcount == 1 &&
+               (page->flags & UNSWAPPABLE) == 0 &&
+               GFP::ref_count(page->addr) == 1;
+    }
+
+    Result<void> MemoryPayload::swap_out(size_t offset) noexcept {
+        if (!swappable(offset)) {
+            unexpect_return(ErrCode::NOT_SUPPORTED);
+        }
+        size_t offvpn  = offset_to_offvpn(offset);
+        auto *page     = phy_pages.find(offvpn);
+        auto store_res = ZRam::store(page->addr);
+        propagate(store_res);
+
+        PhyAddr old = page->addr;
+        *page = PhyPage{PhyAddr(store_res.value()), 1, PhyPage::PP_SWAPPED};
+        GFP::put_page(old, 1);
+        loggers::PAGING::DEBUG(
+            "MemoryPayload::swap_out: mem=%p offvpn=%lu paddr=%p", this,
+            offvpn, old.addr());
+        void_return();
     }
 
     Result<size_t> MemoryPayload::page_refcount(size_t offset) const noexcept {
@@ -268,7 +563,9 @@ namespace cap {
             unexpect_return(ErrCode::OUT_OF_BOUNDARY);
         }
         return lookup_page_entry(*this, offset_to_offvpn(offset))
-            .transform(std::mem_fn(&PhyPage::refcount));
+            .transform([](const PhyPage &page) -> size_t {
+                return page.refcount;
+            });
     }
 
     Result<void> MemoryPayload::replace_page(size_t offset,
@@ -281,6 +578,7 @@ namespace cap {
         PhyAddr old  = page.addr;
         page.addr    = new_addr;
         page.refcount = 1;
+        page.flags   = 0;
         GFP::put_page(old, 1);
         loggers::PAGING::DEBUG(
             "MemoryPayload::replace_page: offvpn=%lu old=%p new=%p", offvpn,
@@ -339,19 +637,17 @@ namespace cap {
         while (consumed < total) {
             size_t cur_offset = offset + consumed;
             size_t chunk      = page_chunk_size(cur_offset, total - consumed);
-            auto page_res     = ensure_page(cur_offset);
-            propagate(page_res);
+            auto entry_res    = ensure_page_entry(cur_offset);
+            propagate(entry_res);
 
-            auto refcount_res = page_refcount(cur_offset);
-            propagate(refcount_res);
-            if (refcount_res.value() > 1) {
+            PhyAddr paddr = entry_res.value().addr;
+            if (entry_res.value().refcount > 1) {
                 auto fork_res = fork(cur_offset);
                 propagate(fork_res);
+                auto current_res = lookup_page(cur_offset);
+                propagate(current_res);
+                paddr = current_res.value();
             }
-
-            auto current_res = lookup_page(cur_offset);
-            propagate(current_res);
-            PhyAddr paddr = current_res.value();
             memcpy(static_cast<char *>(convert<KpaAddr>(paddr).addr()) +
                        offset_in_page(cur_offset),
                    src + consumed, chunk);
@@ -382,8 +678,9 @@ namespace cap {
             size_t cur_offset = offset + consumed;
             size_t chunk      = page_chunk_size(cur_offset, total - consumed);
             size_t offvpn     = offset_to_offvpn(cur_offset);
-            auto it           = phy_pages.find(offvpn);
-            if (it == phy_pages.end()) {
+            const auto *page  = phy_pages.find(offvpn);
+            // 仍与页缓存共享的页未被修改过, 无需回写
+            if (page == nullptr || (page->flags & PhyPage::PP_PAGECACHE) != 0) {
                 consumed += chunk;
                 continue;
             }
@@ -411,7 +708,7 @@ namespace cap {
             }
 
             auto *src =
-                static_cast<const char *>(convert<KpaAddr>(it->second.addr).addr()) +
+                static_cast<const char *>(convert<KpaAddr>(page->addr).addr()) +
                 offset_in_page(cur_offset);
             auto write_res =
                 file_obj.write(file_offset + cur_offset, src, write_len);
@@ -437,7 +734,9 @@ namespace cap {
         propagate(entry_res);
         auto &page          = entry_res.value().get();
         size_t old_refcount = page.refcount;
-        if (old_refcount <= 1) {
+        bool foreign =
+            (page.flags & (PhyPage::PP_ZERO | PhyPage::PP_PAGECACHE)) != 0;
+        if (old_refcount <= 1 && !foreign) {
             page.refcount = 1;
             loggers::PAGING::DEBUG(
                 "MemoryPayload::fork: offvpn=%lu already exclusive paddr=%p",
@@ -445,17 +744,25 @@ namespace cap {
             void_return();
         }
 
-        auto new_page_res = GFP::get_free_page(1);
+        bool zero         = (page.flags & PhyPage::PP_ZERO) != 0;
+        auto new_page_res = GFP::get_free_page(1, zero ? GFP_ZERO : GFP_NONE);
         propagate(new_page_res);
         PhyAddr new_paddr = new_page_res.value();
-        memcpy(convert<KpaAddr>(new_paddr).addr(),
-               convert<KpaAddr>(page.addr).addr(), PAGESIZE);
+        if (!zero) {
+            memcpy(convert<KpaAddr>(new_paddr).addr(),
+                   convert<KpaAddr>(page.addr).addr(), PAGESIZE);
+        }
 
         PhyAddr old_paddr = page.addr;
         page.addr         = new_paddr;
         page.refcount     = 1;
+        page.flags        = 0;
         old_refcount--;
         GFP::put_page(old_paddr, 1);
+        if (zero) {
+            // 零页条目不计入 anon_pages, 换成私有页后才开始计数
+            adjust_backed_pages(false, 1);
+        }
         loggers::PAGING::DEBUG(
             "MemoryPayload::fork: offvpn=%lu old=%p new=%p shared_ref=%lu",
             offvpn, old_paddr.addr(), new_paddr.addr(), old_refcount);
@@ -464,15 +771,12 @@ namespace cap {
 
     void MemoryPayload::release_pages_from(size_t offset) noexcept {
         size_t first_offvpn = page_align_up(offset) / PAGESIZE;
-        for (auto it = phy_pages.begin(); it != phy_pages.end();) {
-            if (it->first >= first_offvpn) {
-                GFP::put_page(it->second.addr, 1);
-                adjust_backed_pages(file_backed(), -1);
-                it = phy_pages.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        size_t released     = 0;
+        phy_pages.drain_from(first_offvpn, [&](size_t, PhyPage &page) {
+            released += backed_entry(page) ? 1 : 0;
+            release_entry(page);
+        });
+        adjust_backed_pages(file_backed(), -static_cast<ssize_t>(released));
     }
 
     Result<void> MemoryPayload::resize(size_t newsz) {
@@ -501,7 +805,7 @@ namespace cap {
                 void_return();
             }
 
-            auto new_base_res = GFP::get_free_page(new_pages);
+            auto new_base_res = Compaction::alloc_contiguous(new_pages);
             propagate(new_base_res);
             PhyAddr new_base = new_base_res.value();
             memset(convert<KpaAddr>(new_base).addr(), 0, new_pages * PAGESIZE);
@@ -516,16 +820,25 @@ namespace cap {
                 }
             }
 
-            for (auto &page : phy_pages) {
-                GFP::put_page(page.second.addr, 1);
+            // 先建好新索引, 节点分配失败时旧内容保持不变
+            PageIndex fresh;
+            for (size_t i = 0; i < new_pages; ++i) {
+                auto insert_res =
+                    fresh.insert(i, PhyPage{new_base + i * PAGESIZE, 1});
+                if (!insert_res.has_value()) {
+                    for (size_t j = 0; j < new_pages; ++j) {
+                        GFP::put_page(new_base + j * PAGESIZE, 1);
+                    }
+                    propagate_return(insert_res);
+                }
             }
+
+            phy_pages.for_each([](size_t, PhyPage &page) {
+                GFP::put_page(page.addr, 1);
+            });
             adjust_backed_pages(file_backed(),
                                 -static_cast<ssize_t>(phy_pages.size()));
-            phy_pages.clear();
-            for (size_t i = 0; i < new_pages; ++i) {
-                phy_pages.insert_or_assign(i,
-                                           PhyPage{new_base + i * PAGESIZE, 1});
-            }
+            phy_pages.swap(fresh);
             adjust_backed_pages(file_backed(),
                                 static_cast<ssize_t>(phy_pages.size()));
         } else if (newsz < memsz) {
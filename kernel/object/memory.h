@@ -14,32 +14,11 @@
 #include <fwd.h>
 #include <arch/description.h>
 #include <cap/capability.h>
+#include <object/page_index.h>
 #include <sus/list.h>
 #include <sustcore/addr.h>
 
-#include <unordered_map>
-
 namespace cap {
-    /**
-     * @brief Memory Capability 已分配物理页记录. 
-     *
-     * addr 是物理页起始地址, refcount 仅用于标记该页是否仍处于
-     * 当前 payload 视角下的 COW 共享状态. 
-     */
-    struct PhyPage {
-        /// 物理页起始地址. 
-        PhyAddr addr;
-        /// 当前 payload 视角下的 COW 共享引用计数. 
-        size_t refcount;
-
-        /**
-         * @brief 比较两个物理页记录是否完全相同. 
-         */
-        constexpr bool operator==(const PhyPage &other) const noexcept {
-            return addr == other.addr && refcount == other.refcount;
-        }
-    };
-
     /**
      * @brief Memory Capability 支持的 VMA 增长/收缩方向. 
      *
@@ -70,6 +49,12 @@ namespace cap {
      * 物理页生命周期由 payload 统一管理. 
      */
     struct MemoryPayload : public _PayloadHelper<PayloadType::MEMORY> {
+        /// 透明大页大小, 与页表 2M 叶子一致.
+        static constexpr size_t HUGE_PAGE_SIZE =
+            PageMan::psize(PageMan::PageSize::_2M);
+        /// 一个透明大页包含的 4K 页数.
+        static constexpr size_t HUGE_PAGE_PAGES = HUGE_PAGE_SIZE / PAGESIZE;
+
         /// 承诺的内存大小, 单位为字节. 
         size_t memsz;
         /// 是否在 clone 时共享同一 payload 和物理页. 
@@ -84,8 +69,10 @@ namespace cap {
         size_t file_offset;
         /// 从 payload 偏移 0 开始, 实际由文件内容提供的字节数.
         size_t file_backed_len;
-        /// 已实际分配的物理页映射, key 为 offvpn. 
-        std::unordered_map<size_t, PhyPage> phy_pages;
+        /// 已实际分配的物理页索引, key 为 offvpn. 
+        PageIndex phy_pages;
+        /// 映射该 payload 的 VMA 数. 只被一个 VMA 映射时其页才能被换出.
+        size_t map_count = 0;
 
         /**
          * @brief 构造 Memory payload. 
@@ -127,20 +114,109 @@ namespace cap {
          * @brief 查询指定偏移对应的已分配物理页. 
          *
          * @param offset Memory 内偏移, 可以非页对齐. 
-         * @return 已分配物理页地址; 未分配返回 PAGE_NOT_PRESENT. 
+         * @return 已分配物理页地址; 未分配或已换出返回 PAGE_NOT_PRESENT. 
          */
         [[nodiscard]]
         Result<PhyAddr> lookup_page(size_t offset) const noexcept;
+        /**
+         * @brief 查询指定偏移对应的已分配页的完整记录, 不会分配新页. 
+         *
+         * @param offset Memory 内偏移, 可以非页对齐. 
+         * @return 物理页记录副本; 未分配或已换出返回 PAGE_NOT_PRESENT. 
+         */
+        [[nodiscard]]
+        Result<PhyPage> find_page_entry(size_t offset) const noexcept;
         /**
          * @brief 确保指定偏移对应的物理页存在. 
          *
-         * 未分配时会懒分配一个零页并加入 phy_pages. 
+         * 未分配时会懒分配一个零页并加入 phy_pages. 非 shared 的文件
+         * Memory 优先直接引用页缓存中的文件页, 首次写入时再复制.
+         * 已被换出的页会解压回新分配的页. 
          *
          * @param offset Memory 内偏移, 可以非页对齐. 
          * @return 物理页地址. 
          */
         [[nodiscard]]
         Result<PhyAddr> ensure_page(size_t offset);
+        /**
+         * @brief 确保指定偏移对应的物理页存在, 并返回其完整记录. 
+         *
+         * 与 ensure_page 语义相同, 但一次查询同时得到物理地址与
+         * COW 共享计数, 供缺页路径使用. 
+         *
+         * @param offset Memory 内偏移, 可以非页对齐. 
+         * @return 物理页记录副本. 
+         */
+        [[nodiscard]]
+        Result<PhyPage> ensure_page_entry(size_t offset);
+        /**
+         * @brief 为读访问确保指定偏移对应的页记录存在. 
+         *
+         * 非 shared、非 continuity 的匿名 Memory 中未分配的页记录为
+         * 全局共享零页, 不分配新页; 首次写入时经 fork 换成私有页.
+         * 其余情况与 ensure_page_entry 相同. 
+         *
+         * @param offset Memory 内偏移, 可以非页对齐. 
+         * @return 物理页记录副本. 
+         */
+        [[nodiscard]]
+        Result<PhyPage> ensure_read_page_entry(size_t offset);
+        /**
+         * @brief 全局共享零页, 内容恒为 0, 只能以只读方式映射. 
+         *
+         * 首次调用时分配, 之后永不释放. 
+         */
+        [[nodiscard]]
+        static Result<PhyAddr> zero_page() noexcept;
+        /**
+         * @brief 以页缓存中的文件页直接满足 offvpn 处的缺页.
+         *
+         * 仅用于非 shared 的文件 Memory 中被文件完整覆盖且按页对齐的页.
+         * 记录的页持有一个 GFP 引用, 写入前经 fork 复制为私有页.
+         *
+         * @return 新插入的页记录; 不满足条件或文件不经过页缓存时返回
+         * NOT_SUPPORTED, 调用方应回退到复制文件内容.
+         */
+        [[nodiscard]]
+        Result<PhyPage> map_cached_page(size_t offvpn);
+        /**
+         * @brief 计算从 payload 内页对齐偏移起, 该页由文件提供的字节数.
+         */
+        [[nodiscard]]
+        size_t file_read_len(size_t page_file_offset) const noexcept;
+        /**
+         * @brief 确保以指定偏移开始的 HUGE_PAGE_SIZE 区域由一块物理连续、
+         * 按大页对齐的独占内存提供. 
+         *
+         * 区域内没有任何已分配页时, 一次分配 HUGE_PAGE_PAGES 个连续零页,
+         * 仍按 4K 粒度记录在 phy_pages 中, 以便 fork 后逐页 COW 拆分.
+         * 仅私有匿名 Memory 支持大页; 共享 Memory 的页会被多个映射
+         * 按 4K 粒度引用, 不使用大页. 
+         *
+         * @param offset 大页对齐的 Memory 内偏移. 
+         * @return 大页起始物理地址; 区域已被部分填充或不满足条件时返回
+         * NOT_SUPPORTED, 连续页分配失败时返回分配器错误, 调用方应回退到 4K 页. 
+         */
+        [[nodiscard]]
+        Result<PhyAddr> ensure_huge_page(size_t offset);
+        /**
+         * @brief 判断指定偏移对应的页能否被压缩换出.
+         *
+         * 仅非 shared、非 continuity 的匿名 Memory 中独占的普通页可以换出;
+         * 零页、页缓存页与仍处于 COW 共享的页都不换出.
+         */
+        [[nodiscard]]
+        bool swappable(size_t offset) const noexcept;
+        /**
+         * @brief 把指定偏移对应的页压缩存入 ZRam 并释放物理页.
+         *
+         * 调用方必须已解除该页的全部映射并失效 TLB. 换出的页在下一次
+         * ensure_page_entry 时解压回新页.
+         *
+         * @return 不满足 swappable 或页不可压缩时返回 NOT_SUPPORTED.
+         */
+        [[nodiscard]]
+        Result<void> swap_out(size_t offset) noexcept;
         /**
          * @brief 查询指定偏移对应页的 COW 共享引用计数. 
          *
@@ -0,0 +1,302 @@
+/**
+ * @file page_index.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief Memory payload 物理页索引
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/alloc.h>
+#include <object/page_index.h>
+#include <storage.h>
+
+#include <new>
+
+namespace cap {
+    namespace kop {
+        Storage<KOP<PageIndex::Node>> page_index_node_storage;
+        Storage<KOP<PageIndex::Leaf>> page_index_leaf_storage;
+
+        [[nodiscard]]
+        KOP<PageIndex::Node> &page_index_node() {
+            return page_index_node_storage.ref();
+        }
+
+        [[nodiscard]]
+        KOP<PageIndex::Leaf> &page_index_leaf() {
+            return page_index_leaf_storage.ref();
+        }
+    }  // namespace kop
+
+    void init_page_index_kop() {
+        kop::page_index_node_storage.construct("page_index_node");
+        kop::page_index_leaf_storage.construct("page_index_leaf");
+    }
+}  // namespace cap
+
+namespace {
+    using cap::PageIndex;
+
+    [[nodiscard]]
+    PageIndex::Node *new_node() noexcept {
+        auto *node = cap::kop::page_index_node().alloc();
+        return node == nullptr ? nullptr : new (node) PageIndex::Node{};
+    }
+
+    [[nodiscard]]
+    PageIndex::Leaf *new_leaf() noexcept {
+        auto *leaf = cap::kop::page_index_leaf().alloc();
+        return leaf == nullptr ? nullptr : new (leaf) PageIndex::Leaf{};
+    }
+
+    /**
+     * @brief 释放以 node 为根、高度为 height 的子树.
+     */
+    void free_subtree(void *node, size_t height) noexcept {
+        if (height == 1) {
+            cap::kop::page_index_leaf().free(
+                static_cast<PageIndex::Leaf *>(node));
+            return;
+        }
+        auto *inner = static_cast<PageIndex::Node *>(node);
+        for (uint64_t bits = inner->present; bits != 0; bits &= bits - 1) {
+            size_t slot = static_cast<size_t>(__builtin_ctzll(bits));
+            free_subtree(inner->slots[slot], height - 1);
+        }
+        cap::kop::page_index_node().free(inner);
+    }
+
+    /**
+     * @brief 高度为 height 的子树中每个槽覆盖的键数.
+     */
+    [[nodiscard]]
+    constexpr size_t slot_span(size_t height) noexcept {
+        return 1ul << (PageIndex::SHIFT * (height - 1));
+    }
+
+    /**
+     * @brief 高度为 height 的树可容纳的键数.
+     */
+    [[nodiscard]]
+    constexpr size_t capacity(size_t height) noexcept {
+        return height == 0 ? 0 : 1ul << (PageIndex::SHIFT * height);
+    }
+
+    struct WalkState {
+        size_t first;
+        size_t last;
+        bool remove;
+        PageIndex::Visitor visit;
+        void *ctx;
+        size_t removed;
+    };
+
+    /**
+     * @brief 递归访问子树中落在 [first, last] 内的项.
+     *
+     * @return true 删除后子树已空, 调用方应回收该节点
+     */
+    bool walk_subtree(void *node, size_t height, size_t base,
+                      WalkState &state) noexcept {
+        size_t span  = slot_span(height);
+        size_t start = state.first > base ? (state.first - base) / span : 0;
+        if (start >= PageIndex::FANOUT) {
+            return false;
+        }
+        uint64_t window = ~0ull << start;
+
+        if (height == 1) {
+            auto *leaf = static_cast<PageIndex::Leaf *>(node);
+            for (uint64_t bits = leaf->present & window; bits != 0;
+                 bits &= bits - 1)
+            {
+                size_t slot  = static_cast<size_t>(__builtin_ctzll(bits));
+                size_t index = base + slot;
+                if (index > state.last) {
+                    break;
+                }
+                state.visit(state.ctx, index, leaf->pages[slot]);
+                if (state.remove) {
+                    leaf->present &= ~(1ull << slot);
+                    state.removed++;
+                }
+            }
+            return leaf->present == 0;
+        }
+
+        auto *inner = static_cast<PageIndex::Node *>(node);
+        for (uint64_t bits = inner->present & window; bits != 0;
+             bits &= bits - 1)
+        {
+            size_t slot       = static_cast<size_t>(__builtin_ctzll(bits));
+            size_t child_base = base + slot * span;
+            if (child_base > state.last) {
+                break;
+            }
+            if (walk_subtree(inner->slots[slot], height - 1, child_base,
+                             state) &&
+                state.remove)
+            {
+                free_subtree(inner->slots[slot], height - 1);
+                inner->slots[slot] = nullptr;
+                inner->present &= ~(1ull << slot);
+            }
+        }
+        return inner->present == 0;
+    }
+}  // namespace
+
+namespace cap {
+    PageIndex::~PageIndex() {
+        clear();
+    }
+
+    PageIndex::Leaf *PageIndex::find_leaf(size_t index) const noexcept {
+        if (_hint_leaf != nullptr && (index & ~MASK) == _hint_base) {
+            return _hint_leaf;
+        }
+        if (index >= capacity(_height)) {
+            return nullptr;
+        }
+        void *node = _root;
+        for (size_t h = _height; h > 1; h--) {
+            auto *inner = static_cast<Node *>(node);
+            size_t slot = (index >> (SHIFT * (h - 1))) & MASK;
+            if ((inner->present & (1ull << slot)) == 0) {
+                return nullptr;
+            }
+            node = inner->slots[slot];
+        }
+        _hint_leaf = static_cast<Leaf *>(node);
+        _hint_base = index & ~MASK;
+        return _hint_leaf;
+    }
+
+    PhyPage *PageIndex::find(size_t index) noexcept {
+        Leaf *leaf = find_leaf(index);
+        size_t slot = index & MASK;
+        if (leaf == nullptr || (leaf->present & (1ull << slot)) == 0) {
+            return nullptr;
+        }
+        return &leaf->pages[slot];
+    }
+
+    const PhyPage *PageIndex::find(size_t index) const noexcept {
+        const Leaf *leaf = find_leaf(index);
+        size_t slot      = index & MASK;
+        if (leaf == nullptr || (leaf->present & (1ull << slot)) == 0) {
+            return nullptr;
+        }
+        return &leaf->pages[slot];
+    }
+
+    Result<PhyPage *> PageIndex::insert(size_t index, const PhyPage &page) {
+        if (index >= MAX_INDEX) {
+            unexpect_return(ErrCode::OUT_OF_BOUNDARY);
+        }
+
+        Leaf *leaf = find_leaf(index);
+        if (leaf == nullptr) {
+            if (_root == nullptr) {
+                _root = new_leaf();
+                if (_root == nullptr) {
+                    unexpect_return(ErrCode::OUT_OF_MEMORY);
+                }
+                _height = 1;
+            }
+            // 键超出当前容量时在根上方加层, 原树成为新根的 0 号子树
+            while (index >= capacity(_height)) {
+                Node *top = new_node();
+                if (top == nullptr) {
+                    unexpect_return(ErrCode::OUT_OF_MEMORY);
+                }
+                top->slots[0] = _root;
+                top->present  = 1;
+                _root         = top;
+                _height++;
+            }
+
+            void *node = _root;
+            for (size_t h = _height; h > 1; h--) {
+                auto *inner = static_cast<Node *>(node);
+                size_t slot = (index >> (SHIFT * (h - 1))) & MASK;
+                if ((inner->present & (1ull << slot)) == 0) {
+                    void *child = h == 2 ? static_cast<void *>(new_leaf())
+                                         : static_cast<void *>(new_node());
+                    if (child == nullptr) {
+                        unexpect_return(ErrCode::OUT_OF_MEMORY);
+                    }
+                    inner->slots[slot] = child;
+                    inner->present |= 1ull << slot;
+                }
+                node = inner->slots[slot];
+            }
+            leaf       = static_cast<Leaf *>(node);
+            _hint_leaf = leaf;
+            _hint_base = index & ~MASK;
+        }
+
+        size_t slot = index & MASK;
+        if ((leaf->present & (1ull << slot)) == 0) {
+            leaf->present |= 1ull << slot;
+            _size++;
+        }
+        leaf->pages[slot] = page;
+        return &leaf->pages[slot];
+    }
+
+    void PageIndex::walk(size_t first, size_t last, bool remove,
+                         Visitor visit, void *ctx) {
+        if (_root == nullptr || first > last) {
+            return;
+        }
+        if (remove) {
+            // 叶子可能被回收, 丢弃缓存
+            _hint_leaf = nullptr;
+        }
+        WalkState state{first, last, remove, visit, ctx, 0};
+        bool empty = walk_subtree(_root, _height, 0, state);
+        _size -= state.removed;
+        if (remove && empty) {
+            free_subtree(_root, _height);
+            _root   = nullptr;
+            _height = 0;
+            return;
+        }
+        if (remove) {
+            shrink();
+        }
+    }
+
+    void PageIndex::shrink() noexcept {
+        // 根只剩 0 号子树时降低树高
+        while (_height > 1) {
+            auto *top = static_cast<Node *>(_root);
+            if (top->present != 1) {
+                break;
+            }
+            _root = top->slots[0];
+            _height--;
+            kop::page_index_node().free(top);
+        }
+    }
+
+    bool PageIndex::erase(size_t index) noexcept {
+        size_t before = _size;
+        walk(index, index, true, [](void *, size_t, PhyPage &) {}, nullptr);
+        return _size != before;
+    }
+
+    void PageIndex::clear() noexcept {
+        if (_root != nullptr) {
+            free_subtree(_root, _height);
+        }
+        _root      = nullptr;
+        _height    = 0;
+        _size      = 0;
+        _hint_leaf = nullptr;
+    }
+}  // namespace cap
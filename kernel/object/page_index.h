@@ -0,0 +1,217 @@
+/**
+ * @file page_index.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief Memory payload 物理页索引
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sustcore/addr.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace cap {
+    /**
+     * @brief Memory Capability 已分配物理页记录.
+     *
+     * addr 是物理页起始地址, refcount 仅用于标记该页是否仍处于
+     * 当前 payload 视角下的 COW 共享状态. 记录直接内嵌在索引叶子节点中.
+     */
+    struct PhyPage {
+        enum Flags : uint32_t {
+            /// 该页来自一次分配的透明大页块, 尚未因 COW 被替换.
+            PP_HUGE = 1u << 0,
+            /// 该页是页缓存中的文件页, 与页缓存共享, 写入前必须 COW.
+            PP_PAGECACHE = 1u << 1,
+            /// 该页是全局共享零页, 写入前必须 COW.
+            PP_ZERO = 1u << 2,
+            /// 该页已被压缩换出, addr 保存的是 ZRam 句柄而非物理地址.
+            PP_SWAPPED = 1u << 3,
+        };
+
+        /// 物理页起始地址.
+        PhyAddr addr;
+        /// 当前 payload 视角下的 COW 共享引用计数.
+        uint32_t refcount;
+        /// PhyPage::Flags 位集合.
+        uint32_t flags = 0;
+
+        /**
+         * @brief 比较两个物理页记录是否完全相同.
+         */
+        constexpr bool operator==(const PhyPage &other) const noexcept {
+            return addr == other.addr && refcount == other.refcount &&
+                   flags == other.flags;
+        }
+    };
+
+    static_assert(sizeof(PhyPage) == 16, "PhyPage 应保持 16 字节");
+
+    /**
+     * @brief 以 offvpn 为键的基数树.
+     *
+     * 每层 64 路, 叶子节点直接内嵌 64 个 PhyPage 并以位图标记有效项,
+     * 相邻页共享同一叶子, 顺序访问大映射时只需触及少量连续内存.
+     * 树高随最大键按需增长, 删除后自动回收空节点并降低树高.
+     * 最近访问的叶子被缓存, 连续缺页通常无需从根下降.
+     *
+     * 节点由 KOP 分配, 使用前需调用 init_page_index_kop().
+     * PageIndex 本身不加锁, 由持有者保证互斥.
+     */
+    class PageIndex {
+    public:
+        static constexpr size_t SHIFT      = 6;
+        static constexpr size_t FANOUT     = 1ul << SHIFT;
+        static constexpr size_t MASK       = FANOUT - 1;
+        /// 10 层可覆盖 2^60 个页, 远超任何合法 Memory 大小.
+        static constexpr size_t MAX_HEIGHT = 10;
+        static constexpr size_t MAX_INDEX  = 1ul << (SHIFT * MAX_HEIGHT);
+
+        /// 内部节点.
+        struct Node {
+            uint64_t present = 0;
+            void *slots[FANOUT]{};
+        };
+
+        /// 叶子节点.
+        struct Leaf {
+            uint64_t present = 0;
+            PhyPage pages[FANOUT]{};
+        };
+
+        /// 遍历回调, ctx 为调用方上下文.
+        using Visitor = void (*)(void *ctx, size_t index, PhyPage &page);
+
+    private:
+        void *_root       = nullptr;
+        // 0 表示空树, 1 表示根即为叶子
+        size_t _height    = 0;
+        size_t _size      = 0;
+        mutable Leaf *_hint_leaf = nullptr;
+        mutable size_t _hint_base = 0;
+
+        /**
+         * @brief 按顺序访问 [first, last] 内的所有项.
+         *
+         * @param remove 为 true 时访问后删除该项, 并回收变空的节点
+         */
+        void walk(size_t first, size_t last, bool remove, Visitor visit,
+                  void *ctx);
+        [[nodiscard]]
+        Leaf *find_leaf(size_t index) const noexcept;
+        void shrink() noexcept;
+
+    public:
+        PageIndex() = default;
+        ~PageIndex();
+
+        PageIndex(const PageIndex &)            = delete;
+        PageIndex &operator=(const PageIndex &) = delete;
+
+        /**
+         * @brief 查询指定 offvpn 的记录.
+         *
+         * @return PhyPage* 记录指针; 不存在时返回 nullptr.
+         * 指针在下一次 insert/erase 之前有效
+         */
+        [[nodiscard]]
+        PhyPage *find(size_t index) noexcept;
+        [[nodiscard]]
+        const PhyPage *find(size_t index) const noexcept;
+
+        /**
+         * @brief 插入或覆盖指定 offvpn 的记录.
+         *
+         * @return 记录在叶子中的位置; 节点分配失败返回 OUT_OF_MEMORY,
+         * 键超出 MAX_INDEX 返回 OUT_OF_BOUNDARY
+         */
+        [[nodiscard]]
+        Result<PhyPage *> insert(size_t index, const PhyPage &page);
+
+        /**
+         * @brief 删除指定 offvpn 的记录.
+         *
+         * @return true 记录存在并已删除
+         */
+        bool erase(size_t index) noexcept;
+
+        /**
+         * @brief 删除全部记录并释放所有节点.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief 与另一索引交换全部内容.
+         */
+        void swap(PageIndex &other) noexcept {
+            std::swap(_root, other._root);
+            std::swap(_height, other._height);
+            std::swap(_size, other._size);
+            std::swap(_hint_leaf, other._hint_leaf);
+            std::swap(_hint_base, other._hint_base);
+        }
+
+        [[nodiscard]]
+        size_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        /**
+         * @brief 按 offvpn 升序访问 [first, last] 内的记录.
+         *
+         * @param fn 形如 void(size_t index, PhyPage &page) 的回调,
+         * 可以修改记录内容, 但不得插入或删除
+         */
+        template <typename Fn>
+        void for_each(size_t first, size_t last, Fn &&fn) {
+            walk(
+                first, last, false,
+                [](void *ctx, size_t index, PhyPage &page) {
+                    (*static_cast<std::remove_reference_t<Fn> *>(ctx))(index,
+                                                                       page);
+                },
+                &fn);
+        }
+
+        template <typename Fn>
+        void for_each(Fn &&fn) {
+            for_each(0, MAX_INDEX - 1, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 按 offvpn 升序访问并删除 first 及之后的所有记录.
+         *
+         * @param fn 形如 void(size_t index, PhyPage &page) 的回调,
+         * 在记录被删除前调用
+         */
+        template <typename Fn>
+        void drain_from(size_t first, Fn &&fn) {
+            walk(
+                first, MAX_INDEX - 1, true,
+                [](void *ctx, size_t index, PhyPage &page) {
+                    (*static_cast<std::remove_reference_t<Fn> *>(ctx))(index,
+                                                                       page);
+                },
+                &fn);
+        }
+    };
+
+    /**
+     * @brief 初始化 PageIndex 节点对象池.
+     */
+    void init_page_index_kop();
+}  // namespace cap
@@ -24,6 +24,16 @@ namespace cap {
         return VFS::inst().read(*_obj, offset, buf, len);
     }
 
+    Result<PhyAddr> VFileObject::pin_page(off_t offset) {
+        using namespace perm::vfile;
+        if (!imply(READ)) {
+            loggers::CAPABILITY::ERROR("权限不足");
+            return {unexpect, ErrCode::INSUFFICIENT_PERMISSIONS};
+        }
+        // 调用VFS的pin_page接口
+        return VFS::inst().pin_page(*_obj, offset);
+    }
+
     Result<size_t> VFileObject::write(off_t offset, const void *buf,
                                       size_t len) {
         using namespace perm::vfile;
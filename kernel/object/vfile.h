@@ -24,6 +24,7 @@ namespace cap {
         void operator delete(void *ptr) = delete;
 
         Result<size_t> read(off_t offset, void *buf, size_t len);
+        Result<PhyAddr> pin_page(off_t offset);
         Result<size_t> write(off_t offset, const void *buf, size_t len);
         Result<size_t> size();
         Result<void> sync();
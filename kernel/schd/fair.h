@@ -0,0 +1,311 @@
+/**
+ * @file fair.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief completely fair scheduler
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <schd/schdbase.h>
+#include <sus/list.h>
+#include <sus/nonnull.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace schd::fair {
+    constexpr int MIN_NICE = -20;
+    constexpr int MAX_NICE = 19;
+
+    /// nice 0 的权重, vruntime 以它为基准折算
+    constexpr uint64_t NICE_0_WEIGHT = 1024;
+
+    /// nice 每差 1 级, CPU 份额约差 10%, 数值与 Linux 的权重表一致
+    constexpr uint32_t NICE_TO_WEIGHT[MAX_NICE - MIN_NICE + 1] = {
+        88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+        9548,  7620,  6100,  4904,  3906,  3121,  2501,  1991,  1586,  1277,
+        1024,  820,   655,   526,   423,   335,   272,   215,   172,   137,
+        110,   87,    70,    56,    45,    36,    29,    23,    18,    15,
+    };
+
+    /// 调度周期: 就绪线程不多时, 每个线程在一个周期内至少运行一次
+    constexpr uint64_t SCHED_LATENCY_NS = 30'000'000;
+    /// 单次运行的最短时间, 线程多时周期按它拉长; 与 10ms 的 tick 相当
+    constexpr uint64_t MIN_GRANULARITY_NS = 10'000'000;
+    /// 唤醒的线程至少要比当前线程少这么多 vruntime 才抢占, 抑制频繁切换
+    constexpr uint64_t WAKEUP_GRANULARITY_NS = 2'000'000;
+    /// 睡醒的线程最多领先 min_vruntime 这么多, 交互线程借此优先运行
+    constexpr uint64_t SLEEPER_CREDIT_NS = SCHED_LATENCY_NS / 2;
+
+    [[nodiscard]]
+    constexpr uint64_t weight_of(int nice) noexcept {
+        if (nice < MIN_NICE) {
+            nice = MIN_NICE;
+        } else if (nice > MAX_NICE) {
+            nice = MAX_NICE;
+        }
+        return NICE_TO_WEIGHT[nice - MIN_NICE];
+    }
+
+    /**
+     * @brief 把实际运行时间按权重折算为 vruntime 增量.
+     */
+    [[nodiscard]]
+    constexpr uint64_t weighted_delta(uint64_t delta_ns, int nice) noexcept {
+        return delta_ns * NICE_0_WEIGHT / weight_of(nice);
+    }
+
+    template <typename SU>
+    class FAIR : public BaseSched<SU> {
+    public:
+        using SUType                          = SU;
+        constexpr static ClassType CLASS_TYPE = ClassType::FAIR;
+
+        constexpr static size_t ENTITY_OFFSET = offsetof(SUType, fair_entity);
+
+        static util::nonnull<Entity *> as_entity_fair(
+            util::nonnull<SUType *> unit) {
+            return util::nnullforce(&unit->fair_entity);
+        }
+
+        static util::nonnull<SUType *> asunit_fair(
+            util::nonnull<Entity *> entity) {
+            auto *entity_ptr = reinterpret_cast<char *>(entity.get());
+            return util::nnullforce(
+                reinterpret_cast<SUType *>(entity_ptr - ENTITY_OFFSET));
+        }
+
+    private:
+        [[nodiscard]]
+        static bool before(uint64_t lhs, uint64_t rhs) noexcept {
+            return static_cast<int64_t>(lhs - rhs) < 0;
+        }
+
+        [[nodiscard]]
+        static uint64_t later(uint64_t lhs, uint64_t rhs) noexcept {
+            return before(lhs, rhs) ? rhs : lhs;
+        }
+
+        /**
+         * @brief 正在运行的本类实体, 当前 hart 运行的不是本类线程时为空.
+         */
+        [[nodiscard]]
+        Entity *running() noexcept {
+            if (this->cursched == nullptr ||
+                this->cursched->state != ThreadState::RUNNING)
+            {
+                return nullptr;
+            }
+            return as_entity_fair(this->asunit(util::nnullforce(this->cursched)))
+                .get();
+        }
+
+        /**
+         * @brief 推进 min_vruntime, 取运行中与队首实体的较小者, 且只增不减.
+         */
+        void update_min_vruntime(util::nonnull<RQ *> rq) noexcept {
+            Entity *curr = running();
+            bool has_min = false;
+            uint64_t min = 0;
+            if (curr != nullptr) {
+                has_min = true;
+                min     = curr->vruntime;
+            }
+            if (!rq->fair_list.empty()) {
+                uint64_t leftmost = rq->fair_list.front().vruntime;
+                if (!has_min || before(leftmost, min)) {
+                    min = leftmost;
+                }
+                has_min = true;
+            }
+            if (has_min) {
+                rq->fair_min_vruntime = later(rq->fair_min_vruntime, min);
+            }
+        }
+
+        /**
+         * @brief 按 vruntime 插入就绪队列.
+         */
+        void insert(util::nonnull<RQ *> rq, Entity &entity) noexcept {
+            rq->fair_list.insert(entity);
+            rq->fair_load += weight_of(entity.nice);
+        }
+
+        /**
+         * @brief 为入队的实体确定起始 vruntime.
+         *
+         * 从其他 hart 迁来的实体保存的是相对值, 加上本队列的 min_vruntime 即可.
+         * 新线程从 min_vruntime 开始, 不能借创建线程抢占 CPU;
+         * 睡醒的线程最多获得 SLEEPER_CREDIT_NS 的补偿, 长睡也不会积攒过多.
+         */
+        void place_entity(util::nonnull<RQ *> rq, Entity &entity) noexcept {
+            if (entity.relative) {
+                entity.vruntime += rq->fair_min_vruntime;
+                entity.relative  = false;
+                return;
+            }
+            uint64_t base = rq->fair_min_vruntime;
+            if (entity.sum_exec != 0) {
+                base -= SLEEPER_CREDIT_NS;
+            }
+            entity.vruntime = later(entity.vruntime, base);
+        }
+
+    public:
+        /**
+         * @brief 当前运行实体应得的时间片: 调度周期按权重分摊.
+         */
+        [[nodiscard]]
+        static uint64_t ideal_slice(util::nonnull<RQ *> rq,
+                                    const Entity &curr) noexcept {
+            size_t nr_running = rq->fair_list.size() + 1;
+            uint64_t period   = SCHED_LATENCY_NS;
+            if (nr_running * MIN_GRANULARITY_NS > period) {
+                period = nr_running * MIN_GRANULARITY_NS;
+            }
+            uint64_t weight = weight_of(curr.nice);
+            return period * weight / (rq->fair_load + weight);
+        }
+
+        Result<void> enqueue(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_fair(unit);
+            meta->state = ThreadState::READY;
+            place_entity(rq, *entity);
+            insert(rq, *entity);
+            void_return();
+        }
+
+        Result<void> dequeue(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_fair(unit);
+            if (!rq->fair_list.contains(*entity)) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            rq->fair_list.remove(*entity);
+            rq->fair_load -= weight_of(entity->nice);
+            // 出队后可能迁往其他 hart, 只保留相对于本队列的领先量
+            entity->vruntime -= rq->fair_min_vruntime;
+            entity->relative  = true;
+            meta->state       = ThreadState::EMPTY;
+            update_min_vruntime(rq);
+            void_return();
+        }
+
+        Result<util::nonnull<SUType *>> pick_next(
+            util::nonnull<RQ *> rq) override {
+            if (rq->fair_list.empty()) {
+                unexpect_return(ErrCode::NO_RUNNABLE_THREAD);
+            }
+            // vruntime 最小者在队首
+            Entity &entity = rq->fair_list.front();
+            rq->fair_list.pop_front();
+            rq->fair_load     -= weight_of(entity.nice);
+            entity.slice_exec  = 0;
+            auto unit          = asunit_fair(util::nnullforce(&entity));
+            auto meta          = this->asmeta(unit);
+            meta->state        = ThreadState::RUNNING;
+            this->cursched     = meta.get();
+            update_min_vruntime(rq);
+            return unit;
+        }
+
+        Result<void> put_prev(util::nonnull<RQ *> rq,
+                              util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            meta->state = ThreadState::READY;
+            insert(rq, *as_entity_fair(unit));
+            void_return();
+        }
+
+        Result<void> yield(util::nonnull<RQ *> rq) override {
+            Entity *curr = running();
+            if (curr == nullptr) {
+                void_return();
+            }
+            // 排到当前所有就绪线程之后, 否则 vruntime 最小的自己会被立即选中
+            if (!rq->fair_list.empty()) {
+                curr->vruntime = later(curr->vruntime,
+                                       rq->fair_list.back().vruntime + 1);
+            }
+            this->cursched->template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            void_return();
+        }
+
+        Result<void> account(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit,
+                             uint64_t delta_ns) override {
+            auto entity         = as_entity_fair(unit);
+            entity->sum_exec   += delta_ns;
+            entity->slice_exec += delta_ns;
+            entity->vruntime   += weighted_delta(delta_ns, entity->nice);
+            update_min_vruntime(rq);
+            void_return();
+        }
+
+        /**
+         * @brief 时间片用完, 或队首线程落后当前线程超过唤醒粒度时请求重新调度.
+         */
+        Result<void> on_tick(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            if (rq->fair_list.empty()) {
+                void_return();
+            }
+            auto entity  = as_entity_fair(unit);
+            bool resched = entity->slice_exec >= ideal_slice(rq, *entity);
+            if (!resched && entity->slice_exec >= MIN_GRANULARITY_NS) {
+                const Entity &leftmost = rq->fair_list.front();
+                resched = before(leftmost.vruntime + WAKEUP_GRANULARITY_NS,
+                                 entity->vruntime);
+            }
+            if (resched) {
+                this->asmeta(unit)
+                    ->template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            }
+            void_return();
+        }
+
+        /**
+         * @brief 唤醒抢占检查.
+         *
+         * 当前运行的不是本类线程时, 本类优先级更高, 直接抢占.
+         * 否则只有新线程的 vruntime 比当前线程少出唤醒粒度 (按新线程权重折算) 时才抢占.
+         */
+        bool check_preempt_curr(util::nonnull<RQ *> rq,
+                                util::nonnull<SUType *> new_su) override {
+            Entity *curr = running();
+            if (curr == nullptr) {
+                return true;
+            }
+            auto entity   = as_entity_fair(new_su);
+            uint64_t gran = weighted_delta(WAKEUP_GRANULARITY_NS, entity->nice);
+            return before(entity->vruntime + gran, curr->vruntime);
+        }
+
+        /**
+         * @brief 修改线程的 nice 值, 已在就绪队列中时同步更新队列权重.
+         */
+        void set_nice(util::nonnull<RQ *> rq, util::nonnull<SUType *> unit,
+                      int nice) noexcept {
+            if (nice < MIN_NICE) {
+                nice = MIN_NICE;
+            } else if (nice > MAX_NICE) {
+                nice = MAX_NICE;
+            }
+            auto entity = as_entity_fair(unit);
+            if (rq->fair_list.contains(*entity)) {
+                rq->fair_load -= weight_of(entity->nice);
+                rq->fair_load += weight_of(nice);
+            }
+            entity->nice = nice;
+        }
+    };
+}  // namespace schd::fair
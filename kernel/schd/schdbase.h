@@ -18,6 +18,7 @@
 
 #include <atomic>
 #include <concepts>
+#include <cstdint>
 
 enum class ThreadState {
     EMPTY                   = 0,
@@ -45,6 +46,8 @@ constexpr const char *to_string(ThreadState state) {
 }
 
 namespace schd {
+    // 数值是用户可见的 ABI (kmod SCHED_CLASS_*), 只能追加, 不能重排;
+    // 调度优先级由 class_rank() 给出, 与数值无关.
     // BOT is the lowest priority, served as the minimum of the class type
     // however, there is no actual BOT class, it's just a placeholder for the
     // end of the class type range
@@ -54,14 +57,34 @@ namespace schd {
         FCFS = 2,
         RR   = 3,
         INIT = 4,
-        RT   = 5
+        RT   = 5,
+        FAIR = 6
     };
 
+    /**
+     * @brief 调度类的优先级, 越大越优先.
+     *
+     * FAIR 晚于其他类加入, 数值排在最后, 但优先级位于 RR 与 FCFS 之间.
+     */
+    constexpr int class_rank(ClassType type) {
+        switch (type) {
+            case ClassType::BOT:  return 0;
+            case ClassType::IDLE: return 1;
+            case ClassType::FCFS: return 2;
+            case ClassType::FAIR: return 3;
+            case ClassType::RR:   return 4;
+            case ClassType::INIT: return 5;
+            case ClassType::RT:   return 6;
+        }
+        return 0;
+    }
+
     constexpr const char *to_cstring(ClassType type) {
         switch (type) {
             case ClassType::RT:   return "RT";
             case ClassType::INIT: return "INIT";
             case ClassType::RR:   return "RR";
+            case ClassType::FAIR: return "FAIR";
             case ClassType::FCFS: return "FCFS";
             case ClassType::IDLE: return "IDLE";
             case ClassType::BOT:  return "BOT";
@@ -111,10 +134,48 @@ namespace schd {
         }
     };
 
+    namespace fair {
+        /**
+         * @brief FAIR 调度类的每线程状态.
+         *
+         * 就绪队列按 vruntime 排序, 需要独立的链表节点,
+         * 因此定义在 RQ 之前而不是 fair.h 中.
+         */
+        struct Entity {
+            util::ListHead<Entity> rq_head{};
+            /// 按权重折算后的累计运行时间 (ns)
+            uint64_t vruntime = 0;
+            /// 实际累计运行时间 (ns)
+            uint64_t sum_exec = 0;
+            /// 本次被选中后运行的时间 (ns)
+            uint64_t slice_exec = 0;
+            int nice            = 0;
+            /// 出队后 vruntime 暂存为相对 min_vruntime 的差值, 入队时还原
+            bool relative = false;
+        };
+
+        /**
+         * @brief vruntime 升序, 用差值比较以容忍回绕.
+         */
+        struct VruntimeLess {
+            constexpr bool operator()(const Entity &lhs,
+                                      const Entity &rhs) const noexcept {
+                return static_cast<int64_t>(lhs.vruntime - rhs.vruntime) < 0;
+            }
+        };
+    }  // namespace fair
+
     struct RQ {
         util::IntrusiveList<SchedMeta, &SchedMeta::rq_head> rt_list;
         util::IntrusiveList<SchedMeta, &SchedMeta::rq_head> fcfs_list;
         util::IntrusiveList<SchedMeta, &SchedMeta::rq_head> rr_list;
+        util::OrderedIntrusiveList<fair::Entity, &fair::Entity::rq_head,
+                                   fair::VruntimeLess>
+            fair_list;
+        /// 单调不减, 新入队与睡醒的线程以它为基准放置
+        uint64_t fair_min_vruntime = 0;
+        /// fair_list 中线程的权重之和
+        uint64_t fair_load = 0;
     };
 
     template <typename SU>
@@ -193,9 +254,26 @@ namespace schd {
         virtual Result<void> on_tick(util::nonnull<RQ *> rq,
                                      util::nonnull<SUType *> unit)  = 0;
 
+        /**
+         * @brief 把一段实际运行时间记到调度单元上
+         *
+         * 在 on_tick 之前以及调度单元被换下时调用.
+         * 只按 tick 计数的调度类无需关心, 默认忽略
+         *
+         * @param rq 调度器的就绪队列
+         * @param unit 当前正在运行的调度单元
+         * @param delta_ns 自上次记账以来运行的时间
+         */
+        virtual Result<void> account(util::nonnull<RQ *> rq,
+                                     util::nonnull<SUType *> unit,
+                                     uint64_t delta_ns) {
+            void_return();
+        }
+
         /**
          * @brief 判断当前任务是否要被new_su抢占(其中new_su的class
-         * type总是大于当前任务的class type)
+         * type总是大于当前任务的class type, FAIR 类除外:
+         * 它也会在两者同属 FAIR 时被调用)
          *
          * @param rq 调度器的就绪队列
          * @param new_su 即将要运行的调度单元
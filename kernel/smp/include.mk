@@ -0,0 +1 @@
+sources += smp.cpp
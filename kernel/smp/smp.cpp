@@ -0,0 +1,255 @@
+/**
+ * @file smp.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 多核启动与核间中断
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <device/model.h>
+#include <env.h>
+#include <logger.h>
+#include <mem/gfp.h>
+#include <smp/smp.h>
+#include <sustcore/addr.h>
+#include <task/task_struct.h>
+
+#include <atomic>
+
+namespace {
+    constexpr size_t NO_OWNER = static_cast<size_t>(-1);
+
+    struct SMPState {
+        // 票据锁: 按取号顺序获得大内核锁, 避免某个 hart 长期饥饿
+        std::atomic<uint32_t> next{0};
+        std::atomic<uint32_t> serving{0};
+        std::atomic<size_t> owner{NO_OWNER};
+        // 只由持锁 hart 自己读写
+        size_t depth[MAX_HARTS]{};
+
+        std::atomic<uint64_t> online_mask{0};
+        std::atomic<uint32_t> pending[MAX_HARTS]{};
+    };
+
+    SMPState smp_state;
+
+    [[nodiscard]]
+    size_t self() noexcept {
+        return env::hart_ctx->hart_id();
+    }
+
+    /**
+     * @brief 自旋时处理挂在本 hart 上的请求.
+     *
+     * 自旋期间中断关闭, 请求只能靠轮询响应.
+     */
+    void poll_ipi() noexcept {
+        if (smp_state.pending[self()].load(std::memory_order_acquire) != 0) {
+            Hart::clear_ipi();
+            SMP::handle_ipi();
+        }
+    }
+}  // namespace
+
+void BigKernelLock::acquire() noexcept {
+    size_t hart = self();
+    if (smp_state.owner.load(std::memory_order_relaxed) == hart) {
+        smp_state.depth[hart]++;
+        return;
+    }
+
+    bool prev_enabled = Interrupt::enabled();
+    Interrupt::cli();
+    uint32_t ticket =
+        smp_state.next.fetch_add(1, std::memory_order_relaxed);
+    while (smp_state.serving.load(std::memory_order_acquire) != ticket) {
+        poll_ipi();
+    }
+    smp_state.owner.store(hart, std::memory_order_relaxed);
+    smp_state.depth[hart] = 1;
+    if (prev_enabled) {
+        Interrupt::sti();
+    }
+}
+
+void BigKernelLock::release() noexcept {
+    size_t hart = self();
+    if (smp_state.owner.load(std::memory_order_relaxed) != hart) {
+        panic("BigKernelLock: 释放未持有的锁");
+    }
+    if (--smp_state.depth[hart] != 0) {
+        return;
+    }
+    smp_state.owner.store(NO_OWNER, std::memory_order_relaxed);
+    smp_state.serving.fetch_add(1, std::memory_order_release);
+}
+
+size_t BigKernelLock::release_all() noexcept {
+    size_t hart = self();
+    if (smp_state.owner.load(std::memory_order_relaxed) != hart) {
+        return 0;
+    }
+    size_t depth          = smp_state.depth[hart];
+    smp_state.depth[hart] = 1;
+    release();
+    return depth;
+}
+
+void BigKernelLock::reacquire(size_t depth) noexcept {
+    if (depth == 0) {
+        return;
+    }
+    acquire();
+    smp_state.depth[self()] = depth;
+}
+
+size_t BigKernelLock::depth() noexcept {
+    size_t hart = self();
+    if (smp_state.owner.load(std::memory_order_relaxed) != hart) {
+        return 0;
+    }
+    return smp_state.depth[hart];
+}
+
+void BigKernelLock::set_depth(size_t depth) noexcept {
+    smp_state.depth[self()] = depth;
+}
+
+void BigKernelLock::relax() noexcept {
+    uint32_t serving = smp_state.serving.load(std::memory_order_relaxed);
+    if (smp_state.next.load(std::memory_order_relaxed) == serving + 1) {
+        return;
+    }
+    reacquire(release_all());
+}
+
+void SMP::boot_secondary() noexcept {
+    size_t boot_hart = self();
+    for (auto &cpu : device::DeviceModel::inst().cpus().cpus) {
+        if (cpu == nullptr) {
+            continue;
+        }
+        auto hart = static_cast<size_t>(cpu->id());
+        if (hart == boot_hart) {
+            continue;
+        }
+        if (hart >= MAX_HARTS) {
+            loggers::SUSTCORE::WARN("hart %lu 超出 MAX_HARTS, 跳过", hart);
+            continue;
+        }
+
+        env::hart_context(hart).set_hart_id(hart);
+        auto stack_res = GFP::get_free_page(SECONDARY_STACK_PAGES);
+        if (!stack_res.has_value()) {
+            loggers::SUSTCORE::ERROR("为 hart %lu 分配启动栈失败: %s", hart,
+                                     to_cstring(stack_res.error()));
+            continue;
+        }
+        auto *stack_top = convert<KpaAddr>(stack_res.value() +
+                                           SECONDARY_STACK_PAGES * PAGESIZE)
+                              .addr();
+        auto start_res = Hart::start(hart, stack_top);
+        if (!start_res.has_value()) {
+            GFP::put_page(stack_res.value(), SECONDARY_STACK_PAGES);
+            continue;
+        }
+
+        // 从 hart 的初始化同样需要大内核锁
+        size_t depth = BigKernelLock::release_all();
+        size_t spin  = 0;
+        while (!online(hart) && spin < BOOT_SPIN_LIMIT) {
+            spin++;
+        }
+        BigKernelLock::reacquire(depth);
+        if (online(hart)) {
+            loggers::SUSTCORE::INFO("hart %lu 已上线", hart);
+        } else {
+            loggers::SUSTCORE::ERROR("等待 hart %lu 上线超时", hart);
+        }
+    }
+    loggers::SUSTCORE::INFO("在线 hart 数: %lu", online_count());
+}
+
+void SMP::mark_online() noexcept {
+    smp_state.online_mask.fetch_or(1ul << self(), std::memory_order_release);
+}
+
+bool SMP::online(size_t hart) noexcept {
+    if (hart >= MAX_HARTS) {
+        return false;
+    }
+    return (online_mask() & (1ul << hart)) != 0;
+}
+
+size_t SMP::online_count() noexcept {
+    return static_cast<size_t>(__builtin_popcountll(online_mask()));
+}
+
+uint64_t SMP::online_mask() noexcept {
+    return smp_state.online_mask.load(std::memory_order_acquire);
+}
+
+Result<void> SMP::send_ipi(size_t hart, uint32_t actions) noexcept {
+    if (hart == self() || !online(hart)) {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+    smp_state.pending[hart].fetch_or(actions, std::memory_order_release);
+    Hart::send_ipi(hart);
+    void_return();
+}
+
+void SMP::handle_ipi() noexcept {
+    auto &pending    = smp_state.pending[self()];
+    uint32_t actions = pending.load(std::memory_order_acquire);
+    if ((actions & IPI_TLB_FLUSH) != 0) {
+        PageMan::flush_tlb();
+    }
+    if ((actions & IPI_DRAIN_PCP) != 0) {
+        // buddy 自带关中断的锁, 链表正被打断的操作占用时本次跳过
+        GFP::drain_pcp();
+    }
+    if ((actions & IPI_RESCHEDULE) != 0) {
+        // 真正的切换留给陷入返回前的 schedule()
+        auto *current = env::hart_ctx->current_tcb();
+        if (current != nullptr) {
+            current->basic_entity
+                .template flags_set<schd::SchedMeta::FLAGS_NEED_RESCHED>();
+        }
+    }
+    // 处理完再清除, sync_others 据此判断请求已完成
+    pending.fetch_and(~actions, std::memory_order_release);
+}
+
+void SMP::sync_others(uint64_t mask, uint32_t actions) noexcept {
+    mask &= online_mask() & ~(1ul << self());
+    if (mask == 0) {
+        return;
+    }
+    for (size_t hart = 0; hart < MAX_HARTS; ++hart) {
+        if ((mask & (1ul << hart)) != 0) {
+            (void)send_ipi(hart, actions);
+        }
+    }
+    for (size_t hart = 0; hart < MAX_HARTS; ++hart) {
+        if ((mask & (1ul << hart)) == 0) {
+            continue;
+        }
+        // 等待期间对方也可能在等本 hart 处理请求
+        while ((smp_state.pending[hart].load(std::memory_order_acquire) &
+                actions) != 0)
+        {
+            poll_ipi();
+        }
+    }
+}
+
+void SMP::flush_tlb_others(uint64_t mask) noexcept {
+    sync_others(mask, IPI_TLB_FLUSH);
+}
+
+extern "C" void bkl_release_all(void) {
+    (void)BigKernelLock::release_all();
+}
@@ -0,0 +1,149 @@
+/**
+ * @file smp.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 多核启动与核间中断
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <arch/description.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 大内核锁.
+ *
+ * 内核数据结构 (调度器、地址空间、VFS 等) 尚未逐一加锁,
+ * 因此多核下内核态整体串行: 陷入与内核线程运行期间持有该锁,
+ * 返回用户态或 idle 等待中断前释放. 锁按 hart 可重入,
+ * 线程切换时由调度器保存与恢复各自的重入深度.
+ */
+class BigKernelLock {
+public:
+    /**
+     * @brief 获取锁, 同一 hart 可重入.
+     *
+     * 自旋期间关闭中断并处理发给本 hart 的核间请求,
+     * 避免持锁者等待本 hart 响应 TLB 击落时死锁.
+     */
+    static void acquire() noexcept;
+
+    /**
+     * @brief 释放一层重入.
+     */
+    static void release() noexcept;
+
+    /**
+     * @brief 彻底释放本 hart 持有的锁.
+     *
+     * @return size_t 释放前的重入深度, 交给 reacquire 恢复
+     */
+    static size_t release_all() noexcept;
+
+    /**
+     * @brief 重新获取锁并恢复 release_all 之前的深度.
+     */
+    static void reacquire(size_t depth) noexcept;
+
+    /**
+     * @brief 本 hart 当前的重入深度, 未持锁时为 0.
+     */
+    [[nodiscard]]
+    static size_t depth() noexcept;
+
+    /**
+     * @brief 线程切换后恢复被换入线程的重入深度, 调用方必须已持锁.
+     */
+    static void set_depth(size_t depth) noexcept;
+
+    /**
+     * @brief 有其他 hart 等待时短暂让出锁.
+     *
+     * 供长时间运行的内核线程在 yield 时调用.
+     */
+    static void relax() noexcept;
+};
+
+/**
+ * @brief 多核管理.
+ *
+ * 负责拉起从 hart、维护在线掩码, 以及核间中断的发送与处理.
+ * 核间请求以位图形式挂在目标 hart 上, 中断本身不携带数据.
+ */
+class SMP {
+public:
+    /// 让目标 hart 重新调度
+    static constexpr uint32_t IPI_RESCHEDULE = 1u << 0;
+    /// 让目标 hart 刷新本地 TLB
+    static constexpr uint32_t IPI_TLB_FLUSH = 1u << 1;
+    /// 让目标 hart 把 0 阶空闲页链表归还 buddy
+    static constexpr uint32_t IPI_DRAIN_PCP = 1u << 2;
+
+    /// 从 hart 内核栈页数
+    static constexpr size_t SECONDARY_STACK_PAGES = 4;
+    /// 等待从 hart 上线的自旋次数上限
+    static constexpr size_t BOOT_SPIN_LIMIT = 100'000'000;
+
+    /**
+     * @brief 由启动 hart 调用, 依次拉起设备树中其余的 hart.
+     *
+     * 调用方持有大内核锁; 等待期间会临时放开.
+     */
+    static void boot_secondary() noexcept;
+
+    /**
+     * @brief 当前 hart 完成初始化, 标记为在线.
+     */
+    static void mark_online() noexcept;
+
+    [[nodiscard]]
+    static bool online(size_t hart) noexcept;
+
+    [[nodiscard]]
+    static size_t online_count() noexcept;
+
+    [[nodiscard]]
+    static uint64_t online_mask() noexcept;
+
+    /**
+     * @brief 向目标 hart 挂上请求并发送核间中断.
+     *
+     * @param hart 目标 hart, 不能是当前 hart
+     * @param actions IPI_* 的组合
+     */
+    static Result<void> send_ipi(size_t hart, uint32_t actions) noexcept;
+
+    /**
+     * @brief 处理发给当前 hart 的全部请求.
+     *
+     * 在获取大内核锁之前调用, 只做不依赖锁的动作.
+     */
+    static void handle_ipi() noexcept;
+
+    /**
+     * @brief 向 mask 中的其他在线 hart 发送请求, 等待全部处理完后返回.
+     *
+     * @param mask 目标 hart 位图, 当前 hart 的位会被忽略
+     * @param actions IPI_* 的组合
+     */
+    static void sync_others(uint64_t mask, uint32_t actions) noexcept;
+
+    /**
+     * @brief 让 mask 中的其他在线 hart 刷新 TLB, 等待全部完成后返回.
+     *
+     * @param mask 需要刷新的 hart 位图, 当前 hart 的位会被忽略
+     */
+    static void flush_tlb_others(uint64_t mask) noexcept;
+};
+
+/**
+ * @brief 供汇编跳板调用, 新用户线程返回用户态前释放大内核锁.
+ */
+extern "C" void bkl_release_all(void);
@@ -28,15 +28,17 @@ private:
 public:
     SpinLocker() = default;
 
+    /**
+     * @brief 获取锁.
+     *
+     * 本身不关闭抢占: 持锁期间可能被抢占的路径应通过 GuardedLock 或
+     * IrqSaveGuardedLock 加锁, 由它们标记当前线程不可抢占并在解锁后恢复.
+     */
     void lock() {
-        // TODO: 将当前线程标记为不可抢断
-        // 更准确地说, 添加一个方法, 记录不可抢断的次数
-        // 次数归零时取消不可抢断
         __raw_spin_lock(&_lock);
     }
 
     void unlock() {
-        // TODO: 将当前线程取消不可抢断的标记
         __raw_spin_unlock(&_lock);
     }
 };
@@ -115,6 +117,61 @@ public:
     }
 };
 
+/**
+ * @brief 抢占关闭保护区.
+ *
+ * 仅将当前线程标记为不可抢占, 不关闭中断, 也不持有任何锁.
+ * 适用于只访问当前 hart 私有数据的短路径.
+ */
+class PreemptGuard {
+private:
+    bool entered               = false;
+    bool _preempt_was_disabled = false;
+
+public:
+    PreemptGuard() = default;
+
+    PreemptGuard(const PreemptGuard &)            = delete;
+    PreemptGuard &operator=(const PreemptGuard &) = delete;
+
+    /**
+     * @brief 进入抢占关闭保护区.
+     */
+    void enter() {
+        if (entered) {
+            return;
+        }
+        entered = true;
+
+        if (!schd::Scheduler::initialized()) {
+            _preempt_was_disabled = true;
+            return;
+        }
+
+        auto &scheduler = schd::Scheduler::inst();
+        if (scheduler.current_tcb() == nullptr ||
+            scheduler.preempt_disabled()) {
+            _preempt_was_disabled = true;
+            return;
+        }
+
+        auto preempt_res = scheduler.preempt_disable();
+        assert(preempt_res.has_value());
+        _preempt_was_disabled = false;
+    }
+
+    /**
+     * @brief 退出保护区并恢复抢占状态.
+     */
+    ~PreemptGuard() {
+        if (entered && !_preempt_was_disabled &&
+            schd::Scheduler::initialized()) {
+            auto preempt_res = schd::Scheduler::inst().preempt_enable();
+            assert(preempt_res.has_value());
+        }
+    }
+};
+
 class GuardedLock {
 private:
     SpinLocker &_lock;
@@ -234,6 +234,7 @@ namespace syscall {
         switch (static_cast<schd::ClassType>(value)) {
             case schd::ClassType::RT:
             case schd::ClassType::RR:
+            case schd::ClassType::FAIR:
             case schd::ClassType::FCFS:
                 return static_cast<schd::ClassType>(value);
             case schd::ClassType::INIT:
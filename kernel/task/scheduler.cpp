@@ -11,9 +11,11 @@
 
 #include <arch/description.h>
 #include <device/int.h>
+#include <driver/clock.h>
 #include <env.h>
 #include <logger.h>
 #include <mem/vma.h>
+#include <smp/smp.h>
 #include <storage.h>
 #include <sus/nonnull.h>
 #include <syscall/syscall.h>
@@ -51,10 +53,44 @@ namespace schd {
         return *inst_scheduler;
     }
 
+    Scheduler::Scheduler(util::nonnull<TCB *> idle_tcb,
+                         util::nonnull<TCB *> kinit_tcb) {
+        init_hart(idle_tcb);
+        kinit_tcb->basic_entity.state = ThreadState::READY;
+        kinit_tcb->hart               = local_hart();
+        init_schd()->kinit_ready      = &kinit_tcb->basic_entity;
+    }
+
+    void Scheduler::init_hart(util::nonnull<TCB *> idle_tcb) {
+        idle_tcb->basic_entity.state = ThreadState::READY;
+        idle_tcb->hart               = local_hart();
+        idle_schd()->ready           = &idle_tcb->basic_entity;
+    }
+
+    size_t Scheduler::local_hart() noexcept {
+        return env::hart_ctx->hart_id();
+    }
+
+    size_t Scheduler::target_hart(TCB *tcb) noexcept {
+        size_t hart = tcb->hart;
+        if (hart == local_hart() || SMP::online(hart)) {
+            return hart;
+        }
+        tcb->hart = local_hart();
+        return tcb->hart;
+    }
+
     util::nonnull<RQ *> Scheduler::rq() {
         return util::nnullforce(env::hart_ctx->rq());
     }
 
+    util::nonnull<RQ *> Scheduler::rq(size_t hart) {
+        if (hart == local_hart()) {
+            return rq();
+        }
+        return util::nnullforce(env::hart_context(hart).rq());
+    }
+
     TCB *Scheduler::current_tcb() const {
         return env::hart_ctx->current_tcb();
     }
@@ -95,7 +131,7 @@ namespace schd {
     void switch_pgd(TaskMemoryManager *tmm) {
         // 只在页表不为null且不等于当前页表时才切换
         if (tmm->pgd().nonnull() && tmm->pgd() != env::inst().pgd()) {
-            tmm->pman().switch_root();
+            tmm->activate();
         }
         // 更新 environment 中的 task memory
         env::inst().tmm(env::key::set()) = tmm;
@@ -104,29 +140,71 @@ namespace schd {
     void Scheduler::prepare_switch(TCB *tcb) {
         // 切换页表
         switch_pgd(tcb->task->tmm);
+        tcb->hart                    = local_hart();
         env::hart_ctx->current_tcb() = tcb;
         env::hart_ctx->current_pcb() = tcb->task;
     }
 
+    bool Scheduler::ext_context_loaded(const TCB *tcb) const noexcept {
+        return tcb->ext_ctx_live &&
+               tcb->ext_ctx_hart == env::hart_ctx->hart_id() &&
+               env::hart_ctx->ext_owner() == tcb;
+    }
+
+    void Scheduler::arm_ext_context(TCB *next) noexcept {
+        // 内核线程不使用扩展指令, 也没有用户态 trap 上下文
+        if (next->is_kernel || ext_context_loaded(next)) {
+            return;
+        }
+        ext_context_disable(*next->context());
+    }
+
     void Scheduler::switch_to(TCB *prev, TCB *next) {
         assert(prev != nullptr);
         assert(next != nullptr);
         assert(prev->ext_ctx != nullptr);
         assert(next->ext_ctx != nullptr);
-        if (prev->ext_ctx_live) {
-            save_ext_context(*prev->ext_ctx);
-        }
+        // 寄存器仍归 prev 所有, 未修改时 ext_ctx 已是最新
+        sync_ext_context(prev);
         prepare_switch(next);
-        if (!next->ext_ctx_live) {
-            restore_ext_context(*next->ext_ctx);
-            next->ext_ctx_live = true;
-        }
+        arm_ext_context(next);
+        // 大内核锁的重入深度随线程走, 切回 prev 时恢复它自己的深度
+        size_t depth = BigKernelLock::depth();
         __switch_to(prev->kernel_context_ptr(), next->kernel_context_ptr());
+        BigKernelLock::set_depth(depth);
+    }
+
+    bool Scheduler::ext_context_fault(Context *uctx) noexcept {
         auto *current = current_tcb();
-        assert(current != nullptr);
-        assert(current->ext_ctx != nullptr);
-        restore_ext_context(*current->ext_ctx);
-        current->ext_ctx_live = true;
+        if (current == nullptr || current->is_kernel ||
+            current->ext_ctx == nullptr || uctx == nullptr)
+        {
+            return false;
+        }
+        if (!ext_context_loaded(current)) {
+            // 原所有者切出时已写回脏状态, 可以直接覆盖
+            restore_ext_context(*current->ext_ctx);
+            env::hart_ctx->ext_owner() = current;
+            current->ext_ctx_live      = true;
+            current->ext_ctx_hart      = env::hart_ctx->hart_id();
+        }
+        ext_context_enable(*uctx);
+        return true;
+    }
+
+    void Scheduler::sync_ext_context(TCB *tcb) noexcept {
+        if (!ext_context_loaded(tcb) || !ext_context_dirty(*tcb->context())) {
+            return;
+        }
+        save_ext_context(*tcb->ext_ctx);
+        ext_context_clean(*tcb->context());
+    }
+
+    void Scheduler::drop_ext_context(TCB *tcb) noexcept {
+        tcb->ext_ctx_live = false;
+        if (!tcb->is_kernel) {
+            ext_context_disable(*tcb->context());
+        }
     }
 
     bool Scheduler::try_wakeup(TCB *tcb, int flags) {
@@ -148,10 +226,174 @@ namespace schd {
     }
 
     bool Scheduler::wakeup_new(TCB *new_tcb) {
-        // 我们目前直接执行try_wakeup
+        // 新线程先放在创建者所在的 hart, 由负载均衡再分散
+        new_tcb->hart = local_hart();
         return try_wakeup(new_tcb, 0);
     }
 
+    size_t Scheduler::load(size_t hart) noexcept {
+        auto hart_rq = rq(hart);
+        return hart_rq->rr_list.size() + hart_rq->fair_list.size() +
+               hart_rq->fcfs_list.size();
+    }
+
+    uint64_t Scheduler::clock_ns() noexcept {
+        auto *time_keeper =
+            env::hart_ctx != nullptr ? env::hart_ctx->time_keeper() : nullptr;
+        if (time_keeper == nullptr || time_keeper->source() == nullptr) {
+            return 0;
+        }
+        return static_cast<uint64_t>(
+            time_keeper->source()
+                ->to_ns(time_keeper->source()->now())
+                .to_nanoseconds());
+    }
+
+    void Scheduler::account_current(TCB *tcb) noexcept {
+        auto &local      = _harts[local_hart()];
+        uint64_t now     = clock_ns();
+        uint64_t start   = local.exec_start;
+        local.exec_start = now;
+        // 时钟未就绪或尚未开始计时, 没有可记的时间
+        if (tcb == nullptr || now == 0 || start == 0 || now <= start) {
+            return;
+        }
+        auto schd_res = schd(tcb->schd_class);
+        if (!schd_res.has_value()) {
+            return;
+        }
+        auto account_res =
+            schd_res.value()->account(rq(), util::nnullforce(tcb), now - start);
+        if (!account_res.has_value()) {
+            loggers::SUSTCORE::ERROR(
+                "调度器处理account失败! 错误码: %s 对应调度类: %s",
+                to_cstring(account_res.error()), to_cstring(tcb->schd_class));
+        }
+    }
+
+    bool Scheduler::tick_needed(TCB *running) noexcept {
+        if (running == nullptr) {
+            return true;
+        }
+        if (running->schd_class == ClassType::IDLE) {
+            // idle 进入等待前已尝试 pull_task, 之后有线程入队时由 nohz_kick 叫醒
+            return false;
+        }
+        auto local_rq = rq();
+        if (!local_rq->rt_list.empty() || !local_rq->rr_list.empty() ||
+            !local_rq->fair_list.empty() || !local_rq->fcfs_list.empty())
+        {
+            return true;
+        }
+        // 与 pull_task 的迁移条件一致: 对方至少有两个就绪线程才值得拉取
+        size_t self   = local_hart();
+        uint64_t mask = SMP::online_mask();
+        for (size_t hart = 0; hart < MAX_HARTS; ++hart) {
+            if ((mask & (1ul << hart)) == 0 || hart == self) {
+                continue;
+            }
+            if (load(hart) >= 2) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Scheduler::update_tick(TCB *running) noexcept {
+        auto *time_keeper =
+            env::hart_ctx != nullptr ? env::hart_ctx->time_keeper() : nullptr;
+        if (time_keeper == nullptr) {
+            return;
+        }
+        bool needed = tick_needed(running);
+        if (needed && time_keeper->tick_stopped()) {
+            time_keeper->restart_tick();
+        } else if (!needed && !time_keeper->tick_stopped()) {
+            time_keeper->stop_tick();
+        }
+    }
+
+    bool Scheduler::tick_stopped(size_t hart) noexcept {
+        auto *time_keeper = hart == local_hart()
+                                ? env::hart_ctx->time_keeper()
+                                : env::hart_context(hart).time_keeper();
+        return time_keeper != nullptr && time_keeper->tick_stopped();
+    }
+
+    void Scheduler::nohz_kick(size_t hart) noexcept {
+        if (hart == local_hart()) {
+            update_tick(current_tcb());
+        } else if (tick_stopped(hart)) {
+            // 对方停了 tick, 靠调度中断让它在 schedule() 中重新判断
+            (void)SMP::send_ipi(hart, SMP::IPI_RESCHEDULE);
+        }
+        if (load(hart) < 2) {
+            return;
+        }
+        // hart 过载: 停了 tick 的 hart 不会主动做负载均衡, 叫醒它们;
+        // 当前 hart 正在执行入队, 稍后自会经过 schedule() 或 idle 循环
+        uint64_t mask = SMP::online_mask();
+        for (size_t other = 0; other < MAX_HARTS; ++other) {
+            if ((mask & (1ul << other)) == 0 || other == hart ||
+                other == local_hart() || !tick_stopped(other))
+            {
+                continue;
+            }
+            (void)SMP::send_ipi(other, SMP::IPI_RESCHEDULE);
+        }
+    }
+
+    bool Scheduler::pull_task() {
+        if (SMP::online_count() < 2) {
+            return false;
+        }
+        size_t self     = local_hart();
+        size_t busiest  = self;
+        size_t max_load = load(self) + 1;
+        uint64_t mask   = SMP::online_mask();
+        for (size_t hart = 0; hart < MAX_HARTS; ++hart) {
+            if ((mask & (1ul << hart)) == 0 || hart == self) {
+                continue;
+            }
+            size_t hart_load = load(hart);
+            if (hart_load > max_load) {
+                busiest  = hart;
+                max_load = hart_load;
+            }
+        }
+        if (busiest == self) {
+            return false;
+        }
+
+        // RT 线程对延迟敏感, 不参与迁移; 取队尾, 它最晚才会被对方运行
+        auto src_rq = rq(busiest);
+        TCB *victim = nullptr;
+        if (src_rq->rr_list.empty() && !src_rq->fair_list.empty()) {
+            victim = fair::FAIR<TCB>::asunit_fair(
+                         util::nnullforce(&src_rq->fair_list.back()))
+                         .get();
+        } else {
+            auto &list = src_rq->rr_list.empty() ? src_rq->fcfs_list
+                                                 : src_rq->rr_list;
+            victim =
+                SchedMeta::asunit<TCB>(util::nnullforce(&list.back())).get();
+        }
+        auto tcb         = util::nnullforce(victim);
+        auto dequeue_res = dequeue(tcb);
+        if (!dequeue_res.has_value()) {
+            loggers::SUSTCORE::ERROR("负载均衡迁出线程失败! 错误码: %s",
+                                     to_cstring(dequeue_res.error()));
+            return false;
+        }
+        tcb->hart = self;
+        if (!try_wakeup(tcb.get(), 0)) {
+            return false;
+        }
+        loggers::TASK::DEBUG("负载均衡: tid=%d hart %lu -> %lu",
+                             static_cast<int>(tcb->tid), busiest, self);
+        return true;
+    }
+
     Result<util::nonnull<TCB *>> Scheduler::pick_next_task() {
         TCB *next = nullptr;
         foreach_schdclass([&](auto &&schd_inst) {
@@ -171,6 +413,8 @@ namespace schd {
     }
 
     Result<void> Scheduler::prepare_prev_task(TCB *tcb) noexcept {
+        // 无论是否重新入队, 换下前都要结清运行时间
+        account_current(tcb);
         if (tcb == nullptr ||
             tcb->basic_entity.state == ThreadState::INTERRUPTIBLE_WAITING ||
             tcb->basic_entity.state == ThreadState::UNINTERRUPTIBLE_WAITING ||
@@ -215,7 +459,10 @@ namespace schd {
     }
 
     void Scheduler::check_preempt_curr(TCB *new_tcb) {
-        auto *current = current_tcb();
+        size_t hart   = new_tcb->hart;
+        auto *current = hart == local_hart()
+                            ? current_tcb()
+                            : env::hart_context(hart).current_tcb();
         if (current == nullptr) {
             // 没有正在运行的线程, 不需要抢占
             return;
@@ -227,13 +474,25 @@ namespace schd {
         }
 
         bool do_preempt = false;
-        if (new_tcb->schd_class <= current->schd_class) {
-            // 如果新线程的调度类优先级不高于当前线程, 则不需要抢占
+        if (class_rank(new_tcb->schd_class) <
+            class_rank(current->schd_class))
+        {
+            // 如果新线程的调度类优先级低于当前线程, 则不需要抢占
             return;
         }
+        if (new_tcb->schd_class == current->schd_class) {
+            // 同类线程之间只有 FAIR 按 vruntime 比较, 其余类不抢占
+            if (new_tcb->schd_class != ClassType::FAIR) {
+                return;
+            }
+            if (hart == local_hart()) {
+                // 先结清当前线程的运行时间, 比较的才是最新的 vruntime
+                account_current(current);
+            }
+        }
 
         // 否则, 需要询问新线程的调度类是否需要抢占当前线程
-        auto schd_res = schd(new_tcb->schd_class);
+        auto schd_res = schd(new_tcb->schd_class, hart);
         if (!schd_res.has_value()) {
             loggers::SUSTCORE::ERROR("未知的调度类! 错误码: %s",
                                      to_cstring(schd_res.error()));
@@ -241,13 +500,17 @@ namespace schd {
         }
 
         do_preempt = schd_res.value()->check_preempt_curr(
-            rq(), util::nnullforce(new_tcb));
+            rq(hart), util::nnullforce(new_tcb));
 
         if (do_preempt) {
             // 为当前线程添加 NEED_RESCHED 标志,
             // 让调度器在合适的时候切换到新线程
             current->basic_entity
                 .template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            if (hart != local_hart()) {
+                // 对方可能正在用户态或 idle 中等待, 需要中断把它叫回来
+                (void)SMP::send_ipi(hart, SMP::IPI_RESCHEDULE);
+            }
         }
     }
 
@@ -296,27 +559,37 @@ namespace schd {
             panic("调度器崩溃!");
         }
         TCB *next = next_res.value();
+        update_tick(next);
         if (prev != next && prev != nullptr) {
             switch_to(prev, next);
         }
     }
 
     Result<void> Scheduler::enqueue(util::nonnull<TCB *> tcb) {
-        auto schd_res = schd(tcb->schd_class);
+        size_t hart   = target_hart(tcb);
+        auto schd_res = schd(tcb->schd_class, hart);
         if (!schd_res.has_value()) {
             unexpect_return(schd_res.error());
         }
 
-        return schd_res.value()->enqueue(rq(), tcb);
+        if (hart == local_hart()) {
+            // tick 停止时 min_vruntime 等记账可能很久未更新, 入队前先结清
+            account_current(current_tcb());
+        }
+        auto enqueue_res = schd_res.value()->enqueue(rq(hart), tcb);
+        propagate(enqueue_res);
+        nohz_kick(hart);
+        void_return();
     }
 
     Result<void> Scheduler::dequeue(util::nonnull<TCB *> tcb) {
-        auto schd_res = schd(tcb->schd_class);
+        size_t hart   = tcb->hart;
+        auto schd_res = schd(tcb->schd_class, hart);
         if (!schd_res.has_value()) {
             unexpect_return(schd_res.error());
         }
 
-        return schd_res.value()->dequeue(rq(), tcb);
+        return schd_res.value()->dequeue(rq(hart), tcb);
     }
 
     Result<void> Scheduler::block_current(wait::wd_t wait_wd) {
@@ -376,9 +649,11 @@ namespace schd {
         }
 
         schedule(true);
+        // 长时间运行的内核线程靠 yield 让出 CPU, 顺带把大内核锁让给其他 hart
+        BigKernelLock::relax();
     }
 
-    // RR > FCFS
+    // RR > FAIR > FCFS
     void Scheduler::do_tick(const TimerTickEvent &e) {
         loggers::TASK::DEBUG(
             "调度 tick: last=%llu now=%llu delta=%llu",
@@ -398,16 +673,26 @@ namespace schd {
             return;
         }
 
+        account_current(current);
         auto tick_res = schd_res.value()->on_tick(rq(), tcb);
         if (!tick_res.has_value()) {
             loggers::SUSTCORE::ERROR(
                 "调度器处理on_tick失败! 错误码: %s 对应调度类: %s",
                 to_cstring(tick_res.error()), to_cstring(tcb->schd_class));
         }
+
+        // tick 停止过时一次补记全部错过的周期
+        auto &local          = _harts[local_hart()];
+        local.balance_ticks += e.ticks;
+        if (local.balance_ticks >= BALANCE_INTERVAL) {
+            local.balance_ticks = 0;
+            (void)pull_task();
+        }
     }
 
     void Scheduler::init() {
-        if (_idle_schd.ready == nullptr || _init_schd.kinit_ready == nullptr) {
+        if (idle_schd()->ready == nullptr || init_schd()->kinit_ready == nullptr)
+        {
             loggers::SUSTCORE::ERROR("调度器启动前实体无效");
             panic("调度器崩溃!");
         }
@@ -431,10 +716,10 @@ namespace schd {
         }
         auto next = next_res.value();
         Interrupt::cli();
+        _harts[local_hart()].exec_start = clock_ns();
         prepare_switch(next);
         assert(next->ext_ctx != nullptr);
-        restore_ext_context(*next->ext_ctx);
-        next->ext_ctx_live = true;
+        arm_ext_context(next);
         Context bootstrap_prev{};
         bootstrap_prev.sp() = 0;
         __switch_to(&bootstrap_prev, next->kernel_context_ptr());
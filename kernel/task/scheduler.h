@@ -27,45 +27,124 @@ namespace schd {
 
     class Scheduler {
     private:
-        rt::RT<TCB> _rt_schd;
-        rr::RR<TCB> _rr_schd;
-        fcfs::FCFS<TCB> _fcfs_schd;
-        idle::IDLE<TCB> _idle_schd;
-        init::INIT<TCB> _init_schd;
+        /**
+         * @brief 单个 hart 的调度类实例.
+         *
+         * 调度类的 cursched 与 IDLE/INIT 的就绪槽都是 hart 私有的,
+         * 因此每个 hart 各持一套.
+         */
+        struct HartSchd {
+            rt::RT<TCB> rt;
+            rr::RR<TCB> rr;
+            fcfs::FCFS<TCB> fcfs;
+            idle::IDLE<TCB> idle;
+            init::INIT<TCB> init;
+            fair::FAIR<TCB> fair;
+            // 距上次负载均衡经过的 tick 数
+            size_t balance_ticks = 0;
+            // 当前线程上次记账的时刻 (ns)
+            uint64_t exec_start = 0;
+        };
+
+        HartSchd _harts[MAX_HARTS];
+
+        [[nodiscard]]
+        static size_t local_hart() noexcept;
+
+        /**
+         * @brief 决定 tcb 入队的 hart: 原 hart 离线时落到当前 hart.
+         */
+        [[nodiscard]]
+        size_t target_hart(TCB *tcb) noexcept;
+
+        /**
+         * @brief hart 就绪队列中可迁移的线程数.
+         */
+        [[nodiscard]]
+        size_t load(size_t hart) noexcept;
+
+        /**
+         * @brief 当前时间 (ns), 时钟尚未初始化时为 0.
+         */
+        [[nodiscard]]
+        static uint64_t clock_ns() noexcept;
+
+        /**
+         * @brief 把 exec_start 以来的运行时间记到当前线程所属的调度类上.
+         */
+        void account_current(TCB *tcb) noexcept;
+
+        /**
+         * @brief 当前 hart 运行 running 时是否需要周期 tick.
+         *
+         * idle 或只有一个可运行线程时不需要 (NO_HZ),
+         * 除非其他 hart 过载, 要靠本 hart 的 tick 做负载均衡.
+         */
+        [[nodiscard]]
+        bool tick_needed(TCB *running) noexcept;
+
+        /**
+         * @brief 按 tick_needed 停止或恢复当前 hart 的周期 tick.
+         */
+        void update_tick(TCB *running) noexcept;
+
+        /**
+         * @brief hart 的周期 tick 是否已停止.
+         */
+        [[nodiscard]]
+        static bool tick_stopped(size_t hart) noexcept;
+
+        /**
+         * @brief 线程入队 hart 后, 让停了 tick 的 hart 重新判断是否需要 tick.
+         */
+        void nohz_kick(size_t hart) noexcept;
+
     public:
+        /// 每隔多少个 tick 在 do_tick 中尝试一次负载均衡
+        constexpr static size_t BALANCE_INTERVAL = 10;
+
         static void init(util::nonnull<TCB *> idle_tcb,
                          util::nonnull<TCB *> kinit_tcb);
         static bool initialized();
         static Scheduler &inst();
 
-        constexpr Scheduler(util::nonnull<TCB *> idle_tcb,
-                            util::nonnull<TCB *> kinit_tcb) {
-            idle_tcb->basic_entity.state = ThreadState::READY;
-            _idle_schd.ready             = &idle_tcb->basic_entity;
-            kinit_tcb->basic_entity.state = ThreadState::READY;
-            _init_schd.kinit_ready        = &kinit_tcb->basic_entity;
-        }
+        Scheduler(util::nonnull<TCB *> idle_tcb,
+                  util::nonnull<TCB *> kinit_tcb);
+
+        /**
+         * @brief 为从 hart 安装 idle 线程, 在该 hart 上调用.
+         */
+        void init_hart(util::nonnull<TCB *> idle_tcb);
 
         util::nonnull<RQ *> rq();
+        util::nonnull<RQ *> rq(size_t hart);
+
+        util::nonnull<rt::RT<TCB> *> rt_schd(size_t hart = local_hart()) {
+            return _harts[hart].rt;
+        }
 
-        constexpr util::nonnull<rt::RT<TCB> *> rt_schd() {
-            return _rt_schd;
+        util::nonnull<rr::RR<TCB> *> rr_schd(size_t hart = local_hart()) {
+            return _harts[hart].rr;
         }
 
-        constexpr util::nonnull<rr::RR<TCB> *> rr_schd() {
-            return _rr_schd;
+        util::nonnull<fair::FAIR<TCB> *> fair_schd(
+            size_t hart = local_hart()) {
+            return _harts[hart].fair;
         }
 
-        constexpr util::nonnull<fcfs::FCFS<TCB> *> fcfs_schd() {
-            return _fcfs_schd;
+        util::nonnull<fcfs::FCFS<TCB> *> fcfs_schd(
+            size_t hart = local_hart()) {
+            return _harts[hart].fcfs;
         }
 
-        constexpr util::nonnull<idle::IDLE<TCB> *> idle_schd() {
-            return _idle_schd;
+        util::nonnull<idle::IDLE<TCB> *> idle_schd(
+            size_t hart = local_hart()) {
+            return _harts[hart].idle;
         }
 
-        constexpr util::nonnull<init::INIT<TCB> *> init_schd() {
-            return _init_schd;
+        util::nonnull<init::INIT<TCB> *> init_schd(
+            size_t hart = local_hart()) {
+            return _harts[hart].init;
         }
 
         [[nodiscard]]
@@ -90,13 +169,14 @@ namespace schd {
 
         using BaseSchedPtr = util::nonnull<BaseSched<TCB> *>;
 
-        constexpr Result<BaseSchedPtr> schd(ClassType type) {
+        Result<BaseSchedPtr> schd(ClassType type, size_t hart = local_hart()) {
             switch (type) {
-                case ClassType::RT:   return {rt_schd()};
-                case ClassType::INIT: return {init_schd()};
-                case ClassType::RR:   return {rr_schd()};
-                case ClassType::FCFS: return {fcfs_schd()};
-                case ClassType::IDLE: return {idle_schd()};
+                case ClassType::RT:   return {rt_schd(hart)};
+                case ClassType::INIT: return {init_schd(hart)};
+                case ClassType::RR:   return {rr_schd(hart)};
+                case ClassType::FAIR: return {fair_schd(hart)};
+                case ClassType::FCFS: return {fcfs_schd(hart)};
+                case ClassType::IDLE: return {idle_schd(hart)};
                 default:              unexpect_return(ErrCode::INVALID_PARAM);
             }
         }
@@ -115,19 +195,23 @@ namespace schd {
          */
         template <typename Func>
         void foreach_schdclass(Func f, ClassType bot = ClassType::BOT) {
-            if (ClassType::RT >= bot) {
+            const int bot_rank = class_rank(bot);
+            if (class_rank(ClassType::RT) >= bot_rank) {
                 f(rt_schd());
             }
-            if (ClassType::INIT >= bot) {
+            if (class_rank(ClassType::INIT) >= bot_rank) {
                 f(init_schd());
             }
-            if (ClassType::RR >= bot) {
+            if (class_rank(ClassType::RR) >= bot_rank) {
                 f(rr_schd());
             }
-            if (ClassType::FCFS >= bot) {
+            if (class_rank(ClassType::FAIR) >= bot_rank) {
+                f(fair_schd());
+            }
+            if (class_rank(ClassType::FCFS) >= bot_rank) {
                 f(fcfs_schd());
             }
-            if (ClassType::IDLE >= bot) {
+            if (class_rank(ClassType::IDLE) >= bot_rank) {
                 f(idle_schd());
             }
         }
@@ -142,9 +226,29 @@ namespace schd {
         void prepare_switch(TCB *tcb);
         void switch_to(TCB *prev, TCB *next);
 
+        /**
+         * @brief 判断 tcb 的扩展上下文是否仍装载在当前 hart 的寄存器中.
+         */
+        [[nodiscard]]
+        bool ext_context_loaded(const TCB *tcb) const noexcept;
+        /**
+         * @brief 让 next 返回用户态后首次使用扩展指令时陷入, 除非寄存器中已是它的状态.
+         */
+        void arm_ext_context(TCB *next) noexcept;
+
         bool try_wakeup(TCB *tcb, int flags);
         bool wakeup(TCB *tcb);
 
+        /**
+         * @brief 从最忙的 hart 拉取一个就绪线程到当前 hart.
+         *
+         * 只有对方比当前 hart 至少多两个就绪线程时才迁移,
+         * 避免线程在两个负载相当的 hart 之间来回搬动.
+         *
+         * @return true 拉到了线程
+         */
+        bool pull_task();
+
     public:
         void do_tick(const TimerTickEvent &e);
 
@@ -179,5 +283,30 @@ namespace schd {
 
         // 主动放弃 CPU
         void yield();
+
+        /**
+         * @brief 处理用户态首次使用扩展指令引发的陷入.
+         *
+         * 寄存器中不是当前线程的状态时从 ext_ctx 装载,
+         * 随后允许当前线程直接使用扩展指令.
+         *
+         * @param uctx 当前线程的用户态 trap 上下文
+         * @return true 已处理, 应重新执行该指令
+         */
+        bool ext_context_fault(Context *uctx) noexcept;
+
+        /**
+         * @brief 把 tcb 在寄存器中被修改过的扩展状态写回 ext_ctx.
+         *
+         * tcb 必须是当前线程, 用于 fork 与信号投递前读取 ext_ctx.
+         */
+        void sync_ext_context(TCB *tcb) noexcept;
+
+        /**
+         * @brief 直接改写 ext_ctx 后调用, 丢弃寄存器中的旧状态.
+         *
+         * tcb 必须是当前线程, 下次使用扩展指令时重新装载.
+         */
+        void drop_ext_context(TCB *tcb) noexcept;
     };
 }  // namespace schd
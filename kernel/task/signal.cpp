@@ -13,6 +13,7 @@
 #include <object/task.h>
 #include <syscall/uaccess.h>
 #include <syscall.h.in>
+#include <task/scheduler.h>
 #include <task/task.h>
 
 #include <cstddef>
@@ -576,8 +577,8 @@ namespace task {
             frame.flags |= LINUX_FRAME_FROM_SYSCALL;
             frame.syscall_pc = ctx->pc();
         }
-        if (tcb->ext_ctx_live && tcb->ext_ctx != nullptr) {
-            save_ext_context(*tcb->ext_ctx);
+        if (tcb->ext_ctx != nullptr) {
+            schd::Scheduler::inst().sync_ext_context(tcb.get());
         }
         fill_ucontext(frame.ucontext, *ctx, old_mask,
                       tcb->ext_ctx.get());
@@ -607,6 +608,8 @@ namespace task {
                       ? frame_addr + offsetof(linux_riscv64_frame, ucontext)
                       : 0;
         ctx->sstatus.value = LINUX_USER_STATUS_BITS;
+        // 上面覆盖了 sstatus.FS, 让处理函数首次使用浮点时重新装载
+        schd::Scheduler::inst().drop_ext_context(tcb.get());
 #elif defined(__ARCH_loongarch64__)
         linux_loongarch64_frame frame{};
         fill_user_siginfo(frame.info, signo);
@@ -616,8 +619,8 @@ namespace task {
             frame.flags |= LINUX_FRAME_FROM_SYSCALL;
             frame.syscall_pc = ctx->pc();
         }
-        if (tcb->ext_ctx_live && tcb->ext_ctx != nullptr) {
-            save_ext_context(*tcb->ext_ctx);
+        if (tcb->ext_ctx != nullptr) {
+            schd::Scheduler::inst().sync_ext_context(tcb.get());
         }
         fill_ucontext(frame.ucontext, *ctx, old_mask,
                       tcb->ext_ctx.get());
@@ -688,8 +691,7 @@ namespace task {
         }
         restore_ext(frame.ucontext, tcb->ext_ctx.get());
         if (tcb->ext_ctx != nullptr) {
-            restore_ext_context(*tcb->ext_ctx);
-            tcb->ext_ctx_live = true;
+            schd::Scheduler::inst().drop_ext_context(tcb.get());
         }
         tcb->task->signal_state.blocked_mask =
             user_mask_to_kernel_mask(frame.ucontext.uc_sigmask.sig[0]);
@@ -713,8 +715,7 @@ namespace task {
         }
         restore_ext(frame, tcb->ext_ctx.get());
         if (tcb->ext_ctx != nullptr) {
-            restore_ext_context(*tcb->ext_ctx);
-            tcb->ext_ctx_live = true;
+            schd::Scheduler::inst().drop_ext_context(tcb.get());
         }
         tcb->task->signal_state.blocked_mask =
             user_mask_to_kernel_mask(frame.ucontext.uc_sigmask.sig[0]);
@@ -548,6 +548,7 @@ namespace task {
         tcb->nanosleep_ctx  = nullptr;
         tcb->timed_wait_ctx = nullptr;
         tcb->wait_head      = {};
+        tcb->vma_cache      = {};
         tcb->syscall_info.reset();
 
         Result<PhyAddr> gfp_res = GFP::get_free_page(TCB::KSTACK_PAGES);
@@ -681,9 +682,7 @@ namespace task {
         }
 
         if (pcb->tmm.get() != nullptr) {
-            PhyAddr pgd = pcb->tmm->pgd();
-            delete pcb->tmm;
-            GFP::page_putpage(pgd);
+            TaskMemoryManager::release(pcb->tmm);
         }
         if (pcb->cholder != nullptr) {
             auto &chman = cap::CHolderManager::inst();
@@ -723,44 +722,40 @@ namespace task {
     }
 
     namespace kop {
-        Storage<KOP<PCB>> pcb_raw;
-        Storage<KOP<TCB>> tcb_raw;
-        Storage<LockedObject<IrqSaveGuardedLock, KOP<PCB>>> pcb_storage;
-        Storage<LockedObject<IrqSaveGuardedLock, KOP<TCB>>> tcb_storage;
+        Storage<KOP<PCB>> pcb_storage;
+        Storage<KOP<TCB>> tcb_storage;
 
         [[nodiscard]]
-        LockedObject<IrqSaveGuardedLock, KOP<PCB>> &pcb() {
+        KOP<PCB> &pcb() {
             return pcb_storage.ref();
         }
 
         [[nodiscard]]
-        LockedObject<IrqSaveGuardedLock, KOP<TCB>> &tcb() {
+        KOP<TCB> &tcb() {
             return tcb_storage.ref();
         }
     }  // namespace kop
 
     void init_kop() {
-        kop::pcb_raw.construct();
-        kop::tcb_raw.construct();
-        kop::pcb_storage.construct(kop::pcb_raw.get());
-        kop::tcb_storage.construct(kop::tcb_raw.get());
+        kop::pcb_storage.construct("pcb");
+        kop::tcb_storage.construct("tcb");
     }
 
     void *PCB::operator new(size_t size) {
         assert(size == sizeof(PCB));
-        return kop::pcb().get()->alloc();
+        return kop::pcb().alloc();
     }
 
     void PCB::operator delete(void *ptr) {
-        kop::pcb().get()->free(static_cast<PCB *>(ptr));
+        kop::pcb().free(static_cast<PCB *>(ptr));
     }
 
     void *TCB::operator new(size_t size) {
         assert(size == sizeof(TCB));
-        return kop::tcb().get()->alloc();
+        return kop::tcb().alloc();
     }
 
     void TCB::operator delete(void *ptr) {
-        kop::tcb().get()->free(static_cast<TCB *>(ptr));
+        kop::tcb().free(static_cast<TCB *>(ptr));
     }
 }  // namespace task
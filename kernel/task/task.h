@@ -115,10 +115,13 @@ namespace task {
             tcb->kstack_phy           = PhyAddr::null;
             tcb->ext_ctx              = util::owner<ExtContext *>(nullptr);
             tcb->ext_ctx_live         = false;
+            tcb->ext_ctx_hart         = 0;
             tcb->schd_class           = schd::ClassType::BOT;
+            tcb->hart                 = 0;
             tcb->basic_entity.state   = ThreadState::EMPTY;
             tcb->basic_entity.rq_head = {};
             tcb->rr_entity            = {};
+            tcb->fair_entity          = {};
             tcb->wait_wd              = 0;
             tcb->wait_predicate       = {};
             tcb->timeout              = false;
@@ -16,8 +16,10 @@
 #include <guard.h>
 #include <kinit.h>
 #include <logger.h>
+#include <mem/gfp.h>
 #include <object/memory.h>
 #include <object/task.h>
+#include <smp/smp.h>
 #include <sus/raii.h>
 #include <task/scheduler.h>
 #include <task/task.h>
@@ -65,6 +67,10 @@ namespace task {
             tcb->basic_entity.rq_head = {};
             tcb->basic_entity.flags   = 0;
             tcb->rr_entity            = {};
+            // vruntime 不清零: exec 时当前线程仍在运行,
+            // 清零后换下会长期占据 FAIR 队首; 入队时 place_entity 会再校正
+            tcb->fair_entity.rq_head    = {};
+            tcb->fair_entity.slice_exec = 0;
             tcb->syscall_info.reset();
         }
 
@@ -164,7 +170,15 @@ namespace task {
 
         void kthread_idle() {
             while (true) {
-                Idle::idle();
+                // 先利用空闲时间补充预清零页池, 再尝试从其他 hart 拉取线程,
+                // 都无事可做时才进入低功耗等待; 等待期间放开大内核锁
+                if (!GFP::refill_zero_pool() &&
+                    !schd::Scheduler::inst().pull_task())
+                {
+                    size_t depth = BigKernelLock::release_all();
+                    Idle::idle();
+                    BigKernelLock::reacquire(depth);
+                }
                 schd::Scheduler::inst().yield();
             }
         }
@@ -189,6 +203,8 @@ namespace task {
             if (tcb == nullptr || !tcb->is_kernel || tcb->kentry == nullptr) {
                 panic("内核线程入口无效");
             }
+            // 新线程不是从 switch_to 返回, 由这里建立自己的重入深度
+            BigKernelLock::set_depth(1);
             tcb->kentry(tcb->karg);
             kthread_exit();
         }
@@ -426,9 +442,7 @@ namespace task {
 
         void cleanup_task_spec(TaskSpec &spec) {
             if (spec.tmm.get() != nullptr) {
-                PhyAddr pgd = spec.tmm->pgd();
-                delete spec.tmm;
-                GFP::page_putpage(pgd);
+                TaskMemoryManager::release(spec.tmm);
                 spec.tmm = util::owner<TaskMemoryManager *>(nullptr);
             }
         }
@@ -828,7 +842,10 @@ namespace task {
                                      to_cstring(tmm_res.error()));
             propagate_return(tmm_res);
         }
-        auto tmm_guard  = delete_guard(tmm_res.value());
+        auto tmm_guard  = util::Guard([tmm = tmm_res.value()]() {
+            // 主内核页表不随之归还
+            TaskMemoryManager::release(tmm, false);
+        });
         pcb->tmm        = tmm_res.value();
         auto create_res = cap::CHolderManager::inst().create_holder();
         propagate(create_res);
@@ -1086,9 +1103,7 @@ namespace task {
             if (child_tmm.get() == nullptr) {
                 return;
             }
-            PhyAddr pgd = child_tmm->pgd();
-            delete child_tmm;
-            GFP::page_putpage(pgd);
+            TaskMemoryManager::release(child_tmm);
         });
 
         auto clone_mem_res = parent_pcb->tmm->clone_to_cow(*child_tmm);
@@ -1150,7 +1165,7 @@ namespace task {
                               parent_tcb->boot_role);
         assert(parent_tcb->ext_ctx != nullptr);
         assert(child_tcb->ext_ctx != nullptr);
-        save_ext_context(*parent_tcb->ext_ctx);
+        schd::Scheduler::inst().sync_ext_context(parent_tcb);
         copy_ext_context(*child_tcb->ext_ctx, *parent_tcb->ext_ctx);
         child_pcb->threads.push_back(*child_tcb);
         tcb_guard.release();
@@ -1339,6 +1354,8 @@ namespace task {
             current_tcb->basic_entity.state = ThreadState::RUNNING;
             current_tcb->basic_entity.flags = 0;
             current_tcb->rr_entity          = {};
+            // 寄存器中仍是旧映像的扩展状态, 新映像首次使用时装载清零的 ext_ctx
+            schd::Scheduler::inst().arm_ext_context(current_tcb);
         } else if (!schd::Scheduler::inst().wakeup_new(populate_res.value())) {
             unexpect_return(ErrCode::CREATION_FAILED);
         }
@@ -1439,6 +1456,8 @@ namespace task {
             current_tcb->basic_entity.state = ThreadState::RUNNING;
             current_tcb->basic_entity.flags = 0;
             current_tcb->rr_entity          = {};
+            // 寄存器中仍是旧映像的扩展状态, 新映像首次使用时装载清零的 ext_ctx
+            schd::Scheduler::inst().arm_ext_context(current_tcb);
         } else if (!schd::Scheduler::inst().wakeup_new(populate_res.value())) {
             unexpect_return(ErrCode::CREATION_FAILED);
         }
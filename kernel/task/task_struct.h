@@ -15,6 +15,7 @@
 #include <arch/description.h>
 #include <cap/cholder.h>
 #include <mem/vma.h>
+#include <schd/fair.h>
 #include <schd/fcfs.h>
 #include <schd/rr.h>
 #include <schd/schdbase.h>
@@ -150,7 +151,10 @@ namespace task {
         PhyAddr kstack_phy;
         Context kernel_ctx;
         util::owner<ExtContext *> ext_ctx;
+        // 扩展上下文是否装载在 ext_ctx_hart 的寄存器中,
+        // 还需该 hart 的 ext_owner 仍指向本线程才有效
         bool ext_ctx_live;
+        size_t ext_ctx_hart;
 
         [[nodiscard]]
         void *kstack_top() const noexcept {
@@ -200,8 +204,11 @@ namespace task {
         //  schedule data
         BootThreadRole boot_role;
         schd::ClassType schd_class;
+        // 所在运行队列的 hart, 切入时更新, 负载均衡迁移时改写
+        size_t hart;
         schd::SchedMeta basic_entity;
         schd::rr::Entity rr_entity;
+        schd::fair::Entity fair_entity;
 
         // wait data
         util::ListHead<TCB> wait_head;
@@ -218,6 +225,8 @@ namespace task {
         NanosleepContext *nanosleep_ctx;
         TimedWaitContext *timed_wait_ctx;
         SyscallInfo syscall_info;
+        // 最近一次 VMA 查找结果
+        VMACache vma_cache;
 
         void *operator new(size_t size);
         void operator delete(void *ptr);
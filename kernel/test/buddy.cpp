@@ -13,6 +13,8 @@
 #include <sus/list.h>
 #include <test/buddy.h>
 
+#include <cstring>
+
 namespace test::buddy {
 
     class CaseFragmentation : public TestCase {
@@ -159,6 +161,180 @@ namespace test::buddy {
         }
     };
 
+    class CaseMemMapDescriptor : public TestCase {
+    public:
+        CaseMemMapDescriptor() : TestCase("页描述符表引用计数与 buddy 状态") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            expect("分配的页应有描述符, 且引用计数为 1, 不处于 buddy 中");
+            auto r = GFP::get_free_page(2);
+            tassert(r.has_value(), "分配失败");
+            PhyAddr p   = r.value();
+            Page* page  = MemMap::page_of(p);
+            tassert(page != nullptr, "分配的页不在描述符表中");
+            ttest(MemMap::paddr_of(page) == p);
+            ttest(page[0].refcount == 1 && page[1].refcount == 1);
+            ttest(!page[0].test(Page::PG_BUDDY));
+
+            action("增加引用后释放一次, 页应仍被占用");
+            GFP::keep_page(p, 2);
+            ttest(GFP::ref_count(p) == 2);
+            GFP::put_page(p, 2);
+            ttest(GFP::ref_count(p) == 1);
+
+            action("再次释放, 页应回到 buddy");
+            GFP::put_page(p, 2);
+            ttest(GFP::ref_count(p) == 0);
+            ttest(page[0].owner == nullptr);
+
+            expect("描述符表自身占用的页被标记为保留");
+            Page* storage = MemMap::page_of(MemMap::storage_area().begin);
+            tassert(storage != nullptr);
+            ttest(storage->test(Page::PG_RESERVED));
+        }
+    };
+
+    class CaseMergeOutOfOrder : public TestCase {
+    public:
+        CaseMergeOutOfOrder() : TestCase("Buddy 乱序逐页释放后完全合并") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kPages   = 8;
+            constexpr size_t kOrder[]   = {5, 0, 7, 2, 4, 1, 6, 3};
+
+            expect("分配 8 页对齐块");
+            auto r = GFP::get_free_page(kPages);
+            tassert(r.has_value(), "分配失败");
+            PhyAddr base = r.value();
+
+            action("以乱序逐页释放");
+            for (size_t idx : kOrder) {
+                GFP::put_page(base + idx * PAGESIZE, 1);
+            }
+            GFP::drain_pcp();
+
+            check("块首页应重新成为至少 3 阶的空闲块");
+            Page* head = MemMap::page_of(base);
+            tassert(head != nullptr);
+            bool merged = false;
+            for (size_t order = 3; order <= BuddyAllocator::MAX_BUDDY_ORDER;
+                 order++)
+            {
+                size_t span = (1ul << order) * PAGESIZE;
+                Page* block = MemMap::page_of(PhyAddr(base.arith() & ~(span - 1)));
+                if (block != nullptr && block->test(Page::PG_BUDDY) &&
+                    block->order == order)
+                {
+                    merged = true;
+                    break;
+                }
+            }
+            ttest(merged);
+            ttest(!head->test(Page::PG_BUDDY) || head->order >= 3);
+        }
+    };
+
+    class CaseFragmentationIndex : public TestCase {
+    public:
+        CaseFragmentationIndex() : TestCase("Buddy 外部碎片指数计算") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            BuddyAllocator::BuddyStats stats{};
+
+            expect("没有空闲块时指数为 0");
+            ttest(BuddyAllocator::fragmentation_index(stats, 3) == 0);
+
+            expect("只有 8 个 0 阶空闲块时, 3 阶请求的指数为 750");
+            stats.free_blocks[0] = 8;
+            stats.free_pages     = 8;
+            ttest(BuddyAllocator::fragmentation_index(stats, 3) == 750);
+
+            expect("存在足够大的块时指数为 -1000");
+            ttest(BuddyAllocator::fragmentation_index(stats, 0) == -1000);
+        }
+    };
+
+    class CasePcpReuse : public TestCase {
+    public:
+        CasePcpReuse() : TestCase("per-hart 0 阶空闲页链表热页复用") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            expect("单页释放后再次申请应拿回同一个热页");
+            auto r = GFP::get_free_page(1);
+            tassert(r.has_value(), "分配失败");
+            PhyAddr p = r.value();
+            GFP::put_page(p, 1);
+            ttest(GFP::ref_count(p) == 0);
+
+            auto again = GFP::get_free_page(1);
+            tassert(again.has_value(), "再次分配失败");
+            ttest(again.value() == p);
+            ttest(GFP::ref_count(p) == 1);
+
+            action("连续释放超过高水位的单页");
+            constexpr size_t kPages = GFP::PCP_HIGH + GFP::PCP_BATCH;
+            PhyAddr pages[kPages];
+            pages[0] = again.value();
+            for (size_t i = 1; i < kPages; i++) {
+                auto res = GFP::get_free_page(1);
+                tassert(res.has_value(), "分配失败");
+                pages[i] = res.value();
+            }
+            for (size_t i = 0; i < kPages; i++) {
+                GFP::put_page(pages[i], 1);
+            }
+
+            check("链表长度不超过高水位, 排空后归零");
+            ttest(GFP::pcp_pages() <= GFP::PCP_HIGH);
+            GFP::drain_pcp();
+            ttest(GFP::pcp_pages() == 0);
+        }
+    };
+
+    class CaseZeroPool : public TestCase {
+    public:
+        CaseZeroPool() : TestCase("预清零页池与 GFP_ZERO 分配") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            auto all_zero = [](PhyAddr paddr) {
+                auto* bytes = convert<KpaAddr>(paddr).as<uint8_t>();
+                for (size_t i = 0; i < PAGESIZE; i++) {
+                    if (bytes[i] != 0) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            expect("池未满时补充应清零至少一页");
+            size_t before = GFP::zero_pool_pages();
+            if (before < GFP::ZERO_POOL_HIGH) {
+                ttest(GFP::refill_zero_pool());
+                ttest(GFP::zero_pool_pages() > before);
+            }
+
+            action("从池中取页并写脏后释放");
+            auto r = GFP::get_free_page(1, GFP_ZERO);
+            tassert(r.has_value(), "分配失败");
+            PhyAddr p = r.value();
+            ttest(all_zero(p));
+            ttest(GFP::ref_count(p) == 1);
+            memset(convert<KpaAddr>(p).addr(), 0xa5, PAGESIZE);
+            GFP::put_page(p, 1);
+
+            check("排空池后 GFP_ZERO 仍返回全零页");
+            size_t drained = 0;
+            PhyAddr held[GFP::ZERO_POOL_HIGH];
+            while (GFP::zero_pool_pages() > 0 && drained < GFP::ZERO_POOL_HIGH) {
+                auto res = GFP::get_free_page(1, GFP_ZERO);
+                tassert(res.has_value(), "分配失败");
+                held[drained++] = res.value();
+            }
+            auto dirty = GFP::get_free_page(1, GFP_ZERO);
+            tassert(dirty.has_value(), "分配失败");
+            ttest(all_zero(dirty.value()));
+            GFP::put_page(dirty.value(), 1);
+            for (size_t i = 0; i < drained; i++) {
+                GFP::put_page(held[i], 1);
+            }
+        }
+    };
+
     void collect_tests(TestFramework& framework) {
         auto cases = util::ArrayList<TestCase*>();
         cases.push_back(new CaseFragmentation());
@@ -167,6 +343,11 @@ namespace test::buddy {
         cases.push_back(new CaseInvalidArgs());
         cases.push_back(new CaseAlignment());
         cases.push_back(new CaseStressSmall());
+        cases.push_back(new CaseMemMapDescriptor());
+        cases.push_back(new CaseMergeOutOfOrder());
+        cases.push_back(new CaseFragmentationIndex());
+        cases.push_back(new CasePcpReuse());
+        cases.push_back(new CaseZeroPool());
 
         framework.add_category(new TestCategory("buddy", std::move(cases)));
     }
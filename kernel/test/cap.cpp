@@ -12,11 +12,15 @@
 #include <cap/capability.h>
 #include <cap/cholder.h>
 #include <guard.h>
+#include <mem/zram.h>
 #include <object/endpoint.h>
 #include <object/intobj.h>
+#include <object/memory.h>
 #include <object/perm.h>
 #include <test/cap.h>
 
+#include <cstring>
+
 namespace test::cap {
     namespace kcap = ::cap;
 
@@ -207,6 +211,187 @@ namespace test::cap {
         }
     };
 
+    class CaseMemoryHugePage : public TestCase {
+    public:
+        CaseMemoryHugePage() : TestCase("匿名 Memory 透明大页补页") {}
+
+        void _run(void *env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kHuge = ::cap::MemoryPayload::HUGE_PAGE_SIZE;
+
+            expect("共享 Memory 不使用大页");
+            auto *shared = new ::cap::MemoryPayload(
+                kHuge, true, false, ::cap::MemoryGrowth::FIXED);
+            auto shared_res = shared->ensure_huge_page(0);
+            ttest(!shared_res.has_value() &&
+                  shared_res.error() == ErrCode::NOT_SUPPORTED);
+            shared->destruct();
+
+            auto *memory = new ::cap::MemoryPayload(
+                kHuge * 2, false, false, ::cap::MemoryGrowth::FIXED);
+            check_private(memory);
+            // 无论中途是否失败, payload 及其大页都在这里释放
+            memory->destruct();
+        }
+
+    private:
+        void check_private(::cap::MemoryPayload *memory) const noexcept {
+            constexpr size_t kHuge = ::cap::MemoryPayload::HUGE_PAGE_SIZE;
+
+            expect("非大页对齐的偏移被拒绝");
+            auto misaligned = memory->ensure_huge_page(PAGESIZE);
+            ttest(!misaligned.has_value() &&
+                  misaligned.error() == ErrCode::INVALID_PARAM);
+
+            auto huge_res = memory->ensure_huge_page(0);
+            if (!huge_res.has_value()) {
+                // 物理内存碎片化时允许回退, 此时不再检查大页布局
+                ttest(huge_res.error() == ErrCode::OUT_OF_MEMORY);
+                return;
+            }
+
+            check("大页物理连续且按 2M 对齐, 仍以 4K 粒度记录");
+            PhyAddr base = huge_res.value();
+            ttest(base.aligned<kHuge>());
+            ttest(memory->allocated_size() == kHuge);
+            auto page_res = memory->lookup_page(5 * PAGESIZE);
+            ttest(page_res.has_value() && page_res.value() == base + 5 * PAGESIZE);
+
+            expect("重复请求返回同一块大页");
+            auto again = memory->ensure_huge_page(0);
+            ttest(again.has_value() && again.value() == base);
+
+            expect("已被 4K 页部分填充的区域不再使用大页");
+            auto small = memory->ensure_page(kHuge + PAGESIZE);
+            tassert(small.has_value(), "4K 补页");
+            auto partial = memory->ensure_huge_page(kHuge);
+            ttest(!partial.has_value() &&
+                  partial.error() == ErrCode::NOT_SUPPORTED);
+        }
+    };
+
+    class CaseMemoryZeroPage : public TestCase {
+    public:
+        CaseMemoryZeroPage() : TestCase("匿名 Memory 读缺页共享零页") {}
+
+        void _run(void *env [[maybe_unused]]) const noexcept override {
+            auto zero_res = ::cap::MemoryPayload::zero_page();
+            tassert(zero_res.has_value(), "分配共享零页");
+            PhyAddr zero = zero_res.value();
+
+            auto *memory = new ::cap::MemoryPayload(
+                4 * PAGESIZE, false, false, ::cap::MemoryGrowth::FIXED);
+
+            expect("读访问记录为共享零页, 不分配新页");
+            auto read_res = memory->ensure_read_page_entry(PAGESIZE);
+            tassert(read_res.has_value(), "读补页");
+            ttest(read_res.value().addr == zero);
+            ttest(read_res.value().refcount > 1);
+            ttest((read_res.value().flags & ::cap::PhyPage::PP_ZERO) != 0);
+
+            expect("写入后换成内容为 0 的私有页");
+            char byte      = 1;
+            auto write_res = memory->write(PAGESIZE + 8, &byte, 1);
+            tassert(write_res.has_value(), "写入零页");
+            auto page_res = memory->lookup_page(PAGESIZE);
+            ttest(page_res.has_value() && page_res.value() != zero);
+            char buf[16]  = {};
+            auto back_res = memory->read(PAGESIZE, buf, sizeof(buf));
+            ttest(back_res.has_value() && buf[0] == 0 && buf[8] == 1);
+
+            check("共享零页本身保持为 0");
+            ttest(*static_cast<char *>(convert<KpaAddr>(zero).addr()) == 0);
+
+            memory->destruct();
+        }
+    };
+
+    class CaseMemorySwap : public TestCase {
+    public:
+        CaseMemorySwap() : TestCase("匿名 Memory 页压缩换出与换入") {}
+
+        void _run(void *env [[maybe_unused]]) const noexcept override {
+            auto *memory = new ::cap::MemoryPayload(
+                4 * PAGESIZE, false, false, ::cap::MemoryGrowth::FIXED);
+            char pattern[64];
+            for (size_t i = 0; i < sizeof(pattern); ++i) {
+                pattern[i] = static_cast<char>('a' + i % 26);
+            }
+            auto write_res = memory->write(PAGESIZE, pattern, sizeof(pattern));
+            tassert(write_res.has_value(), "写入匿名页");
+
+            expect("独占的匿名页可以换出, 换出后视为不驻留");
+            ttest(memory->swappable(PAGESIZE));
+            size_t before = ZRam::get_stats().swap_outs;
+            auto swap_res = memory->swap_out(PAGESIZE);
+            tassert(swap_res.has_value(), "换出匿名页");
+            ttest(ZRam::get_stats().swap_outs == before + 1);
+            ttest(!memory->lookup_page(PAGESIZE).has_value());
+            ttest(!memory->swappable(PAGESIZE));
+
+            check("再次访问时换入原内容");
+            char buf[64]  = {};
+            auto read_res = memory->read(PAGESIZE, buf, sizeof(buf));
+            ttest(read_res.has_value() &&
+                  memcmp(buf, pattern, sizeof(buf)) == 0);
+            ttest(memory->lookup_page(PAGESIZE).has_value());
+
+            expect("已换出的页随 payload 一并释放");
+            size_t stored = ZRam::get_stats().stored_pages;
+            tassert(memory->swap_out(PAGESIZE).has_value(), "再次换出");
+            memory->destruct();
+            ttest(ZRam::get_stats().stored_pages == stored);
+        }
+    };
+
+    class CasePageIndex : public TestCase {
+    public:
+        CasePageIndex() : TestCase("Memory 物理页基数树索引") {}
+
+        void _run(void *env [[maybe_unused]]) const noexcept override {
+            ::cap::PageIndex index;
+
+            expect("稀疏键插入后可查询, 树高按需增长");
+            constexpr size_t kFar = 1ul << 20;
+            size_t keys[]         = {0, 1, 63, 64, 4095, kFar};
+            for (size_t key : keys) {
+                auto insert_res = index.insert(
+                    key, ::cap::PhyPage{PhyAddr((key + 1) * PAGESIZE), 1});
+                tassert(insert_res.has_value(), "插入页记录");
+            }
+            ttest(index.size() == 6);
+            auto *far = index.find(kFar);
+            ttest(far != nullptr && far->addr == PhyAddr((kFar + 1) * PAGESIZE));
+            ttest(index.find(2) == nullptr);
+
+            expect("覆盖已有键不改变记录数");
+            auto again = index.insert(63, ::cap::PhyPage{PhyAddr::null, 2});
+            ttest(again.has_value() && index.size() == 6);
+            ttest(index.find(63)->refcount == 2);
+
+            expect("区间遍历按键升序且只访问范围内记录");
+            size_t visited = 0;
+            size_t last    = 0;
+            bool ordered   = true;
+            index.for_each(1, 4095, [&](size_t key, ::cap::PhyPage &) {
+                ordered = ordered && (visited == 0 || key > last);
+                last    = key;
+                visited++;
+            });
+            ttest(ordered && visited == 4);
+
+            expect("drain_from 删除尾部记录并回收节点");
+            size_t drained = 0;
+            index.drain_from(64, [&](size_t, ::cap::PhyPage &) { drained++; });
+            ttest(drained == 3 && index.size() == 3);
+            ttest(index.find(kFar) == nullptr && index.find(1) != nullptr);
+
+            expect("逐个删除直至为空");
+            ttest(index.erase(0) && !index.erase(0));
+            ttest(index.erase(1) && index.erase(63));
+            ttest(index.empty());
+        }
+    };
+
     void collect_tests(TestFramework &framework) {
         auto cases = util::ArrayList<TestCase *>();
         cases.push_back(new CaseCreateObject());
@@ -214,6 +399,10 @@ namespace test::cap {
         cases.push_back(new CaseDowngradeAndDerive());
         cases.push_back(new CasePayloadDestruct());
         cases.push_back(new CaseEndpointTransferPermissions());
+        cases.push_back(new CaseMemoryHugePage());
+        cases.push_back(new CaseMemoryZeroPage());
+        cases.push_back(new CaseMemorySwap());
+        cases.push_back(new CasePageIndex());
 
         framework.add_category(
             new TestCategory("capability", std::move(cases)));
@@ -22,21 +22,25 @@
 #include <test/functional.h>
 #include <test/meta.h>
 #include <test/optional.h>
+#include <test/page_cache.h>
 #include <test/path.h>
 #include <test/printf.h>
 #include <test/raii.h>
 #include <test/ranges.h>
 #include <test/ringbuf.h>
 #include <test/schd/fcfs.h>
+#include <test/schd/fair.h>
 #include <test/schd/rr.h>
 #include <test/slub.h>
 #include <test/source_location.h>
 #include <test/string.h>
 #include <test/string_view.h>
+#include <test/timer_wheel.h>
 #include <test/tree.h>
 #include <test/unordered_map.h>
 #include <test/unordered_set.h>
 #include <test/vector.h>
+#include <test/vma.h>
 #include <test/wait.h>
 
 void collect_tests(TestFramework& framework) {
@@ -58,14 +62,21 @@ void collect_tests(TestFramework& framework) {
     // test::ranges::collect_tests(framework);
     // test::schd_test::fcfs::collect_tests(framework);
     // test::schd_test::rr::collect_tests(framework);
+    test::schd_test::fair::collect_tests(framework);
     // test::slub::collect_tests(framework);
     // test::source_location::collect_tests(framework);
     // test::string::collect_tests(framework);
     // test::string_view::collect_tests(framework);
+    test::timer_wheel::collect_tests(framework);
     // test::tree::collect_tests(framework);
     // test::unordered_map::collect_tests(framework);
     test::unordered_set::collect_tests(framework);
     // test::vector::collect_tests(framework);
+    // test::vma::collect_tests(framework);
+}
+
+void collect_runtime_tests(TestFramework& framework) {
+    test::page_cache::collect_tests(framework);
 }
 
 void TestFramework::run_all() const {
@@ -225,3 +225,5 @@ public:
 };
 
 void collect_tests(TestFramework& framework);
+// 依赖 VFS 等运行时子系统的测试, 由 kinit 在这些子系统就绪后运行
+void collect_runtime_tests(TestFramework& framework);
@@ -1,3 +1,3 @@
 sources += array.cpp buddy.cpp cap.cpp coroutine.cpp expected.cpp framework.cpp optional.cpp path.cpp printf.cpp raii.cpp ranges.cpp slub.cpp
 sources += source_location.cpp string.cpp string_view.cpp tree.cpp functional.cpp unordered_map.cpp unordered_set.cpp vector.cpp ringbuf.cpp
-sources += wait.cpp
+sources += wait.cpp vma.cpp timer_wheel.cpp page_cache.cpp
@@ -0,0 +1,107 @@
+/**
+ * @file page_cache.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 页缓存回收测试
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <sus/raii.h>
+#include <test/page_cache.h>
+#include <vfs/vfs.h>
+
+#include <cstring>
+
+namespace test::page_cache {
+    namespace {
+        constexpr const char* kTestFile = "/page_cache_shrink_test";
+        constexpr size_t kPages         = 9;
+        constexpr size_t kSize          = kPages * PAGESIZE;
+
+        void fill_data(char* data) {
+            for (size_t i = 0; i < kSize; ++i) {
+                data[i] = static_cast<char>('A' + ((i / PAGESIZE + i) % 26));
+            }
+        }
+    }  // namespace
+
+    class CaseShrinkLRU : public TestCase {
+    public:
+        CaseShrinkLRU() : TestCase("shrinker 按 LRU 淘汰并回写脏页") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            auto& vfs = VFS::inst();
+            auto* data = new char[kSize];
+            auto* page = new char[PAGESIZE];
+            tassert(data != nullptr && page != nullptr, "分配缓冲区成功");
+            util::Guard buf_guard([data, page]() {
+                delete[] data;
+                delete[] page;
+            });
+            fill_data(data);
+
+            // 测试文件留在根 tmpfs 中, 其数据在回写后由 tmpfs 自身持有
+            auto file_res = vfs.__debug_create(kTestFile);
+            tassert(file_res.has_value(), "创建测试文件成功");
+            auto* file = file_res.value();
+            util::Guard file_guard([file]() { file->destruct(); });
+
+            action("写入全部页, 使其成为脏页");
+            auto write_res = vfs.write(*file, 0, data, kSize);
+            tassert(write_res.has_value() && write_res.value() == kSize,
+                    "写入测试文件成功");
+
+            // 读回一页并与写入的数据比对
+            auto read_page = [&vfs, file, data, page](size_t index) {
+                memset(page, 0, PAGESIZE);
+                auto read_res =
+                    vfs.read(*file, static_cast<off_t>(index * PAGESIZE), page,
+                             PAGESIZE);
+                return read_res.has_value() && read_res.value() == PAGESIZE &&
+                       memcmp(page, data + index * PAGESIZE, PAGESIZE) == 0;
+            };
+
+            action("依次访问首页与末页, 使其成为最近使用的两页");
+            constexpr size_t hot_page = kPages - 1;
+            tassert(read_page(0));
+            tassert(read_page(hot_page));
+
+            VFSPageCacheStats before = VFS::page_cache_stats();
+            tassert(before.cached_pages >= kPages, "全部测试页驻留在页缓存中");
+
+            action("驱动 shrinker, 只留下最近使用的两页");
+            size_t shrunk = VFS::shrink_page_cache(before.cached_pages - 2);
+            VFSPageCacheStats after = VFS::page_cache_stats();
+
+            expect("冷页全部被淘汰, 且淘汰前已回写");
+            ttest(shrunk >= kPages - 2);
+            ttest(after.evictions == before.evictions + shrunk);
+            ttest(after.cached_pages == before.cached_pages - shrunk);
+            ttest(after.writebacks >= before.writebacks + kPages - 2);
+
+            expect("最近使用的两页仍然命中");
+            ttest(read_page(0));
+            ttest(read_page(hot_page));
+
+            VFSPageCacheStats recent = VFS::page_cache_stats();
+            ttest(recent.misses == after.misses);
+            ttest(recent.hits == after.hits + 2);
+
+            expect("冷页缺失一次, 并读回淘汰前回写的数据");
+            ttest(read_page(1));
+
+            VFSPageCacheStats cold = VFS::page_cache_stats();
+            ttest(cold.misses == recent.misses + 1);
+        }
+    };
+
+    void collect_tests(TestFramework& framework) {
+        auto cases = util::ArrayList<TestCase*>();
+        cases.push_back(new CaseShrinkLRU());
+
+        framework.add_category(new TestCategory("page_cache", std::move(cases)));
+    }
+}  // namespace test::page_cache
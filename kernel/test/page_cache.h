@@ -0,0 +1,18 @@
+/**
+ * @file page_cache.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 页缓存回收测试头文件
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <test/framework.h>
+
+namespace test::page_cache {
+    void collect_tests(TestFramework& framework);
+}
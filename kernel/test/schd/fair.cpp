@@ -0,0 +1,255 @@
+/**
+ * @file fair.cpp
+ * @brief FAIR 调度器 vruntime 排序与唤醒延迟模拟测试
+ */
+
+#include <schd/fair.h>
+#include <sus/units.h>
+#include <test/schd/fair.h>
+
+namespace test::schd_test::fair {
+    struct TestThread {
+        schd::SchedMeta basic_entity{};
+        schd::fair::Entity fair_entity{};
+    };
+
+    using Fair = schd::fair::FAIR<TestThread>;
+
+    bool need_resched(TestThread& thread) {
+        return (thread.basic_entity.flags & schd::SchedMeta::FLAGS_NEED_RESCHED) != 0;
+    }
+
+    class CaseClassRank : public TestCase {
+    public:
+        CaseClassRank() : TestCase("FAIR 加入后调度类 ABI 数值不变") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            using schd::ClassType;
+            using schd::class_rank;
+
+            expect("已有调度类保持原数值, FAIR 追加在最后");
+            ttest(static_cast<size_t>(ClassType::IDLE) == 1);
+            ttest(static_cast<size_t>(ClassType::FCFS) == 2);
+            ttest(static_cast<size_t>(ClassType::RR) == 3);
+            ttest(static_cast<size_t>(ClassType::RT) == 5);
+            ttest(static_cast<size_t>(ClassType::FAIR) == 6);
+
+            expect("优先级按 class_rank: RT > INIT > RR > FAIR > FCFS > IDLE");
+            ttest(class_rank(ClassType::RT) > class_rank(ClassType::INIT));
+            ttest(class_rank(ClassType::INIT) > class_rank(ClassType::RR));
+            ttest(class_rank(ClassType::RR) > class_rank(ClassType::FAIR));
+            ttest(class_rank(ClassType::FAIR) > class_rank(ClassType::FCFS));
+            ttest(class_rank(ClassType::FCFS) > class_rank(ClassType::IDLE));
+            ttest(class_rank(ClassType::IDLE) > class_rank(ClassType::BOT));
+        }
+    };
+
+    class CaseNiceWeight : public TestCase {
+    public:
+        CaseNiceWeight() : TestCase("FAIR nice 权重与 vruntime 排序") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Fair scheduler;
+            schd::RQ rq{};
+            TestThread normal{};
+            TestThread nice{};
+            scheduler.set_nice(util::nnullforce(&rq), util::nnullforce(&nice), 5);
+
+            action("两个线程运行相同的实际时间");
+            tassert(scheduler.account(util::nnullforce(&rq), util::nnullforce(&normal),
+                                      10'000'000).has_value(),
+                    "nice 0 线程记账成功");
+            tassert(scheduler.account(util::nnullforce(&rq), util::nnullforce(&nice),
+                                      10'000'000).has_value(),
+                    "nice 5 线程记账成功");
+
+            expect("nice 0 的 vruntime 等于实际时间, nice 5 按权重放大");
+            ttest(normal.fair_entity.vruntime == 10'000'000);
+            ttest(nice.fair_entity.vruntime ==
+                  10'000'000 * schd::fair::NICE_0_WEIGHT / schd::fair::weight_of(5));
+            ttest(nice.fair_entity.vruntime > normal.fair_entity.vruntime);
+
+            action("两个线程入队后取下一个线程");
+            tassert(scheduler.enqueue(util::nnullforce(&rq),
+                                      util::nnullforce(&nice)).has_value(),
+                    "nice 5 线程入队成功");
+            tassert(scheduler.enqueue(util::nnullforce(&rq),
+                                      util::nnullforce(&normal)).has_value(),
+                    "nice 0 线程入队成功");
+            ttest(rq.fair_load ==
+                  schd::fair::weight_of(0) + schd::fair::weight_of(5));
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "取下一个线程成功");
+            ttest(next.value().get() == &normal);
+            ttest(normal.basic_entity.state == ThreadState::RUNNING);
+            ttest(rq.fair_list.size() == 1);
+            ttest(rq.fair_load == schd::fair::weight_of(5));
+        }
+    };
+
+    class CaseSleeperCredit : public TestCase {
+    public:
+        CaseSleeperCredit() : TestCase("FAIR 新线程与睡醒线程的起始 vruntime") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Fair scheduler;
+            schd::RQ rq{};
+            rq.fair_min_vruntime = 100'000'000;
+            TestThread fresh{};
+            TestThread sleeper{};
+            sleeper.fair_entity.sum_exec = 1'000'000;
+            sleeper.fair_entity.vruntime = 1'000'000;
+
+            tassert(scheduler.enqueue(util::nnullforce(&rq),
+                                      util::nnullforce(&fresh)).has_value(),
+                    "新线程入队成功");
+            tassert(scheduler.enqueue(util::nnullforce(&rq),
+                                      util::nnullforce(&sleeper)).has_value(),
+                    "睡醒线程入队成功");
+
+            expect("新线程从 min_vruntime 开始, 不能借创建线程插队");
+            ttest(fresh.fair_entity.vruntime == rq.fair_min_vruntime);
+            expect("长睡的线程最多领先 SLEEPER_CREDIT_NS");
+            ttest(sleeper.fair_entity.vruntime ==
+                  rq.fair_min_vruntime - schd::fair::SLEEPER_CREDIT_NS);
+            ttest(&rq.fair_list.front() == &sleeper.fair_entity);
+
+            action("出队后再入队到 min_vruntime 更大的队列");
+            tassert(scheduler.dequeue(util::nnullforce(&rq),
+                                      util::nnullforce(&fresh)).has_value(),
+                    "新线程出队成功");
+            ttest(fresh.fair_entity.relative);
+            rq.fair_min_vruntime += 50'000'000;
+            tassert(scheduler.enqueue(util::nnullforce(&rq),
+                                      util::nnullforce(&fresh)).has_value(),
+                    "新线程重新入队成功");
+            expect("迁移保留相对于 min_vruntime 的位置");
+            ttest(!fresh.fair_entity.relative);
+            ttest(fresh.fair_entity.vruntime == rq.fair_min_vruntime);
+        }
+    };
+
+    /**
+     * @brief 一个交互线程 (运行 1ms, 睡眠 20ms) 与若干计算线程共享 CPU.
+     *
+     * RR 下交互线程醒来要排在所有计算线程之后,
+     * 最坏等待 计算线程数 x TIME_SLICES 个 tick;
+     * FAIR 下它凭睡眠补偿立即抢占, 计算线程之间仍平分 CPU.
+     */
+    class CaseWakeupLatency : public TestCase {
+    public:
+        CaseWakeupLatency() : TestCase("FAIR 唤醒延迟模拟") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr uint64_t STEP_NS   = 1'000'000;
+            constexpr size_t TICK_STEPS  = 10;
+            constexpr size_t RUN_STEPS   = 1;
+            constexpr size_t SLEEP_STEPS = 20;
+            constexpr size_t TOTAL_STEPS = 3000;
+            constexpr size_t HOGS        = 3;
+
+            Fair scheduler;
+            schd::RQ rq{};
+            auto rq_ptr = util::nnullforce(&rq);
+            TestThread hogs[HOGS]{};
+            TestThread interactive{};
+
+            for (auto& hog : hogs) {
+                tassert(scheduler.enqueue(rq_ptr, util::nnullforce(&hog)).has_value(),
+                        "计算线程入队成功");
+            }
+            tassert(scheduler.enqueue(rq_ptr, util::nnullforce(&interactive))
+                        .has_value(),
+                    "交互线程入队成功");
+            TestThread* curr = scheduler.pick_next(rq_ptr).value().get();
+
+            bool sleeping      = false;
+            size_t wake_at     = 0;
+            size_t woke_step   = 0;
+            bool waiting       = false;
+            size_t ran_steps   = 0;
+            size_t bursts      = 0;
+            size_t max_latency = 0;
+
+            action("模拟 3000ms 的运行");
+            for (size_t step = 0; step < TOTAL_STEPS; ++step) {
+                if (sleeping && step == wake_at) {
+                    sleeping  = false;
+                    waiting   = true;
+                    woke_step = step;
+                    tassert(scheduler.enqueue(rq_ptr, util::nnullforce(&interactive))
+                                .has_value(),
+                            "交互线程唤醒入队成功");
+                    if (scheduler.check_preempt_curr(rq_ptr,
+                                                     util::nnullforce(&interactive)))
+                    {
+                        curr->basic_entity.flags |= schd::SchedMeta::FLAGS_NEED_RESCHED;
+                    }
+                }
+
+                if (need_resched(*curr)) {
+                    curr->basic_entity.flags &= ~schd::SchedMeta::FLAGS_NEED_RESCHED;
+                    tassert(scheduler.put_prev(rq_ptr, util::nnullforce(curr))
+                                .has_value(),
+                            "换下线程成功");
+                    curr = scheduler.pick_next(rq_ptr).value().get();
+                }
+
+                if (curr == &interactive && waiting) {
+                    waiting = false;
+                    if (step - woke_step > max_latency) {
+                        max_latency = step - woke_step;
+                    }
+                }
+
+                tassert(scheduler.account(rq_ptr, util::nnullforce(curr), STEP_NS)
+                            .has_value(),
+                        "记账成功");
+
+                if (curr == &interactive) {
+                    if (++ran_steps == RUN_STEPS) {
+                        // 主动睡眠: 不放回就绪队列
+                        ran_steps = 0;
+                        bursts++;
+                        sleeping = true;
+                        wake_at  = step + 1 + SLEEP_STEPS;
+                        interactive.basic_entity.state =
+                            ThreadState::INTERRUPTIBLE_WAITING;
+                        curr = scheduler.pick_next(rq_ptr).value().get();
+                    }
+                } else if ((step + 1) % TICK_STEPS == 0) {
+                    tassert(scheduler.on_tick(rq_ptr, util::nnullforce(curr))
+                                .has_value(),
+                            "on_tick 成功");
+                }
+            }
+
+            expect("交互线程每次醒来都能在唤醒粒度内运行");
+            ttest(max_latency * STEP_NS <= schd::fair::WAKEUP_GRANULARITY_NS);
+            ttest(bursts >= TOTAL_STEPS / (RUN_STEPS + SLEEP_STEPS + 1));
+
+            expect("计算线程之间的 CPU 时间相差不超过一个调度周期");
+            uint64_t min_exec = hogs[0].fair_entity.sum_exec;
+            uint64_t max_exec = hogs[0].fair_entity.sum_exec;
+            for (auto& hog : hogs) {
+                if (hog.fair_entity.sum_exec < min_exec) {
+                    min_exec = hog.fair_entity.sum_exec;
+                }
+                if (hog.fair_entity.sum_exec > max_exec) {
+                    max_exec = hog.fair_entity.sum_exec;
+                }
+            }
+            ttest(max_exec - min_exec <= schd::fair::SCHED_LATENCY_NS);
+        }
+    };
+
+    void collect_tests(TestFramework& framework) {
+        auto cases = util::ArrayList<TestCase*>();
+        cases.push_back(new CaseClassRank());
+        cases.push_back(new CaseNiceWeight());
+        cases.push_back(new CaseSleeperCredit());
+        cases.push_back(new CaseWakeupLatency());
+        framework.add_category(new TestCategory("schd.fair", std::move(cases)));
+    }
+
+}  // namespace test::schd_test::fair
@@ -0,0 +1,13 @@
+/**
+ * @file fair.h
+ * @author
+ * @brief FAIR 调度器测试
+ */
+
+#pragma once
+
+#include <test/framework.h>
+
+namespace test::schd_test::fair {
+    void collect_tests(TestFramework& framework);
+}
@@ -1 +1 @@
-sources += fcfs.cpp rr.cpp
+sources += fcfs.cpp rr.cpp fair.cpp
@@ -9,10 +9,14 @@
  *
  */
 
+#include <driver/clock.h>
+#include <env.h>
 #include <mem/alloc.h>
 #include <sus/list.h>
 #include <test/slub.h>
 
+#include <cstring>
+
 namespace test::slub {
 
     struct SlubSmallObj {
@@ -183,7 +187,7 @@ namespace test::slub {
             for (int round = 0; round < kRounds; ++round) {
                 for (int i = 0; i < kSizeCount; ++i) {
                     ptrs[round][i] =
-                        Allocator::INSTANCE().get()->malloc(kSizes[i]);
+                        Allocator::INSTANCE().malloc(kSizes[i]);
                     if (ptrs[round][i] == nullptr) {
                         test(false, "Allocator 分配失败");
                         break;
@@ -195,7 +199,7 @@ namespace test::slub {
             for (int round = 0; round < kRounds; round += 2) {
                 for (int i = 0; i < kSizeCount; ++i) {
                     if (ptrs[round][i] != nullptr) {
-                        Allocator::INSTANCE().get()->free(ptrs[round][i]);
+                        Allocator::INSTANCE().free(ptrs[round][i]);
                         ptrs[round][i] = nullptr;
                     }
                 }
@@ -205,7 +209,7 @@ namespace test::slub {
             for (int round = 0; round < kRounds; round += 2) {
                 for (int i = 0; i < kSizeCount; ++i) {
                     ptrs[round][i] =
-                        Allocator::INSTANCE().get()->malloc(kSizes[i]);
+                        Allocator::INSTANCE().malloc(kSizes[i]);
                     if (ptrs[round][i] == nullptr) {
                         test(false, "Allocator 复用分配失败");
                         break;
@@ -217,7 +221,7 @@ namespace test::slub {
             for (int round = 0; round < kRounds; ++round) {
                 for (int i = 0; i < kSizeCount; ++i) {
                     if (ptrs[round][i] != nullptr) {
-                        Allocator::INSTANCE().get()->free(ptrs[round][i]);
+                        Allocator::INSTANCE().free(ptrs[round][i]);
                         ptrs[round][i] = nullptr;
                     }
                 }
@@ -227,6 +231,304 @@ namespace test::slub {
         }
     };
 
+    class CaseKfreeSizeRecovery : public TestCase {
+    public:
+        CaseKfreeSizeRecovery() : TestCase("SLUB kfree 尺寸反查测试") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kSizes[] = {1, 24, 100, 500, 1500, 3000, 9000};
+            constexpr int kSizeCount  = sizeof(kSizes) / sizeof(kSizes[0]);
+            // 不超过该值的请求走 slab 路径, 其余走页对齐的大对象路径
+            constexpr size_t kSlabLimit = 1536;
+            void* ptrs[kSizeCount]      = {};
+
+            expect("分配不同尺寸对象, 小对象尺寸可由 SlabHeader 反查");
+            for (int i = 0; i < kSizeCount; ++i) {
+                ptrs[i] = Allocator::INSTANCE().malloc(kSizes[i]);
+                tassert(ptrs[i] != nullptr, "Allocator 分配失败");
+                memset(ptrs[i], 0x5a, kSizes[i]);
+                auto addr = reinterpret_cast<uintptr_t>(ptrs[i]);
+                if (kSizes[i] <= kSlabLimit) {
+                    ttest(addr % PAGESIZE != 0);
+                    ttest(::slub::slab_header_of(ptrs[i])->obj_size >=
+                          kSizes[i]);
+                } else {
+                    ttest(addr % PAGESIZE == 0);
+                }
+            }
+
+            action("释放后以相同尺寸重新分配, 应回到同一尺寸类");
+            for (int i = 0; i < kSizeCount; ++i) {
+                Allocator::INSTANCE().free(ptrs[i]);
+                void* again = Allocator::INSTANCE().malloc(kSizes[i]);
+                tassert(again != nullptr, "Allocator 复用分配失败");
+                if (kSizes[i] <= kSlabLimit) {
+                    ttest(again == ptrs[i]);
+                }
+                ptrs[i] = again;
+            }
+
+            action("释放 nullptr 不应产生影响");
+            Allocator::INSTANCE().free(nullptr);
+
+            for (int i = 0; i < kSizeCount; ++i) {
+                Allocator::INSTANCE().free(ptrs[i]);
+            }
+        }
+    };
+
+    class CaseKmallocSizeClasses : public TestCase {
+    public:
+        CaseKmallocSizeClasses() : TestCase("SLUB 非 2 的幂尺寸类与整页分配") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            struct Expect {
+                size_t request;
+                size_t obj_size;
+            };
+            constexpr Expect kExpects[] = {
+                {80, 96},    {96, 96},    {150, 192},  {300, 384},
+                {600, 768},  {1000, 1024}, {1500, 1536},
+            };
+
+            expect("请求应落入不小于请求的最小尺寸类");
+            for (const auto& e : kExpects) {
+                void* p = Allocator::INSTANCE().malloc(e.request);
+                tassert(p != nullptr, "Allocator 分配失败");
+                ttest(::slub::slab_header_of(p)->obj_size == e.obj_size);
+                Allocator::INSTANCE().free(p);
+            }
+
+            expect("尺寸类碎片统计只计在用对象, 释放后回落");
+            size_t cls = 0;
+            while (::slub::KMALLOC_SIZES[cls] != 192) {
+                cls++;
+            }
+            auto idle   = Allocator::INSTANCE().get_stats().classes[cls];
+            void* small = Allocator::INSTANCE().malloc(150);
+            tassert(small != nullptr, "Allocator 分配失败");
+            auto live = Allocator::INSTANCE().get_stats().classes[cls];
+            ttest(live.allocs - idle.allocs == 1);
+            ttest(live.requested_bytes - idle.requested_bytes == 150);
+            Allocator::INSTANCE().free(small);
+            auto freed = Allocator::INSTANCE().get_stats().classes[cls];
+            ttest(freed.allocs == idle.allocs);
+            ttest(freed.requested_bytes == idle.requested_bytes);
+
+            expect("9 页的大对象只占用 9 页而非 16 页");
+            auto before = Allocator::INSTANCE().get_stats();
+            void* big   = Allocator::INSTANCE().malloc(9 * PAGESIZE);
+            tassert(big != nullptr, "大对象分配失败");
+            auto after = Allocator::INSTANCE().get_stats();
+            ttest(after.large_pages - before.large_pages == 9);
+            ttest(after.large_allocs - before.large_allocs == 1);
+
+            action("释放大对象, 统计应回到原值");
+            Allocator::INSTANCE().free(big);
+            auto released = Allocator::INSTANCE().get_stats();
+            ttest(released.large_pages == before.large_pages);
+        }
+    };
+
+    [[nodiscard]]
+    int64_t bench_now_ns() {
+        auto* time_keeper =
+            ::env::hart_ctx != nullptr ? ::env::hart_ctx->time_keeper() : nullptr;
+        if (time_keeper == nullptr || time_keeper->source() == nullptr) {
+            return 0;
+        }
+        auto* source = time_keeper->source();
+        return source->to_ns(source->now()).to_nanoseconds();
+    }
+
+    /**
+     * @brief 在保持 live_count 个存活对象的前提下, 测量 malloc/free 的平均耗时.
+     *
+     * 旧实现的 free 需要线性扫描全部分配记录, 耗时随存活对象数增长;
+     * 基于 SlabHeader 反查后两组数据应处于同一量级.
+     */
+    [[nodiscard]]
+    int64_t bench_malloc_free(size_t live_count, size_t iterations) {
+        auto** live = new void*[live_count];
+        for (size_t i = 0; i < live_count; ++i) {
+            live[i] = Allocator::INSTANCE().malloc(48);
+        }
+
+        int64_t begin = bench_now_ns();
+        for (size_t i = 0; i < iterations; ++i) {
+            void* p = Allocator::INSTANCE().malloc(48);
+            Allocator::INSTANCE().free(p);
+        }
+        int64_t end = bench_now_ns();
+
+        for (size_t i = 0; i < live_count; ++i) {
+            Allocator::INSTANCE().free(live[i]);
+        }
+        delete[] live;
+        return (end - begin) / static_cast<int64_t>(iterations);
+    }
+
+    class CaseKfreeBench : public TestCase {
+    public:
+        CaseKfreeBench() : TestCase("SLUB kmalloc/kfree 微基准") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kIterations = 4096;
+            constexpr size_t kFewLive    = 16;
+            constexpr size_t kManyLive   = 8192;
+
+            action("分别在少量与大量存活对象下测量 malloc/free 耗时");
+            int64_t few_ns  = bench_malloc_free(kFewLive, kIterations);
+            int64_t many_ns = bench_malloc_free(kManyLive, kIterations);
+            kprintfln("    kmalloc/kfree(48B): live=%lu %ld ns/op, live=%lu %ld ns/op",
+                      static_cast<unsigned long>(kFewLive),
+                      static_cast<long>(few_ns),
+                      static_cast<unsigned long>(kManyLive),
+                      static_cast<long>(many_ns));
+            ttest(few_ns >= 0 && many_ns >= 0);
+        }
+    };
+
+    class CaseMagazineCache : public TestCase {
+    public:
+        CaseMagazineCache() : TestCase("SLUB per-hart 弹匣缓存") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kCount = ::slub::MAGAZINE_SIZE * 3;
+            auto* cache = new ::slub::SlubCache<SlubSmallObj>();
+            tassert(cache != nullptr, "SlubCache 分配失败");
+
+            expect("释放后立即分配应命中弹匣顶部的同一对象");
+            SlubSmallObj* p1 = cache->alloc();
+            tassert(p1 != nullptr);
+            cache->free(p1);
+            SlubSmallObj* p2 = cache->alloc();
+            ttest(p2 == p1);
+            cache->free(p2);
+
+            action("分配并释放多倍弹匣容量的对象");
+            SlubSmallObj* objs[kCount] = {nullptr};
+            for (size_t i = 0; i < kCount; i++) {
+                objs[i] = cache->alloc();
+                tassert(objs[i] != nullptr, "分配失败");
+            }
+            for (size_t i = 0; i < kCount; i++) {
+                cache->free(objs[i]);
+            }
+
+            check("弹匣容量有上限, 其余对象已成批归还 slab");
+            auto stats = cache->get_stats();
+            ttest(stats.objects_inuse == 0);
+            ttest(stats.objects_cached > 0);
+            ttest(stats.objects_cached <= ::slub::MAGAZINE_SIZE);
+
+            check("drain 后弹匣为空");
+            cache->drain();
+            stats = cache->get_stats();
+            ttest(stats.objects_cached == 0);
+            ttest(stats.objects_inuse == 0);
+
+            delete cache;
+        }
+    };
+
+    class CaseEmptySlabRelease : public TestCase {
+    public:
+        CaseEmptySlabRelease() : TestCase("SLUB 空 slab 归还与具名缓存登记") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kSlabs = ::slub::EMPTY_SLAB_LIMIT + 3;
+            auto* slub = new ::slub::Slub<SlubSmallObj>();
+            tassert(slub != nullptr, "Slub 分配失败");
+
+            action("分配占满多个 slab 的对象后全部释放");
+            SlubSmallObj* first = slub->alloc();
+            tassert(first != nullptr);
+            size_t per_slab = slub->get_stats().objects_per_slab;
+            size_t count    = per_slab * kSlabs;
+            auto** objs     = new SlubSmallObj*[count];
+            tassert(objs != nullptr, "指针数组分配失败");
+            objs[0] = first;
+            for (size_t i = 1; i < count; i++) {
+                objs[i] = slub->alloc();
+                tassert(objs[i] != nullptr, "分配失败");
+            }
+            ttest(slub->get_stats().full_slabs == kSlabs);
+            for (size_t i = 0; i < count; i++) {
+                slub->free(objs[i]);
+            }
+            delete[] objs;
+
+            check("超出上限的空 slab 已归还 GFP");
+            auto stats = slub->get_stats();
+            ttest(stats.empty_slabs == ::slub::EMPTY_SLAB_LIMIT);
+            ttest(stats.released_slabs == kSlabs - ::slub::EMPTY_SLAB_LIMIT);
+            ttest(stats.partial_slabs == 0 && stats.full_slabs == 0);
+
+            check("shrink 归还剩余的空 slab");
+            ttest(slub->shrink() == ::slub::EMPTY_SLAB_LIMIT);
+            ttest(slub->get_stats().total_slabs == 0);
+            delete slub;
+
+            check("具名缓存出现在快照中, 析构后移除");
+            auto has_cache = [](const char* name) {
+                for (const auto& info : ::slub::cache_snapshot()) {
+                    if (strcmp(info.name, name) == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            auto* cache = new ::slub::SlubCache<SlubSmallObj>("test_slab");
+            tassert(cache != nullptr, "SlubCache 分配失败");
+            ttest(has_cache("test_slab"));
+            delete cache;
+            ttest(!has_cache("test_slab"));
+        }
+    };
+
+    [[nodiscard]]
+    int64_t bench_locked_slub(size_t iterations) {
+        auto* raw    = new ::slub::Slub<SlubSmallObj>();
+        auto* locked = new LockedObject<IrqSaveGuardedLock,
+                                        ::slub::Slub<SlubSmallObj>>(raw);
+        int64_t begin = bench_now_ns();
+        for (size_t i = 0; i < iterations; ++i) {
+            SlubSmallObj* p = locked->get()->alloc();
+            locked->get()->free(p);
+        }
+        int64_t end = bench_now_ns();
+        delete locked;
+        delete raw;
+        return (end - begin) / static_cast<int64_t>(iterations);
+    }
+
+    [[nodiscard]]
+    int64_t bench_magazine_slub(size_t iterations) {
+        auto* cache   = new ::slub::SlubCache<SlubSmallObj>();
+        int64_t begin = bench_now_ns();
+        for (size_t i = 0; i < iterations; ++i) {
+            SlubSmallObj* p = cache->alloc();
+            cache->free(p);
+        }
+        int64_t end = bench_now_ns();
+        cache->drain();
+        delete cache;
+        return (end - begin) / static_cast<int64_t>(iterations);
+    }
+
+    class CaseMagazineBench : public TestCase {
+    public:
+        CaseMagazineBench() : TestCase("SLUB 弹匣快路径微基准") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kIterations = 4096;
+
+            action("对比加锁 Slub 与 per-hart 弹匣的 alloc/free 耗时");
+            int64_t locked_ns   = bench_locked_slub(kIterations);
+            int64_t magazine_ns = bench_magazine_slub(kIterations);
+            kprintfln("    alloc/free(%luB): locked %ld ns/op, magazine %ld ns/op",
+                      static_cast<unsigned long>(sizeof(SlubSmallObj)),
+                      static_cast<long>(locked_ns),
+                      static_cast<long>(magazine_ns));
+            ttest(locked_ns >= 0 && magazine_ns >= 0);
+        }
+    };
+
     void collect_tests(TestFramework& framework) {
         auto cases = util::ArrayList<TestCase*>();
         cases.push_back(new CaseSmallObjAlloc());
@@ -235,6 +537,12 @@ namespace test::slub {
         cases.push_back(new CaseMultiSlab());
         cases.push_back(new CaseStressFreelist());
         cases.push_back(new CaseMixedAllocatorRecords());
+        cases.push_back(new CaseKfreeSizeRecovery());
+        cases.push_back(new CaseKmallocSizeClasses());
+        cases.push_back(new CaseKfreeBench());
+        cases.push_back(new CaseMagazineCache());
+        cases.push_back(new CaseEmptySlabRelease());
+        cases.push_back(new CaseMagazineBench());
 
         framework.add_category(new TestCategory("slub", std::move(cases)));
     }
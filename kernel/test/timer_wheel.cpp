@@ -0,0 +1,221 @@
+/**
+ * @file timer_wheel.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 分层时间轮测试
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <test/timer_wheel.h>
+
+#include <driver/clock.h>
+
+namespace test::timer_wheel {
+    using driver::ExpireAction;
+    using driver::ExpireHandle;
+    using driver::MAX_DUE_ACTIONS;
+    using driver::PopDueResult;
+    using driver::TimerWheel;
+
+    uint64_t lcg(uint64_t& state) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    ExpireAction make_action(size_t expire_ns, size_t tag) {
+        return ExpireAction{
+            .expireTime   = expire_ns,
+            .expireAction = 0,
+            .expireArg0   = tag,
+            .expireArg1   = 0,
+        };
+    }
+
+    class CaseCoalesce : public TestCase {
+    public:
+        CaseCoalesce() : TestCase("同一 slack 内的动作合并为一次到期") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            auto* wheel = new TimerWheel(50'000);
+            tassert(wheel != nullptr, "分配时间轮成功");
+            tassert(wheel->reserve(MAX_DUE_ACTIONS).has_value(), "预留节点");
+
+            action("在 (1ms, 1.05ms] 内插入 8 个动作");
+            for (size_t i = 0; i < MAX_DUE_ACTIONS; i++) {
+                tassert(wheel->push(make_action(1'000'001 + i * 5'000, i))
+                            .has_value(),
+                        "插入成功");
+            }
+
+            expect("下一次到期取整到 1.05ms, 一次弹出全部动作");
+            auto next = wheel->next_expiry();
+            tassert(next.has_value(), "时间轮非空");
+            ttest(*next == 1'050'000);
+            ttest(wheel->pop_due(*next - 1).count == 0);
+            PopDueResult result = wheel->pop_due(*next);
+            ttest(result.count == MAX_DUE_ACTIONS);
+            ttest(wheel->empty());
+            ttest(!wheel->next_expiry().has_value());
+
+            delete wheel;
+        }
+    };
+
+    class CaseHandleReuse : public TestCase {
+    public:
+        CaseHandleReuse() : TestCase("取消与句柄复用") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            auto* wheel = new TimerWheel(1);
+            tassert(wheel != nullptr, "分配时间轮成功");
+            tassert(wheel->reserve(1).has_value(), "预留节点");
+
+            auto first = wheel->push(make_action(1'000, 1));
+            tassert(first.has_value(), "插入成功");
+            ttest(wheel->cancel(first.value()));
+            ttest(!wheel->cancel(first.value()));
+            ttest(!wheel->cancel(ExpireHandle{}));
+
+            action("复用同一节点插入新动作");
+            auto second = wheel->push(make_action(2'000, 2));
+            tassert(second.has_value(), "插入成功");
+            ttest(second.value().slot == first.value().slot);
+            ttest(second.value().generation != first.value().generation);
+
+            expect("旧句柄不能取消新动作");
+            ttest(!wheel->cancel(first.value()));
+            ttest(wheel->size() == 1);
+
+            expect("已经过期的动作立即到期");
+            ttest(wheel->pop_due(5'000).count == 1);
+            tassert(wheel->push(make_action(3'000, 3)).has_value(), "插入成功");
+            ttest(wheel->next_expiry() == 5'000);
+            ttest(wheel->pop_due(5'000).count == 1);
+
+            delete wheel;
+        }
+    };
+
+    class CasePoolExhaustion : public TestCase {
+    public:
+        CasePoolExhaustion() : TestCase("节点池耗尽时 push 报错而不分配") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            auto* wheel = new TimerWheel(1);
+            tassert(wheel != nullptr, "分配时间轮成功");
+
+            expect("未预留节点时 push 失败");
+            auto empty = wheel->push(make_action(1'000, 0));
+            ttest(!empty.has_value() &&
+                  empty.error() == ErrCode::OUT_OF_MEMORY);
+            ttest(wheel->low_on_nodes());
+
+            action("预留一块节点后填满");
+            tassert(wheel->reserve(1).has_value(), "预留节点");
+            ttest(!wheel->low_on_nodes());
+            for (size_t i = 0; i < TimerWheel::CHUNK_NODES; i++) {
+                tassert(wheel->push(make_action(1'000 + i, i)).has_value(),
+                        "插入成功");
+            }
+
+            expect("空闲节点耗尽后 push 报错, 弹出后节点可复用");
+            auto full = wheel->push(make_action(9'000, 0));
+            ttest(!full.has_value() && full.error() == ErrCode::OUT_OF_MEMORY);
+            ttest(wheel->pop_due(1'000).count == 1);
+            ttest(wheel->push(make_action(9'000, 0)).has_value());
+
+            delete wheel;
+        }
+    };
+
+    /**
+     * @brief 上千个定时器随机插入、取消, 时间随机推进.
+     *
+     * 检查不提前触发、被取消的不触发、其余全部触发恰好一次,
+     * 以及每次弹完后下一次到期时间都在当前时间之后.
+     */
+    class CaseStress : public TestCase {
+    public:
+        CaseStress() : TestCase("数千个并发定时器") {}
+
+        static constexpr size_t TIMERS = 4096;
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            run_round(1, 50'000, 10'000'000'000'000ull, 10'000'000'000ull);
+            run_round(2, 1, 1'000'000'000ull, 1'000'000ull);
+            run_round(3, 1'000'000, 1'000'000'000ull, 1'000'000ull);
+        }
+
+        void run_round(uint64_t seed, size_t slack_ns, uint64_t horizon,
+                       uint64_t step) const noexcept {
+            auto* wheel     = new TimerWheel(slack_ns);
+            auto* handles   = new ExpireHandle[TIMERS];
+            auto* cancelled = new bool[TIMERS]{};
+            auto* fired     = new bool[TIMERS]{};
+            tassert(wheel != nullptr && handles != nullptr &&
+                        cancelled != nullptr && fired != nullptr,
+                    "分配测试数据成功");
+            tassert(wheel->reserve(TIMERS).has_value(), "预留节点");
+
+            action("插入随机到期时间的定时器, 取消其中三分之一");
+            uint64_t state = seed;
+            size_t now     = 0;
+            for (size_t i = 0; i < TIMERS; i++) {
+                auto handle = wheel->push(make_action(lcg(state) % horizon, i));
+                tassert(handle.has_value(), "插入成功");
+                handles[i] = handle.value();
+            }
+            size_t expected = TIMERS;
+            for (size_t i = 0; i < TIMERS; i += 3) {
+                ttest(wheel->cancel(handles[i]));
+                ttest(!wheel->cancel(handles[i]));
+                cancelled[i] = true;
+                expected--;
+            }
+            ttest(wheel->size() == expected);
+
+            action("随机推进时间并弹出到期动作");
+            size_t popped = 0;
+            while (!wheel->empty()) {
+                now += lcg(state) % step;
+                while (true) {
+                    PopDueResult result = wheel->pop_due(now);
+                    for (size_t i = 0; i < result.count; i++) {
+                        size_t tag = result.entries[i].expireArg0;
+                        ttest(result.entries[i].expireTime <= now);
+                        ttest(!cancelled[tag]);
+                        ttest(!fired[tag]);
+                        fired[tag] = true;
+                        popped++;
+                    }
+                    if (result.count < MAX_DUE_ACTIONS) {
+                        break;
+                    }
+                }
+                auto next = wheel->next_expiry();
+                ttest(!next.has_value() || *next > now);
+            }
+
+            expect("未取消的定时器全部触发");
+            ttest(popped == expected);
+
+            delete[] fired;
+            delete[] cancelled;
+            delete[] handles;
+            delete wheel;
+        }
+    };
+
+    void collect_tests(TestFramework& framework) {
+        auto cases = util::ArrayList<TestCase*>();
+        cases.push_back(new CaseCoalesce());
+        cases.push_back(new CaseHandleReuse());
+        cases.push_back(new CasePoolExhaustion());
+        cases.push_back(new CaseStress());
+
+        framework.add_category(new TestCategory("timer_wheel", std::move(cases)));
+    }
+}  // namespace test::timer_wheel
@@ -0,0 +1,18 @@
+/**
+ * @file timer_wheel.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 分层时间轮测试头文件
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <test/framework.h>
+
+namespace test::timer_wheel {
+    void collect_tests(TestFramework& framework);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file vma.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief VMA 地址索引测试
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/vma.h>
+#include <mem/vma_tree.h>
+#include <test/vma.h>
+
+namespace test::vma {
+    namespace {
+        constexpr size_t kCount = 16;
+
+        /**
+         * @brief 第 i 个 VMA 占据 [base + 4i 页, base + 4i 页 + 2 页).
+         */
+        VirArea area_of(size_t i) {
+            VirAddr base = VirAddr(0x10000000) + i * 4 * PAGESIZE;
+            return VirArea(base, base + 2 * PAGESIZE);
+        }
+    }  // namespace
+
+    class CaseOrderAndFloor : public TestCase {
+    public:
+        CaseOrderAndFloor() : TestCase("乱序插入后有序遍历与 floor 查询") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            VMA vmas[kCount];
+            VMATree tree;
+            // 以步长 5 打乱插入顺序
+            for (size_t k = 0; k < kCount; ++k) {
+                size_t i       = (k * 5) % kCount;
+                vmas[i].varea = area_of(i);
+                tree.insert(vmas[i]);
+            }
+
+            expect("中序遍历按起点升序");
+            size_t visited = 0;
+            for (VMA* vma = tree.first(); vma != nullptr; vma = VMATree::next(vma)) {
+                ttest(vma == &vmas[visited]);
+                visited++;
+            }
+            ttest(visited == kCount);
+
+            expect("floor 返回起点不大于地址的最后一个 VMA");
+            ttest(tree.floor(area_of(0).begin - 1) == nullptr);
+            ttest(tree.floor(area_of(3).begin) == &vmas[3]);
+            ttest(tree.floor(area_of(3).begin + 3 * PAGESIZE) == &vmas[3]);
+            ttest(VMATree::prev(&vmas[3]) == &vmas[2]);
+
+            expect("删除后仍保持有序");
+            tree.erase(vmas[3]);
+            tree.erase(vmas[0]);
+            ttest(tree.floor(area_of(3).begin) == &vmas[2]);
+            ttest(tree.first() == &vmas[1]);
+        }
+    };
+
+    class CaseGapSearch : public TestCase {
+    public:
+        CaseGapSearch() : TestCase("空洞统计与空闲区间查找") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            VMA vmas[kCount];
+            VMATree tree;
+            for (size_t i = 0; i < kCount; ++i) {
+                vmas[i].varea = area_of(i);
+                tree.insert(vmas[i]);
+            }
+
+            expect("相邻 VMA 之间各有 2 页空洞");
+            ttest(tree.max_gap() == 2 * PAGESIZE);
+            VirArea window(area_of(0).begin, area_of(kCount - 1).end);
+            auto small = tree.find_gap(window, 2 * PAGESIZE);
+            ttest(small.has_value() && small.value() == area_of(0).end);
+            auto large = tree.find_gap(window, 3 * PAGESIZE);
+            ttest(!large.has_value() &&
+                  large.error() == ErrCode::OUT_OF_MEMORY);
+
+            expect("删除 VMA 后合并出更大的空洞");
+            tree.erase(vmas[5]);
+            ttest(tree.max_gap() == 6 * PAGESIZE);
+            large = tree.find_gap(window, 5 * PAGESIZE);
+            ttest(large.has_value() && large.value() == area_of(4).end);
+
+            expect("原地收缩后更新增强信息");
+            vmas[9].varea.end = vmas[9].varea.begin + PAGESIZE;
+            tree.refresh(vmas[9]);
+            auto shrunk = tree.find_gap(
+                VirArea(area_of(8).begin, area_of(kCount - 1).end),
+                3 * PAGESIZE);
+            ttest(shrunk.has_value() &&
+                  shrunk.value() == vmas[9].varea.end);
+        }
+    };
+
+    void collect_tests(TestFramework& framework) {
+        auto cases = util::ArrayList<TestCase*>();
+        cases.push_back(new CaseOrderAndFloor());
+        cases.push_back(new CaseGapSearch());
+
+        framework.add_category(new TestCategory("vma", std::move(cases)));
+    }
+}  // namespace test::vma
@@ -10,6 +10,13 @@
  */
 
 #include <logger.h>
+#include <mem/alloc.h>
+#include <mem/buddy.h>
+#include <mem/compaction.h>
+#include <mem/gfp.h>
+#include <mem/reclaim.h>
+#include <mem/vma.h>
+#include <mem/zram.h>
 #include <object/perm.h>
 #include <task/scheduler.h>
 #include <task/task.h>
@@ -249,6 +256,238 @@ namespace procfs {
         return nullptr;
     }
 
+    /**
+     * @brief slab 中未被在用对象占据的字节数, 含空 slab、空闲槽位与对齐填充.
+     */
+    [[nodiscard]]
+    size_t slab_waste_bytes(const ::slub::SlubStats &slab) {
+        size_t used = slab.objects_inuse * slab.object_size;
+        return slab.memory_usage_bytes > used ? slab.memory_usage_bytes - used
+                                              : 0;
+    }
+
+    /**
+     * @brief 追加一行 slabinfo 的公共部分: 对象统计、各状态 slab 数与浪费字节数.
+     */
+    void append_slab_line(std::string &out, const char *name,
+                          const ::slub::SlubStats &slab) {
+        char line[192]{};
+        int len = snprintf(
+            line, sizeof(line),
+            "%-16s %13lu %10lu %9lu %12lu %15lu : slabdata %11lu %7lu %9lu "
+            "%6lu : waste %9lu",
+            name, static_cast<unsigned long>(slab.objects_inuse),
+            static_cast<unsigned long>(slab.objects_total),
+            static_cast<unsigned long>(slab.object_size),
+            static_cast<unsigned long>(slab.objects_per_slab),
+            static_cast<unsigned long>(::slub::PAGES_PER_SLAB),
+            static_cast<unsigned long>(slab.total_slabs),
+            static_cast<unsigned long>(slab.empty_slabs),
+            static_cast<unsigned long>(slab.partial_slabs),
+            static_cast<unsigned long>(slab.full_slabs),
+            static_cast<unsigned long>(slab_waste_bytes(slab)));
+        if (len > 0) {
+            out.append(line, static_cast<size_t>(len));
+        }
+    }
+
+    /**
+     * @brief 生成 `/proc/slabinfo`.
+     *
+     * 除 Linux 风格的对象/slab 统计外, 额外给出各状态的 slab 数与浪费字节数;
+     * kmalloc 尺寸类另有在用对象数、其平均请求大小与内部碎片率 (千分比),
+     * 三者都随释放回落, 反映的是当前而非历史累计的碎片.
+     * 具名 KOP 缓存列在 kmalloc 之后, 最后是整页大对象路径的浪费字节数.
+     */
+    [[nodiscard]]
+    std::string render_slabinfo() {
+        auto stats = Allocator::INSTANCE().get_stats();
+        std::string out =
+            "slabinfo - version: 2.1\n"
+            "# name            <active_objs> <num_objs> <objsize> "
+            "<objperslab> <pagesperslab> : slabdata <num_slabs> <empty> "
+            "<partial> <full> : waste <bytes> "
+            ": frag <active_allocs> <avg_request> <waste_permille>\n";
+        char name[24]{};
+        char line[192]{};
+        for (const auto &cls : stats.classes) {
+            size_t avg_request = cls.allocs == 0
+                                     ? 0
+                                     : cls.requested_bytes / cls.allocs;
+            size_t waste_permille =
+                cls.allocs == 0
+                    ? 0
+                    : 1000 - cls.requested_bytes * 1000 /
+                                 (cls.allocs * cls.obj_size);
+            snprintf(name, sizeof(name), "kmalloc-%lu",
+                     static_cast<unsigned long>(cls.obj_size));
+            append_slab_line(out, name, cls.slab);
+            int len = snprintf(line, sizeof(line), " : frag %8lu %13lu %16lu\n",
+                               static_cast<unsigned long>(cls.allocs),
+                               static_cast<unsigned long>(avg_request),
+                               static_cast<unsigned long>(waste_permille));
+            if (len > 0) {
+                out.append(line, static_cast<size_t>(len));
+            }
+        }
+        for (const auto &cache : ::slub::cache_snapshot()) {
+            append_slab_line(out, cache.name, cache.stats);
+            out.push_back('\n');
+        }
+        size_t large_bytes = stats.large_pages * PAGESIZE;
+        int len            = snprintf(
+            line, sizeof(line),
+            "kmalloc-large: allocs=%lu pages=%lu requested=%lu waste=%lu\n",
+            static_cast<unsigned long>(stats.large_allocs),
+            static_cast<unsigned long>(stats.large_pages),
+            static_cast<unsigned long>(stats.large_requested_bytes),
+            static_cast<unsigned long>(large_bytes -
+                                       stats.large_requested_bytes));
+        if (len > 0) {
+            out.append(line, static_cast<size_t>(len));
+        }
+        return out;
+    }
+
+    /**
+     * @brief 生成 `/proc/buddyinfo`, 给出各阶空闲块数量.
+     */
+    [[nodiscard]]
+    std::string render_buddyinfo() {
+        auto stats      = BuddyAllocator::get_stats();
+        std::string out = "Node 0, zone   Normal ";
+        char cell[32]{};
+        for (size_t order = 0; order <= BuddyAllocator::MAX_BUDDY_ORDER;
+             order++)
+        {
+            int len = snprintf(
+                cell, sizeof(cell), " %6lu",
+                static_cast<unsigned long>(stats.free_blocks[order]));
+            if (len > 0) {
+                out.append(cell, static_cast<size_t>(len));
+            }
+        }
+        out.push_back('\n');
+        return out;
+    }
+
+    /**
+     * @brief 生成 `/proc/extfrag_index`, 给出各阶外部碎片指数.
+     *
+     * 格式与 Linux debugfs 的 extfrag_index 相同, -1.000 表示该阶分配可以满足.
+     */
+    [[nodiscard]]
+    std::string render_extfrag_index() {
+        auto stats      = BuddyAllocator::get_stats();
+        std::string out = "Node 0, zone   Normal ";
+        char cell[32]{};
+        for (size_t order = 0; order <= BuddyAllocator::MAX_BUDDY_ORDER;
+             order++)
+        {
+            int index = BuddyAllocator::fragmentation_index(stats, order);
+            int abs   = index < 0 ? -index : index;
+            int len   = snprintf(cell, sizeof(cell), " %s%d.%03d",
+                                 index < 0 ? "-" : "", abs / 1000, abs % 1000);
+            if (len > 0) {
+                out.append(cell, static_cast<size_t>(len));
+            }
+        }
+        out.push_back('\n');
+        return out;
+    }
+
+    /**
+     * @brief 生成 `/proc/vmstat`, 给出缺页、fault-around、ASID、换出、回收与整理计数.
+     *
+     * faultaround_pages 为预先映射的页数, 即至多可避免的缺页次数.
+     */
+    [[nodiscard]]
+    std::string render_vmstat() {
+        auto stats   = TaskMemoryManager::get_fault_stats();
+        auto zram    = ZRam::get_stats();
+        auto reclaim = Reclaim::get_stats();
+        auto compact = Compaction::get_stats();
+        size_t swapin_avg_ns =
+            zram.swap_ins == 0 ? 0 : zram.swapin_ns_total / zram.swap_ins;
+        char buf[1024]{};
+        int len = snprintf(buf, sizeof(buf),
+                           "pgfault %lu\n"
+                           "faultaround_window %lu\n"
+                           "faultaround_pages %lu\n"
+                           "asid_rollover %lu\n"
+                           "zram_stored_pages %lu\n"
+                           "zram_orig_bytes %lu\n"
+                           "zram_compr_bytes %lu\n"
+                           "zram_reject %lu\n"
+                           "pswpin %lu\n"
+                           "pswpout %lu\n"
+                           "swapin_avg_ns %lu\n"
+                           "swapin_max_ns %lu\n"
+                           "reclaim_low_wmark %lu\n"
+                           "reclaim_high_wmark %lu\n"
+                           "reclaim_background %lu\n"
+                           "reclaim_direct %lu\n"
+                           "reclaim_objects %lu\n"
+                           "compact_stall %lu\n"
+                           "compact_daemon_wake %lu\n"
+                           "compact_success %lu\n"
+                           "compact_fail %lu\n"
+                           "pgmigrate_success %lu\n",
+                           static_cast<unsigned long>(stats.faults),
+                           static_cast<unsigned long>(
+                               TaskMemoryManager::FAULT_AROUND_PAGES),
+                           static_cast<unsigned long>(stats.around_pages),
+                           static_cast<unsigned long>(
+                               AsidAllocator::rollovers()),
+                           static_cast<unsigned long>(zram.stored_pages),
+                           static_cast<unsigned long>(zram.stored_pages *
+                                                      PAGESIZE),
+                           static_cast<unsigned long>(zram.compr_bytes),
+                           static_cast<unsigned long>(zram.rejects),
+                           static_cast<unsigned long>(zram.swap_ins),
+                           static_cast<unsigned long>(zram.swap_outs),
+                           static_cast<unsigned long>(swapin_avg_ns),
+                           static_cast<unsigned long>(zram.swapin_ns_max),
+                           static_cast<unsigned long>(
+                               Reclaim::low_watermark()),
+                           static_cast<unsigned long>(
+                               Reclaim::high_watermark()),
+                           static_cast<unsigned long>(reclaim.background_runs),
+                           static_cast<unsigned long>(reclaim.direct_runs),
+                           static_cast<unsigned long>(reclaim.reclaimed),
+                           static_cast<unsigned long>(compact.direct_runs),
+                           static_cast<unsigned long>(compact.background_runs),
+                           static_cast<unsigned long>(compact.successes),
+                           static_cast<unsigned long>(
+                               compact.direct_runs + compact.background_runs -
+                               compact.successes),
+                           static_cast<unsigned long>(compact.pages_migrated));
+        if (len <= 0) {
+            return {};
+        }
+        return std::string(buf, static_cast<size_t>(len));
+    }
+
+    const ProcStatEntry PROC_STAT_ENTRIES[] = {
+        ProcStatEntry{.name = "slabinfo", .render = &render_slabinfo},
+        ProcStatEntry{.name = "buddyinfo", .render = &render_buddyinfo},
+        ProcStatEntry{.name = "extfrag_index", .render = &render_extfrag_index},
+        ProcStatEntry{.name = "vmstat", .render = &render_vmstat},
+    };
+    constexpr size_t PROC_STAT_ENTRIES_COUNT =
+        sizeof(PROC_STAT_ENTRIES) / sizeof(PROC_STAT_ENTRIES[0]);
+    // 根目录固定节点: 0 root, 1 self, 2 meminfo, 3 mounts, 其后为统计文件
+    constexpr inode_t PROC_STAT_INODE_BASE = 4;
+
+    const ProcStatEntry *lookup_stat_entry(std::string_view name) noexcept {
+        for (const auto &entry : PROC_STAT_ENTRIES) {
+            if (name == entry.name) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
     Result<void> initialize_proc_state(
         task::ProcState &state, const std::string &comm,
         const std::vector<std::string> &argv,
@@ -300,6 +539,9 @@ namespace procfs {
     MountsFile::MountsFile(ProcFSSuperblock &sb, ProcNode &node) noexcept
         : _sb(&sb), _node(&node) {}
 
+    ProcStatFile::ProcStatFile(ProcFSSuperblock &sb, ProcNode &node) noexcept
+        : _sb(&sb), _node(&node) {}
+
     Result<void> MeminfoFile::getattr(AttrSet &out) const {
         out.mode    = S_IFREG | 0444;
         out.uid     = 0;
@@ -522,7 +764,19 @@ namespace procfs {
                                        .entry    = nullptr,
                                        .metadata = {},
                                    });
-        _next_inode = 4;
+        for (size_t i = 0; i < PROC_STAT_ENTRIES_COUNT; i++) {
+            inode_t inode_id = PROC_STAT_INODE_BASE + i;
+            _nodes.insert_or_assign(inode_id,
+                                    ProcNode{
+                                        .inode_id = inode_id,
+                                        .kind     = NodeKind::STAT_FILE,
+                                        .pid      = 0,
+                                        .entry    = nullptr,
+                                        .stat     = &PROC_STAT_ENTRIES[i],
+                                        .metadata = {},
+                                    });
+        }
+        _next_inode = PROC_STAT_INODE_BASE + PROC_STAT_ENTRIES_COUNT;
     }
 
     Result<ProcNode *> ProcFSSuperblock::lookup_node(
@@ -613,6 +867,7 @@ namespace procfs {
             case NodeKind::MEMINFO_FILE:
             case NodeKind::MOUNTS_FILE:
             case NodeKind::PROC_FILE:
+            case NodeKind::STAT_FILE:
                 attrs.mode = S_IFREG | 0444;
                 break;
         }
@@ -638,7 +893,8 @@ namespace procfs {
 
     Result<size_t> ProcDirectoryNode::entry_count() {
         if (_node->kind == NodeKind::ROOT_DIR) {
-            return task::TaskManager::inst().snapshot_pids().size() + 3;
+            return task::TaskManager::inst().snapshot_pids().size() + 3 +
+                   PROC_STAT_ENTRIES_COUNT;
         }
         if (_node->kind == NodeKind::PID_DIR) {
             return PROC_STATE_ENTRIES_COUNT;
@@ -657,8 +913,12 @@ namespace procfs {
             if (index == 2) {
                 return DirectoryEntryInfo{.name = "mounts"};
             }
+            if (index < 3 + PROC_STAT_ENTRIES_COUNT) {
+                return DirectoryEntryInfo{
+                    .name = PROC_STAT_ENTRIES[index - 3].name};
+            }
             auto pids        = task::TaskManager::inst().snapshot_pids();
-            size_t pid_index = index - 3;
+            size_t pid_index = index - 3 - PROC_STAT_ENTRIES_COUNT;
             if (pid_index >= pids.size()) {
                 unexpect_return(ErrCode::OUT_OF_BOUNDARY);
             }
@@ -693,6 +953,10 @@ namespace procfs {
             if (name == "mounts") {
                 return inode_t(3);
             }
+            if (auto *stat = lookup_stat_entry(name); stat != nullptr) {
+                return PROC_STAT_INODE_BASE +
+                       static_cast<inode_t>(stat - PROC_STAT_ENTRIES);
+            }
             pid_t pid = 0;
             if (name.empty()) {
                 unexpect_return(ErrCode::ENTRY_NOT_FOUND);
@@ -769,6 +1033,13 @@ namespace procfs {
                 }
                 return util::owner<IINode *>(file);
             }
+            case NodeKind::STAT_FILE: {
+                auto *file = new ProcStatFile(*this, *node);
+                if (file == nullptr) {
+                    unexpect_return(ErrCode::OUT_OF_MEMORY);
+                }
+                return util::owner<IINode *>(file);
+            }
         }
         unexpect_return(ErrCode::INVALID_PARAM);
     }
@@ -881,6 +1152,10 @@ namespace procfs {
         auto pages_to_kb = [](size_t pages) -> size_t {
             return (pages * PAGESIZE) / 1024;
         };
+        // per-hart 空闲页链表与预清零页池中的页对 buddy 而言已分配,
+        // 但仍可立即使用
+        const size_t free_pages =
+            info.mem_free_pages + GFP::pcp_pages() + GFP::zero_pool_pages();
         constexpr size_t MEMINFO_BUF_SIZE = 4096;
         char *buf = new char[MEMINFO_BUF_SIZE];
         auto buf_guard = delete_guard(util::owner(buf));
@@ -931,9 +1206,9 @@ namespace procfs {
             "DirectMap2M: %10lu kB\n"
             "DirectMap1G: %10lu kB\n",
             static_cast<unsigned long>(pages_to_kb(info.mem_total_pages)),
-            static_cast<unsigned long>(pages_to_kb(info.mem_free_pages)),
+            static_cast<unsigned long>(pages_to_kb(free_pages)),
             static_cast<unsigned long>(
-                pages_to_kb(info.mem_free_pages + info.inactive_file_pages)),
+                pages_to_kb(free_pages + info.inactive_file_pages)),
             static_cast<unsigned long>(pages_to_kb(info.buffer_pages)),
             static_cast<unsigned long>(pages_to_kb(info.page_cache_pages)),
             0U,
@@ -1117,6 +1392,93 @@ namespace procfs {
         return INodeCachePolicy::NONE;
     }
 
+    std::string ProcStatFile::render() const {
+        if (_node->stat == nullptr || _node->stat->render == nullptr) {
+            return {};
+        }
+        return _node->stat->render();
+    }
+
+    Result<size_t> ProcStatFile::read(off_t offset, void *buf, size_t len) {
+        if (offset < 0) {
+            unexpect_return(ErrCode::INVALID_PARAM);
+        }
+        auto content = render();
+        size_t off = static_cast<size_t>(offset);
+        if (off >= content.size()) {
+            return 0;
+        }
+        size_t actual = std::min(len, content.size() - off);
+        if (actual != 0 && buf == nullptr) {
+            unexpect_return(ErrCode::NULLPTR);
+        }
+        if (actual != 0) {
+            memcpy(buf, content.data() + off, actual);
+        }
+        return actual;
+    }
+
+    Result<size_t> ProcStatFile::write(off_t, const void *, size_t) {
+        unexpect_return(ErrCode::INSUFFICIENT_PERMISSIONS);
+    }
+
+    Result<size_t> ProcStatFile::size() {
+        return render().size();
+    }
+
+    Result<void> ProcStatFile::sync() {
+        void_return();
+    }
+
+    Result<void> ProcStatFile::truncate(size_t new_size) {
+        (void)new_size;
+        loggers::VFS::ERROR("procfs don't support truncate");
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
+
+    Result<void> ProcStatFile::ioctl(size_t cmd, syscall::UBuffer &&arg) {
+        (void)cmd;
+        (void)arg;
+        loggers::VFS::ERROR("procfs not suppoty ioctl");
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
+
+    IMetadata &ProcStatFile::metadata() {
+        return _node->metadata;
+    }
+
+    inode_t ProcStatFile::inode_id() const {
+        return _node->inode_id;
+    }
+
+    INodeCachePolicy ProcStatFile::inode_cache() const {
+        return INodeCachePolicy::NONE;
+    }
+
+    Result<void> ProcStatFile::getattr(AttrSet &out) const {
+        out.mode    = S_IFREG | 0444;
+        out.uid     = 0;
+        out.gid     = 0;
+        auto size_res = const_cast<ProcStatFile *>(this)->size();
+        if (!size_res.has_value()) { propagate_return(size_res); }
+        out.size    = size_res.value();
+        out.inode   = _node->inode_id;
+        out.nlink   = 1;
+        out.atime   = 0;
+        out.mtime   = 0;
+        out.ctime   = 0;
+        out.blksize = 512;
+        out.blocks  = (out.size + 511) / 512;
+        void_return();
+    }
+
+    Result<void> ProcStatFile::setattr(AttrMask mask, const AttrSet &attrs) {
+        (void)mask;
+        (void)attrs;
+        loggers::VFS::ERROR("procfs don't support setattr");
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
+
     ProcFSDriver &ProcFSDriver::inst() {
         if (_INSTANCE == nullptr) {
             _INSTANCE = new (&_INSTANCE_STORAGE[0]) ProcFSDriver();
@@ -61,6 +61,17 @@ namespace procfs {
         PID_DIR,
         PROC_FILE,
         PROC_LINK,
+        STAT_FILE,
+    };
+
+    /**
+     * @brief `/proc` 根目录下的全局只读统计文件.
+     *
+     * 文件内容在每次读取时由 render 重新生成.
+     */
+    struct ProcStatEntry {
+        const char *name;
+        std::string (*render)();
     };
 
     struct ProcMetadata final : public IMetadata {};
@@ -70,6 +81,7 @@ namespace procfs {
         NodeKind kind = NodeKind::ROOT_DIR;
         pid_t pid = 0;
         const ProcStateEntry *entry = nullptr;
+        const ProcStatEntry *stat = nullptr;
         ProcMetadata metadata{};
     };
 }  // namespace procfs
@@ -268,6 +280,43 @@ namespace procfs {
         Result<void> setattr(AttrMask mask, const AttrSet &attrs) override;
     };
 
+    class ProcStatFile final : public IFile {
+    private:
+        ProcFSSuperblock *_sb;
+        ProcNode *_node;
+
+        [[nodiscard]]
+        std::string render() const;
+
+    public:
+        ProcStatFile(ProcFSSuperblock &sb, ProcNode &node) noexcept;
+        ~ProcStatFile() final = default;
+
+        [[nodiscard]]
+        Result<size_t> read(off_t offset, void *buf, size_t len) override;
+        [[nodiscard]]
+        Result<size_t> write(off_t offset, const void *buf,
+                             size_t len) override;
+        [[nodiscard]]
+        Result<size_t> size() override;
+        [[nodiscard]]
+        Result<void> sync() override;
+        [[nodiscard]]
+        Result<void> truncate(size_t new_size) override;
+        [[nodiscard]]
+        Result<void> ioctl(size_t cmd, syscall::UBuffer &&arg) override;
+        [[nodiscard]]
+        IMetadata &metadata() override;
+        [[nodiscard]]
+        inode_t inode_id() const override;
+        [[nodiscard]]
+        INodeCachePolicy inode_cache() const override;
+        [[nodiscard]]
+        Result<void> getattr(AttrSet &out) const override;
+        [[nodiscard]]
+        Result<void> setattr(AttrMask mask, const AttrSet &attrs) override;
+    };
+
     class ProcFSSuperblock final : public ISuperblock {
     private:
         ProcFSDriver *_fs;
@@ -317,6 +366,8 @@ namespace procfs {
 
     [[nodiscard]]
     const ProcStateEntry *lookup_entry(std::string_view name) noexcept;
+    [[nodiscard]]
+    const ProcStatEntry *lookup_stat_entry(std::string_view name) noexcept;
 
     [[nodiscard]]
     Result<void> initialize_proc_state(
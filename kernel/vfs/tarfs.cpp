@@ -22,20 +22,16 @@
 
 // TarFile / TarDirectory 使用 KOP 内存池
 namespace kop {
-	Storage<KOP<tarfs::TarFile>> TarFileRaw;
-	Storage<KOP<tarfs::TarDirectory>> TarDirectoryRaw;
-	Storage<LockedObject<IrqSaveGuardedLock, KOP<tarfs::TarFile>>>
-		TarFileStorage;
-	Storage<LockedObject<IrqSaveGuardedLock, KOP<tarfs::TarDirectory>>>
-		TarDirectoryStorage;
+	Storage<KOP<tarfs::TarFile>> TarFileStorage;
+	Storage<KOP<tarfs::TarDirectory>> TarDirectoryStorage;
 
 	[[nodiscard]]
-	LockedObject<IrqSaveGuardedLock, KOP<tarfs::TarFile>> &TarFile() {
+	KOP<tarfs::TarFile> &TarFile() {
 		return TarFileStorage.ref();
 	}
 
 	[[nodiscard]]
-	LockedObject<IrqSaveGuardedLock, KOP<tarfs::TarDirectory>> &TarDirectory() {
+	KOP<tarfs::TarDirectory> &TarDirectory() {
 		return TarDirectoryStorage.ref();
 	}
 }
@@ -89,11 +85,11 @@ namespace tarfs {
 
     void *TarFile::operator new(size_t size) {
 		assert(size == sizeof(TarFile));
-		return kop::TarFile().get()->alloc();
+		return kop::TarFile().alloc();
 	}
 
 	void TarFile::operator delete(void *ptr) {
-		kop::TarFile().get()->free(static_cast<TarFile *>(ptr));
+		kop::TarFile().free(static_cast<TarFile *>(ptr));
 	}
 
 	TarFile::TarFile(TarSuperblock *sb, const TarBlock *header, inode_t id)
@@ -156,11 +152,11 @@ namespace tarfs {
 
 	void *TarDirectory::operator new(size_t size) {
 		assert(size == sizeof(TarDirectory));
-		return kop::TarDirectory().get()->alloc();
+		return kop::TarDirectory().alloc();
 	}
 
 	void TarDirectory::operator delete(void *ptr) {
-		kop::TarDirectory().get()->free(static_cast<TarDirectory *>(ptr));
+		kop::TarDirectory().free(static_cast<TarDirectory *>(ptr));
 	}
 
 	Result<inode_t> TarDirectory::lookup(std::string_view name) {
@@ -528,9 +524,7 @@ namespace tarfs {
     }
 
 	void init_kop() {
-		kop::TarFileRaw.construct();
-		kop::TarDirectoryRaw.construct();
-		kop::TarFileStorage.construct(kop::TarFileRaw.get());
-		kop::TarDirectoryStorage.construct(kop::TarDirectoryRaw.get());
+		kop::TarFileStorage.construct("tarfs_file");
+		kop::TarDirectoryStorage.construct("tarfs_dir");
 	}
 }  // namespace tarfs
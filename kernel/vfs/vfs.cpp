@@ -13,6 +13,7 @@
 #include <cap/cholder.h>
 #include <env.h>
 #include <mem/gfp.h>
+#include <mem/reclaim.h>
 #include <sus/path.h>
 #include <sustcore/attr.h>
 #include <sustcore/errcode.h>
@@ -27,10 +28,9 @@
 #include <cassert>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 namespace {
-    constexpr size_t kMaxPageCachePages = 1024;
-
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
     static VFS inst_vfs;
     static bool inst_vfs_initialized = false;
@@ -41,7 +41,7 @@ namespace {
         .writebacks     = 0,
         .evictions      = 0,
         .cached_pages   = 0,
-        .max_pages      = kMaxPageCachePages,
+        .max_pages      = 0,
         .backing_reads  = 0,
         .backing_writes = 0,
     };
@@ -52,6 +52,37 @@ namespace {
     static VINode::CachedFilePage *active_head   = nullptr;
     static VINode::CachedFilePage *active_tail   = nullptr;
 
+    /**
+     * @brief 全部 VSuperblock 的登记表, inode 缓存回收时据此遍历.
+     */
+    struct SuperblockRegistry {
+        std::vector<VSuperblock *> superblocks;
+        /// 下一次回收从该下标开始, 使各超级块轮流被收缩
+        size_t cursor = 0;
+        SpinLocker lock;
+    };
+
+    SuperblockRegistry vsb_registry;
+
+    void register_vsb(VSuperblock *vsb) {
+        GuardedLock guard(vsb_registry.lock);
+        vsb_registry.superblocks.push_back(vsb);
+    }
+
+    void unregister_vsb(VSuperblock *vsb) {
+        GuardedLock guard(vsb_registry.lock);
+        std::erase(vsb_registry.superblocks, vsb);
+    }
+
+    /**
+     * @brief vnode 只被 inode 缓存引用, 且其策略允许回收.
+     */
+    [[nodiscard]]
+    bool idle_inode(VINode *vnode) {
+        return vnode != nullptr && vnode->ref_count() == 1 &&
+               vnode->inode()->inode_cache() == INodeCachePolicy::SHARED;
+    }
+
     constexpr uint64_t EXT4_SUPER_MAGIC  = 0xEF53;
     constexpr uint64_t TMPFS_MAGIC       = 0x01021994;
     constexpr uint64_t PROC_SUPER_MAGIC  = 0x9FA0;
@@ -223,19 +254,6 @@ namespace {
         return inactive_head;
     }
 
-    Result<bool> evict_lru_page();
-
-    Result<void> ensure_page_cache_capacity() {
-        while (page_cache_stats.cached_pages >= kMaxPageCachePages) {
-            auto evict_res = evict_lru_page();
-            propagate(evict_res);
-            if (!evict_res.value()) {
-                unexpect_return(ErrCode::OUT_OF_MEMORY);
-            }
-        }
-        void_return();
-    }
-
     Result<bool> evict_lru_page() {
         VINode *owner = nullptr;
         {
@@ -244,6 +262,10 @@ namespace {
             if (victim == nullptr || victim->owner == nullptr) {
                 return false;
             }
+            // vnode 正在析构, 其文件页会由析构函数释放
+            if (!victim->owner->alive()) {
+                return false;
+            }
             owner = victim->owner;
             owner->keep();
         }
@@ -252,6 +274,91 @@ namespace {
         return evict_res;
     }
 
+    /**
+     * @brief 页缓存: 按 LRU 淘汰文件页, 脏页先回写.
+     */
+    class PageCacheShrinker final : public IShrinker {
+    public:
+        [[nodiscard]]
+        const char *name() const noexcept override {
+            return "page_cache";
+        }
+
+        [[nodiscard]]
+        size_t count() noexcept override {
+            GuardedLock cache_guard(page_cache_lock);
+            return page_cache_stats.cached_pages;
+        }
+
+        size_t scan(size_t nr) noexcept override {
+            size_t freed = 0;
+            while (freed < nr) {
+                auto evict_res = evict_lru_page();
+                if (!evict_res.has_value()) {
+                    loggers::VFS::ERROR("页缓存回收失败: err=%s",
+                                        to_cstring(evict_res.error()));
+                    break;
+                }
+                if (!evict_res.value()) {
+                    break;
+                }
+                freed++;
+            }
+            return freed;
+        }
+    };
+
+    /**
+     * @brief inode 缓存: 释放只被缓存引用的 vnode, 其文件页随之回写并释放.
+     */
+    class InodeCacheShrinker final : public IShrinker {
+    public:
+        [[nodiscard]]
+        const char *name() const noexcept override {
+            return "inode_cache";
+        }
+
+        [[nodiscard]]
+        size_t count() noexcept override {
+            GuardedLock guard(vsb_registry.lock);
+            size_t count = 0;
+            for (auto *vsb : vsb_registry.superblocks) {
+                count += vsb->idle_inodes();
+            }
+            return count;
+        }
+
+        size_t scan(size_t nr) noexcept override {
+            std::vector<VINode *> victims{};
+            {
+                GuardedLock guard(vsb_registry.lock);
+                size_t count = vsb_registry.superblocks.size();
+                for (size_t i = 0; i < count && victims.size() < nr; ++i) {
+                    size_t idx = vsb_registry.cursor++ % count;
+                    vsb_registry.superblocks[idx]->take_idle_inodes(
+                        nr - victims.size(), victims);
+                }
+            }
+            // 析构 vnode 会回写脏页, 必须在锁外进行
+            for (auto *vnode : victims) {
+                vnode->release();
+            }
+            return victims.size();
+        }
+    };
+
+    PageCacheShrinker page_cache_shrinker;
+    InodeCacheShrinker inode_cache_shrinker;
+
+    void register_shrinker(IShrinker &shrinker) noexcept {
+        auto register_res = Reclaim::register_shrinker(shrinker);
+        if (!register_res.has_value()) {
+            loggers::VFS::ERROR("登记 %s shrinker 失败: err=%s",
+                                shrinker.name(),
+                                to_cstring(register_res.error()));
+        }
+    }
+
     Result<void> fill_attr_from_vnode(VINode &vnode, AttrSet &out) {
         auto getattr_res = vnode.inode()->getattr(out);
         propagate(getattr_res);
@@ -267,7 +374,13 @@ namespace {
     }
 }  // namespace
 
+VSuperblock::VSuperblock(util::owner<ISuperblock *> sb, VFsDriver &fsd)
+    : _sb(sb), _fsd(&fsd) {
+    register_vsb(this);
+}
+
 VSuperblock::~VSuperblock() {
+    unregister_vsb(this);
     auto flush_res = flush_file_pages();
     if (!flush_res.has_value()) {
         loggers::VFS::ERROR("VSuperblock 析构回写页缓存失败: err=%s",
@@ -283,15 +396,25 @@ VSuperblock::~VSuperblock() {
     _sb = util::owner<ISuperblock *>(nullptr);
 }
 
-Result<util::refc_ptr<VINode>> VSuperblock::get_vnode(inode_t inode_id) {
+util::refc_ptr<VINode> VSuperblock::cached_vnode(inode_t inode_id) {
+    GuardedLock guard(_inode_cache_lock);
     auto cache_res = _inode_cache.at_nt(inode_id);
-    if (cache_res.has_value()) {
-        VINode *cached = *cache_res.value();
-        if (cached != nullptr) {
-            return util::refc_ptr(cached);
-        }
+    if (!cache_res.has_value()) {
+        return nullptr;
+    }
+    VINode *cached = *cache_res.value();
+    if (cached == nullptr) {
         _inode_cache.erase(inode_id);
     }
+    // 必须在锁内取得引用, 否则可能被 inode 缓存回收抢先释放
+    return cached;
+}
+
+Result<util::refc_ptr<VINode>> VSuperblock::get_vnode(inode_t inode_id) {
+    auto cached = cached_vnode(inode_id);
+    if (cached != nullptr) {
+        return cached;
+    }
 
     auto inode_res = sb()->get_inode(inode_id);
     if (!inode_res.has_value()) {
@@ -308,6 +431,7 @@ Result<util::refc_ptr<VINode>> VSuperblock::get_vnode(inode_t inode_id) {
 
     auto policy = vnode->inode()->inode_cache();
     if (policy != INodeCachePolicy::NONE) {
+        GuardedLock guard(_inode_cache_lock);
         vnode->keep();
         _inode_cache.insert_or_assign(inode_id, vnode);
     }
@@ -316,44 +440,81 @@ Result<util::refc_ptr<VINode>> VSuperblock::get_vnode(inode_t inode_id) {
 }
 
 Result<void> VSuperblock::invalidate_inode(inode_t inode_id) {
-    auto cache_res = _inode_cache.at_nt(inode_id);
-    if (!cache_res.has_value()) {
-        void_return();
-    }
-    VINode *cached = *cache_res.value();
+    auto cached = cached_vnode(inode_id);
     if (cached == nullptr) {
-        _inode_cache.erase(inode_id);
         void_return();
     }
     return cached->invalidate();
 }
 
 Result<void> VSuperblock::evict_inode(inode_t inode_id) {
-    auto cache_res = _inode_cache.at_nt(inode_id);
-    if (cache_res.has_value()) {
-        VINode *cached = *cache_res.value();
-        if (cached != nullptr) {
-            auto flush_res = cached->flush_file_pages();
-            propagate(flush_res);
-            cached->invalidate_file_pages();
-            cached->release();
+    auto cached = cached_vnode(inode_id);
+    if (cached != nullptr) {
+        auto flush_res = cached->flush_file_pages();
+        propagate(flush_res);
+        cached->invalidate_file_pages();
+    }
+
+    VINode *evicted = nullptr;
+    {
+        GuardedLock guard(_inode_cache_lock);
+        auto cache_res = _inode_cache.at_nt(inode_id);
+        if (cache_res.has_value()) {
+            evicted = *cache_res.value();
         }
+        _inode_cache.erase(inode_id);
+    }
+    if (evicted != nullptr) {
+        evicted->release();
     }
-    _inode_cache.erase(inode_id);
     void_return();
 }
 
 Result<void> VSuperblock::flush_file_pages() {
-    for (auto &entry : _inode_cache) {
-        if (entry.second == nullptr) {
-            continue;
+    // 回写会阻塞, 先在锁内取得全部 vnode 的引用
+    std::vector<util::refc_ptr<VINode>> vnodes{};
+    {
+        GuardedLock guard(_inode_cache_lock);
+        for (auto &entry : _inode_cache) {
+            if (entry.second != nullptr) {
+                vnodes.emplace_back(entry.second);
+            }
         }
-        auto flush_res = entry.second->flush_file_pages();
+    }
+    for (auto &vnode : vnodes) {
+        auto flush_res = vnode->flush_file_pages();
         propagate(flush_res);
     }
     void_return();
 }
 
+size_t VSuperblock::idle_inodes() {
+    GuardedLock guard(_inode_cache_lock);
+    size_t count = 0;
+    for (auto &entry : _inode_cache) {
+        if (idle_inode(entry.second)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void VSuperblock::take_idle_inodes(size_t nr, std::vector<VINode *> &out) {
+    GuardedLock guard(_inode_cache_lock);
+    size_t taken = 0;
+    for (auto it = _inode_cache.begin();
+         it != _inode_cache.end() && taken < nr;)
+    {
+        if (!idle_inode(it->second)) {
+            ++it;
+            continue;
+        }
+        out.push_back(it->second);
+        it = _inode_cache.erase(it);
+        taken++;
+    }
+}
+
 void VSuperblock::on_death() {
     // MountRecord owns mounted superblocks; zero vnode refs must not unmount.
 }
@@ -409,14 +570,16 @@ Result<PhyAddr> VINode::cached_file_page(IFile &file, size_t page_index,
     loggers::VFS::DEBUG("page cache miss: inode=%u page=%lu",
                         static_cast<unsigned>(_inode->inode_id()), page_index);
 
-    auto capacity_res = ensure_page_cache_capacity();
-    propagate(capacity_res);
-
-    auto page_res = GFP::get_free_page(1);
+    auto page_res = GFP::get_free_page(1, GFP_ZERO);
+    if (!page_res.has_value() && page_res.error() == ErrCode::OUT_OF_MEMORY &&
+        Reclaim::direct_reclaim())
+    {
+        // 页缓存不设上限, 只在分配失败时回收一批后重试一次
+        page_res = GFP::get_free_page(1, GFP_ZERO);
+    }
     propagate(page_res);
     PhyAddr paddr = page_res.value();
     auto *page    = convert<KpaAddr>(paddr).addr();
-    memset(page, 0, PAGESIZE);
 
     auto read_res =
         file.read(static_cast<off_t>(page_index * PAGESIZE), page, PAGESIZE);
@@ -447,6 +610,9 @@ Result<PhyAddr> VINode::cached_file_page(IFile &file, size_t page_index,
         cached.owner      = this;
         cached.page_index = page_index;
         lru_push_tail(cached, false);
+        if (Page *desc = MemMap::page_of(paddr); desc != nullptr) {
+            desc->set_owner(Page::PG_PAGECACHE, this);
+        }
         page_cache_stats.cached_pages++;
         env::inst().system_memory_info(env::key::set()).page_cache_pages++;
     }
@@ -456,6 +622,28 @@ Result<PhyAddr> VINode::cached_file_page(IFile &file, size_t page_index,
     return paddr;
 }
 
+Result<PhyAddr> VINode::pin_file_page(IFile &file, size_t page_index,
+                                      size_t *valid_len) {
+    while (true) {
+        auto page_res = cached_file_page(file, page_index, nullptr);
+        propagate(page_res);
+
+        GuardedLock cache_guard(page_cache_lock);
+        auto cached = _file_pages.find(page_index);
+        // 返回与加锁之间该页可能已被淘汰, 此时重新装入
+        if (cached == _file_pages.end() || cached->second.evicting ||
+            cached->second.paddr != page_res.value())
+        {
+            continue;
+        }
+        GFP::keep_page(cached->second.paddr, 1);
+        if (valid_len != nullptr) {
+            *valid_len = cached->second.valid;
+        }
+        return cached->second.paddr;
+    }
+}
+
 Result<size_t> VINode::read_cached_file(IFile &file, size_t offset, void *buf,
                                         size_t len) {
     auto *dst        = static_cast<char *>(buf);
@@ -688,6 +876,9 @@ Result<bool> VINode::evict_file_page() {
             if (info.page_cache_pages > 0) {
                 info.page_cache_pages--;
             }
+            if (Page *desc = MemMap::page_of(paddr); desc != nullptr) {
+                desc->clear_owner();
+            }
             _file_pages.erase(it);
             page_cache_stats.cached_pages--;
             page_cache_stats.evictions++;
@@ -697,6 +888,47 @@ Result<bool> VINode::evict_file_page() {
     return true;
 }
 
+bool VINode::migrate_cached_page(PhyAddr old_paddr,
+                                 PhyAddr new_paddr) noexcept {
+    {
+        GuardedLock cache_guard(page_cache_lock);
+        Page *desc = MemMap::page_of(old_paddr);
+        if (desc == nullptr || !desc->test(Page::PG_PAGECACHE) ||
+            desc->owner == nullptr)
+        {
+            return false;
+        }
+        auto *vnode = static_cast<VINode *>(desc->owner);
+        // pin_file_page 在同一把锁下增加引用, 这里看到的计数是准确的
+        if (!vnode->alive() || GFP::ref_count(old_paddr) != 1) {
+            return false;
+        }
+        CachedFilePage *page = nullptr;
+        for (auto &[page_index, cached] : vnode->_file_pages) {
+            if (cached.paddr == old_paddr) {
+                page = &cached;
+                break;
+            }
+        }
+        if (page == nullptr || page->evicting) {
+            return false;
+        }
+
+        GuardedLock page_guard(page->lock);
+        memcpy(convert<KpaAddr>(new_paddr).addr(),
+               convert<KpaAddr>(old_paddr).addr(), PAGESIZE);
+        page->paddr = new_paddr;
+        desc->clear_owner();
+        if (Page *new_desc = MemMap::page_of(new_paddr); new_desc != nullptr) {
+            new_desc->set_owner(Page::PG_PAGECACHE, vnode);
+        }
+    }
+    // 与淘汰路径相同, 等待锁外的读者离开旧页后再释放
+    synchronize_page_cache_rcu();
+    GFP::put_page(old_paddr, 1);
+    return true;
+}
+
 bool VINode::has_file_pages() const noexcept {
     return !_file_pages.empty();
 }
@@ -751,6 +983,9 @@ void VINode::invalidate_file_pages() noexcept {
             if (info.page_cache_pages > 0) {
                 info.page_cache_pages--;
             }
+            if (Page *desc = MemMap::page_of(paddr); desc != nullptr) {
+                desc->clear_owner();
+            }
             _file_pages.erase(it);
             if (page_cache_stats.cached_pages > 0) {
                 page_cache_stats.cached_pages--;
@@ -795,6 +1030,10 @@ void VFS::init() {
     // before use
     new (&inst_vfs) VFS();
     inst_vfs_initialized = true;
+
+    // 页缓存与 inode 缓存不设容量上限, 由内存压力回收收缩
+    register_shrinker(page_cache_shrinker);
+    register_shrinker(inode_cache_shrinker);
 }
 
 bool VFS::initialized() {
@@ -812,6 +1051,10 @@ VFSPageCacheStats VFS::page_cache_stats() noexcept {
     return ::page_cache_stats;
 }
 
+size_t VFS::shrink_page_cache(size_t nr) noexcept {
+    return page_cache_shrinker.scan(nr);
+}
+
 void VFS::reset_page_cache_stats() noexcept {
     size_t cached_pages = ::page_cache_stats.cached_pages;
     ::page_cache_stats  = VFSPageCacheStats{
@@ -821,7 +1064,7 @@ void VFS::reset_page_cache_stats() noexcept {
          .writebacks     = 0,
          .evictions      = 0,
          .cached_pages   = cached_pages,
-         .max_pages      = kMaxPageCachePages,
+         .max_pages      = 0,
          .backing_reads  = 0,
          .backing_writes = 0,
     };
@@ -2094,6 +2337,22 @@ Result<VFile *> VFS::__debug_open(const char *filepath) {
     return _open_file(filepath);
 }
 
+Result<VFile *> VFS::__debug_create(const char *filepath) {
+    if (filepath == nullptr) {
+        unexpect_return(ErrCode::NULLPTR);
+    }
+    if (*filepath != '/') {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+
+    util::Path mount_path;
+    auto root_res = _resolve_inode(util::Path("/"), mount_path);
+    propagate(root_res);
+    return _open_file_at(*root_res.value(), mount_path, util::Path("/"),
+                         filepath + 1,
+                         flags::O_READ | flags::O_WRITE | flags::O_CREAT);
+}
+
 Result<VFS::MountRecord *> VFS::_lookup_mount_record(
     const MountKey &key) const {
     auto record_res = mount_table.at_nt(key);
@@ -2443,6 +2702,22 @@ Result<size_t> VFS::read(VFile &vfile, off_t offset, void *buf,
     return read_res.value();
 }
 
+Result<PhyAddr> VFS::pin_page(VFile &vfile, off_t offset) const {
+    if (offset < 0 || static_cast<size_t>(offset) % PAGESIZE != 0) {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+
+    auto file_res = vfile.vinode()->inode()->as_file();
+    propagate(file_res);
+    IFile *file = file_res.value();
+
+    if (file->file_cache() == FileCachePolicy::NONE) {
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
+    return vfile.vinode()->pin_file_page(
+        *file, static_cast<size_t>(offset) / PAGESIZE, nullptr);
+}
+
 Result<size_t> VFS::write(VFile &vfile, off_t offset, const void *buf,
                           size_t len) const {
     if (offset < 0 || (len != 0 && buf == nullptr)) {
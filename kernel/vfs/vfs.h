@@ -28,6 +28,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class VFsDriver;
 class VSuperblock;
@@ -67,10 +68,16 @@ private:
     util::owner<ISuperblock *> _sb;
     util::refc_ptr<VFsDriver> _fsd;
     std::unordered_map<inode_t, VINode *> _inode_cache;
+    // 保护 _inode_cache, inode 缓存回收可能与查找并发
+    SpinLocker _inode_cache_lock;
+
+    /**
+     * @brief 取得缓存中的 vnode 引用, 不在缓存中时返回空.
+     */
+    util::refc_ptr<VINode> cached_vnode(inode_t inode_id);
 
 public:
-    VSuperblock(util::owner<ISuperblock *> sb, VFsDriver &fsd)
-        : _sb(sb), _fsd(&fsd) {}
+    VSuperblock(util::owner<ISuperblock *> sb, VFsDriver &fsd);
     virtual ~VSuperblock();
     constexpr ISuperblock *sb() const {
         return _sb.get();
@@ -82,6 +89,17 @@ public:
     Result<void> invalidate_inode(inode_t inode_id);
     Result<void> evict_inode(inode_t inode_id);
     Result<void> flush_file_pages();
+    /**
+     * @brief 统计只被 inode 缓存引用且可回收 (SHARED 策略) 的 vnode 数.
+     */
+    [[nodiscard]]
+    size_t idle_inodes();
+    /**
+     * @brief 从 inode 缓存中摘下至多 nr 个可回收的 vnode.
+     *
+     * 缓存持有的引用随之转移给调用方.
+     */
+    void take_idle_inodes(size_t nr, std::vector<VINode *> &out);
     void on_death();
 };
 
@@ -122,6 +140,15 @@ public:
     [[nodiscard]]
     Result<PhyAddr> cached_file_page(IFile &file, size_t page_index,
                                      size_t *valid_len);
+    /**
+     * @brief 取得页缓存中的文件页并为调用方增加一个 GFP 引用.
+     *
+     * 调用方可直接映射该物理页, 不再需要时以 GFP::put_page 释放;
+     * 页缓存随后淘汰该页也不会使其失效.
+     */
+    [[nodiscard]]
+    Result<PhyAddr> pin_file_page(IFile &file, size_t page_index,
+                                  size_t *valid_len);
     [[nodiscard]]
     Result<size_t> read_cached_file(IFile &file, size_t offset, void *buf,
                                     size_t len);
@@ -138,6 +165,17 @@ public:
     Result<void> flush_file_pages();
     [[nodiscard]]
     Result<bool> evict_file_page();
+    /**
+     * @brief 把页缓存中位于 old_paddr 的文件页迁移到 new_paddr.
+     *
+     * 只迁移仅被页缓存引用的页; 被映射或固定的页仍有其他引用者, 不能迁移.
+     * 成功时旧页的引用随之释放.
+     *
+     * @return true 已迁移, new_paddr 归页缓存所有; false 调用方仍持有 new_paddr
+     */
+    [[nodiscard]]
+    static bool migrate_cached_page(PhyAddr old_paddr,
+                                    PhyAddr new_paddr) noexcept;
     [[nodiscard]]
     bool has_file_pages() const noexcept;
     void invalidate_file_pages() noexcept;
@@ -472,6 +510,12 @@ public:
 
     static VFSPageCacheStats page_cache_stats() noexcept;
     static void reset_page_cache_stats() noexcept;
+    /**
+     * @brief 直接驱动页缓存 shrinker, 供内核测试观察淘汰行为.
+     *
+     * @return 实际淘汰的页数
+     */
+    static size_t shrink_page_cache(size_t nr) noexcept;
 
     VFS() = default;
     ~VFS();
@@ -606,10 +650,15 @@ public:
     Result<devfs::DevFSSuperblock *> devfs();
     // 仅供测试代码使用的调试接口
     Result<VFile *> __debug_open(const char *filepath);
+    // 同 __debug_open, 文件不存在时先创建
+    Result<VFile *> __debug_create(const char *filepath);
 
 public:
     // 读取文件内容到buf中, 返回实际读取的字节数
     Result<size_t> read(VFile &vfile, off_t offset, void *buf, size_t len) const;
+    // 取得页对齐偏移处的页缓存页, 调用方持有一个 GFP 引用;
+    // 文件不经过页缓存时返回 NOT_SUPPORTED
+    Result<PhyAddr> pin_page(VFile &vfile, off_t offset) const;
     // 将buf中的内容写入文件, 返回实际写入的字节数
     Result<size_t> write(VFile &vfile, off_t offset, const void *buf,
                          size_t len) const;
@@ -1 +1 @@
-sources += sbi.c sbi_dbcn.c sbi_legacy.c sbi_base.c
+sources += sbi.c sbi_dbcn.c sbi_legacy.c sbi_base.c sbi_send_ipi.c sbi_hsm.c
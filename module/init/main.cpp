@@ -600,6 +600,11 @@ extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
         //     .is_linuxproc = false,
         // },
         // SpawnRequest{
+        //     .path         = "/initrd/test_fault_perf.mod",
+        //     .dispname     = "test_fault_perf",
+        //     .is_linuxproc = false,
+        // },
+        // SpawnRequest{
         //     .path         = "/initrd/test-procfs.mod",
         //     .dispname     = "test-procfs",
         //     .is_linuxproc = false,
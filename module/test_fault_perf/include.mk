@@ -0,0 +1 @@
+sources += main.cpp
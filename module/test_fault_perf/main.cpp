@@ -0,0 +1,100 @@
+/**
+ * @file main.cpp
+ * @brief Anonymous page fault latency benchmark
+ */
+
+#include <kmod/syscall.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    constexpr size_t PAGE_SIZE             = 4096;
+    constexpr size_t FAULT_PAGES           = 256;
+    constexpr size_t ROUNDS                = 8;
+    constexpr uintptr_t MAP_ADDR           = 0x000710000000ULL;
+    constexpr uint64_t MEMORY_GROWTH_FIXED = 0;
+    constexpr uint64_t PROT_READ           = 0x1;
+    constexpr uint64_t PROT_WRITE          = 0x2;
+    constexpr uint64_t PROT_RW             = PROT_READ | PROT_WRITE;
+
+    void fail(const char *msg) {
+        printf("test_fault_perf: FAIL %s\n", msg);
+        exit(-1);
+    }
+
+    void check(bool condition, const char *msg) {
+        if (!condition) {
+            fail(msg);
+        }
+    }
+
+    /**
+     * 每轮新建一块匿名内存并逐页写入, 每次写入触发一次缺页;
+     * 轮末释放内存, 其页框回到空闲页链表供下一轮复用.
+     */
+    uint64_t run_round() {
+        auto mem_res = sys_mem_create(cap::null, FAULT_PAGES * PAGE_SIZE, false,
+                                      false, MEMORY_GROWTH_FIXED, 0)
+                           .to_result();
+        CapIdx mem_cap = mem_res.has_value() ? mem_res.value() : cap::error;
+        check(mem_cap != cap::null && mem_cap != cap::error,
+              "anonymous memory create failed");
+
+        auto *mapped = reinterpret_cast<volatile char *>(MAP_ADDR);
+        check(sys_pcb_map(__pcb_cap, mem_cap, 0, const_cast<char *>(mapped),
+                          FAULT_PAGES * PAGE_SIZE, PROT_RW),
+              "map anonymous memory failed");
+
+        uint64_t start_ns = sys_time_now_ns().value();
+        for (size_t i = 0; i < FAULT_PAGES; ++i) {
+            mapped[i * PAGE_SIZE] = static_cast<char>(i);
+        }
+        uint64_t done_ns = sys_time_now_ns().value();
+
+        for (size_t i = 0; i < FAULT_PAGES; ++i) {
+            check(mapped[i * PAGE_SIZE] == static_cast<char>(i),
+                  "faulted page content mismatch");
+        }
+
+        check(sys_mem_unmap(mem_cap, const_cast<char *>(mapped)),
+              "unmap anonymous memory failed");
+        check(sys_cap_remove(mem_cap), "remove memory cap failed");
+        return done_ns - start_ns;
+    }
+}  // namespace
+
+extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
+                         const bsheader *bsargv[]) {
+    (void)argc;
+    (void)argv;
+    (void)envp;
+    (void)bsargv;
+
+    printf("test_fault_perf: start pid=%u pages=%lu rounds=%lu\n",
+           sys_getpid(__pcb_cap).value(),
+           static_cast<unsigned long>(FAULT_PAGES),
+           static_cast<unsigned long>(ROUNDS));
+
+    uint64_t first_ns = 0;
+    uint64_t warm_sum = 0;
+    for (size_t round = 0; round < ROUNDS; ++round) {
+        uint64_t elapsed = run_round();
+        printf("test_fault_perf: round=%lu total_ns=%lu ns_per_fault=%lu\n",
+               static_cast<unsigned long>(round),
+               static_cast<unsigned long>(elapsed),
+               static_cast<unsigned long>(elapsed / FAULT_PAGES));
+        if (round == 0) {
+            first_ns = elapsed;
+        } else {
+            warm_sum += elapsed;
+        }
+    }
+
+    printf("test_fault_perf: cold_ns_per_fault=%lu warm_ns_per_fault=%lu\n",
+           static_cast<unsigned long>(first_ns / FAULT_PAGES),
+           static_cast<unsigned long>(warm_sum / ((ROUNDS - 1) * FAULT_PAGES)));
+    printf("test_fault_perf: PASS\n");
+    exit(0);
+    return 0;
+}
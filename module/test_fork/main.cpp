@@ -16,6 +16,13 @@ constexpr size_t kCompletionSignal   = 0;
 static CapIdx exec_notif_cap         = cap::null;
 constexpr uint32_t kBootstrapTypeNotif = 0xFFFF0002U;
 
+constexpr size_t kPageSize            = 4096;
+constexpr size_t kBenchPages          = 1024;
+constexpr size_t kBenchRounds         = 8;
+constexpr uintptr_t kBenchMapAddr     = 0x000720000000ULL;
+constexpr uint64_t kMemoryGrowthFixed = 0;
+constexpr uint64_t kProtRW            = 0x3;
+
 static const char *cap_type_name(PayloadType type) {
     return to_string(type);
 }
@@ -46,6 +53,61 @@ static char *alloc_page_string(const char *str) {
     return buf;
 }
 
+/**
+ * fork 延迟基准: 父进程先写满 kBenchPages 页匿名内存, 再反复 fork,
+ * 只计 fork 调用本身的耗时. 子进程立即退出, 不触碰任何页面.
+ */
+static void run_fork_bench() {
+    auto mem_res = sys_mem_create(cap::null, kBenchPages * kPageSize, false,
+                                  false, kMemoryGrowthFixed, 0)
+                       .to_result();
+    CapIdx mem_cap = mem_res.has_value() ? mem_res.value() : cap::error;
+    if (mem_cap == cap::null || mem_cap == cap::error) {
+        printf("test_fork(bench): anonymous memory create failed\n");
+        exit(-1);
+    }
+    auto *mapped = reinterpret_cast<char *>(kBenchMapAddr);
+    if (!sys_pcb_map(__pcb_cap, mem_cap, 0, mapped, kBenchPages * kPageSize,
+                     kProtRW))
+    {
+        printf("test_fork(bench): map anonymous memory failed\n");
+        exit(-1);
+    }
+
+    uint64_t sum_ns = 0;
+    for (size_t round = 0; round < kBenchRounds; ++round) {
+        // 上一轮 fork 把页面改成了 COW, 重新写入使其恢复可写
+        for (size_t i = 0; i < kBenchPages; ++i) {
+            mapped[i * kPageSize] = static_cast<char>(round + i);
+        }
+
+        CapIdx child_cap  = cap::null;
+        uint64_t start_ns = sys_time_now_ns().value();
+        auto fork_res     = fork(&child_cap).to_result();
+        uint64_t done_ns  = sys_time_now_ns().value();
+        if (!fork_res.has_value() || child_cap == cap::error) {
+            printf("test_fork(bench): fork failed\n");
+            exit(-1);
+        }
+        if (fork_res.value() == 0) {
+            exit(0);
+        }
+
+        uint64_t elapsed = done_ns - start_ns;
+        sum_ns += elapsed;
+        printf("test_fork(bench): round=%lu pages=%lu fork_ns=%lu\n",
+               static_cast<unsigned long>(round),
+               static_cast<unsigned long>(kBenchPages),
+               static_cast<unsigned long>(elapsed));
+    }
+    printf("test_fork(bench): avg_fork_ns=%lu ns_per_page=%lu\n",
+           static_cast<unsigned long>(sum_ns / kBenchRounds),
+           static_cast<unsigned long>(sum_ns / (kBenchRounds * kBenchPages)));
+
+    (void)sys_mem_unmap(mem_cap, mapped);
+    (void)sys_cap_remove(mem_cap);
+}
+
 extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
                          const bsheader *bsargv[]) {
     (void)argc;
@@ -144,6 +206,8 @@ extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
     printf("test_fork(%s): 发送 ACK\n", tag);
     (void)sys_notif_signal(exec_notif_cap, kSignalAck).to_result();
 
+    run_fork_bench();
+
     printf("test_fork(%s): exit\n", tag);
     exit(0);
 
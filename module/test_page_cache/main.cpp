@@ -54,9 +54,8 @@ namespace {
                static_cast<unsigned>(value.max_pages));
     }
 
-    void check_cache_bound(const VFSPageCacheStats &value, const char *msg) {
-        check(value.max_pages == 4, "page cache max should be four pages");
-        check(value.cached_pages <= value.max_pages, msg);
+    void check_unbounded(const VFSPageCacheStats &value) {
+        check(value.max_pages == 0, "page cache should have no fixed cap");
     }
 }  // namespace
 
@@ -85,13 +84,13 @@ extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
 
     VFSPageCacheStats after_write = stats();
     print_stats("after write", after_write);
-    check_cache_bound(after_write, "write should respect cache page bound");
+    check_unbounded(after_write);
     check(after_write.misses == TEST_PAGES,
           "write should allocate each file page through cache");
-    check(after_write.evictions >= TEST_PAGES - after_write.max_pages,
-          "write should evict pages past the four-page cap");
-    check(after_write.writebacks >= 1,
-          "dirty eviction should write back at least one page");
+    check(after_write.cached_pages >= TEST_PAGES,
+          "write should keep every file page cached");
+    check(after_write.evictions == 0,
+          "write should not evict without memory pressure");
     check(after_write.invalidations == 0, "write should not invalidate cache");
 
     for (size_t page = 0; page < TEST_PAGES; ++page) {
@@ -99,18 +98,18 @@ extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
         size_t got = sys_vfs_read(file_cap, page * PAGE_SIZE, g_read,
                                   sizeof(g_read))
                          .value();
-        check(got == sizeof(g_read), "read full page after eviction failed");
+        check(got == sizeof(g_read), "read full page after write failed");
         check(memcmp(g_read, g_data + page * PAGE_SIZE, sizeof(g_read)) == 0,
-              "read after dirty eviction data mismatch");
+              "read after write data mismatch");
     }
 
     VFSPageCacheStats after_reads = stats();
     print_stats("after full reads", after_reads);
-    check_cache_bound(after_reads, "reads should respect cache page bound");
-    check(after_reads.misses > after_write.misses,
-          "reading evicted pages should miss and refill");
-    check(after_reads.evictions > after_write.evictions,
-          "reading more than four pages should keep evicting");
+    check_unbounded(after_reads);
+    check(after_reads.misses == after_write.misses,
+          "reading resident pages should not miss");
+    check(after_reads.hits == after_write.hits + TEST_PAGES,
+          "reading resident pages should hit");
 
     size_t hot_page = TEST_PAGES - 1;
     memset(g_read, 0, sizeof(g_read));
@@ -130,9 +129,9 @@ extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
 
     memset(g_read, 0, sizeof(g_read));
     got = sys_vfs_read(file_cap, 0, g_read, sizeof(g_read)).value();
-    check(got == sizeof(g_read), "cold page refill failed");
+    check(got == sizeof(g_read), "first page reread failed");
     check(memcmp(g_read, g_data, sizeof(g_read)) == 0,
-          "cold page refill data mismatch");
+          "first page reread data mismatch");
 
     memset(g_read, 0, sizeof(g_read));
     got = sys_vfs_read(file_cap, hot_page * PAGE_SIZE, g_read, sizeof(g_read))
@@ -143,10 +142,10 @@ extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
 
     VFSPageCacheStats after_lru = stats();
     print_stats("after lru check", after_lru);
-    check(after_lru.misses == after_hot.misses + 1,
-          "cold refill should miss once");
-    check(after_lru.hits == after_hot.hits + 1,
-          "active hot page should survive cold refill");
+    check(after_lru.misses == after_hot.misses,
+          "first page should still be resident");
+    check(after_lru.hits == after_hot.hits + 2,
+          "both rereads should hit");
 
     AttrSet attrs{};
     check(sys_vfs_getattr(file_cap, &attrs),
@@ -163,9 +162,9 @@ extern "C" int kmod_main(int argc, const char *argv[], const char *envp[],
 
     VFSPageCacheStats after_sync = stats();
     print_stats("after sync", after_sync);
-    check_cache_bound(after_sync, "sync should keep cache within bound");
-    check(after_sync.writebacks >= after_lru.writebacks,
-          "sync should not lose writeback accounting");
+    check_unbounded(after_sync);
+    check(after_sync.writebacks >= after_lru.writebacks + 1,
+          "sync should write back dirty pages");
     check(after_sync.invalidations == after_lru.invalidations,
           "sync should keep clean cached page");
 